@@ -513,6 +513,25 @@ Object *ClassDB::instance(const StringName &p_class) {
 	return ti->creation_func();
 }
 
+Object *(*ClassDB::get_creation_func(const StringName &p_class))() {
+	OBJTYPE_RLOCK;
+	ClassInfo *ti = classes.getptr(p_class);
+	if (!ti || ti->disabled || !ti->creation_func) {
+		if (compat_classes.has(p_class)) {
+			ti = classes.getptr(compat_classes[p_class]);
+		}
+	}
+	if (!ti || ti->disabled) {
+		return nullptr;
+	}
+#ifdef TOOLS_ENABLED
+	if (ti->api == API_EDITOR && !Engine::get_singleton()->is_editor_hint()) {
+		return nullptr;
+	}
+#endif
+	return ti->creation_func;
+}
+
 bool ClassDB::can_instance(const StringName &p_class) {
 	OBJTYPE_RLOCK;
 
@@ -1055,6 +1074,53 @@ bool ClassDB::get_property(Object *p_object, const StringName &p_property, Varia
 	return false;
 }
 
+// The two functions below return the MethodBind that get_property() and
+// set_property() would call directly for a class, so callers can cache it.
+// They return nullptr whenever those would do anything else.
+
+MethodBind *ClassDB::get_property_getter_bind(const StringName &p_class, const StringName &p_property) {
+	OBJTYPE_RLOCK;
+
+	ClassInfo *check = classes.getptr(p_class);
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+			if (psg->getter && psg->index < 0) {
+				return psg->_getptr;
+			}
+			return nullptr;
+		}
+
+		if (check->constant_map.has(p_property) || check->method_map.has(p_property) || check->signal_map.has(p_property)) {
+			return nullptr;
+		}
+
+		check = check->inherits_ptr;
+	}
+
+	return nullptr;
+}
+
+MethodBind *ClassDB::get_property_setter_bind(const StringName &p_class, const StringName &p_property, int *r_index) {
+	OBJTYPE_RLOCK;
+
+	ClassInfo *check = classes.getptr(p_class);
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+			if (psg->setter) {
+				*r_index = psg->index;
+				return psg->_setptr;
+			}
+			return nullptr;
+		}
+
+		check = check->inherits_ptr;
+	}
+
+	return nullptr;
+}
+
 int ClassDB::get_property_index(const StringName &p_class, const StringName &p_property, bool *r_is_valid) {
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
@@ -0,0 +1,403 @@
+/*************************************************************************/
+/*  compact_ordered_hash_map.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef COMPACT_ORDERED_HASH_MAP_H
+#define COMPACT_ORDERED_HASH_MAP_H
+
+#include "core/hashfuncs.h"
+#include "core/os/memory.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * An insertion ordered HashMap that keeps its entries in a dense array, in
+ * insertion order, and looks them up through a separate open addressed index
+ * (linear probing with backward shift deletion) holding hashes and positions.
+ *
+ * Inserting doesn't allocate per entry, and iterating walks contiguous memory.
+ *
+ * The entry array is split in pages that double in size and are never moved,
+ * so, like with OrderedHashMap, pointers to keys and values stay valid while
+ * other keys are inserted. Erasing leaves a hole that iteration skips; holes are
+ * compacted away by erase() once they outnumber the entries, which moves them.
+ *
+ * Positions go from 0 to get_position_count() - 1 in insertion order, and can
+ * be walked with front_position() and next_position().
+ */
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class CompactOrderedHashMap {
+	struct Entry {
+		TKey key;
+		TValue value;
+		uint32_t hash; // EMPTY_HASH once erased.
+	};
+
+	struct Slot {
+		uint32_t hash;
+		uint32_t position;
+	};
+
+	static const uint32_t EMPTY_HASH = 0;
+	static const uint32_t MIN_INDEX_CAPACITY = 8;
+	static const uint32_t FIRST_PAGE_SHIFT = 2; // The first page holds 4 entries.
+
+	Entry **pages = nullptr;
+	uint32_t page_count = 0;
+
+	uint32_t used = 0; // Positions taken, including erased ones.
+	uint32_t elements = 0;
+
+	Slot *index = nullptr;
+	uint32_t index_capacity = 0; // Power of two.
+
+	// Index of the highest set bit, p_value must not be 0.
+	_FORCE_INLINE_ static uint32_t _highest_bit(uint32_t p_value) {
+#if defined(__GNUC__)
+		return 31 - __builtin_clz(p_value);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse(&index, p_value);
+		return index;
+#else
+		uint32_t bit = 0;
+		while (p_value >>= 1) {
+			bit++;
+		}
+		return bit;
+#endif
+	}
+
+	_FORCE_INLINE_ static uint32_t _page_of(uint32_t p_position, uint32_t &r_offset) {
+		// Page p starts at position 4 * (2^p - 1) and holds 4 * 2^p entries.
+		uint32_t n = p_position + (1 << FIRST_PAGE_SHIFT);
+		uint32_t page = _highest_bit(n) - FIRST_PAGE_SHIFT;
+		r_offset = n - (1 << (page + FIRST_PAGE_SHIFT));
+		return page;
+	}
+
+	_FORCE_INLINE_ Entry *_entry(uint32_t p_position) const {
+		uint32_t offset;
+		uint32_t page = _page_of(p_position, offset);
+		return &pages[page][offset];
+	}
+
+	_FORCE_INLINE_ static uint32_t _hash(const TKey &p_key) {
+		uint32_t hash = Hasher::hash(p_key);
+		if (hash == EMPTY_HASH) {
+			hash = EMPTY_HASH + 1;
+		}
+		return hash;
+	}
+
+	// Returns the index slot holding the key, or UINT32_MAX.
+	uint32_t _lookup_slot(const TKey &p_key, uint32_t p_hash) const {
+		if (!elements) {
+			return UINT32_MAX;
+		}
+		uint32_t mask = index_capacity - 1;
+		uint32_t pos = p_hash & mask;
+		while (index[pos].hash != EMPTY_HASH) {
+			if (index[pos].hash == p_hash && Comparator::compare(_entry(index[pos].position)->key, p_key)) {
+				return pos;
+			}
+			pos = (pos + 1) & mask;
+		}
+		return UINT32_MAX;
+	}
+
+	void _index_insert(uint32_t p_hash, uint32_t p_position) {
+		uint32_t mask = index_capacity - 1;
+		uint32_t pos = p_hash & mask;
+		while (index[pos].hash != EMPTY_HASH) {
+			pos = (pos + 1) & mask;
+		}
+		index[pos].hash = p_hash;
+		index[pos].position = p_position;
+	}
+
+	void _index_remove(uint32_t p_slot) {
+		// Backward shift deletion, so lookups never need tombstones.
+		uint32_t mask = index_capacity - 1;
+		uint32_t hole = p_slot;
+		uint32_t pos = (p_slot + 1) & mask;
+		while (index[pos].hash != EMPTY_HASH) {
+			uint32_t ideal = index[pos].hash & mask;
+			// Move the slot back if the hole lies between its ideal position and where it is.
+			if (((pos - ideal) & mask) >= ((pos - hole) & mask)) {
+				index[hole] = index[pos];
+				hole = pos;
+			}
+			pos = (pos + 1) & mask;
+		}
+		index[hole].hash = EMPTY_HASH;
+	}
+
+	void _rebuild_index(uint32_t p_capacity) {
+		if (index) {
+			memdelete_arr(index);
+		}
+		index_capacity = p_capacity;
+		index = memnew_arr(Slot, index_capacity);
+		for (uint32_t i = 0; i < index_capacity; i++) {
+			index[i].hash = EMPTY_HASH;
+		}
+		for (uint32_t i = 0; i < used; i++) {
+			Entry *e = _entry(i);
+			if (e->hash != EMPTY_HASH) {
+				_index_insert(e->hash, i);
+			}
+		}
+	}
+
+	Entry *_append(const TKey &p_key, const TValue &p_value, uint32_t p_hash) {
+		// Keep the index at most 3/4 full.
+		if ((elements + 1) * 4 > index_capacity * 3) {
+			_rebuild_index(MAX(MIN_INDEX_CAPACITY, index_capacity * 2));
+		}
+
+		uint32_t offset;
+		uint32_t page = _page_of(used, offset);
+		if (page >= page_count) {
+			pages = (Entry **)memrealloc(pages, sizeof(Entry *) * (page + 1));
+			pages[page] = (Entry *)memalloc(sizeof(Entry) * (1 << (page + FIRST_PAGE_SHIFT)));
+			page_count = page + 1;
+		}
+
+		Entry *e = &pages[page][offset];
+		memnew_placement(&e->key, TKey(p_key));
+		memnew_placement(&e->value, TValue(p_value));
+		e->hash = p_hash;
+
+		_index_insert(p_hash, used);
+		used++;
+		elements++;
+		return e;
+	}
+
+	// Moves entries over the holes left by erase, and releases pages no longer needed.
+	void _compact() {
+		uint32_t to = 0;
+		for (uint32_t from = 0; from < used; from++) {
+			Entry *src = _entry(from);
+			if (src->hash == EMPTY_HASH) {
+				continue;
+			}
+			if (to != from) {
+				Entry *dst = _entry(to);
+				memnew_placement(&dst->key, TKey(src->key));
+				memnew_placement(&dst->value, TValue(src->value));
+				dst->hash = src->hash;
+				src->key.~TKey();
+				src->value.~TValue();
+				src->hash = EMPTY_HASH;
+			}
+			to++;
+		}
+		used = to;
+
+		uint32_t needed = 0;
+		if (used) {
+			uint32_t offset;
+			needed = _page_of(used - 1, offset) + 1;
+		}
+		for (uint32_t i = needed; i < page_count; i++) {
+			memfree(pages[i]);
+		}
+		page_count = needed;
+		if (!page_count) {
+			memfree(pages);
+			pages = nullptr;
+		}
+
+		_rebuild_index(index_capacity);
+	}
+
+public:
+	_FORCE_INLINE_ int size() const { return elements; }
+	_FORCE_INLINE_ bool empty() const { return elements == 0; }
+
+	TValue *getptr(const TKey &p_key) {
+		uint32_t slot = _lookup_slot(p_key, _hash(p_key));
+		return slot == UINT32_MAX ? nullptr : &_entry(index[slot].position)->value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		uint32_t slot = _lookup_slot(p_key, _hash(p_key));
+		return slot == UINT32_MAX ? nullptr : &_entry(index[slot].position)->value;
+	}
+
+	bool has(const TKey &p_key) const {
+		return _lookup_slot(p_key, _hash(p_key)) != UINT32_MAX;
+	}
+
+	// Returns the position of the key, or -1.
+	int find_position(const TKey &p_key) const {
+		uint32_t slot = _lookup_slot(p_key, _hash(p_key));
+		return slot == UINT32_MAX ? -1 : int(index[slot].position);
+	}
+
+	TValue &insert(const TKey &p_key, const TValue &p_value) {
+		uint32_t hash = _hash(p_key);
+		uint32_t slot = _lookup_slot(p_key, hash);
+		if (slot != UINT32_MAX) {
+			Entry *e = _entry(index[slot].position);
+			e->value = p_value;
+			return e->value;
+		}
+		return _append(p_key, p_value, hash)->value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		uint32_t hash = _hash(p_key);
+		uint32_t slot = _lookup_slot(p_key, hash);
+		if (slot != UINT32_MAX) {
+			return _entry(index[slot].position)->value;
+		}
+		// consistent with Map behaviour
+		return _append(p_key, TValue(), hash)->value;
+	}
+
+	const TValue &operator[](const TKey &p_key) const {
+		const TValue *value = getptr(p_key);
+		CRASH_COND(!value);
+		return *value;
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t slot = _lookup_slot(p_key, _hash(p_key));
+		if (slot == UINT32_MAX) {
+			return false;
+		}
+
+		uint32_t position = index[slot].position;
+		_index_remove(slot);
+
+		Entry *e = _entry(position);
+		e->key.~TKey();
+		e->value.~TValue();
+		e->hash = EMPTY_HASH;
+		elements--;
+
+		// Erasing the last entries leaves no hole.
+		while (used && _entry(used - 1)->hash == EMPTY_HASH) {
+			used--;
+		}
+		if (used - elements > MAX(elements, 8u)) {
+			_compact();
+		}
+		return true;
+	}
+
+	// Iteration over positions, skipping erased entries. Both return -1 at the end.
+	int front_position() const {
+		return next_position(-1);
+	}
+
+	int next_position(int p_position) const {
+		for (uint32_t i = p_position + 1; i < used; i++) {
+			if (_entry(i)->hash != EMPTY_HASH) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	_FORCE_INLINE_ int get_position_count() const { return used; }
+	// True when positions match the order of the entries, so the n-th entry is at position n.
+	_FORCE_INLINE_ bool is_dense() const { return used == elements; }
+
+	_FORCE_INLINE_ const TKey &get_key(int p_position) const {
+		return _entry(p_position)->key;
+	}
+
+	_FORCE_INLINE_ TValue &get_value(int p_position) {
+		return _entry(p_position)->value;
+	}
+
+	_FORCE_INLINE_ const TValue &get_value(int p_position) const {
+		return _entry(p_position)->value;
+	}
+
+	const void *id() const {
+		return this;
+	}
+
+	void clear() {
+		for (uint32_t i = 0; i < used; i++) {
+			Entry *e = _entry(i);
+			if (e->hash != EMPTY_HASH) {
+				e->key.~TKey();
+				e->value.~TValue();
+			}
+		}
+		for (uint32_t i = 0; i < page_count; i++) {
+			memfree(pages[i]);
+		}
+		if (pages) {
+			memfree(pages);
+			pages = nullptr;
+		}
+		if (index) {
+			memdelete_arr(index);
+			index = nullptr;
+		}
+		page_count = 0;
+		index_capacity = 0;
+		used = 0;
+		elements = 0;
+	}
+
+	void operator=(const CompactOrderedHashMap &p_map) {
+		if (this == &p_map) {
+			return;
+		}
+		clear();
+		for (int i = p_map.front_position(); i >= 0; i = p_map.next_position(i)) {
+			const Entry *e = p_map._entry(i);
+			_append(e->key, e->value, e->hash);
+		}
+	}
+
+	CompactOrderedHashMap(const CompactOrderedHashMap &p_map) {
+		*this = p_map;
+	}
+
+	CompactOrderedHashMap() {}
+
+	~CompactOrderedHashMap() {
+		clear();
+	}
+};
+
+#endif // COMPACT_ORDERED_HASH_MAP_H
@@ -30,13 +30,13 @@
 
 #include "dictionary.h"
 
-#include "core/ordered_hash_map.h"
+#include "core/compact_ordered_hash_map.h"
 #include "core/safe_refcount.h"
 #include "core/variant.h"
 
 struct DictionaryPrivate {
 	SafeRefCount refcount;
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> variant_map;
+	CompactOrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> variant_map;
 };
 
 void Dictionary::get_key_list(List<Variant> *p_keys) const {
@@ -44,33 +44,44 @@ void Dictionary::get_key_list(List<Variant> *p_keys) const {
 		return;
 	}
 
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
-		p_keys->push_back(E.key());
+	for (int i = _p->variant_map.front_position(); i >= 0; i = _p->variant_map.next_position(i)) {
+		p_keys->push_back(_p->variant_map.get_key(i));
 	}
 }
 
-Variant Dictionary::get_key_at_index(int p_index) const {
+// Returns the position of the n-th entry, or -1.
+static int _get_position_of_index(const CompactOrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> &p_map, int p_index) {
+	if (p_index < 0 || p_index >= p_map.size()) {
+		return -1;
+	}
+	if (p_map.is_dense()) {
+		return p_index; // No erased entries in between, so no need to walk.
+	}
+
 	int index = 0;
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
+	for (int i = p_map.front_position(); i >= 0; i = p_map.next_position(i)) {
 		if (index == p_index) {
-			return E.key();
+			return i;
 		}
 		index++;
 	}
+	return -1;
+}
 
-	return Variant();
+Variant Dictionary::get_key_at_index(int p_index) const {
+	int position = _get_position_of_index(_p->variant_map, p_index);
+	if (position < 0) {
+		return Variant();
+	}
+	return _p->variant_map.get_key(position);
 }
 
 Variant Dictionary::get_value_at_index(int p_index) const {
-	int index = 0;
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
-		if (index == p_index) {
-			return E.value();
-		}
-		index++;
+	int position = _get_position_of_index(_p->variant_map, p_index);
+	if (position < 0) {
+		return Variant();
 	}
-
-	return Variant();
+	return _p->variant_map.get_value(position);
 }
 
 Variant &Dictionary::operator[](const Variant &p_key) {
@@ -82,30 +93,19 @@ const Variant &Dictionary::operator[](const Variant &p_key) const {
 }
 
 const Variant *Dictionary::getptr(const Variant &p_key) const {
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::ConstElement E = ((const OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(p_key);
-
-	if (!E) {
-		return nullptr;
-	}
-	return &E.get();
+	return ((const CompactOrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->getptr(p_key);
 }
 
 Variant *Dictionary::getptr(const Variant &p_key) {
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.find(p_key);
-
-	if (!E) {
-		return nullptr;
-	}
-	return &E.get();
+	return _p->variant_map.getptr(p_key);
 }
 
 Variant Dictionary::get_valid(const Variant &p_key) const {
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::ConstElement E = ((const OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(p_key);
-
-	if (!E) {
+	const Variant *result = getptr(p_key);
+	if (!result) {
 		return Variant();
 	}
-	return E.get();
+	return *result;
 }
 
 Variant Dictionary::get(const Variant &p_key, const Variant &p_default) const {
@@ -182,9 +182,9 @@ void Dictionary::_unref() const {
 uint32_t Dictionary::hash() const {
 	uint32_t h = hash_djb2_one_32(Variant::DICTIONARY);
 
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
-		h = hash_djb2_one_32(E.key().hash(), h);
-		h = hash_djb2_one_32(E.value().hash(), h);
+	for (int i = _p->variant_map.front_position(); i >= 0; i = _p->variant_map.next_position(i)) {
+		h = hash_djb2_one_32(_p->variant_map.get_key(i).hash(), h);
+		h = hash_djb2_one_32(_p->variant_map.get_value(i).hash(), h);
 	}
 
 	return h;
@@ -199,8 +199,8 @@ Array Dictionary::keys() const {
 	varr.resize(size());
 
 	int i = 0;
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
-		varr[i] = E.key();
+	for (int j = _p->variant_map.front_position(); j >= 0; j = _p->variant_map.next_position(j)) {
+		varr[i] = _p->variant_map.get_key(j);
 		i++;
 	}
 
@@ -216,8 +216,8 @@ Array Dictionary::values() const {
 	varr.resize(size());
 
 	int i = 0;
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
-		varr[i] = E.get();
+	for (int j = _p->variant_map.front_position(); j >= 0; j = _p->variant_map.next_position(j)) {
+		varr[i] = _p->variant_map.get_value(j);
 		i++;
 	}
 
@@ -225,26 +225,29 @@ Array Dictionary::values() const {
 }
 
 const Variant *Dictionary::next(const Variant *p_key) const {
+	int position;
 	if (p_key == nullptr) {
 		// caller wants to get the first element
-		if (_p->variant_map.front()) {
-			return &_p->variant_map.front().key();
+		position = _p->variant_map.front_position();
+	} else {
+		position = _p->variant_map.find_position(*p_key);
+		if (position < 0) {
+			return nullptr;
 		}
-		return nullptr;
+		position = _p->variant_map.next_position(position);
 	}
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.find(*p_key);
 
-	if (E && E.next()) {
-		return &E.next().key();
+	if (position < 0) {
+		return nullptr;
 	}
-	return nullptr;
+	return &_p->variant_map.get_key(position);
 }
 
 Dictionary Dictionary::duplicate(bool p_deep) const {
 	Dictionary n;
 
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
-		n[E.key()] = p_deep ? E.value().duplicate(true) : E.value();
+	for (int i = _p->variant_map.front_position(); i >= 0; i = _p->variant_map.next_position(i)) {
+		n[_p->variant_map.get_key(i)] = p_deep ? _p->variant_map.get_value(i).duplicate(true) : _p->variant_map.get_value(i);
 	}
 
 	return n;
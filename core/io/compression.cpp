@@ -39,6 +39,27 @@
 #include <zlib.h>
 #include <zstd.h>
 
+// Creating a decompression context allocates a few hundred KB, which used to
+// dominate decompressing small blocks. Each thread keeps its own instead.
+struct ZSTDThreadDecompressor {
+	ZSTD_DCtx *dctx = nullptr;
+
+	ZSTD_DCtx *get() {
+		if (!dctx) {
+			dctx = ZSTD_createDCtx();
+		}
+		return dctx;
+	}
+
+	~ZSTDThreadDecompressor() {
+		if (dctx) {
+			ZSTD_freeDCtx(dctx);
+		}
+	}
+};
+
+static thread_local ZSTDThreadDecompressor zstd_thread_decompressor;
+
 int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode) {
 	switch (p_mode) {
 		case MODE_FASTLZ: {
@@ -167,12 +188,11 @@ int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p
 			return total;
 		} break;
 		case MODE_ZSTD: {
-			ZSTD_DCtx *dctx = ZSTD_createDCtx();
-			if (zstd_long_distance_matching) {
-				ZSTD_DCtx_setParameter(dctx, ZSTD_d_windowLogMax, zstd_window_log_size);
-			}
+			ZSTD_DCtx *dctx = zstd_thread_decompressor.get();
+			ERR_FAIL_COND_V(!dctx, -1);
+			// Parameters are sticky, set the window every time (0 is the default).
+			ZSTD_DCtx_setParameter(dctx, ZSTD_d_windowLogMax, zstd_long_distance_matching ? zstd_window_log_size : 0);
 			int ret = ZSTD_decompressDCtx(dctx, p_dst, p_dst_max_size, p_src, p_src_size);
-			ZSTD_freeDCtx(dctx);
 			return ret;
 		} break;
 	}
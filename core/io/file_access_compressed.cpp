@@ -30,6 +30,7 @@
 
 #include "file_access_compressed.h"
 
+#include "core/os/copymem.h"
 #include "core/print_string.h"
 
 void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, int p_block_size) {
@@ -58,6 +59,114 @@ void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_
 		}                                                   \
 	}
 
+FileAccessCompressed::CachedBlock *FileAccessCompressed::_find_cached_block(int p_block) const {
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		if (cache[i].block == p_block) {
+			return &cache[i];
+		}
+	}
+	return nullptr;
+}
+
+FileAccessCompressed::CachedBlock *FileAccessCompressed::_reuse_cached_block() const {
+	// Least recently used slot, other than the one being read from. Read ahead
+	// blocks are the most recent ones, so a slot still decompressing is only
+	// picked when all the others are too, and it is waited on first.
+	CachedBlock *lru = nullptr;
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		CachedBlock *cb = &cache[i];
+		if (cb->data && cb->data == read_ptr) {
+			continue;
+		}
+		if (cb->block == -1) {
+			return cb;
+		}
+		if (!lru || cb->last_used < lru->last_used) {
+			lru = cb;
+		}
+	}
+
+	if (lru->job != ThreadWorkPool::INVALID_JOB_ID) {
+		ThreadWorkPool::get_singleton()->wait_for_job(lru->job);
+		lru->job = ThreadWorkPool::INVALID_JOB_ID;
+	}
+	return lru;
+}
+
+void FileAccessCompressed::_read_compressed_block(CachedBlock *p_cached, int p_block) const {
+	const ReadBlock &rb = read_blocks[p_block];
+	p_cached->compressed.resize(rb.csize);
+	f->seek(rb.offset);
+	f->get_buffer(p_cached->compressed.ptrw(), rb.csize);
+
+	if (!p_cached->data) {
+		p_cached->data = memnew_arr(uint8_t, block_size);
+	}
+	p_cached->block = p_block;
+	p_cached->data_size = p_block == read_block_count - 1 ? read_total % block_size : block_size;
+	p_cached->last_used = ++cache_tick;
+}
+
+void FileAccessCompressed::_decompress_block(CachedBlock *p_cached) const {
+	// Runs on worker threads for read ahead, only touches the block and settings fixed at open.
+	Compression::decompress(p_cached->data, read_blocks.size() == 1 ? read_total : block_size, p_cached->compressed.ptr(), p_cached->compressed.size(), cmode);
+}
+
+void FileAccessCompressed::_read_ahead(int p_from) const {
+	ThreadWorkPool *pool = ThreadWorkPool::get_singleton();
+	if (!pool || pool->get_thread_count() == 0) {
+		return;
+	}
+
+	int to = MIN(p_from + READ_AHEAD_BLOCKS, read_block_count);
+	for (int i = p_from; i < to; i++) {
+		if (_find_cached_block(i)) {
+			continue;
+		}
+		CachedBlock *cb = _reuse_cached_block();
+		_read_compressed_block(cb, i);
+		cb->job = pool->add_job(this, &FileAccessCompressed::_decompress_block, cb);
+	}
+}
+
+void FileAccessCompressed::_load_block(int p_block) const {
+	CachedBlock *cb = _find_cached_block(p_block);
+	if (!cb) {
+		cb = _reuse_cached_block();
+		_read_compressed_block(cb, p_block);
+		_decompress_block(cb);
+	} else if (cb->job != ThreadWorkPool::INVALID_JOB_ID) {
+		ThreadWorkPool::get_singleton()->wait_for_job(cb->job);
+		cb->job = ThreadWorkPool::INVALID_JOB_ID;
+	}
+
+	cb->last_used = ++cache_tick;
+	read_block = p_block;
+	read_ptr = cb->data;
+	read_block_size = cb->data_size;
+	read_pos = 0;
+
+	_read_ahead(p_block + 1);
+}
+
+void FileAccessCompressed::_clear_cache() {
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		CachedBlock &cb = cache[i];
+		if (cb.job != ThreadWorkPool::INVALID_JOB_ID) {
+			ThreadWorkPool::get_singleton()->wait_for_job(cb.job);
+			cb.job = ThreadWorkPool::INVALID_JOB_ID;
+		}
+		if (cb.data) {
+			memdelete_arr(cb.data);
+			cb.data = nullptr;
+		}
+		cb.compressed.clear();
+		cb.block = -1;
+		cb.last_used = 0;
+	}
+	read_ptr = nullptr;
+}
+
 Error FileAccessCompressed::open_after_magic(FileAccess *p_base) {
 	f = p_base;
 	cmode = (Compression::Mode)f->get_32();
@@ -69,28 +178,18 @@ Error FileAccessCompressed::open_after_magic(FileAccess *p_base) {
 	read_total = f->get_32();
 	int bc = (read_total / block_size) + 1;
 	int acc_ofs = f->get_position() + bc * 4;
-	int max_bs = 0;
 	for (int i = 0; i < bc; i++) {
 		ReadBlock rb;
 		rb.offset = acc_ofs;
 		rb.csize = f->get_32();
 		acc_ofs += rb.csize;
-		max_bs = MAX(max_bs, rb.csize);
 		read_blocks.push_back(rb);
 	}
 
-	comp_buffer.resize(max_bs);
-	buffer.resize(block_size);
-	read_ptr = buffer.ptrw();
-	f->get_buffer(comp_buffer.ptrw(), read_blocks[0].csize);
 	at_end = false;
 	read_eof = false;
 	read_block_count = bc;
-	read_block_size = read_blocks.size() == 1 ? read_total : block_size;
-
-	Compression::decompress(buffer.ptrw(), read_block_size, comp_buffer.ptr(), read_blocks[0].csize, cmode);
-	read_block = 0;
-	read_pos = 0;
+	_load_block(0);
 
 	return OK;
 }
@@ -177,8 +276,7 @@ void FileAccessCompressed::close() {
 		buffer.clear();
 
 	} else {
-		comp_buffer.clear();
-		buffer.clear();
+		_clear_cache();
 		read_blocks.clear();
 	}
 
@@ -199,18 +297,14 @@ void FileAccessCompressed::seek(size_t p_position) {
 
 	} else {
 		ERR_FAIL_COND(p_position > read_total);
+		read_eof = false;
 		if (p_position == read_total) {
 			at_end = true;
 		} else {
 			at_end = false;
-			read_eof = false;
 			int block_idx = p_position / block_size;
 			if (block_idx != read_block) {
-				read_block = block_idx;
-				f->seek(read_blocks[read_block].offset);
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				_load_block(block_idx);
 			}
 
 			read_pos = p_position % block_size;
@@ -231,6 +325,8 @@ size_t FileAccessCompressed::get_position() const {
 	ERR_FAIL_COND_V_MSG(!f, 0, "File must be opened before use.");
 	if (writing) {
 		return write_pos;
+	} else if (at_end) {
+		return read_total;
 	} else {
 		return read_block * block_size + read_pos;
 	}
@@ -266,19 +362,12 @@ uint8_t FileAccessCompressed::get_8() const {
 	uint8_t ret = read_ptr[read_pos];
 
 	read_pos++;
-	if (read_pos >= read_block_size) {
-		read_block++;
-
-		if (read_block < read_block_count) {
-			//read another block of compressed data
-			f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-			Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-			read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
-			read_pos = 0;
-
+	while (read_pos >= read_block_size) {
+		if (read_block + 1 < read_block_count) {
+			_load_block(read_block + 1);
 		} else {
-			read_block--;
 			at_end = true;
+			break;
 		}
 	}
 
@@ -294,26 +383,23 @@ int FileAccessCompressed::get_buffer(uint8_t *p_dst, int p_length) const {
 		return 0;
 	}
 
-	for (int i = 0; i < p_length; i++) {
-		p_dst[i] = read_ptr[read_pos];
-		read_pos++;
-		if (read_pos >= read_block_size) {
-			read_block++;
-
-			if (read_block < read_block_count) {
-				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
-				read_pos = 0;
-
+	int read = 0;
+	while (read < p_length) {
+		int chunk = MIN(p_length - read, read_block_size - read_pos);
+		copymem(&p_dst[read], &read_ptr[read_pos], chunk);
+		read += chunk;
+		read_pos += chunk;
+
+		// A length that is a multiple of the block size leaves an empty last block.
+		while (read_pos >= read_block_size) {
+			if (read_block + 1 < read_block_count) {
+				_load_block(read_block + 1);
 			} else {
-				read_block--;
 				at_end = true;
-				if (i < p_length - 1) {
+				if (read < p_length) {
 					read_eof = true;
 				}
-				return i;
+				return read;
 			}
 		}
 	}
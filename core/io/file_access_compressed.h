@@ -33,6 +33,7 @@
 
 #include "core/io/compression.h"
 #include "core/os/file_access.h"
+#include "core/thread_work_pool.h"
 
 class FileAccessCompressed : public FileAccess {
 	Compression::Mode cmode = Compression::MODE_ZSTD;
@@ -50,8 +51,32 @@ class FileAccessCompressed : public FileAccess {
 		int offset;
 	};
 
-	mutable Vector<uint8_t> comp_buffer;
-	uint8_t *read_ptr = nullptr;
+	enum {
+		CACHE_BLOCKS = 8, // Decompressed blocks kept, so seeking back does not decompress again.
+		READ_AHEAD_BLOCKS = 4, // Blocks decompressed on worker threads ahead of the reader.
+	};
+
+	struct CachedBlock {
+		int block = -1;
+		uint64_t last_used = 0;
+		Vector<uint8_t> compressed; // Read on the reading thread, f is not thread safe.
+		uint8_t *data = nullptr;
+		int data_size = 0;
+		ThreadWorkPool::JobID job = ThreadWorkPool::INVALID_JOB_ID; // Still decompressing when valid.
+	};
+
+	mutable CachedBlock cache[CACHE_BLOCKS];
+	mutable uint64_t cache_tick = 0;
+
+	CachedBlock *_find_cached_block(int p_block) const;
+	CachedBlock *_reuse_cached_block() const;
+	void _read_compressed_block(CachedBlock *p_cached, int p_block) const;
+	void _decompress_block(CachedBlock *p_cached) const;
+	void _read_ahead(int p_from) const;
+	void _load_block(int p_block) const;
+	void _clear_cache();
+
+	mutable const uint8_t *read_ptr = nullptr;
 	mutable int read_block = 0;
 	int read_block_count = 0;
 	mutable int read_block_size = 0;
@@ -153,6 +153,19 @@ int FileAccessMemory::get_buffer(uint8_t *p_dst, int p_length) const {
 	return read;
 }
 
+const uint8_t *FileAccessMemory::get_buffer_view(int p_length) const {
+	ERR_FAIL_COND_V(!data, nullptr);
+
+	if (p_length < 0 || p_length > length - pos) {
+		return nullptr;
+	}
+
+	const uint8_t *view = &data[pos];
+	pos += p_length;
+
+	return view;
+}
+
 Error FileAccessMemory::get_error() const {
 	return pos >= length ? ERR_FILE_EOF : OK;
 }
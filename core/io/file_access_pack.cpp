@@ -60,7 +60,7 @@ void PackedData::add_path(const String &pkg_path, const String &path, uint64_t o
 	pf.src = p_src;
 
 	if (!exists || p_replace_files) {
-		files[pmd5] = pf;
+		files.set(pmd5, pf);
 	}
 
 	if (!exists) {
@@ -194,15 +194,50 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files)
 		PackedData::get_singleton()->add_path(p_path, path, ofs, size, md5, this, p_replace_files);
 	}
 
+	if (PackedData::get_singleton()->is_memory_mapping_enabled() && !_find_mapped_pack(p_path)) {
+		// Keep the pack open and mapped, so opening a file in it costs no syscalls
+		// and reads are served from the page cache directly.
+		const uint8_t *data = f->map_read_only();
+		if (data) {
+			MappedPack mp;
+			mp.path = p_path;
+			mp.f = f;
+			mp.data = data;
+			mp.size = f->get_len();
+			mapped_packs.push_back(mp);
+			return true;
+		}
+	}
+
 	f->close();
 	memdelete(f);
 	return true;
 }
 
+const PackedSourcePCK::MappedPack *PackedSourcePCK::_find_mapped_pack(const String &p_path) const {
+	for (int i = 0; i < mapped_packs.size(); i++) {
+		if (mapped_packs[i].path == p_path) {
+			return &mapped_packs[i];
+		}
+	}
+	return nullptr;
+}
+
 FileAccess *PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFile *p_file) {
+	const MappedPack *mp = _find_mapped_pack(p_file->pack);
+	if (mp && p_file->offset <= mp->size && p_file->size <= mp->size - p_file->offset) {
+		return memnew(FileAccessPack(p_path, *p_file, mp->data + p_file->offset));
+	}
 	return memnew(FileAccessPack(p_path, *p_file));
 }
 
+PackedSourcePCK::~PackedSourcePCK() {
+	for (int i = 0; i < mapped_packs.size(); i++) {
+		mapped_packs[i].f->close();
+		memdelete(mapped_packs[i].f);
+	}
+}
+
 //////////////////////////////////////////////////////////////////
 
 Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
@@ -211,10 +246,16 @@ Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
 }
 
 void FileAccessPack::close() {
-	f->close();
+	if (f) {
+		f->close();
+	}
+	data = nullptr;
 }
 
 bool FileAccessPack::is_open() const {
+	if (!f) {
+		return data != nullptr;
+	}
 	return f->is_open();
 }
 
@@ -225,7 +266,9 @@ void FileAccessPack::seek(size_t p_position) {
 		eof = false;
 	}
 
-	f->seek(pf.offset + p_position);
+	if (f) {
+		f->seek(pf.offset + p_position);
+	}
 	pos = p_position;
 }
 
@@ -251,6 +294,10 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (data) {
+		return data[pos++];
+	}
+
 	pos++;
 	return f->get_8();
 }
@@ -266,19 +313,36 @@ int FileAccessPack::get_buffer(uint8_t *p_dst, int p_length) const {
 		to_read = int64_t(pf.size) - int64_t(pos);
 	}
 
+	size_t from = pos;
 	pos += p_length;
 
 	if (to_read <= 0) {
 		return 0;
 	}
-	f->get_buffer(p_dst, to_read);
+	if (data) {
+		copymem(p_dst, data + from, to_read);
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_buffer_view(int p_length) const {
+	if (!data || eof || p_length < 0 || pos > pf.size || uint64_t(p_length) > pf.size - pos) {
+		return nullptr;
+	}
+
+	const uint8_t *view = data + pos;
+	pos += p_length;
+	return view;
+}
+
 void FileAccessPack::set_endian_swap(bool p_swap) {
 	FileAccess::set_endian_swap(p_swap);
-	f->set_endian_swap(p_swap);
+	if (f) {
+		f->set_endian_swap(p_swap);
+	}
 }
 
 Error FileAccessPack::get_error() const {
@@ -304,14 +368,20 @@ bool FileAccessPack::file_exists(const String &p_name) {
 	return false;
 }
 
-FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
+FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_data) :
 		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
+		data(p_data) {
+	pos = 0;
+	eof = false;
+
+	if (data) {
+		return;
+	}
+
+	f = FileAccess::open(pf.pack, FileAccess::READ);
 	ERR_FAIL_COND_MSG(!f, "Can't open pack-referenced file '" + String(pf.pack) + "'.");
 
 	f->seek(pf.offset);
-	pos = 0;
-	eof = false;
 }
 
 FileAccessPack::~FileAccessPack() {
@@ -31,6 +31,7 @@
 #ifndef FILE_ACCESS_PACK_H
 #define FILE_ACCESS_PACK_H
 
+#include "core/hash_map.h"
 #include "core/list.h"
 #include "core/map.h"
 #include "core/os/dir_access.h"
@@ -89,7 +90,13 @@ private:
 		}
 	};
 
-	Map<PathMD5, PackedFile> files;
+	struct PathMD5Hasher {
+		// The key is already a digest, any part of it hashes well.
+		static _FORCE_INLINE_ uint32_t hash(const PathMD5 &p_md5) { return uint32_t(p_md5.a); }
+	};
+
+	// Looked up on every res:// open, keep the chains short.
+	HashMap<PathMD5, PackedFile, PathMD5Hasher, HashMapComparatorDefault<PathMD5>, 3, 2> files;
 
 	Vector<PackSource *> sources;
 
@@ -97,6 +104,7 @@ private:
 
 	static PackedData *singleton;
 	bool disabled = false;
+	bool memory_mapping = true;
 
 	void _free_packed_dirs(PackedDir *p_dir);
 
@@ -107,6 +115,10 @@ public:
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
 
+	// Affects packs added afterwards, mapped packs stay mapped.
+	void set_memory_mapping_enabled(bool p_enabled) { memory_mapping = p_enabled; }
+	bool is_memory_mapping_enabled() const { return memory_mapping; }
+
 	static PackedData *get_singleton() { return singleton; }
 	Error add_pack(const String &p_path, bool p_replace_files);
 
@@ -125,9 +137,24 @@ public:
 };
 
 class PackedSourcePCK : public PackSource {
+	// Packs kept open and mapped in memory, files inside them are read
+	// straight from the mapping instead of opening the pack again.
+	struct MappedPack {
+		String path;
+		FileAccess *f = nullptr;
+		const uint8_t *data = nullptr;
+		uint64_t size = 0;
+	};
+
+	Vector<MappedPack> mapped_packs;
+
+	const MappedPack *_find_mapped_pack(const String &p_path) const;
+
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files);
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
+
+	virtual ~PackedSourcePCK();
 };
 
 class FileAccessPack : public FileAccess {
@@ -136,7 +163,8 @@ class FileAccessPack : public FileAccess {
 	mutable size_t pos;
 	mutable bool eof;
 
-	FileAccess *f;
+	const uint8_t *data = nullptr; // Contents of the file when the pack is mapped, f is not used then.
+	FileAccess *f = nullptr;
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 	virtual uint32_t _get_unix_permissions(const String &p_file) { return 0; }
@@ -156,6 +184,7 @@ public:
 	virtual uint8_t get_8() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *get_buffer_view(int p_length) const;
 
 	virtual void set_endian_swap(bool p_swap);
 
@@ -168,21 +197,21 @@ public:
 
 	virtual bool file_exists(const String &p_name);
 
-	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_data = nullptr);
 	~FileAccessPack();
 };
 
 FileAccess *PackedData::try_open_path(const String &p_path) {
 	PathMD5 pmd5(p_path.md5_buffer());
-	Map<PathMD5, PackedFile>::Element *E = files.find(pmd5);
-	if (!E) {
+	PackedFile *pf = files.getptr(pmd5);
+	if (!pf) {
 		return nullptr; //not found
 	}
-	if (E->get().offset == 0) {
+	if (pf->offset == 0) {
 		return nullptr; //was erased
 	}
 
-	return E->get().src->get_file(p_path, &E->get());
+	return pf->src->get_file(p_path, pf);
 }
 
 bool PackedData::has_path(const String &p_path) {
@@ -30,6 +30,7 @@
 
 #include "json.h"
 
+#include "core/os/file_access.h"
 #include "core/print_string.h"
 
 const char *JSON::tk_name[TK_MAX] = {
@@ -453,3 +454,938 @@ Error JSON::parse(const String &p_json, Variant &r_ret, String &r_err_str, int &
 
 	return err;
 }
+
+// UTF-8 reader. Works on a single buffer, or refills from a file in chunks.
+// Nesting is tracked on an explicit stack, so deep documents can't overflow
+// the C++ stack.
+
+class JSONUTF8Reader {
+	enum {
+		CHUNK_SIZE = 65536,
+	};
+
+	enum State {
+		STATE_VALUE,
+		STATE_VALUE_OR_ARRAY_END,
+		STATE_KEY,
+		STATE_KEY_OR_OBJECT_END,
+		STATE_AFTER_VALUE,
+	};
+
+	const uint8_t *buf = nullptr;
+	int pos = 0;
+	int len = 0;
+
+	FileAccess *file = nullptr;
+	LocalVector<uint8_t> chunk;
+
+	LocalVector<uint8_t> stack; // 1 for objects, 0 for arrays.
+	LocalVector<char> scratch;
+
+	JSON::Visitor *visitor = nullptr;
+	String *err_str = nullptr;
+	bool skipped_whitespace = false; // By the last _skip_whitespace() call.
+
+	bool _refill() {
+		if (!file) {
+			return false;
+		}
+		if (chunk.size() == 0) {
+			chunk.resize(CHUNK_SIZE);
+		}
+		int read = file->get_buffer(&chunk[0], CHUNK_SIZE);
+		if (read <= 0) {
+			file = nullptr;
+			return false;
+		}
+		buf = &chunk[0];
+		pos = 0;
+		len = read;
+		return true;
+	}
+
+	// Makes the next p_count bytes available in the buffer, if the input has
+	// them, so a few bytes can be looked ahead or given back.
+	void _ensure(int p_count) {
+		if (!file || len - pos >= p_count) {
+			return;
+		}
+		memmove(&chunk[0], &chunk[pos], len - pos);
+		buf = &chunk[0];
+		len -= pos;
+		pos = 0;
+		while (file && len < p_count) {
+			int read = file->get_buffer(&chunk[len], CHUNK_SIZE - len);
+			if (read <= 0) {
+				file = nullptr;
+			} else {
+				len += read;
+			}
+		}
+	}
+
+	// Returns -1 at the end of input. A NUL byte ends input, like in JSON::parse().
+	_FORCE_INLINE_ int _peek() {
+		if (unlikely(pos == len) && !_refill()) {
+			return -1;
+		}
+		return buf[pos] ? buf[pos] : -1;
+	}
+
+	_FORCE_INLINE_ int _skip_whitespace() {
+		bool skipped = false;
+		while (true) {
+			int c = _peek();
+			if (c == '\n') {
+				line++;
+			} else if (c < 0 || c > 32) {
+				skipped_whitespace = skipped;
+				return c;
+			}
+			pos++;
+			skipped = true;
+		}
+	}
+
+	Error _error(const String &p_err) {
+		*err_str = p_err;
+		return ERR_PARSE_ERROR;
+	}
+
+	// JSON::parse() reads a whole token before checking what it expected, so
+	// a character that starts no token is reported as such wherever it is.
+	Error _error_at(int p_char, const String &p_err) {
+		bool token = p_char == '{' || p_char == '}' || p_char == '[' || p_char == ']' || p_char == ':' || p_char == ',' || p_char == '"' || p_char == '-' ||
+				(p_char >= '0' && p_char <= '9') || (p_char >= 'A' && p_char <= 'Z') || (p_char >= 'a' && p_char <= 'z');
+		return _error(p_char < 0 || token ? p_err : String("Unexpected character."));
+	}
+
+	void _append_utf8(uint32_t p_code) {
+		if (p_code < 0x80) {
+			scratch.push_back(p_code);
+		} else if (p_code < 0x800) {
+			scratch.push_back(0xC0 | (p_code >> 6));
+			scratch.push_back(0x80 | (p_code & 0x3F));
+		} else if (p_code < 0x10000) {
+			scratch.push_back(0xE0 | (p_code >> 12));
+			scratch.push_back(0x80 | ((p_code >> 6) & 0x3F));
+			scratch.push_back(0x80 | (p_code & 0x3F));
+		} else {
+			scratch.push_back(0xF0 | (p_code >> 18));
+			scratch.push_back(0x80 | ((p_code >> 12) & 0x3F));
+			scratch.push_back(0x80 | ((p_code >> 6) & 0x3F));
+			scratch.push_back(0x80 | (p_code & 0x3F));
+		}
+	}
+
+	Error _read_hex(uint32_t &r_value) {
+		r_value = 0;
+		for (int i = 0; i < 4; i++) {
+			int c = _peek();
+			if (c < 0) {
+				return _error("Unterminated String");
+			}
+			uint32_t v;
+			if (c >= '0' && c <= '9') {
+				v = c - '0';
+			} else if (c >= 'a' && c <= 'f') {
+				v = c - 'a' + 10;
+			} else if (c >= 'A' && c <= 'F') {
+				v = c - 'A' + 10;
+			} else {
+				return _error("Malformed hex constant in string");
+			}
+			r_value = (r_value << 4) | v;
+			pos++;
+		}
+		return OK;
+	}
+
+	// Expects the backslash to be consumed already.
+	Error _read_escape() {
+		int next = _peek();
+		if (next < 0) {
+			return _error("Unterminated String");
+		}
+		pos++;
+		switch (next) {
+			case 'b':
+				scratch.push_back(8);
+				break;
+			case 't':
+				scratch.push_back(9);
+				break;
+			case 'n':
+				scratch.push_back(10);
+				break;
+			case 'f':
+				scratch.push_back(12);
+				break;
+			case 'r':
+				scratch.push_back(13);
+				break;
+			case 'u': {
+				uint32_t code;
+				Error err = _read_hex(code);
+				if (err) {
+					return err;
+				}
+				if (code >= 0xD800 && code <= 0xDBFF && _peek() == '\\') {
+					// Join a surrogate pair into a single code point.
+					pos++;
+					if (_peek() != 'u') {
+						_append_utf8(code);
+						return _read_escape();
+					}
+					pos++;
+					uint32_t low;
+					err = _read_hex(low);
+					if (err) {
+						return err;
+					}
+					if (low >= 0xDC00 && low <= 0xDFFF) {
+						_append_utf8(0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00));
+					} else {
+						_append_utf8(code);
+						_append_utf8(low);
+					}
+				} else {
+					_append_utf8(code);
+				}
+			} break;
+			default: {
+				scratch.push_back(next);
+			} break;
+		}
+		return OK;
+	}
+
+	// Expects the opening quote to be consumed already. Strings without
+	// escapes that sit fully inside the current buffer are passed on in place.
+	Error _read_string(const char *&r_str, int &r_len) {
+		for (int i = pos; i < len; i++) {
+			uint8_t c = buf[i];
+			if (c == '"') {
+				r_str = (const char *)&buf[pos];
+				r_len = i - pos;
+				pos = i + 1;
+				return OK;
+			} else if (c == '\\' || c == 0) {
+				break;
+			} else if (c == '\n') {
+				line++;
+			}
+		}
+
+		// Slow path: escapes, or the string continues in the next chunk. The
+		// scan above already counted the newlines up to where it stopped.
+		scratch.clear();
+		int from = pos;
+		while (pos < len && buf[pos] != '\\' && buf[pos] != 0) {
+			pos++;
+		}
+		if (pos > from) {
+			scratch.resize(pos - from);
+			memcpy(&scratch[0], &buf[from], pos - from);
+		}
+
+		while (true) {
+			int c = _peek();
+			if (c < 0) {
+				return _error("Unterminated String");
+			}
+			pos++;
+			if (c == '"') {
+				break;
+			} else if (c == '\\') {
+				Error err = _read_escape();
+				if (err) {
+					return err;
+				}
+			} else {
+				if (c == '\n') {
+					line++;
+				}
+				scratch.push_back(c);
+			}
+		}
+
+		r_str = scratch.size() ? &scratch[0] : "";
+		r_len = scratch.size();
+		return OK;
+	}
+
+	// Reads exactly what String::to_double() reads in JSON::parse(): a sign,
+	// digits with at most one '.', and an exponent only if it has digits.
+	// Without digits nothing is read, and the value is 0.
+	Error _read_number(double &r_value) {
+		scratch.clear();
+		_ensure(3); // "-." and the character after them can be given back.
+
+		int c = _peek();
+		if (c == '-') {
+			scratch.push_back(c);
+			pos++;
+		}
+		bool point = false;
+		int digits = 0;
+		while (true) {
+			c = _peek();
+			if (c >= '0' && c <= '9') {
+				digits++;
+			} else if (c == '.' && !point) {
+				point = true;
+			} else {
+				break;
+			}
+			scratch.push_back(c);
+			pos++;
+		}
+		if (digits == 0) {
+			pos -= scratch.size();
+			r_value = 0;
+			return OK;
+		}
+
+		if (c == 'e' || c == 'E') {
+			_ensure(3);
+			int exp = pos + 1;
+			if (exp < len && (buf[exp] == '+' || buf[exp] == '-')) {
+				exp++;
+			}
+			if (exp < len && buf[exp] >= '0' && buf[exp] <= '9') {
+				while (pos < exp) {
+					scratch.push_back(buf[pos++]);
+				}
+				while ((c = _peek()) >= '0' && c <= '9') {
+					scratch.push_back(c);
+					pos++;
+				}
+			}
+		}
+
+		scratch.push_back(0);
+		r_value = String::to_double(&scratch[0]);
+		return OK;
+	}
+
+	Error _read_identifier() {
+		char id[8];
+		int count = 0;
+		String overflow;
+		while (true) {
+			int c = _peek();
+			if (!((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'))) {
+				break;
+			}
+			if (count < 7) {
+				id[count++] = c;
+			} else {
+				overflow += String::chr(c);
+			}
+			pos++;
+		}
+		id[count] = 0;
+
+		bool ok;
+		if (overflow.empty() && strcmp(id, "true") == 0) {
+			ok = visitor->bool_value(true);
+		} else if (overflow.empty() && strcmp(id, "false") == 0) {
+			ok = visitor->bool_value(false);
+		} else if (overflow.empty() && strcmp(id, "null") == 0) {
+			ok = visitor->null_value();
+		} else {
+			return _error("Expected 'true','false' or 'null', got '" + String(id) + overflow + "'.");
+		}
+		return ok ? OK : ERR_SKIP;
+	}
+
+	Error _read_value(int c, State &r_state) {
+		bool ok = true;
+		switch (c) {
+			case '{': {
+				pos++;
+				stack.push_back(1);
+				ok = visitor->begin_object();
+				r_state = STATE_KEY_OR_OBJECT_END;
+			} break;
+			case '[': {
+				pos++;
+				stack.push_back(0);
+				ok = visitor->begin_array();
+				r_state = STATE_VALUE_OR_ARRAY_END;
+			} break;
+			case '"': {
+				pos++;
+				const char *str;
+				int str_len;
+				Error err = _read_string(str, str_len);
+				if (err) {
+					return err;
+				}
+				ok = visitor->string_value(str, str_len);
+				r_state = STATE_AFTER_VALUE;
+			} break;
+			case -1: {
+				return _error("Expected value, got EOF.");
+			}
+			case '}': {
+				return _error("Expected value, got '}'.");
+			}
+			case ']': {
+				return _error("Expected value, got ']'.");
+			}
+			case ':': {
+				return _error("Expected value, got ':'.");
+			}
+			case ',': {
+				return _error("Expected value, got ','.");
+			}
+			default: {
+				if (c == '-' || (c >= '0' && c <= '9')) {
+					double number;
+					Error err = _read_number(number);
+					if (err) {
+						return err;
+					}
+					ok = visitor->number_value(number);
+				} else if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+					Error err = _read_identifier();
+					if (err) {
+						return err;
+					}
+				} else {
+					return _error("Unexpected character.");
+				}
+				r_state = STATE_AFTER_VALUE;
+			}
+		}
+		return ok ? OK : ERR_SKIP;
+	}
+
+	Error _read_key() {
+		const char *str;
+		int str_len;
+		Error err = _read_string(str, str_len);
+		if (err) {
+			return err;
+		}
+		if (!visitor->key(str, str_len)) {
+			return ERR_SKIP;
+		}
+		int c = _skip_whitespace();
+		if (c != ':') {
+			return _error_at(c, "Expected ':'");
+		}
+		pos++;
+		return OK;
+	}
+
+public:
+	int line = 0;
+
+	// Trailing commas and content after the root value are accepted, to
+	// match JSON::parse().
+	Error parse() {
+		// Skip a UTF-8 BOM, like String::parse_utf8() does.
+		_peek();
+		_ensure(3);
+		if (len - pos >= 3 && buf[pos] == 0xEF && buf[pos + 1] == 0xBB && buf[pos + 2] == 0xBF) {
+			pos += 3;
+		}
+
+		State state = STATE_VALUE;
+		while (true) {
+			int c = _skip_whitespace();
+			if (c < 0 && !skipped_whitespace && stack.size()) {
+				// JSON::parse() stops without a message when a container is
+				// cut right after a token, and reports the EOF token otherwise.
+				return _error(String());
+			}
+			switch (state) {
+				case STATE_VALUE_OR_ARRAY_END: {
+					if (c == ']') {
+						pos++;
+						stack.resize(stack.size() - 1);
+						if (!visitor->end_array()) {
+							return ERR_SKIP;
+						}
+						state = STATE_AFTER_VALUE;
+						break;
+					}
+					[[fallthrough]];
+				}
+				case STATE_VALUE: {
+					Error err = _read_value(c, state);
+					if (err) {
+						return err;
+					}
+				} break;
+				case STATE_KEY_OR_OBJECT_END: {
+					if (c == '}') {
+						pos++;
+						stack.resize(stack.size() - 1);
+						if (!visitor->end_object()) {
+							return ERR_SKIP;
+						}
+						state = STATE_AFTER_VALUE;
+						break;
+					}
+					[[fallthrough]];
+				}
+				case STATE_KEY: {
+					if (c != '"') {
+						return _error_at(c, "Expected key");
+					}
+					pos++;
+					Error err = _read_key();
+					if (err) {
+						return err;
+					}
+					state = STATE_VALUE;
+				} break;
+				case STATE_AFTER_VALUE: {
+					if (stack.size() == 0) {
+						return OK;
+					}
+					bool object = stack[stack.size() - 1];
+					if (c == ',') {
+						pos++;
+						state = object ? STATE_KEY_OR_OBJECT_END : STATE_VALUE_OR_ARRAY_END;
+					} else if (object && c == '}') {
+						pos++;
+						stack.resize(stack.size() - 1);
+						if (!visitor->end_object()) {
+							return ERR_SKIP;
+						}
+					} else if (!object && c == ']') {
+						pos++;
+						stack.resize(stack.size() - 1);
+						if (!visitor->end_array()) {
+							return ERR_SKIP;
+						}
+					} else {
+						return _error_at(c, object ? "Expected '}' or ','" : "Expected ','");
+					}
+				} break;
+			}
+		}
+	}
+
+	JSONUTF8Reader(const uint8_t *p_buf, int p_len, FileAccess *p_file, JSON::Visitor *p_visitor, String *r_err_str) {
+		buf = p_buf;
+		len = p_len;
+		file = p_file;
+		visitor = p_visitor;
+		err_str = r_err_str;
+	}
+};
+
+// Builds Variants from the event stream, for the DOM entry points.
+class JSONVariantBuilder : public JSON::Visitor {
+	LocalVector<Variant> containers;
+	LocalVector<String> keys; // One per open container, empty for arrays.
+
+	_FORCE_INLINE_ void _add(const Variant &p_value) {
+		if (containers.size() == 0) {
+			result = p_value;
+			return;
+		}
+		uint32_t top = containers.size() - 1;
+		Variant &container = containers[top];
+		if (container.get_type() == Variant::ARRAY) {
+			Array a = container;
+			a.push_back(p_value);
+		} else {
+			Dictionary d = container;
+			d[keys[top]] = p_value;
+		}
+	}
+
+	void _push(const Variant &p_container) {
+		_add(p_container);
+		containers.push_back(p_container);
+		keys.push_back(String());
+	}
+
+	void _pop() {
+		containers.resize(containers.size() - 1);
+		keys.resize(keys.size() - 1);
+	}
+
+public:
+	Variant result;
+
+	virtual bool begin_object() {
+		_push(Dictionary());
+		return true;
+	}
+	virtual bool end_object() {
+		_pop();
+		return true;
+	}
+	virtual bool begin_array() {
+		_push(Array());
+		return true;
+	}
+	virtual bool end_array() {
+		_pop();
+		return true;
+	}
+	virtual bool key(const char *p_utf8, int p_len) {
+		keys[keys.size() - 1].parse_utf8(p_utf8, p_len);
+		return true;
+	}
+	virtual bool string_value(const char *p_utf8, int p_len) {
+		String s;
+		s.parse_utf8(p_utf8, p_len);
+		_add(s);
+		return true;
+	}
+	virtual bool number_value(double p_value) {
+		_add(p_value);
+		return true;
+	}
+	virtual bool bool_value(bool p_value) {
+		_add(p_value);
+		return true;
+	}
+	virtual bool null_value() {
+		_add(Variant());
+		return true;
+	}
+};
+
+Error JSON::parse_utf8(const uint8_t *p_utf8, int p_len, Visitor *p_visitor, String &r_err_str, int &r_err_line) {
+	ERR_FAIL_NULL_V(p_visitor, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_len < 0, ERR_INVALID_PARAMETER);
+
+	JSONUTF8Reader reader(p_utf8, p_len, nullptr, p_visitor, &r_err_str);
+	Error err = reader.parse();
+	r_err_line = reader.line;
+	return err;
+}
+
+Error JSON::parse_utf8(const uint8_t *p_utf8, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line) {
+	JSONVariantBuilder builder;
+	Error err = parse_utf8(p_utf8, p_len, &builder, r_err_str, r_err_line);
+	r_ret = builder.result;
+	return err;
+}
+
+Error JSON::parse_file(FileAccess *p_file, Visitor *p_visitor, String &r_err_str, int &r_err_line) {
+	ERR_FAIL_NULL_V(p_file, ERR_INVALID_PARAMETER);
+	ERR_FAIL_NULL_V(p_visitor, ERR_INVALID_PARAMETER);
+
+	const uint8_t *mapped = p_file->map_read_only();
+	if (mapped) {
+		size_t from = p_file->get_position();
+		size_t to = p_file->get_len();
+		ERR_FAIL_COND_V(to - from > 0x7FFFFFFF, ERR_OUT_OF_MEMORY);
+		JSONUTF8Reader reader(mapped + from, to - from, nullptr, p_visitor, &r_err_str);
+		Error err = reader.parse();
+		r_err_line = reader.line;
+		return err;
+	}
+
+	// Files in a mapped pack are read in place too.
+	size_t left = p_file->get_len() - p_file->get_position();
+	const uint8_t *view = left <= 0x7FFFFFFF ? p_file->get_buffer_view(left) : nullptr;
+	if (view) {
+		JSONUTF8Reader reader(view, left, nullptr, p_visitor, &r_err_str);
+		Error err = reader.parse();
+		r_err_line = reader.line;
+		return err;
+	}
+
+	JSONUTF8Reader reader(nullptr, 0, p_file, p_visitor, &r_err_str);
+	Error err = reader.parse();
+	r_err_line = reader.line;
+	return err;
+}
+
+Error JSON::parse_file(FileAccess *p_file, Variant &r_ret, String &r_err_str, int &r_err_line) {
+	JSONVariantBuilder builder;
+	Error err = parse_file(p_file, &builder, r_err_str, r_err_line);
+	r_ret = builder.result;
+	return err;
+}
+
+Vector<uint8_t> JSON::print_utf8(const Variant &p_var, const String &p_indent, bool p_sort_keys) {
+	JSONWriter writer(p_indent, p_sort_keys);
+	writer.value(p_var);
+	return writer.get_buffer();
+}
+
+void JSONWriter::_write_indent(int p_depth) {
+	for (int i = 0; i < p_depth; i++) {
+		_write(indent.get_data(), indent.length());
+	}
+}
+
+// Same escapes as String::json_escape().
+static _FORCE_INLINE_ const char *_json_escape_sequence(uint32_t p_char) {
+	switch (p_char) {
+		case '\\':
+			return "\\\\";
+		case '\b':
+			return "\\b";
+		case '\f':
+			return "\\f";
+		case '\n':
+			return "\\n";
+		case '\r':
+			return "\\r";
+		case '\t':
+			return "\\t";
+		case '\v':
+			return "\\v";
+		case '"':
+			return "\\\"";
+		default:
+			return nullptr;
+	}
+}
+
+void JSONWriter::_write_escaped(const String &p_string) {
+	_write('"');
+	const CharType *str = p_string.ptr();
+	int str_len = p_string.length();
+	for (int i = 0; i < str_len; i++) {
+		uint32_t c = str[i];
+		if (c < 0x80) {
+			const char *escape = _json_escape_sequence(c);
+			if (escape) {
+				_write(escape, 2);
+			} else {
+				_write(c);
+			}
+		} else if (c < 0x800) {
+			_write(0xC0 | (c >> 6));
+			_write(0x80 | (c & 0x3F));
+		} else if (c < 0x10000) {
+			_write(0xE0 | (c >> 12));
+			_write(0x80 | ((c >> 6) & 0x3F));
+			_write(0x80 | (c & 0x3F));
+		} else {
+			_write(0xF0 | (c >> 18));
+			_write(0x80 | ((c >> 12) & 0x3F));
+			_write(0x80 | ((c >> 6) & 0x3F));
+			_write(0x80 | (c & 0x3F));
+		}
+	}
+	_write('"');
+}
+
+void JSONWriter::_write_escaped(const char *p_utf8, int p_len) {
+	_write('"');
+	int run = 0; // Start of the pending bytes that need no escaping.
+	for (int i = 0; i < p_len; i++) {
+		const char *escape = _json_escape_sequence((uint8_t)p_utf8[i]);
+		if (escape) {
+			_write(p_utf8 + run, i - run);
+			_write(escape, 2);
+			run = i + 1;
+		}
+	}
+	_write(p_utf8 + run, p_len - run);
+	_write('"');
+}
+
+void JSONWriter::_before_value() {
+	if (after_key) {
+		after_key = false;
+		return;
+	}
+	if (levels.size() == 0) {
+		return;
+	}
+	Level &level = levels[levels.size() - 1];
+	ERR_FAIL_COND_MSG(level.object, "Writing a value in an object requires a key first.");
+	if (level.count > 0) {
+		_write(',');
+		if (indent.length()) {
+			_write('\n');
+		}
+	}
+	level.count++;
+	_write_indent(levels.size());
+}
+
+void JSONWriter::_begin(bool p_object) {
+	_before_value();
+	_write(p_object ? '{' : '[');
+	if (indent.length()) {
+		_write('\n');
+	}
+	Level level;
+	level.object = p_object;
+	levels.push_back(level);
+}
+
+void JSONWriter::_end(bool p_object) {
+	ERR_FAIL_COND_MSG(levels.size() == 0 || levels[levels.size() - 1].object != p_object, "Mismatched end of object or array.");
+	ERR_FAIL_COND_MSG(after_key, "Object key is missing a value.");
+	levels.resize(levels.size() - 1);
+	if (indent.length()) {
+		_write('\n');
+	}
+	_write_indent(levels.size());
+	_write(p_object ? '}' : ']');
+}
+
+void JSONWriter::key(const String &p_key) {
+	ERR_FAIL_COND_MSG(levels.size() == 0 || !levels[levels.size() - 1].object, "Keys can only be written inside an object.");
+	ERR_FAIL_COND_MSG(after_key, "Object key is missing a value.");
+	Level &level = levels[levels.size() - 1];
+	if (level.count > 0) {
+		_write(',');
+		if (indent.length()) {
+			_write('\n');
+		}
+	}
+	level.count++;
+	_write_indent(levels.size());
+	_write_escaped(p_key);
+	_write(':');
+	if (indent.length()) {
+		_write(' ');
+	}
+	after_key = true;
+}
+
+void JSONWriter::key_utf8(const char *p_utf8, int p_len) {
+	ERR_FAIL_COND_MSG(levels.size() == 0 || !levels[levels.size() - 1].object, "Keys can only be written inside an object.");
+	ERR_FAIL_COND_MSG(after_key, "Object key is missing a value.");
+	Level &level = levels[levels.size() - 1];
+	if (level.count > 0) {
+		_write(',');
+		if (indent.length()) {
+			_write('\n');
+		}
+	}
+	level.count++;
+	_write_indent(levels.size());
+	_write_escaped(p_utf8, p_len);
+	_write(':');
+	if (indent.length()) {
+		_write(' ');
+	}
+	after_key = true;
+}
+
+void JSONWriter::write_null() {
+	_before_value();
+	_write("null", 4);
+}
+
+void JSONWriter::write_bool(bool p_value) {
+	_before_value();
+	if (p_value) {
+		_write("true", 4);
+	} else {
+		_write("false", 5);
+	}
+}
+
+void JSONWriter::write_int(int64_t p_value) {
+	_before_value();
+	char digits[24];
+	int count = 0;
+	uint64_t v = p_value < 0 ? -(uint64_t)p_value : p_value;
+	do {
+		digits[count++] = '0' + (v % 10);
+		v /= 10;
+	} while (v);
+	if (p_value < 0) {
+		_write('-');
+	}
+	while (count) {
+		_write(digits[--count]);
+	}
+}
+
+void JSONWriter::write_float(double p_value) {
+	_before_value();
+	CharString s = rtos(p_value).ascii();
+	_write(s.get_data(), s.length());
+}
+
+void JSONWriter::write_string(const String &p_value) {
+	_before_value();
+	_write_escaped(p_value);
+}
+
+void JSONWriter::write_string_utf8(const char *p_utf8, int p_len) {
+	_before_value();
+	_write_escaped(p_utf8, p_len);
+}
+
+void JSONWriter::value(const Variant &p_value) {
+	switch (p_value.get_type()) {
+		case Variant::NIL: {
+			write_null();
+		} break;
+		case Variant::BOOL: {
+			write_bool(p_value);
+		} break;
+		case Variant::INT: {
+			write_int(p_value);
+		} break;
+		case Variant::FLOAT: {
+			write_float(p_value);
+		} break;
+		case Variant::PACKED_INT32_ARRAY:
+		case Variant::PACKED_INT64_ARRAY:
+		case Variant::PACKED_FLOAT32_ARRAY:
+		case Variant::PACKED_FLOAT64_ARRAY:
+		case Variant::PACKED_STRING_ARRAY:
+		case Variant::ARRAY: {
+			Array a = p_value;
+			begin_array();
+			for (int i = 0; i < a.size(); i++) {
+				value(a[i]);
+			}
+			end_array();
+		} break;
+		case Variant::DICTIONARY: {
+			Dictionary d = p_value;
+			List<Variant> keys;
+			d.get_key_list(&keys);
+
+			if (sort_keys) {
+				keys.sort();
+			}
+
+			begin_object();
+			for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+				key(String(E->get()));
+				value(d[E->get()]);
+			}
+			end_object();
+		} break;
+		default: {
+			write_string(String(p_value));
+		} break;
+	}
+}
+
+Vector<uint8_t> JSONWriter::get_buffer() const {
+	Vector<uint8_t> ret;
+	ret.resize(buffer.size());
+	if (buffer.size()) {
+		memcpy(ret.ptrw(), &buffer[0], buffer.size());
+	}
+	return ret;
+}
+
+void JSONWriter::clear() {
+	buffer.clear();
+	levels.clear();
+	after_key = false;
+}
+
+JSONWriter::JSONWriter(const String &p_indent, bool p_sort_keys) {
+	indent = p_indent.utf8();
+	sort_keys = p_sort_keys;
+}
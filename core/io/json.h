@@ -31,8 +31,11 @@
 #ifndef JSON_H
 #define JSON_H
 
+#include "core/local_vector.h"
 #include "core/variant.h"
 
+class FileAccess;
+
 class JSON {
 	enum TokenType {
 		TK_CURLY_BRACKET_OPEN,
@@ -71,8 +74,92 @@ class JSON {
 	static Error _parse_object(Dictionary &object, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str);
 
 public:
+	// Receives a document as a flat stream of events, in document order.
+	// Strings and keys are handed over as UTF-8 and are only valid during the
+	// call. Returning false from any event aborts the parse with ERR_SKIP.
+	class Visitor {
+	public:
+		virtual bool begin_object() = 0;
+		virtual bool end_object() = 0;
+		virtual bool begin_array() = 0;
+		virtual bool end_array() = 0;
+		virtual bool key(const char *p_utf8, int p_len) = 0;
+		virtual bool string_value(const char *p_utf8, int p_len) = 0;
+		virtual bool number_value(double p_value) = 0;
+		virtual bool bool_value(bool p_value) = 0;
+		virtual bool null_value() = 0;
+
+		virtual ~Visitor() {}
+	};
+
 	static String print(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true);
 	static Error parse(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line);
+
+	// UTF-8 variants, which skip the round trip through a wide String.
+	static Vector<uint8_t> print_utf8(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true);
+	static Error parse_utf8(const uint8_t *p_utf8, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line);
+	static Error parse_utf8(const uint8_t *p_utf8, int p_len, Visitor *p_visitor, String &r_err_str, int &r_err_line);
+	// Reads from the current position to the end of the file, in chunks
+	// unless the file can be mapped.
+	static Error parse_file(FileAccess *p_file, Variant &r_ret, String &r_err_str, int &r_err_line);
+	static Error parse_file(FileAccess *p_file, Visitor *p_visitor, String &r_err_str, int &r_err_line);
+};
+
+// Streams JSON as UTF-8 into a growable buffer, formatted exactly like
+// JSON::print(). Containers can be written piecewise with begin/end and key(),
+// or whole with value().
+class JSONWriter {
+	struct Level {
+		bool object = false;
+		int count = 0;
+	};
+
+	LocalVector<uint8_t> buffer;
+	LocalVector<Level> levels;
+	CharString indent;
+	bool sort_keys = true;
+	bool after_key = false;
+
+	_FORCE_INLINE_ void _write(const char *p_data, int p_len) {
+		if (p_len <= 0) {
+			return;
+		}
+		uint32_t from = buffer.size();
+		buffer.resize(from + p_len);
+		memcpy(&buffer[from], p_data, p_len);
+	}
+	_FORCE_INLINE_ void _write(char p_char) { buffer.push_back(p_char); }
+
+	void _write_indent(int p_depth);
+	void _write_escaped(const String &p_string);
+	void _write_escaped(const char *p_utf8, int p_len);
+	void _before_value();
+	void _begin(bool p_object);
+	void _end(bool p_object);
+
+public:
+	void begin_object() { _begin(true); }
+	void end_object() { _end(true); }
+	void begin_array() { _begin(false); }
+	void end_array() { _end(false); }
+
+	void key(const String &p_key);
+	void key_utf8(const char *p_utf8, int p_len);
+
+	void write_null();
+	void write_bool(bool p_value);
+	void write_int(int64_t p_value);
+	void write_float(double p_value);
+	void write_string(const String &p_value);
+	void write_string_utf8(const char *p_utf8, int p_len);
+	void value(const Variant &p_value);
+
+	const uint8_t *get_data() const { return buffer.size() ? &buffer[0] : nullptr; }
+	int get_size() const { return buffer.size(); }
+	Vector<uint8_t> get_buffer() const;
+	void clear();
+
+	JSONWriter(const String &p_indent = "", bool p_sort_keys = true);
 };
 
 #endif // JSON_H
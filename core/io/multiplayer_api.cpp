@@ -32,6 +32,7 @@
 
 #include "core/debugger/engine_debugger.h"
 #include "core/io/marshalls.h"
+#include "core/os/os.h"
 #include "scene/main/node.h"
 
 #include <stdint.h>
@@ -40,10 +41,6 @@
 #define NAME_ID_COMPRESSION_SHIFT 5
 #define BYTE_ONLY_OR_NO_ARGS_SHIFT 6
 
-#ifdef DEBUG_ENABLED
-#include "core/os/os.h"
-#endif
-
 _FORCE_INLINE_ bool _should_call_local(MultiplayerAPI::RPCMode mode, bool is_master, bool &r_skip_rpc) {
 	switch (mode) {
 		case MultiplayerAPI::RPC_MODE_DISABLED: {
@@ -128,6 +125,23 @@ void MultiplayerAPI::poll() {
 			break; // It's also possible that a packet or RPC caused a disconnection, so also check here.
 		}
 	}
+
+	if (!network_peer.is_valid() || network_peer->get_connection_status() != NetworkedMultiplayerPeer::CONNECTION_CONNECTED) {
+		return;
+	}
+
+	if (replication_tick_rate > 0 && !replicated_nodes.empty()) {
+		uint64_t now = OS::get_singleton()->get_ticks_usec();
+		if (now >= replication_next_tick_usec) {
+			uint64_t interval = 1000000 / replication_tick_rate;
+			replication_next_tick_usec += interval;
+			if (replication_next_tick_usec < now) {
+				// Don't try to catch up after a hitch, that would only burst packets.
+				replication_next_tick_usec = now + interval;
+			}
+			_replication_send();
+		}
+	}
 }
 
 void MultiplayerAPI::clear() {
@@ -136,6 +150,14 @@ void MultiplayerAPI::clear() {
 	path_send_cache.clear();
 	packet_cache.clear();
 	last_send_cache_id = 1;
+
+	replication_peers.clear();
+	for (int i = 0; i < REPLICATION_HISTORY; i++) {
+		replication_history[i].tick = 0;
+		replication_history[i].nodes.clear();
+	}
+	replication_tick = 0;
+	replication_next_tick_usec = 0;
 }
 
 void MultiplayerAPI::set_root_node(Node *p_node) {
@@ -310,6 +332,14 @@ void MultiplayerAPI::_process_packet(int p_from, const uint8_t *p_packet, int p_
 		case NETWORK_COMMAND_RAW: {
 			_process_raw(p_from, p_packet, p_packet_len);
 		} break;
+
+		case NETWORK_COMMAND_REPLICATE: {
+			_process_replicate(p_from, p_packet, p_packet_len);
+		} break;
+
+		case NETWORK_COMMAND_REPLICATE_ACK: {
+			_process_replicate_ack(p_from, p_packet, p_packet_len);
+		} break;
 	}
 }
 
@@ -976,6 +1006,7 @@ void MultiplayerAPI::_add_peer(int p_id) {
 
 void MultiplayerAPI::_del_peer(int p_id) {
 	connected_peers.erase(p_id);
+	replication_peers.erase(p_id);
 	// Cleanup get cache.
 	path_get_cache.erase(p_id);
 	// Cleanup sent cache.
@@ -1160,6 +1191,538 @@ void MultiplayerAPI::_process_raw(int p_from, const uint8_t *p_packet, int p_pac
 	emit_signal("network_peer_packet", p_from, out);
 }
 
+// Replication packets are built from variable length integers, 7 bits per
+// byte. Like encode_cstring, passing a null buffer only computes the length.
+static int _encode_varint(uint64_t p_value, uint8_t *r_buffer) {
+	int len = 0;
+	do {
+		uint8_t byte = p_value & 0x7F;
+		p_value >>= 7;
+		if (p_value) {
+			byte |= 0x80;
+		}
+		if (r_buffer) {
+			r_buffer[len] = byte;
+		}
+		len++;
+	} while (p_value);
+	return len;
+}
+
+static Error _decode_varint(const uint8_t *p_buffer, int p_len, uint64_t &r_value, int &r_len) {
+	r_value = 0;
+	r_len = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		ERR_FAIL_COND_V(r_len >= p_len, ERR_INVALID_DATA);
+		uint8_t byte = p_buffer[r_len++];
+		r_value |= uint64_t(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			return OK;
+		}
+	}
+	ERR_FAIL_V(ERR_INVALID_DATA);
+}
+
+// Signed deltas are zigzag encoded so small negative values stay small.
+static _FORCE_INLINE_ uint64_t _zigzag(int64_t p_value) {
+	return (uint64_t(p_value) << 1) ^ uint64_t(p_value >> 63);
+}
+
+static _FORCE_INLINE_ int64_t _unzigzag(uint64_t p_value) {
+	return int64_t(p_value >> 1) ^ -int64_t(p_value & 1);
+}
+
+// Quantized values are integers, which are the only ones sent as deltas.
+static _FORCE_INLINE_ bool _is_delta_type(Variant::Type p_type) {
+	return p_type == Variant::INT || p_type == Variant::VECTOR2I || p_type == Variant::VECTOR3I;
+}
+
+// Only the type the property was registered with is quantized, so the
+// receiving side knows which integers to convert back.
+static Variant _replication_quantize(const Variant &p_value, real_t p_quantization, Variant::Type p_quantized_type) {
+	if (p_quantization <= 0 || p_value.get_type() != p_quantized_type) {
+		return p_value;
+	}
+	switch (p_value.get_type()) {
+		case Variant::FLOAT: {
+			return int64_t(Math::round(double(p_value) / p_quantization));
+		}
+		case Variant::VECTOR2: {
+			Vector2 v = p_value;
+			return Vector2i(Math::round(v.x / p_quantization), Math::round(v.y / p_quantization));
+		}
+		case Variant::VECTOR3: {
+			Vector3 v = p_value;
+			return Vector3i(Math::round(v.x / p_quantization), Math::round(v.y / p_quantization), Math::round(v.z / p_quantization));
+		}
+		default: {
+			return p_value;
+		}
+	}
+}
+
+static Variant _replication_dequantize(const Variant &p_value, real_t p_quantization, Variant::Type p_quantized_type) {
+	if (p_quantization <= 0) {
+		return p_value;
+	}
+	switch (p_quantized_type) {
+		case Variant::FLOAT: {
+			if (p_value.get_type() == Variant::INT) {
+				return double(int64_t(p_value)) * p_quantization;
+			}
+		} break;
+		case Variant::VECTOR2: {
+			if (p_value.get_type() == Variant::VECTOR2I) {
+				Vector2i v = p_value;
+				return Vector2(v.x, v.y) * p_quantization;
+			}
+		} break;
+		case Variant::VECTOR3: {
+			if (p_value.get_type() == Variant::VECTOR3I) {
+				Vector3i v = p_value;
+				return Vector3(v.x, v.y, v.z) * p_quantization;
+			}
+		} break;
+		default: {
+		}
+	}
+	return p_value;
+}
+
+static int _replication_encode_delta_value(const Variant &p_value, const Variant &p_base, uint8_t *r_buffer) {
+	int64_t comps[3];
+	int64_t base[3];
+	int count = 0;
+	switch (p_value.get_type()) {
+		case Variant::INT: {
+			comps[0] = p_value;
+			base[0] = p_base;
+			count = 1;
+		} break;
+		case Variant::VECTOR2I: {
+			Vector2i v = p_value;
+			Vector2i b = p_base;
+			comps[0] = v.x;
+			comps[1] = v.y;
+			base[0] = b.x;
+			base[1] = b.y;
+			count = 2;
+		} break;
+		case Variant::VECTOR3I: {
+			Vector3i v = p_value;
+			Vector3i b = p_base;
+			comps[0] = v.x;
+			comps[1] = v.y;
+			comps[2] = v.z;
+			base[0] = b.x;
+			base[1] = b.y;
+			base[2] = b.z;
+			count = 3;
+		} break;
+		default: {
+			ERR_FAIL_V(0);
+		}
+	}
+
+	int len = 0;
+	for (int i = 0; i < count; i++) {
+		len += _encode_varint(_zigzag(comps[i] - base[i]), r_buffer ? r_buffer + len : nullptr);
+	}
+	return len;
+}
+
+static Error _replication_decode_delta_value(Variant &r_value, const Variant &p_base, const uint8_t *p_buffer, int p_len, int &r_len) {
+	int64_t comps[3];
+	int count = 0;
+	switch (p_base.get_type()) {
+		case Variant::INT: {
+			comps[0] = p_base;
+			count = 1;
+		} break;
+		case Variant::VECTOR2I: {
+			Vector2i b = p_base;
+			comps[0] = b.x;
+			comps[1] = b.y;
+			count = 2;
+		} break;
+		case Variant::VECTOR3I: {
+			Vector3i b = p_base;
+			comps[0] = b.x;
+			comps[1] = b.y;
+			comps[2] = b.z;
+			count = 3;
+		} break;
+		default: {
+			ERR_FAIL_V(ERR_INVALID_DATA);
+		}
+	}
+
+	r_len = 0;
+	for (int i = 0; i < count; i++) {
+		uint64_t delta;
+		int len;
+		Error err = _decode_varint(p_buffer + r_len, p_len - r_len, delta, len);
+		ERR_FAIL_COND_V(err != OK, err);
+		comps[i] += _unzigzag(delta);
+		r_len += len;
+	}
+
+	switch (p_base.get_type()) {
+		case Variant::INT: {
+			r_value = comps[0];
+		} break;
+		case Variant::VECTOR2I: {
+			r_value = Vector2i(comps[0], comps[1]);
+		} break;
+		default: {
+			r_value = Vector3i(comps[0], comps[1], comps[2]);
+		} break;
+	}
+	return OK;
+}
+
+void MultiplayerAPI::_replication_snapshot(ReplicationSnapshot &r_snapshot, Map<int, PathSentCache *> &r_paths) {
+	r_snapshot.tick = replication_tick;
+	r_snapshot.nodes.clear();
+
+	List<ObjectID> freed;
+	for (Map<ObjectID, ReplicatedNode>::Element *E = replicated_nodes.front(); E; E = E->next()) {
+		Node *node = Object::cast_to<Node>(ObjectDB::get_instance(E->key()));
+		if (!node) {
+			freed.push_back(E->key());
+			continue;
+		}
+		if (!node->is_inside_tree() || !node->is_network_master()) {
+			continue; // Only the master of a node replicates it.
+		}
+
+		NodePath path = (root_node->get_path()).rel_path_to(node->get_path());
+		PathSentCache *psc = path_send_cache.getptr(path);
+		if (!psc) {
+			path_send_cache[path] = PathSentCache();
+			psc = path_send_cache.getptr(path);
+			psc->id = last_send_cache_id++;
+		}
+		// Peers that don't know the path yet get it now, and the node once they confirm it.
+		_send_confirm_path(node, path, psc, 0);
+		r_paths[psc->id] = psc;
+
+		const Vector<ReplicatedProperty> &properties = E->get().properties;
+		Vector<Variant> &values = r_snapshot.nodes[psc->id];
+		values.resize(properties.size());
+		for (int i = 0; i < properties.size(); i++) {
+			values.write[i] = _replication_quantize(node->get(properties[i].name), properties[i].quantization, properties[i].quantized_type);
+		}
+	}
+
+	for (List<ObjectID>::Element *E = freed.front(); E; E = E->next()) {
+		replicated_nodes.erase(E->get());
+	}
+}
+
+int MultiplayerAPI::_replication_encode_delta(int p_peer, const ReplicationSnapshot &p_snapshot, const ReplicationSnapshot *p_baseline, const Map<int, PathSentCache *> &p_paths) {
+	ReplicationPeer &peer = replication_peers[p_peer];
+
+	// The header is the command, our tick and the tick of the baseline (0 if none).
+	int ofs = 0;
+	MAKE_ROOM(1 + 10 + 10);
+	packet_cache.write[ofs] = NETWORK_COMMAND_REPLICATE;
+	ofs += 1;
+	ofs += _encode_varint(p_snapshot.tick, &packet_cache.write[ofs]);
+	ofs += _encode_varint(p_baseline ? p_baseline->tick : 0, &packet_cache.write[ofs]);
+
+	// Then, for every node that changed: its path id, which properties changed
+	// and which of those are deltas, followed by the values.
+	for (const Map<int, Vector<Variant>>::Element *E = p_snapshot.nodes.front(); E; E = E->next()) {
+		const PathSentCache *psc = p_paths[E->key()];
+		const Map<int, bool>::Element *C = psc->confirmed_peers.find(p_peer);
+		if (!C || !C->get()) {
+			continue; // Peer can't resolve this node yet.
+		}
+
+		const Vector<Variant> &values = E->get();
+		const Vector<Variant> *base = nullptr;
+		Map<int, uint32_t>::Element *S = peer.sent_nodes.find(E->key());
+		if (!S) {
+			S = peer.sent_nodes.insert(E->key(), p_snapshot.tick);
+		}
+		if (p_baseline && S->get() <= p_baseline->tick) {
+			// The peer only has the node in its baseline if we had sent it by then.
+			const Map<int, Vector<Variant>>::Element *B = p_baseline->nodes.find(E->key());
+			if (B && B->get().size() == values.size()) {
+				base = &B->get();
+			}
+		}
+
+		uint64_t changed = 0;
+		uint64_t delta = 0;
+		for (int i = 0; i < values.size(); i++) {
+			if (base && (*base)[i] == values[i]) {
+				continue;
+			}
+			changed |= uint64_t(1) << i;
+			if (base && _is_delta_type(values[i].get_type()) && (*base)[i].get_type() == values[i].get_type()) {
+				delta |= uint64_t(1) << i;
+			}
+		}
+
+		if (!changed) {
+			continue;
+		}
+
+		MAKE_ROOM(ofs + 10 * 3);
+		ofs += _encode_varint(E->key(), &packet_cache.write[ofs]);
+		ofs += _encode_varint(changed, &packet_cache.write[ofs]);
+		ofs += _encode_varint(delta, &packet_cache.write[ofs]);
+
+		for (int i = 0; i < values.size(); i++) {
+			uint64_t bit = uint64_t(1) << i;
+			if (!(changed & bit)) {
+				continue;
+			}
+			int len = 0;
+			if (delta & bit) {
+				len = _replication_encode_delta_value(values[i], (*base)[i], nullptr);
+				MAKE_ROOM(ofs + len);
+				_replication_encode_delta_value(values[i], (*base)[i], &packet_cache.write[ofs]);
+			} else {
+				Error err = _encode_and_compress_variant(values[i], nullptr, len);
+				ERR_FAIL_COND_V_MSG(err != OK, 0, "Unable to encode replicated value.");
+				MAKE_ROOM(ofs + len);
+				_encode_and_compress_variant(values[i], &packet_cache.write[ofs], len);
+			}
+			ofs += len;
+		}
+	}
+
+	return ofs;
+}
+
+void MultiplayerAPI::_replication_send() {
+	ERR_FAIL_COND_MSG(root_node == nullptr, "Multiplayer root node was not initialized.");
+
+	replication_tick++;
+	if (replication_tick == 0) {
+		replication_tick++; // 0 means "no baseline" on the wire.
+	}
+
+	ReplicationSnapshot &snapshot = replication_history[replication_tick & (REPLICATION_HISTORY - 1)];
+	Map<int, PathSentCache *> paths;
+	_replication_snapshot(snapshot, paths);
+
+	// All of a tick's changes go in a single unreliable packet per peer. Lost
+	// packets are never resent: the next one is a delta against the last
+	// snapshot that peer acknowledged, so it carries everything still missing.
+	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE);
+
+	for (Set<int>::Element *E = connected_peers.front(); E; E = E->next()) {
+		ReplicationPeer &peer = replication_peers[E->get()];
+
+		const ReplicationSnapshot *baseline = nullptr;
+		if (peer.acked_tick && replication_tick - peer.acked_tick < REPLICATION_HISTORY) {
+			baseline = &replication_history[peer.acked_tick & (REPLICATION_HISTORY - 1)];
+			if (baseline->tick != peer.acked_tick) {
+				baseline = nullptr;
+			}
+		}
+
+		int len = _replication_encode_delta(E->get(), snapshot, baseline, paths);
+		if (len == 0) {
+			continue;
+		}
+
+#ifdef DEBUG_ENABLED
+		_profile_bandwidth_data("out", len);
+#endif
+
+		network_peer->set_target_peer(E->get());
+		network_peer->put_packet(packet_cache.ptr(), len);
+	}
+}
+
+void MultiplayerAPI::_process_replicate(int p_from, const uint8_t *p_packet, int p_packet_len) {
+	int ofs = 1;
+	uint64_t tick;
+	uint64_t base_tick;
+	int len;
+
+	Error err = _decode_varint(p_packet + ofs, p_packet_len - ofs, tick, len);
+	ERR_FAIL_COND_MSG(err != OK, "Invalid packet received. Unable to decode replication tick.");
+	ofs += len;
+	err = _decode_varint(p_packet + ofs, p_packet_len - ofs, base_tick, len);
+	ERR_FAIL_COND_MSG(err != OK, "Invalid packet received. Unable to decode replication baseline.");
+	ofs += len;
+
+	ReplicationPeer &peer = replication_peers[p_from];
+	if (tick <= peer.received_tick) {
+		return; // Late or duplicated, a newer state was already applied.
+	}
+
+	const ReplicationSnapshot *baseline = nullptr;
+	if (base_tick) {
+		baseline = &peer.received[base_tick & (REPLICATION_HISTORY - 1)];
+		ERR_FAIL_COND_MSG(baseline->tick != base_tick, "Invalid packet received. Replication baseline is not available.");
+	}
+
+	// Nodes missing from the packet didn't change since the baseline.
+	ReplicationSnapshot state;
+	state.tick = tick;
+	if (baseline) {
+		state.nodes = baseline->nodes;
+	}
+
+	struct Change {
+		int id;
+		uint64_t changed;
+	};
+	List<Change> changes;
+
+	while (ofs < p_packet_len) {
+		uint64_t id;
+		uint64_t changed;
+		uint64_t delta;
+		err = _decode_varint(p_packet + ofs, p_packet_len - ofs, id, len);
+		ERR_FAIL_COND_MSG(err != OK, "Invalid packet received. Unable to decode replicated node.");
+		ofs += len;
+		err = _decode_varint(p_packet + ofs, p_packet_len - ofs, changed, len);
+		ERR_FAIL_COND_MSG(err != OK, "Invalid packet received. Unable to decode replicated node.");
+		ofs += len;
+		err = _decode_varint(p_packet + ofs, p_packet_len - ofs, delta, len);
+		ERR_FAIL_COND_MSG(err != OK, "Invalid packet received. Unable to decode replicated node.");
+		ofs += len;
+		ERR_FAIL_COND_MSG((delta & changed) != delta, "Invalid packet received. Replicated delta was not marked as changed.");
+
+		const Map<int, Vector<Variant>>::Element *B = baseline ? baseline->nodes.find(id) : nullptr;
+		Vector<Variant> &values = state.nodes[id];
+		if (!B) {
+			values.clear();
+		}
+
+		for (int i = 0; i < REPLICATION_MAX_PROPERTIES; i++) {
+			uint64_t bit = uint64_t(1) << i;
+			if (!(changed & bit)) {
+				continue;
+			}
+			if (values.size() <= i) {
+				values.resize(i + 1);
+			}
+			if (delta & bit) {
+				ERR_FAIL_COND_MSG(!B || B->get().size() <= i, "Invalid packet received. Replicated delta has no baseline.");
+				err = _replication_decode_delta_value(values.write[i], B->get()[i], p_packet + ofs, p_packet_len - ofs, len);
+			} else {
+				ERR_FAIL_COND_MSG(ofs >= p_packet_len, "Invalid packet received. Size too small.");
+				err = _decode_and_decompress_variant(values.write[i], p_packet + ofs, p_packet_len - ofs, &len);
+			}
+			ERR_FAIL_COND_MSG(err != OK, "Invalid packet received. Unable to decode replicated value.");
+			ofs += len;
+		}
+
+		Change change;
+		change.id = id;
+		change.changed = changed;
+		changes.push_back(change);
+	}
+
+	peer.received_tick = tick;
+	peer.received[tick & (REPLICATION_HISTORY - 1)] = state;
+
+	// Acknowledge right away so the sender can use this state as a baseline.
+	uint8_t ack[11];
+	ack[0] = NETWORK_COMMAND_REPLICATE_ACK;
+	int ack_len = 1 + _encode_varint(tick, &ack[1]);
+	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE);
+	network_peer->set_target_peer(p_from);
+	network_peer->put_packet(ack, ack_len);
+
+	Map<int, PathGetCache>::Element *P = path_get_cache.find(p_from);
+	ERR_FAIL_COND_MSG(!P, "Invalid packet received. Requests invalid peer cache.");
+
+	for (List<Change>::Element *E = changes.front(); E; E = E->next()) {
+		Map<int, PathGetCache::NodeInfo>::Element *F = P->get().nodes.find(E->get().id);
+		ERR_CONTINUE_MSG(!F, "Invalid packet received. Unable to find replicated node.");
+
+		Node *node = root_node->get_node_or_null(F->get().path);
+		if (!node) {
+			continue;
+		}
+		ERR_CONTINUE_MSG(node->get_network_master() != p_from, "Replicated state for node " + String(node->get_path()) + " received from peer " + itos(p_from) + ", which is not its master.");
+
+		Map<ObjectID, ReplicatedNode>::Element *R = replicated_nodes.find(node->get_instance_id());
+		if (!R) {
+			continue; // Not replicated on this side.
+		}
+
+#ifdef DEBUG_ENABLED
+		_profile_node_data("in_replicate", node->get_instance_id());
+#endif
+
+		const Vector<ReplicatedProperty> &properties = R->get().properties;
+		const Vector<Variant> &values = state.nodes[E->get().id];
+		for (int i = 0; i < properties.size() && i < values.size(); i++) {
+			if (E->get().changed & (uint64_t(1) << i)) {
+				node->set(properties[i].name, _replication_dequantize(values[i], properties[i].quantization, properties[i].quantized_type));
+			}
+		}
+	}
+}
+
+void MultiplayerAPI::_process_replicate_ack(int p_from, const uint8_t *p_packet, int p_packet_len) {
+	uint64_t tick;
+	int len;
+	Error err = _decode_varint(p_packet + 1, p_packet_len - 1, tick, len);
+	ERR_FAIL_COND_MSG(err != OK, "Invalid packet received. Unable to decode replication acknowledgement.");
+	ERR_FAIL_COND_MSG(tick > replication_tick, "Invalid packet received. Acknowledged replication tick was never sent.");
+
+	Map<int, ReplicationPeer>::Element *E = replication_peers.find(p_from);
+	if (E && tick > E->get().acked_tick) {
+		E->get().acked_tick = tick;
+	}
+}
+
+void MultiplayerAPI::replication_add_property(Node *p_node, const StringName &p_property, real_t p_quantization) {
+	ERR_FAIL_NULL(p_node);
+
+	Variant::Type quantized_type = Variant::NIL;
+	if (p_quantization > 0) {
+		quantized_type = p_node->get(p_property).get_type();
+		if (quantized_type != Variant::FLOAT && quantized_type != Variant::VECTOR2 && quantized_type != Variant::VECTOR3) {
+			WARN_PRINT("Property " + String(p_property) + " of node " + String(p_node->get_name()) + " is a " + Variant::get_type_name(quantized_type) + ", only float, Vector2 and Vector3 properties can be quantized. It will be replicated as is.");
+			p_quantization = 0;
+			quantized_type = Variant::NIL;
+		}
+	}
+
+	ReplicatedNode &rn = replicated_nodes[p_node->get_instance_id()];
+	for (int i = 0; i < rn.properties.size(); i++) {
+		if (rn.properties[i].name == p_property) {
+			rn.properties.write[i].quantization = p_quantization;
+			rn.properties.write[i].quantized_type = quantized_type;
+			return;
+		}
+	}
+	ERR_FAIL_COND_MSG(rn.properties.size() >= REPLICATION_MAX_PROPERTIES, "Too many replicated properties on node " + String(p_node->get_name()) + ", the maximum is " + itos(REPLICATION_MAX_PROPERTIES) + ".");
+
+	ReplicatedProperty property;
+	property.name = p_property;
+	property.quantization = p_quantization;
+	property.quantized_type = quantized_type;
+	rn.properties.push_back(property);
+}
+
+void MultiplayerAPI::replication_remove_node(Node *p_node) {
+	ERR_FAIL_NULL(p_node);
+	replicated_nodes.erase(p_node->get_instance_id());
+}
+
+void MultiplayerAPI::set_replication_tick_rate(int p_rate) {
+	ERR_FAIL_COND(p_rate < 0);
+	replication_tick_rate = p_rate;
+}
+
+int MultiplayerAPI::get_replication_tick_rate() const {
+	return replication_tick_rate;
+}
+
 int MultiplayerAPI::get_network_unique_id() const {
 	ERR_FAIL_COND_V_MSG(!network_peer.is_valid(), 0, "No network peer is assigned. Unable to get unique network ID.");
 	return network_peer->get_unique_id();
@@ -1217,9 +1780,15 @@ void MultiplayerAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_refusing_new_network_connections"), &MultiplayerAPI::is_refusing_new_network_connections);
 	ClassDB::bind_method(D_METHOD("set_allow_object_decoding", "enable"), &MultiplayerAPI::set_allow_object_decoding);
 	ClassDB::bind_method(D_METHOD("is_object_decoding_allowed"), &MultiplayerAPI::is_object_decoding_allowed);
+	ClassDB::bind_method(D_METHOD("replication_add_property", "node", "property", "quantization"), &MultiplayerAPI::replication_add_property, DEFVAL(0.0));
+	ClassDB::bind_method(D_METHOD("replication_remove_node", "node"), &MultiplayerAPI::replication_remove_node);
+	ClassDB::bind_method(D_METHOD("set_replication_tick_rate", "rate"), &MultiplayerAPI::set_replication_tick_rate);
+	ClassDB::bind_method(D_METHOD("get_replication_tick_rate"), &MultiplayerAPI::get_replication_tick_rate);
+	ClassDB::bind_method(D_METHOD("get_replication_tick"), &MultiplayerAPI::get_replication_tick);
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "allow_object_decoding"), "set_allow_object_decoding", "is_object_decoding_allowed");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "refuse_new_network_connections"), "set_refuse_new_network_connections", "is_refusing_new_network_connections");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "replication_tick_rate", PROPERTY_HINT_RANGE, "0,128,1"), "set_replication_tick_rate", "get_replication_tick_rate");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "network_peer", PROPERTY_HINT_RESOURCE_TYPE, "NetworkedMultiplayerPeer", 0), "set_network_peer", "get_network_peer");
 	ADD_PROPERTY_DEFAULT("refuse_new_network_connections", false);
 
@@ -54,6 +54,42 @@ private:
 		Map<int, NodeInfo> nodes;
 	};
 
+	// Replication.
+	enum {
+		REPLICATION_HISTORY = 32, // Snapshots kept as baselines, must be a power of two.
+		REPLICATION_MAX_PROPERTIES = 64, // Per node, one bit each in the change masks.
+	};
+
+	struct ReplicatedProperty {
+		StringName name;
+		real_t quantization = 0;
+		Variant::Type quantized_type = Variant::NIL; // FLOAT, VECTOR2 or VECTOR3 when quantized, only those are converted back.
+	};
+
+	struct ReplicatedNode {
+		Vector<ReplicatedProperty> properties;
+	};
+
+	// Values are kept quantized, so deltas are computed on what the remote really has.
+	struct ReplicationSnapshot {
+		uint32_t tick = 0;
+		Map<int, Vector<Variant>> nodes; // Path cache id of the sender to values.
+	};
+
+	struct ReplicationPeer {
+		uint32_t acked_tick = 0; // Last of our ticks acknowledged by this peer.
+		uint32_t received_tick = 0; // Last tick received from this peer.
+		Map<int, uint32_t> sent_nodes; // Path cache id to the first tick it was sent in.
+		ReplicationSnapshot received[REPLICATION_HISTORY];
+	};
+
+	Map<ObjectID, ReplicatedNode> replicated_nodes;
+	Map<int, ReplicationPeer> replication_peers;
+	ReplicationSnapshot replication_history[REPLICATION_HISTORY];
+	uint32_t replication_tick = 0;
+	int replication_tick_rate = 20;
+	uint64_t replication_next_tick_usec = 0;
+
 	Ref<NetworkedMultiplayerPeer> network_peer;
 	int rpc_sender_id = 0;
 	Set<int> connected_peers;
@@ -74,6 +110,12 @@ protected:
 	void _process_rpc(Node *p_node, const uint16_t p_rpc_method_id, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset);
 	void _process_rset(Node *p_node, const uint16_t p_rpc_property_id, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset);
 	void _process_raw(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_replicate(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_replicate_ack(int p_from, const uint8_t *p_packet, int p_packet_len);
+
+	void _replication_snapshot(ReplicationSnapshot &r_snapshot, Map<int, PathSentCache *> &r_paths);
+	int _replication_encode_delta(int p_peer, const ReplicationSnapshot &p_snapshot, const ReplicationSnapshot *p_baseline, const Map<int, PathSentCache *> &p_paths);
+	void _replication_send();
 
 	void _send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, const StringName &p_name, const Variant **p_arg, int p_argcount);
 	bool _send_confirm_path(Node *p_node, NodePath p_path, PathSentCache *psc, int p_target);
@@ -88,6 +130,8 @@ public:
 		NETWORK_COMMAND_SIMPLIFY_PATH,
 		NETWORK_COMMAND_CONFIRM_PATH,
 		NETWORK_COMMAND_RAW,
+		NETWORK_COMMAND_REPLICATE,
+		NETWORK_COMMAND_REPLICATE_ACK,
 	};
 
 	enum NetworkNodeIdCompression {
@@ -141,6 +185,12 @@ public:
 	void set_allow_object_decoding(bool p_enable);
 	bool is_object_decoding_allowed() const;
 
+	void replication_add_property(Node *p_node, const StringName &p_property, real_t p_quantization = 0);
+	void replication_remove_node(Node *p_node);
+	void set_replication_tick_rate(int p_rate);
+	int get_replication_tick_rate() const;
+	uint32_t get_replication_tick() const { return replication_tick; }
+
 	MultiplayerAPI();
 	~MultiplayerAPI();
 };
@@ -35,6 +35,7 @@
 #include "core/io/marshalls.h"
 #include "core/os/dir_access.h"
 #include "core/project_settings.h"
+#include "core/thread_work_pool.h"
 #include "core/version.h"
 
 //#define print_bl(m_what) print_line(m_what)
@@ -315,19 +316,24 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 					uint32_t index = f->get_32();
 					String path = res_path + "::" + itos(index);
 
+					RES res;
 					if (use_nocache) {
 						if (!internal_index_cache.has(path)) {
 							WARN_PRINT(String("Couldn't load resource (no cache): " + path).utf8().get_data());
 						}
-						r_v = internal_index_cache[path];
+						res = internal_index_cache[path];
 					} else {
-						RES res = ResourceLoader::load(path);
+						res = ResourceLoader::load(path);
 						if (res.is_null()) {
 							WARN_PRINT(String("Couldn't load resource: " + path).utf8().get_data());
 						}
-						r_v = res;
 					}
 
+					if (resource_references && res.is_valid()) {
+						resource_references->push_back(res.ptr());
+					}
+					r_v = res;
+
 				} break;
 				case OBJECT_EXTERNAL_RESOURCE: {
 					//old file format, still around for compatibility
@@ -349,6 +355,9 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 					if (res.is_null()) {
 						WARN_PRINT(String("Couldn't load resource: " + path).utf8().get_data());
 					}
+					if (resource_references && res.is_valid()) {
+						resource_references->push_back(res.ptr());
+					}
 					r_v = res;
 
 				} break;
@@ -377,7 +386,11 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 							}
 						}
 
-						r_v = external_resources[erindex].cache;
+						RES res = external_resources[erindex].cache;
+						if (resource_references && res.is_valid()) {
+							resource_references->push_back(res.ptr());
+						}
+						r_v = res;
 					}
 
 				} break;
@@ -661,65 +674,22 @@ Error ResourceLoaderBinary::load() {
 		stage++;
 	}
 
+	if (use_sub_threads && internal_resources.size() > 2 && ThreadWorkPool::get_singleton()) {
+		return _load_internal_resources_threaded();
+	}
+
 	for (int i = 0; i < internal_resources.size(); i++) {
 		bool main = i == (internal_resources.size() - 1);
 
-		//maybe it is loaded already
-		String path;
-		int subindex = 0;
-
-		if (!main) {
-			path = internal_resources[i].path;
-
-			if (path.begins_with("local://")) {
-				path = path.replace_first("local://", "");
-				subindex = path.to_int();
-				path = res_path + "::" + path;
-			}
-
-			if (!use_nocache) {
-				if (ResourceCache::has(path)) {
-					//already loaded, don't do anything
-					stage++;
-					error = OK;
-					continue;
-				}
-			}
-		} else {
-			if (!use_nocache && !ResourceCache::has(res_path)) {
-				path = res_path;
-			}
-		}
-
-		uint64_t offset = internal_resources[i].offset;
-
-		f->seek(offset);
-
-		String t = get_unicode_string();
-
-		Object *obj = ClassDB::instance(t);
-		if (!obj) {
-			error = ERR_FILE_CORRUPT;
-			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
-		}
-
-		Resource *r = Object::cast_to<Resource>(obj);
-		if (!r) {
-			String obj_class = obj->get_class();
-			error = ERR_FILE_CORRUPT;
-			memdelete(obj); //bye
-			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
-		}
-
-		RES res = RES(r);
-
-		if (path != String()) {
-			r->set_path(path);
+		RES res;
+		error = _instance_internal_resource(i, res);
+		if (error != OK) {
+			return error;
 		}
-		r->set_subindex(subindex);
-
-		if (!main) {
-			internal_index_cache[path] = res;
+		if (res.is_null()) {
+			//already loaded, don't do anything
+			stage++;
+			continue;
 		}
 
 		int pc = f->get_32();
@@ -766,6 +736,237 @@ Error ResourceLoaderBinary::load() {
 	return ERR_FILE_EOF;
 }
 
+Error ResourceLoaderBinary::_instance_internal_resource(int p_index, RES &r_res) {
+	bool main = p_index == (internal_resources.size() - 1);
+
+	//maybe it is loaded already
+	String path;
+	int subindex = 0;
+
+	if (!main) {
+		path = internal_resources[p_index].path;
+
+		if (path.begins_with("local://")) {
+			path = path.replace_first("local://", "");
+			subindex = path.to_int();
+			path = res_path + "::" + path;
+		}
+
+		if (!use_nocache) {
+			if (ResourceCache::has(path)) {
+				return OK; // Leaves r_res null.
+			}
+		}
+	} else {
+		if (!use_nocache && !ResourceCache::has(res_path)) {
+			path = res_path;
+		}
+	}
+
+	uint64_t offset = internal_resources[p_index].offset;
+
+	f->seek(offset);
+
+	String t = get_unicode_string();
+
+	Object *obj = ClassDB::instance(t);
+	if (!obj) {
+		ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
+	}
+
+	Resource *r = Object::cast_to<Resource>(obj);
+	if (!r) {
+		String obj_class = obj->get_class();
+		memdelete(obj); //bye
+		ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
+	}
+
+	r_res = RES(r);
+
+	if (path != String()) {
+		r->set_path(path);
+	}
+	r->set_subindex(subindex);
+
+	if (!main) {
+		internal_index_cache[path] = r_res;
+	}
+
+	return OK;
+}
+
+void ResourceLoaderBinary::_set_threaded_resource(int p_index) {
+	ThreadedResource &tr = threaded_resources[p_index];
+
+	for (List<Pair<StringName, Variant>>::Element *E = tr.properties.front(); E; E = E->next()) {
+		tr.res->set(E->get().first, E->get().second);
+	}
+#ifdef TOOLS_ENABLED
+	tr.res->set_edited(false);
+#endif
+	tr.properties.clear();
+}
+
+void ResourceLoaderBinary::_set_threaded_group(uint32_t p_group, const ThreadedGroups *p_groups) {
+	uint32_t from = p_group > 0 ? p_groups->ends[p_group - 1] : 0;
+	for (uint32_t i = from; i < p_groups->ends[p_group]; i++) {
+		_set_threaded_resource(p_groups->order[i]);
+	}
+
+	uint32_t set = atomic_add(&threaded_resources_set, p_groups->ends[p_group] - from);
+	if (progress) {
+		*progress = 0.5 + 0.5 * set / float(threaded_resources.size());
+	}
+}
+
+static int _find_threaded_group(LocalVector<int> &p_parents, int p_node) {
+	while (p_parents[p_node] != p_node) {
+		p_parents[p_node] = p_parents[p_parents[p_node]];
+		p_node = p_parents[p_node];
+	}
+	return p_node;
+}
+
+Error ResourceLoaderBinary::_load_internal_resources_threaded() {
+	// The file can only be read from this thread, so every internal resource
+	// is read first. Setting the properties is what takes time (meshes,
+	// images, shaders...), that runs on the worker pool.
+	//
+	// Setters often connect to the resources they are given (CurveTexture,
+	// GradientTexture, ShaderMaterial, Theme...), and connecting is not
+	// thread safe. So the resources that reference each other, or the same
+	// resource, form a group that a single task sets up in file order, which
+	// also sets up the referenced resources first.
+	int count = internal_resources.size();
+	threaded_resources.resize(count);
+
+	// Nodes of the groups: the internal resources, then the other resources they reference.
+	Map<Resource *, int> nodes;
+	LocalVector<int> parents;
+	parents.resize(count);
+	for (int i = 0; i < count; i++) {
+		parents[i] = i;
+	}
+
+	Vector<Resource *> references;
+	resource_references = &references;
+
+	for (int i = 0; i < count; i++) {
+		ThreadedResource &tr = threaded_resources[i];
+
+		error = _instance_internal_resource(i, tr.res);
+		if (error != OK) {
+			break;
+		}
+		if (tr.res.is_null()) {
+			continue; // Already loaded.
+		}
+
+		references.clear();
+
+		int pc = f->get_32();
+		for (int j = 0; j < pc; j++) {
+			StringName name = _get_string();
+
+			if (name == StringName()) {
+				error = ERR_FILE_CORRUPT;
+				break;
+			}
+
+			Variant value;
+			error = parse_variant(value);
+			if (error) {
+				break;
+			}
+
+			tr.properties.push_back(Pair<StringName, Variant>(name, value));
+		}
+		if (error != OK) {
+			break;
+		}
+
+		nodes[tr.res.ptr()] = i;
+
+		// The main resource is set up last on its own, and often references all the
+		// others (a PackedScene bundles every sub-resource), so it joins no group.
+		if (i < count - 1) {
+			for (int j = 0; j < references.size(); j++) {
+				Map<Resource *, int>::Element *E = nodes.find(references[j]);
+				if (!E) {
+					E = nodes.insert(references[j], parents.size());
+					parents.push_back(parents.size());
+				}
+				parents[_find_threaded_group(parents, E->get())] = _find_threaded_group(parents, i);
+			}
+		}
+
+		resource_cache.push_back(tr.res);
+
+		// Reading is the first half of the progress, setting up the second.
+		if (progress) {
+			*progress = 0.5 * (i + 1) / float(count);
+		}
+	}
+
+	resource_references = nullptr;
+
+	if (error != OK) {
+		threaded_resources.clear();
+		ERR_FAIL_V_MSG(error, "Failed reading the resources in: " + local_path + ".");
+	}
+
+	f->close();
+
+	// Everything but the main resource, by group, each group in file order.
+	LocalVector<int> group_of_root;
+	group_of_root.resize(parents.size());
+	for (uint32_t i = 0; i < group_of_root.size(); i++) {
+		group_of_root[i] = -1;
+	}
+	LocalVector<LocalVector<int>> group_resources;
+	for (int i = 0; i < count - 1; i++) {
+		if (threaded_resources[i].res.is_null()) {
+			continue;
+		}
+		int root = _find_threaded_group(parents, i);
+		if (group_of_root[root] == -1) {
+			group_of_root[root] = group_resources.size();
+			group_resources.push_back(LocalVector<int>());
+		}
+		group_resources[group_of_root[root]].push_back(i);
+	}
+
+	ThreadedGroups groups;
+	groups.order.reserve(count);
+	for (uint32_t i = 0; i < group_resources.size(); i++) {
+		for (uint32_t j = 0; j < group_resources[i].size(); j++) {
+			groups.order.push_back(group_resources[i][j]);
+		}
+		groups.ends.push_back(groups.order.size());
+	}
+
+	threaded_group_count = groups.ends.size();
+	threaded_resources_set = 0;
+	if (groups.ends.size()) {
+		ThreadWorkPool::get_singleton()->do_work(groups.ends.size(), this, &ResourceLoaderBinary::_set_threaded_group, (const ThreadedGroups *)&groups);
+	}
+
+	// The main resource goes last, on this thread.
+	int main = count - 1;
+	_set_threaded_resource(main);
+
+	if (progress) {
+		*progress = 1.0;
+	}
+
+	resource = threaded_resources[main].res;
+	resource->set_as_translation_remapped(translation_remapped);
+	threaded_resources.clear();
+
+	error = OK;
+	return OK;
+}
+
 void ResourceLoaderBinary::set_translation_remapped(bool p_remapped) {
 	translation_remapped = p_remapped;
 }
@@ -33,7 +33,9 @@
 
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
+#include "core/local_vector.h"
 #include "core/os/file_access.h"
+#include "core/pair.h"
 
 class ResourceLoaderBinary {
 	bool translation_remapped = false;
@@ -72,6 +74,28 @@ class ResourceLoaderBinary {
 	Vector<IntResource> internal_resources;
 	Map<String, RES> internal_index_cache;
 
+	// Internal resources read ahead of setting their properties, when loading with sub threads.
+	struct ThreadedResource {
+		RES res;
+		List<Pair<StringName, Variant>> properties;
+	};
+
+	// Resources set up in order by the same task, as they share resources.
+	struct ThreadedGroups {
+		LocalVector<int> order;
+		LocalVector<uint32_t> ends;
+	};
+
+	LocalVector<ThreadedResource> threaded_resources;
+	uint32_t threaded_resources_set = 0; // Counted by the worker tasks, for the progress.
+	int threaded_group_count = 0;
+	Vector<Resource *> *resource_references = nullptr; // Collects the resources parse_variant() resolves.
+
+	Error _instance_internal_resource(int p_index, RES &r_res);
+	void _set_threaded_resource(int p_index);
+	void _set_threaded_group(uint32_t p_group, const ThreadedGroups *p_groups);
+	Error _load_internal_resources_threaded();
+
 	String get_unicode_string();
 	void _advance_padding(uint32_t p_len);
 
@@ -93,6 +117,8 @@ public:
 	void set_translation_remapped(bool p_remapped);
 
 	void set_remaps(const Map<String, String> &p_remaps) { remaps = p_remaps; }
+	void set_use_sub_threads(bool p_use_sub_threads) { use_sub_threads = p_use_sub_threads; }
+	int get_threaded_group_count() const { return threaded_group_count; } // Groups set up in parallel by load().
 	void open(FileAccess *p_f);
 	String recognize(FileAccess *p_f);
 	void get_dependencies(FileAccess *p_f, List<String> *p_dependencies, bool p_add_types);
@@ -179,6 +179,8 @@ void ResourceFormatLoader::_bind_methods() {
 ///////////////////////////////////
 
 RES ResourceLoader::_load(const String &p_path, const String &p_original_path, const String &p_type_hint, bool p_no_cache, Error *r_error, bool p_use_sub_threads, float *r_progress) {
+	MemoryTagScope memory_tag(Memory::TAG_RESOURCES);
+
 	bool found = false;
 
 	// Try all loaders and pick the first match for the type hint
@@ -82,6 +82,8 @@ void ResourceFormatSaver::_bind_methods() {
 }
 
 Error ResourceSaver::save(const String &p_path, const RES &p_resource, uint32_t p_flags) {
+	MemoryTagScope memory_tag(Memory::TAG_RESOURCES);
+
 	String extension = p_path.get_extension();
 	Error err = ERR_FILE_UNRECOGNIZED;
 
@@ -0,0 +1,626 @@
+/*************************************************************************/
+/*  dynamic_bvh.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef DYNAMIC_BVH_H
+#define DYNAMIC_BVH_H
+
+#include "core/hash_map.h"
+#include "core/local_vector.h"
+#include "core/math/aabb.h"
+#include "core/math/rect2.h"
+
+typedef uint32_t DynamicBVHElementID;
+
+#define DYNAMIC_BVH_ELEMENT_INVALID_ID 0
+
+/*
+	Dynamic bounding volume hierarchy for broadphases, usable with AABB/Vector3
+	in 3D and Rect2/Vector2 in 2D.
+
+	Leaves hold fattened bounds, so an element that moves only a little stays in
+	its leaf and the tree is left untouched. Elements escaping their leaf are
+	reinserted and the tree is kept balanced with AVL rotations.
+
+	Pairs are cached: candidates are only searched for when a leaf is reinserted,
+	while moving within the leaf just rechecks the pairs already known. The pair
+	and unpair callbacks follow the exact bounds, like Octree does.
+*/
+
+template <class T, class B, class V>
+class DynamicBVH {
+public:
+	typedef DynamicBVHElementID ID;
+	typedef void *(*PairCallback)(void *, ID, T *, int, ID, T *, int);
+	typedef void (*UnpairCallback)(void *, ID, T *, int, ID, T *, int, void *);
+
+private:
+	enum {
+		NODE_NULL = -1,
+		QUERY_STACK_MAX = 128,
+	};
+
+	struct Node {
+		B bounds;
+		int parent = NODE_NULL; // Next free node while unused.
+		int children[2] = { NODE_NULL, NODE_NULL };
+		int height = 0;
+		ID element = DYNAMIC_BVH_ELEMENT_INVALID_ID;
+
+		_FORCE_INLINE_ bool is_leaf() const { return children[0] == NODE_NULL; }
+	};
+
+	struct Element {
+		T *userdata = nullptr;
+		int subindex = 0;
+		B bounds;
+		int leaf = NODE_NULL;
+		bool used = false;
+		uint32_t pairable_type = 0;
+		uint32_t pairable_mask = 0;
+		LocalVector<ID> pairs;
+	};
+
+	struct PairData {
+		void *ud = nullptr;
+		bool intersect = false;
+	};
+
+	LocalVector<Node> nodes;
+	int root = NODE_NULL;
+	int free_node = NODE_NULL;
+
+	LocalVector<Element> elements; // Indexed by ID - 1.
+	LocalVector<ID> free_elements;
+
+	HashMap<uint64_t, PairData> pair_map;
+	int pair_count = 0;
+
+	real_t margin = 0;
+
+	PairCallback pair_callback = nullptr;
+	UnpairCallback unpair_callback = nullptr;
+	void *pair_callback_userdata = nullptr;
+
+	// Surface area heuristic and overlap tests for the two bounds types.
+	static _FORCE_INLINE_ real_t _get_cost(const AABB &p_bounds) {
+		const Vector3 &s = p_bounds.size;
+		return s.x * s.y + s.y * s.z + s.z * s.x;
+	}
+	static _FORCE_INLINE_ real_t _get_cost(const Rect2 &p_bounds) {
+		return p_bounds.size.x + p_bounds.size.y;
+	}
+	static _FORCE_INLINE_ bool _overlaps(const AABB &p_a, const AABB &p_b) {
+		return p_a.intersects_inclusive(p_b);
+	}
+	static _FORCE_INLINE_ bool _overlaps(const Rect2 &p_a, const Rect2 &p_b) {
+		return p_a.intersects(p_b);
+	}
+
+	static _FORCE_INLINE_ uint64_t _pair_key(ID p_a, ID p_b) {
+		return p_a < p_b ? (uint64_t(p_a) << 32) | p_b : (uint64_t(p_b) << 32) | p_a;
+	}
+
+	_FORCE_INLINE_ Element &_get_element(ID p_id) { return elements[p_id - 1]; }
+	_FORCE_INLINE_ const Element &_get_element(ID p_id) const { return elements[p_id - 1]; }
+
+	int _alloc_node() {
+		int index;
+		if (free_node != NODE_NULL) {
+			index = free_node;
+			free_node = nodes[index].parent;
+			nodes[index] = Node();
+		} else {
+			index = nodes.size();
+			nodes.push_back(Node());
+		}
+		return index;
+	}
+
+	void _free_node(int p_index) {
+		nodes[p_index].parent = free_node;
+		nodes[p_index].height = -1;
+		free_node = p_index;
+	}
+
+	void _refit(int p_index) {
+		Node &n = nodes[p_index];
+		const Node &a = nodes[n.children[0]];
+		const Node &b = nodes[n.children[1]];
+		n.bounds = a.bounds.merge(b.bounds);
+		n.height = 1 + MAX(a.height, b.height);
+	}
+
+	// Rotates the subtree at p_index if it is unbalanced, returns the new subtree root.
+	int _balance(int p_index) {
+		Node &a = nodes[p_index];
+		if (a.is_leaf() || a.height < 2) {
+			return p_index;
+		}
+
+		int ib = a.children[0];
+		int ic = a.children[1];
+		int balance = nodes[ic].height - nodes[ib].height;
+
+		if (balance > 1) {
+			return _rotate(p_index, ic, 1);
+		}
+		if (balance < -1) {
+			return _rotate(p_index, ib, 0);
+		}
+		return p_index;
+	}
+
+	// Promotes child p_up (at slot p_side of p_index) to replace p_index.
+	int _rotate(int p_index, int p_up, int p_side) {
+		Node &a = nodes[p_index];
+		Node &up = nodes[p_up];
+
+		int i0 = up.children[0];
+		int i1 = up.children[1];
+
+		up.children[0] = p_index;
+		up.parent = a.parent;
+		a.parent = p_up;
+
+		if (up.parent != NODE_NULL) {
+			Node &p = nodes[up.parent];
+			if (p.children[0] == p_index) {
+				p.children[0] = p_up;
+			} else {
+				p.children[1] = p_up;
+			}
+		} else {
+			root = p_up;
+		}
+
+		// Keep the taller grandchild up, move the shorter one down into p_index.
+		int keep = nodes[i0].height > nodes[i1].height ? i0 : i1;
+		int move = keep == i0 ? i1 : i0;
+
+		up.children[1] = keep;
+		a.children[p_side] = move;
+		nodes[move].parent = p_index;
+
+		_refit(p_index);
+		_refit(p_up);
+		return p_up;
+	}
+
+	void _insert_leaf(int p_leaf) {
+		if (root == NODE_NULL) {
+			root = p_leaf;
+			nodes[root].parent = NODE_NULL;
+			return;
+		}
+
+		// Find the best sibling.
+		B leaf_bounds = nodes[p_leaf].bounds;
+		int index = root;
+		while (!nodes[index].is_leaf()) {
+			const Node &n = nodes[index];
+			real_t area = _get_cost(n.bounds);
+			real_t combined = _get_cost(n.bounds.merge(leaf_bounds));
+
+			real_t cost = 2 * combined;
+			real_t inheritance = 2 * (combined - area);
+
+			real_t child_cost[2];
+			for (int i = 0; i < 2; i++) {
+				const Node &c = nodes[n.children[i]];
+				real_t merged = _get_cost(c.bounds.merge(leaf_bounds));
+				child_cost[i] = (c.is_leaf() ? merged : merged - _get_cost(c.bounds)) + inheritance;
+			}
+
+			if (cost < child_cost[0] && cost < child_cost[1]) {
+				break;
+			}
+			index = child_cost[0] < child_cost[1] ? n.children[0] : n.children[1];
+		}
+
+		int sibling = index;
+		int old_parent = nodes[sibling].parent;
+		int new_parent = _alloc_node();
+		Node &np = nodes[new_parent];
+		np.parent = old_parent;
+		np.bounds = leaf_bounds.merge(nodes[sibling].bounds);
+		np.height = nodes[sibling].height + 1;
+		np.children[0] = sibling;
+		np.children[1] = p_leaf;
+		nodes[sibling].parent = new_parent;
+		nodes[p_leaf].parent = new_parent;
+
+		if (old_parent != NODE_NULL) {
+			Node &op = nodes[old_parent];
+			if (op.children[0] == sibling) {
+				op.children[0] = new_parent;
+			} else {
+				op.children[1] = new_parent;
+			}
+		} else {
+			root = new_parent;
+		}
+
+		_fix_upwards(new_parent);
+	}
+
+	void _remove_leaf(int p_leaf) {
+		if (p_leaf == root) {
+			root = NODE_NULL;
+			return;
+		}
+
+		int parent = nodes[p_leaf].parent;
+		int grand_parent = nodes[parent].parent;
+		int sibling = nodes[parent].children[0] == p_leaf ? nodes[parent].children[1] : nodes[parent].children[0];
+
+		if (grand_parent != NODE_NULL) {
+			Node &gp = nodes[grand_parent];
+			if (gp.children[0] == parent) {
+				gp.children[0] = sibling;
+			} else {
+				gp.children[1] = sibling;
+			}
+			nodes[sibling].parent = grand_parent;
+			_free_node(parent);
+			_fix_upwards(grand_parent);
+		} else {
+			root = sibling;
+			nodes[sibling].parent = NODE_NULL;
+			_free_node(parent);
+		}
+	}
+
+	void _fix_upwards(int p_index) {
+		int index = p_index;
+		while (index != NODE_NULL) {
+			index = _balance(index);
+			_refit(index);
+			index = nodes[index].parent;
+		}
+	}
+
+	_FORCE_INLINE_ bool _can_pair(const Element &p_a, const Element &p_b) const {
+		if (p_a.userdata == p_b.userdata) {
+			return false;
+		}
+		return (p_a.pairable_type & p_b.pairable_mask) || (p_b.pairable_type & p_a.pairable_mask);
+	}
+
+	void _remove_from_pair_list(Element &p_element, ID p_other) {
+		for (uint32_t i = 0; i < p_element.pairs.size(); i++) {
+			if (p_element.pairs[i] == p_other) {
+				p_element.pairs[i] = p_element.pairs[p_element.pairs.size() - 1];
+				p_element.pairs.resize(p_element.pairs.size() - 1);
+				return;
+			}
+		}
+	}
+
+	void _remove_pair(ID p_a, ID p_b) {
+		uint64_t key = _pair_key(p_a, p_b);
+		PairData *pd = pair_map.getptr(key);
+		ERR_FAIL_COND(!pd);
+
+		Element &a = _get_element(p_a);
+		Element &b = _get_element(p_b);
+
+		if (pd->intersect) {
+			if (unpair_callback) {
+				unpair_callback(pair_callback_userdata, p_a, a.userdata, a.subindex, p_b, b.userdata, b.subindex, pd->ud);
+			}
+			pair_count--;
+		}
+
+		pair_map.erase(key);
+		_remove_from_pair_list(a, p_b);
+		_remove_from_pair_list(b, p_a);
+	}
+
+	void _remove_all_pairs(ID p_id) {
+		Element &e = _get_element(p_id);
+		while (e.pairs.size()) {
+			_remove_pair(p_id, e.pairs[e.pairs.size() - 1]);
+		}
+	}
+
+	// Adds a (not yet intersecting) pair for every leaf overlapping the leaf of p_id.
+	void _find_new_pairs(ID p_id) {
+		Element &e = _get_element(p_id);
+		const B &fat = nodes[e.leaf].bounds;
+
+		int stack[QUERY_STACK_MAX];
+		int stack_size = 0;
+		stack[stack_size++] = root;
+
+		while (stack_size) {
+			const Node &n = nodes[stack[--stack_size]];
+			if (!_overlaps(n.bounds, fat)) {
+				continue;
+			}
+
+			if (!n.is_leaf()) {
+				ERR_FAIL_COND(stack_size + 2 > QUERY_STACK_MAX);
+				stack[stack_size++] = n.children[0];
+				stack[stack_size++] = n.children[1];
+				continue;
+			}
+
+			if (n.element == p_id) {
+				continue;
+			}
+
+			Element &other = _get_element(n.element);
+			if (!_can_pair(e, other)) {
+				continue;
+			}
+
+			uint64_t key = _pair_key(p_id, n.element);
+			if (pair_map.getptr(key)) {
+				continue;
+			}
+
+			pair_map.set(key, PairData());
+			e.pairs.push_back(n.element);
+			other.pairs.push_back(p_id);
+		}
+	}
+
+	// Updates the exact intersection state of the cached pairs of p_id and drops
+	// the pairs whose leaves no longer overlap.
+	void _check_pairs(ID p_id) {
+		Element &e = _get_element(p_id);
+
+		for (uint32_t i = 0; i < e.pairs.size();) {
+			ID other_id = e.pairs[i];
+			Element &other = _get_element(other_id);
+
+			if (!_overlaps(nodes[e.leaf].bounds, nodes[other.leaf].bounds)) {
+				_remove_pair(p_id, other_id); // Swaps the last pair into i.
+				continue;
+			}
+
+			PairData *pd = pair_map.getptr(_pair_key(p_id, other_id));
+			bool intersect = _overlaps(e.bounds, other.bounds);
+
+			if (intersect != pd->intersect) {
+				if (intersect) {
+					if (pair_callback) {
+						pd->ud = pair_callback(pair_callback_userdata, p_id, e.userdata, e.subindex, other_id, other.userdata, other.subindex);
+					}
+					pair_count++;
+				} else {
+					if (unpair_callback) {
+						unpair_callback(pair_callback_userdata, p_id, e.userdata, e.subindex, other_id, other.userdata, other.subindex, pd->ud);
+					}
+					pair_count--;
+				}
+				pd->intersect = intersect;
+			}
+			i++;
+		}
+	}
+
+	template <class Q>
+	int _cull(const Q &p_query, T **p_result_array, int p_result_max, int *p_subindex_array) const {
+		if (root == NODE_NULL) {
+			return 0;
+		}
+
+		int count = 0;
+		int stack[QUERY_STACK_MAX];
+		int stack_size = 0;
+		stack[stack_size++] = root;
+
+		while (stack_size && count < p_result_max) {
+			const Node &n = nodes[stack[--stack_size]];
+			if (!p_query(n.bounds)) {
+				continue;
+			}
+
+			if (!n.is_leaf()) {
+				ERR_FAIL_COND_V(stack_size + 2 > QUERY_STACK_MAX, count);
+				stack[stack_size++] = n.children[0];
+				stack[stack_size++] = n.children[1];
+				continue;
+			}
+
+			const Element &e = _get_element(n.element);
+			if (!p_query(e.bounds)) {
+				continue;
+			}
+
+			p_result_array[count] = e.userdata;
+			if (p_subindex_array) {
+				p_subindex_array[count] = e.subindex;
+			}
+			count++;
+		}
+
+		return count;
+	}
+
+	struct BoundsQuery {
+		B bounds;
+		_FORCE_INLINE_ bool operator()(const B &p_bounds) const { return _overlaps(p_bounds, bounds); }
+	};
+
+	struct SegmentQuery {
+		V from;
+		V to;
+		_FORCE_INLINE_ bool operator()(const B &p_bounds) const { return p_bounds.intersects_segment(from, to); }
+	};
+
+	struct PointQuery {
+		V point;
+		_FORCE_INLINE_ bool operator()(const B &p_bounds) const { return p_bounds.has_point(point); }
+	};
+
+public:
+	ID create(T *p_userdata, int p_subindex = 0, uint32_t p_pairable_type = 0, uint32_t p_pairable_mask = 0) {
+		ID id;
+		if (free_elements.size()) {
+			id = free_elements[free_elements.size() - 1];
+			free_elements.resize(free_elements.size() - 1);
+		} else {
+			elements.push_back(Element());
+			id = elements.size();
+		}
+
+		Element &e = _get_element(id);
+		e.userdata = p_userdata;
+		e.subindex = p_subindex;
+		e.bounds = B();
+		e.leaf = NODE_NULL;
+		e.used = true;
+		e.pairable_type = p_pairable_type;
+		e.pairable_mask = p_pairable_mask;
+		e.pairs.clear();
+		return id;
+	}
+
+	// Elements with empty bounds are kept out of the tree.
+	void move(ID p_id, const B &p_bounds) {
+		ERR_FAIL_COND(p_id == DYNAMIC_BVH_ELEMENT_INVALID_ID || p_id > elements.size());
+		Element &e = _get_element(p_id);
+		ERR_FAIL_COND(!e.used);
+
+		e.bounds = p_bounds;
+
+		if (e.leaf != NODE_NULL && nodes[e.leaf].bounds.encloses(p_bounds)) {
+			_check_pairs(p_id);
+			return;
+		}
+
+		if (e.leaf != NODE_NULL) {
+			_remove_leaf(e.leaf);
+			_free_node(e.leaf);
+			e.leaf = NODE_NULL;
+		}
+
+		if (p_bounds == B()) {
+			_remove_all_pairs(p_id);
+			return;
+		}
+
+		int leaf = _alloc_node();
+		nodes[leaf].bounds = p_bounds.grow(margin);
+		nodes[leaf].element = p_id;
+		_insert_leaf(leaf);
+		e.leaf = leaf;
+
+		_find_new_pairs(p_id);
+		_check_pairs(p_id);
+	}
+
+	void set_pairable(ID p_id, uint32_t p_pairable_type, uint32_t p_pairable_mask) {
+		ERR_FAIL_COND(p_id == DYNAMIC_BVH_ELEMENT_INVALID_ID || p_id > elements.size());
+		Element &e = _get_element(p_id);
+		ERR_FAIL_COND(!e.used);
+
+		if (e.pairable_type == p_pairable_type && e.pairable_mask == p_pairable_mask) {
+			return;
+		}
+
+		_remove_all_pairs(p_id);
+		e.pairable_type = p_pairable_type;
+		e.pairable_mask = p_pairable_mask;
+
+		if (e.leaf != NODE_NULL) {
+			_find_new_pairs(p_id);
+			_check_pairs(p_id);
+		}
+	}
+
+	void erase(ID p_id) {
+		ERR_FAIL_COND(p_id == DYNAMIC_BVH_ELEMENT_INVALID_ID || p_id > elements.size());
+		Element &e = _get_element(p_id);
+		ERR_FAIL_COND(!e.used);
+
+		_remove_all_pairs(p_id);
+
+		if (e.leaf != NODE_NULL) {
+			_remove_leaf(e.leaf);
+			_free_node(e.leaf);
+		}
+
+		e = Element();
+		free_elements.push_back(p_id);
+	}
+
+	_FORCE_INLINE_ T *get(ID p_id) const {
+		ERR_FAIL_COND_V(p_id == DYNAMIC_BVH_ELEMENT_INVALID_ID || p_id > elements.size(), nullptr);
+		return _get_element(p_id).userdata;
+	}
+	_FORCE_INLINE_ int get_subindex(ID p_id) const {
+		ERR_FAIL_COND_V(p_id == DYNAMIC_BVH_ELEMENT_INVALID_ID || p_id > elements.size(), -1);
+		return _get_element(p_id).subindex;
+	}
+	_FORCE_INLINE_ uint32_t get_pairable_mask(ID p_id) const {
+		ERR_FAIL_COND_V(p_id == DYNAMIC_BVH_ELEMENT_INVALID_ID || p_id > elements.size(), 0);
+		return _get_element(p_id).pairable_mask;
+	}
+
+	int cull_aabb(const B &p_bounds, T **p_result_array, int p_result_max, int *p_subindex_array = nullptr) const {
+		BoundsQuery q;
+		q.bounds = p_bounds;
+		return _cull(q, p_result_array, p_result_max, p_subindex_array);
+	}
+
+	int cull_segment(const V &p_from, const V &p_to, T **p_result_array, int p_result_max, int *p_subindex_array = nullptr) const {
+		SegmentQuery q;
+		q.from = p_from;
+		q.to = p_to;
+		return _cull(q, p_result_array, p_result_max, p_subindex_array);
+	}
+
+	int cull_point(const V &p_point, T **p_result_array, int p_result_max, int *p_subindex_array = nullptr) const {
+		PointQuery q;
+		q.point = p_point;
+		return _cull(q, p_result_array, p_result_max, p_subindex_array);
+	}
+
+	// Bounds are grown by this amount when (re)inserted into the tree.
+	void set_margin(real_t p_margin) { margin = p_margin; }
+	real_t get_margin() const { return margin; }
+
+	void set_pair_callback(PairCallback p_callback, void *p_userdata) {
+		pair_callback = p_callback;
+		pair_callback_userdata = p_userdata;
+	}
+	void set_unpair_callback(UnpairCallback p_callback, void *p_userdata) {
+		unpair_callback = p_callback;
+		pair_callback_userdata = p_userdata;
+	}
+
+	int get_pair_count() const { return pair_count; }
+	int get_height() const { return root == NODE_NULL ? 0 : nodes[root].height; }
+};
+
+#endif // DYNAMIC_BVH_H
@@ -36,10 +36,153 @@
 
 MessageQueue *MessageQueue::singleton = nullptr;
 
+static uint32_t last_message_queue_instance_id = 0;
+
+// Points the calling thread to its buffer, and hands the buffer back when
+// the thread exits.
+struct MessageQueueThreadBufferHandle {
+	MessageQueue::ThreadBuffer *buffer = nullptr;
+	uint32_t queue_id = 0;
+
+	~MessageQueueThreadBufferHandle() {
+		MessageQueue *queue = MessageQueue::singleton;
+		if (buffer && queue && queue->instance_id == queue_id) {
+			buffer->orphaned.store(true, std::memory_order_release);
+		}
+	}
+};
+
+static thread_local MessageQueueThreadBufferHandle thread_buffer_handle;
+
 MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
+MessageQueue::Page *MessageQueue::_alloc_page(uint32_t p_capacity) {
+	Page *page = (Page *)memalloc(sizeof(Page) + p_capacity);
+	memnew_placement(page, Page);
+	page->capacity = p_capacity;
+	page_count.fetch_add(1, std::memory_order_relaxed);
+	return page;
+}
+
+void MessageQueue::_free_page(Page *p_page) {
+	p_page->~Page();
+	memfree(p_page);
+	page_count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+MessageQueue::ThreadBuffer *MessageQueue::_get_thread_buffer() {
+	MessageQueueThreadBufferHandle &handle = thread_buffer_handle;
+	if (likely(handle.buffer && handle.queue_id == instance_id)) {
+		return handle.buffer;
+	}
+
+	MutexLock lock(buffers_mutex);
+
+	// Take over the buffer of a thread that exited, with its pending messages.
+	ThreadBuffer *buffer = nullptr;
+	for (uint32_t i = 0; i < buffers.size(); i++) {
+		bool orphaned = true;
+		if (buffers[i]->orphaned.compare_exchange_strong(orphaned, false, std::memory_order_acq_rel)) {
+			buffer = buffers[i];
+			break;
+		}
+	}
+
+	if (!buffer) {
+		buffer = memnew(ThreadBuffer);
+		buffer->write_page = _alloc_page(page_size);
+		buffer->read_page = buffer->write_page;
+		buffers.push_back(buffer);
+	}
+
+	handle.buffer = buffer;
+	handle.queue_id = instance_id;
+	return buffer;
+}
+
+uint8_t *MessageQueue::_reserve(ThreadBuffer *p_buffer, uint32_t p_size) {
+	Page *page = p_buffer->write_page;
+	uint32_t used = page->used.load(std::memory_order_relaxed);
+
+	if (unlikely(used + p_size > page->capacity)) {
+		// Chain a new page, the flushing thread moves to it when done with this one.
+		Page *new_page = nullptr;
+		if (p_size <= page_size) {
+			new_page = p_buffer->spare_page.exchange(nullptr, std::memory_order_acquire);
+		}
+		if (new_page) {
+			new_page->used.store(0, std::memory_order_relaxed);
+			new_page->next.store(nullptr, std::memory_order_relaxed);
+		} else {
+			new_page = _alloc_page(MAX(page_size, p_size));
+		}
+
+		page->next.store(new_page, std::memory_order_release);
+		p_buffer->write_page = new_page;
+		page = new_page;
+		used = 0;
+	}
+
+	return page->get_data() + used;
+}
+
+void MessageQueue::_commit(ThreadBuffer *p_buffer, uint32_t p_size) {
+	// Only the owner thread writes these, no need for atomic increments.
+	Page *page = p_buffer->write_page;
+	page->used.store(page->used.load(std::memory_order_relaxed) + p_size, std::memory_order_release);
+	p_buffer->pushed_messages.store(p_buffer->pushed_messages.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	p_buffer->pushed_bytes.store(p_buffer->pushed_bytes.load(std::memory_order_relaxed) + p_size, std::memory_order_relaxed);
+}
+
+MessageQueue::Message *MessageQueue::_peek(ThreadBuffer *p_buffer) {
+	while (true) {
+		Page *page = p_buffer->read_page;
+		if (p_buffer->read_offset < page->used.load(std::memory_order_acquire)) {
+			return (Message *)(page->get_data() + p_buffer->read_offset);
+		}
+
+		Page *next = page->next.load(std::memory_order_acquire);
+		if (!next) {
+			return nullptr;
+		}
+		if (p_buffer->read_offset < page->used.load(std::memory_order_acquire)) {
+			// Written before the next page was chained.
+			continue;
+		}
+
+		// This page is done, keep it for reuse.
+		p_buffer->read_page = next;
+		p_buffer->read_offset = 0;
+		if (page->capacity == page_size) {
+			page = p_buffer->spare_page.exchange(page, std::memory_order_release);
+		}
+		if (page) {
+			_free_page(page);
+		}
+	}
+}
+
+uint32_t MessageQueue::_get_message_size(const Message *p_message) const {
+	uint32_t size = sizeof(Message);
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		size += sizeof(Variant) * p_message->args;
+	}
+	return size;
+}
+
+void MessageQueue::_destroy_message(Message *p_message) {
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int i = 0; i < p_message->args; i++) {
+			args[i].~Variant();
+		}
+	}
+
+	p_message->~Message();
+}
+
 Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
 	return push_callable(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
 }
@@ -60,55 +203,42 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, VARIANT
 }
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	_THREAD_SAFE_METHOD_
-
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id)) {
-			type = ObjectDB::get_instance(p_id)->get_class();
-		}
-		print_line("Failed set: " + type + ":" + p_prop + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
+	ThreadBuffer *buffer = _get_thread_buffer();
+	uint8_t *data = _reserve(buffer, room_needed);
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(data, Message);
 	msg->args = 1;
 	msg->callable = Callable(p_id, p_prop);
 	msg->type = TYPE_SET;
+	msg->order = message_order.fetch_add(1, std::memory_order_relaxed);
 
-	buffer_end += sizeof(Message);
-
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
+	Variant *v = memnew_placement(data + sizeof(Message), Variant);
 	*v = p_value;
 
+	_commit(buffer, room_needed);
+
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
+	uint32_t room_needed = sizeof(Message);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
+	ThreadBuffer *buffer = _get_thread_buffer();
+	uint8_t *data = _reserve(buffer, room_needed);
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(data, Message);
 
 	msg->type = TYPE_NOTIFICATION;
 	msg->callable = Callable(p_id, CoreStringNames::get_singleton()->notification); //name is meaningless but callable needs it
 	//msg->target;
 	msg->notification = p_notification;
+	msg->order = message_order.fetch_add(1, std::memory_order_relaxed);
 
-	buffer_end += sizeof(Message);
+	_commit(buffer, room_needed);
 
 	return OK;
 }
@@ -126,32 +256,28 @@ Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const V
 }
 
 Error MessageQueue::push_callable(const Callable &p_callable, const Variant **p_args, int p_argcount, bool p_show_error) {
-	_THREAD_SAFE_METHOD_
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
 
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
+	ThreadBuffer *buffer = _get_thread_buffer();
+	uint8_t *data = _reserve(buffer, room_needed);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed method: " + p_callable);
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
-
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(data, Message);
 	msg->args = p_argcount;
 	msg->callable = p_callable;
 	msg->type = TYPE_CALL;
 	if (p_show_error) {
 		msg->type |= FLAG_SHOW_ERROR;
 	}
+	msg->order = message_order.fetch_add(1, std::memory_order_relaxed);
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(data + sizeof(Message));
 	for (int i = 0; i < p_argcount; i++) {
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
+		Variant *v = memnew_placement(&args[i], Variant);
 		*v = *p_args[i];
 	}
 
+	_commit(buffer, room_needed);
+
 	return OK;
 }
 
@@ -175,56 +301,69 @@ void MessageQueue::statistics() {
 	Map<int, int> notify_count;
 	Map<Callable, int> call_count;
 	int null_count = 0;
+	uint64_t total_bytes = 0;
 
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
+	MutexLock lock(buffers_mutex);
 
-		Object *target = message->callable.get_object();
+	for (uint32_t i = 0; i < buffers.size(); i++) {
+		ThreadBuffer *buffer = buffers[i];
+		total_bytes += buffer->pushed_bytes.load(std::memory_order_acquire) - buffer->flushed_bytes;
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					if (!call_count.has(message->callable)) {
-						call_count[message->callable] = 0;
-					}
+		// Walk the pending messages without consuming them.
+		Page *page = buffer->read_page;
+		uint32_t read_pos = buffer->read_offset;
+		while (page) {
+			uint32_t used = page->used.load(std::memory_order_acquire);
+			while (read_pos < used) {
+				Message *message = (Message *)(page->get_data() + read_pos);
 
-					call_count[message->callable]++;
+				Object *target = message->callable.get_object();
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					if (!notify_count.has(message->notification)) {
-						notify_count[message->notification] = 0;
-					}
+				if (target != nullptr) {
+					switch (message->type & FLAG_MASK) {
+						case TYPE_CALL: {
+							if (!call_count.has(message->callable)) {
+								call_count[message->callable] = 0;
+							}
 
-					notify_count[message->notification]++;
+							call_count[message->callable]++;
 
-				} break;
-				case TYPE_SET: {
-					StringName t = message->callable.get_method();
-					if (!set_count.has(t)) {
-						set_count[t] = 0;
-					}
+						} break;
+						case TYPE_NOTIFICATION: {
+							if (!notify_count.has(message->notification)) {
+								notify_count[message->notification] = 0;
+							}
 
-					set_count[t]++;
+							notify_count[message->notification]++;
 
-				} break;
-			}
+						} break;
+						case TYPE_SET: {
+							StringName t = message->callable.get_method();
+							if (!set_count.has(t)) {
+								set_count[t] = 0;
+							}
 
-		} else {
-			//object was deleted
-			print_line("Object was deleted while awaiting a callback");
+							set_count[t]++;
 
-			null_count++;
-		}
+						} break;
+					}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
+				} else {
+					//object was deleted
+					print_line("Object was deleted while awaiting a callback");
+
+					null_count++;
+				}
+
+				read_pos += _get_message_size(message);
+			}
+
+			page = page->next.load(std::memory_order_acquire);
+			read_pos = 0;
 		}
 	}
 
-	print_line("TOTAL BYTES: " + itos(buffer_end));
+	print_line("TOTAL BYTES: " + itos(total_bytes));
 	print_line("NULL count: " + itos(null_count));
 
 	for (Map<StringName, int>::Element *E = set_count.front(); E; E = E->next()) {
@@ -244,6 +383,22 @@ int MessageQueue::get_max_buffer_usage() const {
 	return buffer_max_used;
 }
 
+int MessageQueue::get_max_flush_message_count() const {
+	return max_flush_messages;
+}
+
+int MessageQueue::get_last_flush_message_count() const {
+	return last_flush_messages;
+}
+
+uint64_t MessageQueue::get_flushed_message_count() const {
+	return total_flushed_messages;
+}
+
+int MessageQueue::get_page_count() const {
+	return page_count.load(std::memory_order_relaxed);
+}
+
 void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error) {
 	const Variant **argptrs = nullptr;
 	if (p_argcount) {
@@ -262,35 +417,57 @@ void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_a
 }
 
 void MessageQueue::flush() {
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
-	}
+	bool was_flushing = false;
+	ERR_FAIL_COND(!flushing.compare_exchange_strong(was_flushing, true, std::memory_order_acquire)); //already flushing, you did something odd
 
-	uint32_t read_pos = 0;
-
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
-
-	if (flushing) {
-		_THREAD_SAFE_UNLOCK_
-		ERR_FAIL_COND(flushing); //already flushing, you did something odd
+	LocalVector<ThreadBuffer *> flush_buffers;
+	{
+		MutexLock lock(buffers_mutex);
+		flush_buffers = buffers;
 	}
-	flushing = true;
 
-	while (read_pos < buffer_end) {
-		//lock on each iteration, so a call can re-add itself to the message queue
+	uint64_t pending_bytes = 0;
+	uint64_t pending_messages = 0;
+	for (uint32_t i = 0; i < flush_buffers.size(); i++) {
+		pending_bytes += flush_buffers[i]->pushed_bytes.load(std::memory_order_acquire) - flush_buffers[i]->flushed_bytes;
+		pending_messages += flush_buffers[i]->pushed_messages.load(std::memory_order_acquire) - flush_buffers[i]->flushed_messages;
+	}
+	buffer_max_used = MAX(buffer_max_used, (uint32_t)pending_bytes);
+	max_flush_messages = MAX(max_flush_messages, (uint32_t)pending_messages);
+	if (pending_bytes > warn_size) {
+		WARN_PRINT_ONCE("The message queue holds " + itos(pending_bytes / 1024) + " KiB of deferred calls, more than 'memory/limits/message_queue/max_size_kb'. Something is flooding it.");
+	}
 
-		Message *message = (Message *)&buffer[read_pos];
+	uint32_t flushed = 0;
+
+	while (true) {
+		// Merge the thread buffers, always dispatching the oldest message.
+		// Calls can add messages while flushing, they are dispatched too.
+		ThreadBuffer *buffer = nullptr;
+		Message *message = nullptr;
+		for (uint32_t i = 0; i < flush_buffers.size(); i++) {
+			Message *candidate = _peek(flush_buffers[i]);
+			if (candidate && (!message || candidate->order < message->order)) {
+				buffer = flush_buffers[i];
+				message = candidate;
+			}
+		}
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			advance += sizeof(Variant) * message->args;
+		if (!message) {
+			// Threads that pushed for the first time meanwhile have new buffers.
+			MutexLock lock(buffers_mutex);
+			if (buffers.size() == flush_buffers.size()) {
+				break;
+			}
+			flush_buffers = buffers;
+			continue;
 		}
 
 		//pre-advance so this function is reentrant
-		read_pos += advance;
-
-		_THREAD_SAFE_UNLOCK_
+		uint32_t size = _get_message_size(message);
+		buffer->read_offset += size;
+		buffer->flushed_bytes += size;
+		buffer->flushed_messages++;
 
 		Object *target = message->callable.get_object();
 
@@ -318,57 +495,53 @@ void MessageQueue::flush() {
 			}
 		}
 
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int i = 0; i < message->args; i++) {
-				args[i].~Variant();
-			}
-		}
-
-		message->~Message();
-
-		_THREAD_SAFE_LOCK_
+		_destroy_message(message);
+		flushed++;
 	}
 
-	buffer_end = 0; // reset buffer
-	flushing = false;
-	_THREAD_SAFE_UNLOCK_
+	last_flush_messages = flushed;
+	total_flushed_messages += flushed;
+
+	flushing.store(false, std::memory_order_release);
 }
 
 bool MessageQueue::is_flushing() const {
-	return flushing;
+	return flushing.load(std::memory_order_acquire);
 }
 
-MessageQueue::MessageQueue() {
+MessageQueue::MessageQueue() :
+		message_order(0),
+		page_count(0),
+		flushing(false) {
 	ERR_FAIL_COND_MSG(singleton != nullptr, "A MessageQueue singleton already exists.");
 	singleton = this;
+	instance_id = ++last_message_queue_instance_id;
+
+	page_size = PAGE_SIZE_KB * 1024;
 
-	buffer_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
+	warn_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/message_queue/max_size_kb", PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater"));
-	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
+	warn_size *= 1024;
 }
 
 MessageQueue::~MessageQueue() {
-	uint32_t read_pos = 0;
-
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++) {
-				args[i].~Variant();
-			}
+	for (uint32_t i = 0; i < buffers.size(); i++) {
+		ThreadBuffer *buffer = buffers[i];
+
+		Message *message = _peek(buffer);
+		while (message) {
+			buffer->read_offset += _get_message_size(message);
+			_destroy_message(message);
+			message = _peek(buffer);
 		}
-		message->~Message();
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
+		_free_page(buffer->read_page);
+		Page *spare_page = buffer->spare_page.load(std::memory_order_acquire);
+		if (spare_page) {
+			_free_page(spare_page);
 		}
+		memdelete(buffer);
 	}
 
 	singleton = nullptr;
-	memdelete_arr(buffer);
 }
@@ -31,14 +31,15 @@
 #ifndef MESSAGE_QUEUE_H
 #define MESSAGE_QUEUE_H
 
+#include "core/local_vector.h"
 #include "core/object.h"
-#include "core/os/thread_safe.h"
+#include "core/os/mutex.h"
 
-class MessageQueue {
-	_THREAD_SAFE_CLASS_
+#include <atomic>
 
+class MessageQueue {
 	enum {
-
+		PAGE_SIZE_KB = 64,
 		DEFAULT_QUEUE_SIZE_KB = 1024
 	};
 
@@ -53,6 +54,7 @@ class MessageQueue {
 
 	struct Message {
 		Callable callable;
+		uint64_t order; // Global push order, used to merge the thread buffers.
 		int16_t type;
 		union {
 			int16_t notification;
@@ -60,16 +62,79 @@ class MessageQueue {
 		};
 	};
 
-	uint8_t *buffer;
-	uint32_t buffer_end = 0;
+	// Messages are written in pages, which are chained when full instead of
+	// failing. The data follows the header.
+	struct Page {
+		std::atomic<uint32_t> used;
+		uint32_t capacity;
+		std::atomic<Page *> next;
+
+		Page() :
+				used(0),
+				capacity(0),
+				next(nullptr) {}
+
+		_FORCE_INLINE_ uint8_t *get_data() { return (uint8_t *)(this + 1); }
+	};
+
+	// Each pushing thread owns one buffer, so pushing never locks. The owner
+	// thread appends, the flushing thread consumes from the other end.
+	struct ThreadBuffer {
+		// Producer side.
+		Page *write_page = nullptr;
+		std::atomic<uint64_t> pushed_messages;
+		std::atomic<uint64_t> pushed_bytes;
+
+		// Consumer side.
+		Page *read_page = nullptr;
+		uint32_t read_offset = 0;
+		uint64_t flushed_messages = 0;
+		uint64_t flushed_bytes = 0;
+
+		// A page kept for reuse, to avoid allocating every time one fills up.
+		std::atomic<Page *> spare_page;
+
+		// The owner thread exited, the buffer can be taken by a new thread.
+		std::atomic<bool> orphaned;
+
+		ThreadBuffer() :
+				pushed_messages(0),
+				pushed_bytes(0),
+				spare_page(nullptr),
+				orphaned(false) {}
+	};
+
+	Mutex buffers_mutex;
+	LocalVector<ThreadBuffer *> buffers;
+
+	std::atomic<uint64_t> message_order;
+	std::atomic<uint32_t> page_count;
+
+	uint32_t page_size;
+	uint32_t warn_size;
+	uint32_t instance_id;
+
 	uint32_t buffer_max_used = 0;
-	uint32_t buffer_size;
+	uint32_t max_flush_messages = 0;
+	uint32_t last_flush_messages = 0;
+	uint64_t total_flushed_messages = 0;
+
+	Page *_alloc_page(uint32_t p_capacity);
+	void _free_page(Page *p_page);
+	ThreadBuffer *_get_thread_buffer();
+	uint8_t *_reserve(ThreadBuffer *p_buffer, uint32_t p_size);
+	void _commit(ThreadBuffer *p_buffer, uint32_t p_size);
+	Message *_peek(ThreadBuffer *p_buffer);
+	uint32_t _get_message_size(const Message *p_message) const;
+	void _destroy_message(Message *p_message);
 
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	static MessageQueue *singleton;
 
-	bool flushing = false;
+	std::atomic<bool> flushing;
+
+	friend struct MessageQueueThreadBufferHandle;
 
 public:
 	static MessageQueue *get_singleton();
@@ -90,7 +155,15 @@ public:
 
 	bool is_flushing() const;
 
+	// High-water marks, of the pending bytes and messages when flushing.
 	int get_max_buffer_usage() const;
+	int get_max_flush_message_count() const;
+
+	// Throughput, the messages dispatched by the last flush and since start.
+	int get_last_flush_message_count() const;
+	uint64_t get_flushed_message_count() const;
+
+	int get_page_count() const;
 
 	MessageQueue();
 	~MessageQueue();
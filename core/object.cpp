@@ -895,6 +895,13 @@ Variant Object::call(const StringName &p_method, const Variant **p_args, int p_a
 	return ret;
 }
 
+Variant Object::call_method_bind(MethodBind *p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+	r_error.error = Callable::CallError::CALL_OK;
+
+	OBJ_DEBUG_LOCK
+	return p_method->call(this, p_args, p_argcount, r_error);
+}
+
 void Object::notification(int p_notification, bool p_reversed) {
 	_notificationv(p_notification, p_reversed);
 
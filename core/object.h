@@ -399,6 +399,7 @@ public:                                                        \
                                                                \
 private:
 
+class MethodBind;
 class ScriptInstance;
 
 class Object {
@@ -654,6 +655,7 @@ public:
 	void get_method_list(List<MethodInfo> *p_list) const;
 	Variant callv(const StringName &p_method, const Array &p_args);
 	virtual Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error);
+	Variant call_method_bind(MethodBind *p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error); // Skips the script and ClassDB lookups, for callers caching the bind.
 	virtual void call_multilevel(const StringName &p_method, const Variant **p_args, int p_argcount);
 	virtual void call_multilevel_reversed(const StringName &p_method, const Variant **p_args, int p_argcount);
 	Variant call(const StringName &p_name, VARIANT_ARG_LIST); // C++ helper
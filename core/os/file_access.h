@@ -111,6 +111,8 @@ public:
 	virtual real_t get_real() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const; ///< get an array of bytes
+	virtual const uint8_t *get_buffer_view(int p_length) const { return nullptr; } ///< point at the next p_length bytes without copying, nullptr if not in memory (use get_buffer)
+	virtual const uint8_t *map_read_only() { return nullptr; } ///< map the whole file for reading, nullptr if unsupported; valid until close()
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
@@ -32,13 +32,22 @@
 
 #include "core/error_macros.h"
 #include "core/os/copymem.h"
+#include "core/os/small_allocator.h"
 #include "core/safe_refcount.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <atomic>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define MEMORY_CALLER_ADDRESS() _ReturnAddress()
+#else
+#define MEMORY_CALLER_ADDRESS() __builtin_return_address(0)
+#endif
 
 void *operator new(size_t p_size, const char *p_description) {
-	return Memory::alloc_static(p_size, false);
+	return Memory::_alloc_static(p_size, false, MEMORY_CALLER_ADDRESS());
 }
 
 void *operator new(size_t p_size, void *(*p_allocfunc)(size_t p_size)) {
@@ -66,14 +75,203 @@ uint64_t Memory::max_usage = 0;
 
 uint64_t Memory::alloc_count = 0;
 
+#ifdef MEMORY_ACCOUNTING_ENABLED
+
+// The tag of an allocation is kept in the top byte of its size header.
+#define MEMORY_TAG_SHIFT 56
+#define MEMORY_SIZE_MASK ((uint64_t(1) << MEMORY_TAG_SHIFT) - 1)
+
+thread_local Memory::Tag Memory::current_tag = Memory::TAG_UNTAGGED;
+
+// Counters of a single thread. Only their thread writes them, so updates are
+// a plain load and store. Frees on another thread than the allocation just
+// make that thread's counters go negative. Blocks are never released: a new
+// thread adopts the block of one that exited, and totals are the sum over
+// all blocks.
+struct MemoryThreadCounters {
+	std::atomic<int64_t> usage[Memory::TAG_MAX] = {};
+	std::atomic<int64_t> count[Memory::TAG_MAX] = {};
+	int64_t until_sample = 0;
+	std::atomic<bool> orphaned = { false };
+	MemoryThreadCounters *next = nullptr;
+};
+
+// Shared by threads that allocate or free while being torn down, after their
+// own block was handed back.
+static MemoryThreadCounters exiting_thread_counters;
+static std::atomic<MemoryThreadCounters *> thread_counters_list = { &exiting_thread_counters };
+
+static thread_local MemoryThreadCounters *thread_counters = nullptr;
+static thread_local bool thread_counters_released = false;
+
+struct MemoryThreadCountersHandle {
+	bool acquired = false;
+
+	~MemoryThreadCountersHandle() {
+		if (thread_counters) {
+			thread_counters->orphaned.store(true, std::memory_order_release);
+			thread_counters = nullptr;
+		}
+		thread_counters_released = true;
+	}
+};
+
+static thread_local MemoryThreadCountersHandle thread_counters_handle;
+
+static MemoryThreadCounters *_acquire_thread_counters() {
+	if (thread_counters_released) {
+		return &exiting_thread_counters;
+	}
+
+	MemoryThreadCounters *counters = nullptr;
+	for (MemoryThreadCounters *E = thread_counters_list.load(std::memory_order_acquire); E; E = E->next) {
+		bool orphaned = true;
+		if (E->orphaned.compare_exchange_strong(orphaned, false, std::memory_order_acq_rel)) {
+			counters = E;
+			break;
+		}
+	}
+
+	if (!counters) {
+		// Not through Memory, which would recurse into here.
+		counters = (MemoryThreadCounters *)malloc(sizeof(MemoryThreadCounters));
+		CRASH_COND_MSG(!counters, "Out of memory");
+		memnew_placement(counters, MemoryThreadCounters);
+		counters->next = thread_counters_list.load(std::memory_order_relaxed);
+		while (!thread_counters_list.compare_exchange_weak(counters->next, counters, std::memory_order_release, std::memory_order_relaxed)) {
+		}
+	}
+
+	thread_counters_handle.acquired = true; // Makes sure the handle is released when the thread exits.
+	thread_counters = counters;
+	return counters;
+}
+
+static _FORCE_INLINE_ void _add_to_counter(std::atomic<int64_t> &r_counter, int64_t p_delta, bool p_shared) {
+	if (unlikely(p_shared)) {
+		r_counter.fetch_add(p_delta, std::memory_order_relaxed);
+	} else {
+		r_counter.store(r_counter.load(std::memory_order_relaxed) + p_delta, std::memory_order_relaxed);
+	}
+}
+
+// Sampled allocation sites, keyed by site address and tag (in the top byte),
+// in a fixed open addressing table so recording never allocates.
+struct MemorySampleSlot {
+	std::atomic<uint64_t> key;
+	std::atomic<uint64_t> samples;
+};
+
+static MemorySampleSlot sample_slots[Memory::ALLOCATION_SITES_MAX];
+static std::atomic<uint64_t> samples_dropped = { 0 };
+static std::atomic<uint64_t> sample_interval = { 0 };
+
+static void _record_samples(const void *p_site, Memory::Tag p_tag, uint64_t p_samples) {
+	uint64_t key = (uint64_t(uintptr_t(p_site)) & MEMORY_SIZE_MASK) | (uint64_t(p_tag) << MEMORY_TAG_SHIFT);
+	if (key == 0) {
+		key = 1;
+	}
+	uint32_t hash = uint32_t((key * 0x9E3779B97F4A7C15ULL) >> 32);
+
+	for (uint32_t i = 0; i < 64; i++) {
+		MemorySampleSlot &slot = sample_slots[(hash + i) & (Memory::ALLOCATION_SITES_MAX - 1)];
+		uint64_t current = slot.key.load(std::memory_order_acquire);
+		if (current == 0 && slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+			current = key;
+		}
+		if (current == key) {
+			slot.samples.fetch_add(p_samples, std::memory_order_relaxed);
+			return;
+		}
+	}
+
+	samples_dropped.fetch_add(p_samples, std::memory_order_relaxed);
+}
+
+void Memory::_account(Tag p_tag, int64_t p_bytes, int64_t p_count, const void *p_site) {
+	MemoryThreadCounters *counters = thread_counters;
+	if (unlikely(!counters)) {
+		counters = _acquire_thread_counters();
+	}
+	bool shared = counters == &exiting_thread_counters;
+
+	_add_to_counter(counters->usage[p_tag], p_bytes, shared);
+	if (p_count) {
+		_add_to_counter(counters->count[p_tag], p_count, shared);
+	}
+
+	uint64_t interval = sample_interval.load(std::memory_order_relaxed);
+	if (unlikely(interval) && p_bytes > 0 && !shared) {
+		counters->until_sample -= p_bytes;
+		if (counters->until_sample <= 0) {
+			// An allocation larger than the interval counts as several samples.
+			uint64_t samples = uint64_t(-counters->until_sample) / interval + 1;
+			counters->until_sample += samples * interval;
+			_record_samples(p_site, p_tag, samples);
+		}
+	}
+}
+
+#endif // MEMORY_ACCOUNTING_ENABLED
+
+// System allocator calls, with small blocks served by SmallAllocator when enabled.
+
+static _FORCE_INLINE_ void *_system_alloc(size_t p_bytes) {
+#ifdef SMALL_ALLOCATOR_ENABLED
+	if (p_bytes <= SmallAllocator::MAX_SIZE) {
+		void *mem = SmallAllocator::alloc(p_bytes);
+		if (mem) {
+			return mem;
+		}
+	}
+#endif
+	return malloc(p_bytes);
+}
+
+static _FORCE_INLINE_ void _system_free(void *p_mem) {
+#ifdef SMALL_ALLOCATOR_ENABLED
+	if (SmallAllocator::owns(p_mem)) {
+		SmallAllocator::free(p_mem);
+		return;
+	}
+#endif
+	free(p_mem);
+}
+
+static void *_system_realloc(void *p_mem, size_t p_bytes) {
+#ifdef SMALL_ALLOCATOR_ENABLED
+	if (SmallAllocator::owns(p_mem)) {
+		if (p_bytes == 0) {
+			SmallAllocator::free(p_mem);
+			return nullptr;
+		}
+		size_t block_size = SmallAllocator::get_block_size(p_mem);
+		if (p_bytes <= block_size) {
+			return p_mem;
+		}
+		void *mem = _system_alloc(p_bytes);
+		if (mem) {
+			memcpy(mem, p_mem, block_size);
+			SmallAllocator::free(p_mem);
+		}
+		return mem;
+	}
+#endif
+	return realloc(p_mem, p_bytes);
+}
+
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
-#ifdef DEBUG_ENABLED
+	return _alloc_static(p_bytes, p_pad_align, MEMORY_CALLER_ADDRESS());
+}
+
+void *Memory::_alloc_static(size_t p_bytes, bool p_pad_align, const void *p_site) {
+#ifdef MEMORY_ACCOUNTING_ENABLED
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
 #endif
 
-	void *mem = malloc(p_bytes + (prepad ? PAD_ALIGN : 0));
+	void *mem = _system_alloc(p_bytes + (prepad ? PAD_ALIGN : 0));
 
 	ERR_FAIL_COND_V(!mem, nullptr);
 
@@ -85,6 +283,12 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 
 		uint8_t *s8 = (uint8_t *)mem;
 
+#ifdef MEMORY_ACCOUNTING_ENABLED
+		Tag tag = current_tag;
+		*s |= uint64_t(tag) << MEMORY_TAG_SHIFT;
+		_account(tag, p_bytes, 1, p_site);
+#endif
+
 #ifdef DEBUG_ENABLED
 		atomic_add(&mem_usage, p_bytes);
 		atomic_exchange_if_greater(&max_usage, mem_usage);
@@ -97,12 +301,12 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 
 void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 	if (p_memory == nullptr) {
-		return alloc_static(p_bytes, p_pad_align);
+		return _alloc_static(p_bytes, p_pad_align, MEMORY_CALLER_ADDRESS());
 	}
 
 	uint8_t *mem = (uint8_t *)p_memory;
 
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_ACCOUNTING_ENABLED
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -112,32 +316,47 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 		mem -= PAD_ALIGN;
 		uint64_t *s = (uint64_t *)mem;
 
+#ifdef MEMORY_ACCOUNTING_ENABLED
+		uint64_t old_bytes = *s & MEMORY_SIZE_MASK;
+		Tag tag = Tag(*s >> MEMORY_TAG_SHIFT);
+#endif
+
 #ifdef DEBUG_ENABLED
-		if (p_bytes > *s) {
-			atomic_add(&mem_usage, p_bytes - *s);
+		if (p_bytes > old_bytes) {
+			atomic_add(&mem_usage, p_bytes - old_bytes);
 			atomic_exchange_if_greater(&max_usage, mem_usage);
 		} else {
-			atomic_sub(&mem_usage, *s - p_bytes);
+			atomic_sub(&mem_usage, old_bytes - p_bytes);
 		}
 #endif
 
 		if (p_bytes == 0) {
-			free(mem);
+#ifdef MEMORY_ACCOUNTING_ENABLED
+			_account(tag, -int64_t(old_bytes), -1, nullptr);
+#endif
+			_system_free(mem);
 			return nullptr;
 		} else {
+#ifdef MEMORY_ACCOUNTING_ENABLED
+			_account(tag, int64_t(p_bytes) - int64_t(old_bytes), 0, MEMORY_CALLER_ADDRESS());
+#endif
+
 			*s = p_bytes;
 
-			mem = (uint8_t *)realloc(mem, p_bytes + PAD_ALIGN);
+			mem = (uint8_t *)_system_realloc(mem, p_bytes + PAD_ALIGN);
 			ERR_FAIL_COND_V(!mem, nullptr);
 
 			s = (uint64_t *)mem;
 
 			*s = p_bytes;
+#ifdef MEMORY_ACCOUNTING_ENABLED
+			*s |= uint64_t(tag) << MEMORY_TAG_SHIFT;
+#endif
 
 			return mem + PAD_ALIGN;
 		}
 	} else {
-		mem = (uint8_t *)realloc(mem, p_bytes);
+		mem = (uint8_t *)_system_realloc(mem, p_bytes);
 
 		ERR_FAIL_COND_V(mem == nullptr && p_bytes > 0, nullptr);
 
@@ -150,7 +369,7 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_ptr;
 
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_ACCOUNTING_ENABLED
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -161,14 +380,19 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 	if (prepad) {
 		mem -= PAD_ALIGN;
 
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_ACCOUNTING_ENABLED
 		uint64_t *s = (uint64_t *)mem;
-		atomic_sub(&mem_usage, *s);
+		uint64_t bytes = *s & MEMORY_SIZE_MASK;
+		_account(Tag(*s >> MEMORY_TAG_SHIFT), -int64_t(bytes), -1, nullptr);
+#endif
+
+#ifdef DEBUG_ENABLED
+		atomic_sub(&mem_usage, bytes);
 #endif
 
-		free(mem);
+		_system_free(mem);
 	} else {
-		free(mem);
+		_system_free(mem);
 	}
 }
 
@@ -176,9 +400,24 @@ uint64_t Memory::get_mem_available() {
 	return -1; // 0xFFFF...
 }
 
+#if defined(MEMORY_ACCOUNTING_ENABLED) && !defined(DEBUG_ENABLED)
+// Without the global counters of debug builds, the peak is only as precise
+// as how often usage is queried.
+static std::atomic<uint64_t> sampled_max_usage = { 0 };
+#endif
+
 uint64_t Memory::get_mem_usage() {
 #ifdef DEBUG_ENABLED
 	return mem_usage;
+#elif defined(MEMORY_ACCOUNTING_ENABLED)
+	uint64_t usage = 0;
+	for (int i = 0; i < TAG_MAX; i++) {
+		usage += get_tag_usage(Tag(i));
+	}
+	uint64_t max = sampled_max_usage.load(std::memory_order_relaxed);
+	while (usage > max && !sampled_max_usage.compare_exchange_weak(max, usage, std::memory_order_relaxed)) {
+	}
+	return usage;
 #else
 	return 0;
 #endif
@@ -187,11 +426,105 @@ uint64_t Memory::get_mem_usage() {
 uint64_t Memory::get_mem_max_usage() {
 #ifdef DEBUG_ENABLED
 	return max_usage;
+#elif defined(MEMORY_ACCOUNTING_ENABLED)
+	get_mem_usage();
+	return sampled_max_usage.load(std::memory_order_relaxed);
+#else
+	return 0;
+#endif
+}
+
+uint64_t Memory::get_tag_usage(Tag p_tag) {
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, 0);
+#ifdef MEMORY_ACCOUNTING_ENABLED
+	int64_t usage = 0;
+	for (MemoryThreadCounters *E = thread_counters_list.load(std::memory_order_acquire); E; E = E->next) {
+		usage += E->usage[p_tag].load(std::memory_order_relaxed);
+	}
+	return usage > 0 ? usage : 0; // Can be briefly off while other threads update.
 #else
 	return 0;
 #endif
 }
 
+uint64_t Memory::get_tag_alloc_count(Tag p_tag) {
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, 0);
+#ifdef MEMORY_ACCOUNTING_ENABLED
+	int64_t count = 0;
+	for (MemoryThreadCounters *E = thread_counters_list.load(std::memory_order_acquire); E; E = E->next) {
+		count += E->count[p_tag].load(std::memory_order_relaxed);
+	}
+	return count > 0 ? count : 0;
+#else
+	return 0;
+#endif
+}
+
+const char *Memory::get_tag_name(Tag p_tag) {
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, "");
+	static const char *names[TAG_MAX] = {
+		"untagged",
+		"renderer",
+		"physics",
+		"scripting",
+		"resources",
+		"audio",
+	};
+	return names[p_tag];
+}
+
+void Memory::set_sample_interval(uint64_t p_bytes) {
+#ifdef MEMORY_ACCOUNTING_ENABLED
+	sample_interval.store(p_bytes, std::memory_order_relaxed);
+#else
+	ERR_FAIL_COND_MSG(p_bytes, "Allocation sampling requires a debug build, or a build with memory_accounting=yes.");
+#endif
+}
+
+uint64_t Memory::get_sample_interval() {
+#ifdef MEMORY_ACCOUNTING_ENABLED
+	return sample_interval.load(std::memory_order_relaxed);
+#else
+	return 0;
+#endif
+}
+
+int Memory::get_allocation_samples(AllocationSample *r_samples, int p_max) {
+	int count = 0;
+#ifdef MEMORY_ACCOUNTING_ENABLED
+	for (int i = 0; i < ALLOCATION_SITES_MAX && count < p_max; i++) {
+		uint64_t key = sample_slots[i].key.load(std::memory_order_acquire);
+		uint64_t samples = sample_slots[i].samples.load(std::memory_order_relaxed);
+		if (key == 0 || samples == 0) {
+			continue;
+		}
+		r_samples[count].site = (const void *)uintptr_t(key & MEMORY_SIZE_MASK);
+		r_samples[count].tag = Tag(key >> MEMORY_TAG_SHIFT);
+		r_samples[count].samples = samples;
+		count++;
+	}
+
+	// Samples that found no free slot are reported without a site.
+	uint64_t dropped = samples_dropped.load(std::memory_order_relaxed);
+	if (dropped && count < p_max) {
+		r_samples[count].site = nullptr;
+		r_samples[count].tag = TAG_UNTAGGED;
+		r_samples[count].samples = dropped;
+		count++;
+	}
+#endif
+	return count;
+}
+
+void Memory::clear_allocation_samples() {
+#ifdef MEMORY_ACCOUNTING_ENABLED
+	for (int i = 0; i < ALLOCATION_SITES_MAX; i++) {
+		sample_slots[i].samples.store(0, std::memory_order_relaxed);
+	}
+	samples_dropped.store(0, std::memory_order_relaxed);
+#endif
+}
+
 _GlobalNil::_GlobalNil() {
 	left = this;
 	right = this;
@@ -40,6 +40,13 @@
 #define PAD_ALIGN 16 //must always be greater than this at much
 #endif
 
+// Debug builds always keep a size header in front of allocations, so they can
+// account for memory at no extra cost. Release builds opt in with the
+// "memory_accounting" build option.
+#if defined(DEBUG_ENABLED) && !defined(MEMORY_ACCOUNTING_ENABLED)
+#define MEMORY_ACCOUNTING_ENABLED
+#endif
+
 class Memory {
 	Memory();
 #ifdef DEBUG_ENABLED
@@ -49,14 +56,78 @@ class Memory {
 
 	static uint64_t alloc_count;
 
+public:
+	// Subsystems allocations are attributed to, see MemoryTagScope.
+	enum Tag {
+		TAG_UNTAGGED,
+		TAG_RENDERER,
+		TAG_PHYSICS,
+		TAG_SCRIPTING,
+		TAG_RESOURCES,
+		TAG_AUDIO,
+		TAG_MAX
+	};
+
+	struct AllocationSample {
+		const void *site = nullptr; // Return address of the allocating call.
+		Tag tag = TAG_UNTAGGED;
+		uint64_t samples = 0;
+	};
+
+	enum {
+		ALLOCATION_SITES_MAX = 4096,
+	};
+
+private:
+#ifdef MEMORY_ACCOUNTING_ENABLED
+	friend class MemoryTagScope;
+	static thread_local Tag current_tag;
+
+	static void _account(Tag p_tag, int64_t p_bytes, int64_t p_count, const void *p_site);
+#endif
+
 public:
 	static void *alloc_static(size_t p_bytes, bool p_pad_align = false);
+	static void *_alloc_static(size_t p_bytes, bool p_pad_align, const void *p_site); ///< p_site is the caller the allocation is attributed to when sampled
 	static void *realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align = false);
 	static void free_static(void *p_ptr, bool p_pad_align = false);
 
 	static uint64_t get_mem_available();
 	static uint64_t get_mem_usage();
 	static uint64_t get_mem_max_usage();
+
+	// Bytes and allocations currently live per tag, summed over all threads.
+	// Always 0 unless MEMORY_ACCOUNTING_ENABLED.
+	static uint64_t get_tag_usage(Tag p_tag);
+	static uint64_t get_tag_alloc_count(Tag p_tag);
+	static const char *get_tag_name(Tag p_tag);
+
+	// Allocation site profiler. Takes one sample every p_bytes allocated on
+	// each thread (0 disables it), so a site's samples times the interval
+	// estimates the bytes it allocated.
+	static void set_sample_interval(uint64_t p_bytes);
+	static uint64_t get_sample_interval();
+	static int get_allocation_samples(AllocationSample *r_samples, int p_max);
+	static void clear_allocation_samples();
+};
+
+// Attributes the allocations made by the current thread to p_tag while in scope.
+class MemoryTagScope {
+#ifdef MEMORY_ACCOUNTING_ENABLED
+	Memory::Tag previous;
+
+public:
+	_FORCE_INLINE_ explicit MemoryTagScope(Memory::Tag p_tag) {
+		previous = Memory::current_tag;
+		Memory::current_tag = p_tag;
+	}
+	_FORCE_INLINE_ ~MemoryTagScope() {
+		Memory::current_tag = previous;
+	}
+#else
+public:
+	_FORCE_INLINE_ explicit MemoryTagScope(Memory::Tag p_tag) {}
+#endif
 };
 
 class DefaultAllocator {
@@ -170,8 +170,39 @@ bool OS::is_stdout_verbose() const {
 	return _verbose_stdout;
 }
 
+struct _OSAllocationSampleSort {
+	_FORCE_INLINE_ bool operator()(const Memory::AllocationSample &p_a, const Memory::AllocationSample &p_b) const {
+		return p_a.samples > p_b.samples;
+	}
+};
+
 void OS::dump_memory_to_file(const char *p_file) {
-	//Memory::dump_static_mem_to_file(p_file);
+	Error err;
+	FileAccessRef f = FileAccess::open(String::utf8(p_file), FileAccess::WRITE, &err);
+	ERR_FAIL_COND_MSG(err != OK, "Can't dump memory to file: " + String::utf8(p_file) + ".");
+
+	f->store_line("# Memory usage per tag: tag, bytes, allocations.");
+	for (int i = 0; i < Memory::TAG_MAX; i++) {
+		Memory::Tag tag = Memory::Tag(i);
+		f->store_line(String(Memory::get_tag_name(tag)) + " " + itos(Memory::get_tag_usage(tag)) + " " + itos(Memory::get_tag_alloc_count(tag)));
+	}
+
+	uint64_t interval = Memory::get_sample_interval();
+	Vector<Memory::AllocationSample> samples;
+	samples.resize(Memory::ALLOCATION_SITES_MAX);
+	samples.resize(Memory::get_allocation_samples(samples.ptrw(), samples.size()));
+	samples.sort_custom<_OSAllocationSampleSort>();
+
+	// Addresses are the callers of the allocator. Subtract the anchor and add
+	// the address of Memory::alloc_static in the binary's symbols to resolve
+	// them with address-to-line tools.
+	f->store_line("# Allocation samples, one per " + itos(interval) + " bytes allocated: site, tag, samples, estimated bytes.");
+	f->store_line("anchor 0x" + String::num_uint64((uint64_t)(uintptr_t)(void *)&Memory::alloc_static, 16));
+	for (int i = 0; i < samples.size(); i++) {
+		const Memory::AllocationSample &sample = samples[i];
+		String site = sample.site ? "0x" + String::num_uint64((uint64_t)(uintptr_t)sample.site, 16) : "unknown";
+		f->store_line(site + " " + Memory::get_tag_name(sample.tag) + " " + itos(sample.samples) + " " + itos(sample.samples * interval));
+	}
 }
 
 static FileAccess *_OSPRF = nullptr;
@@ -0,0 +1,290 @@
+/*************************************************************************/
+/*  small_allocator.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "small_allocator.h"
+
+#include "core/os/memory.h"
+#include "core/os/mutex.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <atomic>
+
+#define CHUNK_SIZE (64 * 1024)
+#define CHUNK_HEADER_SIZE 128
+#define CHUNKS_PER_REGION 16
+#define CHUNK_TABLE_SIZE (1 << 16)
+#define CLASS_COUNT 16
+
+static const uint32_t class_sizes[CLASS_COUNT] = { 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512 };
+
+// Size class for each 16 byte step up to MAX_SIZE.
+static const uint8_t size_classes[SmallAllocator::MAX_SIZE / 16 + 1] = { 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 12, 12, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15, 15, 15 };
+
+struct SmallAllocatorThreadCache;
+
+struct SmallAllocatorChunk {
+	// Only touched by the owner.
+	void *local_free = nullptr;
+	uint8_t *bump = nullptr; // Blocks from here on were never handed out.
+	uint8_t *end = nullptr;
+	SmallAllocatorThreadCache *owner = nullptr;
+	SmallAllocatorChunk *next = nullptr; // Next chunk of the owner in the same size class.
+	uint32_t block_size = 0;
+
+	// Pushed to by other threads, on its own cache line.
+	alignas(64) std::atomic<void *> remote_free = { nullptr };
+};
+
+static_assert(sizeof(SmallAllocatorChunk) <= CHUNK_HEADER_SIZE, "Chunk header must fit before the first block.");
+
+struct SmallAllocatorThreadCache {
+	SmallAllocatorChunk *current[CLASS_COUNT] = {};
+	SmallAllocatorChunk *chunks[CLASS_COUNT] = {};
+	std::atomic<bool> orphaned = { false };
+	SmallAllocatorThreadCache *next = nullptr;
+};
+
+// Chunk bases, so any pointer can be checked without touching memory the
+// allocator doesn't own. Only written under chunk_mutex, and never shrinks.
+static std::atomic<uintptr_t> chunk_table[CHUNK_TABLE_SIZE];
+static std::atomic<uint64_t> chunk_count = { 0 };
+
+// Constant initialized, so it works for allocations made during static init.
+static BinaryMutex chunk_mutex;
+static SmallAllocatorChunk *free_chunks = nullptr;
+
+static std::atomic<SmallAllocatorThreadCache *> thread_caches = { nullptr };
+static thread_local SmallAllocatorThreadCache *thread_cache = nullptr;
+static thread_local bool thread_cache_released = false;
+
+struct SmallAllocatorThreadCacheHandle {
+	bool acquired = false;
+
+	~SmallAllocatorThreadCacheHandle() {
+		if (thread_cache) {
+			thread_cache->orphaned.store(true, std::memory_order_release);
+			thread_cache = nullptr;
+		}
+		thread_cache_released = true;
+	}
+};
+
+static thread_local SmallAllocatorThreadCacheHandle thread_cache_handle;
+
+static _FORCE_INLINE_ uint32_t _chunk_hash(uintptr_t p_base) {
+	return uint32_t((uint64_t(p_base / CHUNK_SIZE) * 0x9E3779B97F4A7C15ULL) >> 32) & (CHUNK_TABLE_SIZE - 1);
+}
+
+// Carves a new region into chunks. Called with chunk_mutex held.
+static bool _add_region() {
+	// Stop at half the table, so lookups stay short.
+	if (chunk_count.load(std::memory_order_relaxed) + CHUNKS_PER_REGION > CHUNK_TABLE_SIZE / 2) {
+		return false;
+	}
+
+	uint8_t *region = (uint8_t *)malloc((CHUNKS_PER_REGION + 1) * CHUNK_SIZE);
+	if (!region) {
+		return false;
+	}
+
+	uint8_t *first = (uint8_t *)((uintptr_t(region) + CHUNK_SIZE - 1) & ~uintptr_t(CHUNK_SIZE - 1));
+	for (int i = 0; i < CHUNKS_PER_REGION; i++) {
+		uintptr_t base = uintptr_t(first + i * CHUNK_SIZE);
+		uint32_t slot = _chunk_hash(base);
+		while (chunk_table[slot].load(std::memory_order_relaxed) != 0) {
+			slot = (slot + 1) & (CHUNK_TABLE_SIZE - 1);
+		}
+		chunk_table[slot].store(base, std::memory_order_release);
+
+		SmallAllocatorChunk *chunk = (SmallAllocatorChunk *)base;
+		memnew_placement(chunk, SmallAllocatorChunk);
+		chunk->next = free_chunks;
+		free_chunks = chunk;
+	}
+	chunk_count.fetch_add(CHUNKS_PER_REGION, std::memory_order_relaxed);
+	return true;
+}
+
+static SmallAllocatorChunk *_acquire_chunk() {
+	MutexLock<BinaryMutex> lock(chunk_mutex);
+	if (!free_chunks && !_add_region()) {
+		return nullptr;
+	}
+	SmallAllocatorChunk *chunk = free_chunks;
+	free_chunks = chunk->next;
+	chunk->next = nullptr;
+	return chunk;
+}
+
+static SmallAllocatorThreadCache *_acquire_thread_cache() {
+	if (thread_cache_released) {
+		return nullptr; // Thread is exiting, let the system allocator handle it.
+	}
+
+	SmallAllocatorThreadCache *cache = nullptr;
+	for (SmallAllocatorThreadCache *E = thread_caches.load(std::memory_order_acquire); E; E = E->next) {
+		bool orphaned = true;
+		if (E->orphaned.compare_exchange_strong(orphaned, false, std::memory_order_acq_rel)) {
+			cache = E;
+			break;
+		}
+	}
+
+	if (!cache) {
+		cache = (SmallAllocatorThreadCache *)malloc(sizeof(SmallAllocatorThreadCache));
+		if (!cache) {
+			return nullptr;
+		}
+		memnew_placement(cache, SmallAllocatorThreadCache);
+		cache->next = thread_caches.load(std::memory_order_relaxed);
+		while (!thread_caches.compare_exchange_weak(cache->next, cache, std::memory_order_release, std::memory_order_relaxed)) {
+		}
+	}
+
+	thread_cache_handle.acquired = true; // Makes sure the handle is released when the thread exits.
+	thread_cache = cache;
+	return cache;
+}
+
+static _FORCE_INLINE_ void *_pop_local(SmallAllocatorChunk *p_chunk) {
+	void *block = p_chunk->local_free;
+	p_chunk->local_free = *(void **)block;
+	return block;
+}
+
+static void *_alloc_slow(SmallAllocatorThreadCache *p_cache, uint32_t p_class) {
+	// Blocks freed by other threads come first, then other chunks with free
+	// blocks, and only then a new chunk.
+	SmallAllocatorChunk *current = p_cache->current[p_class];
+	if (current && current->remote_free.load(std::memory_order_relaxed)) {
+		current->local_free = current->remote_free.exchange(nullptr, std::memory_order_acquire);
+		return _pop_local(current);
+	}
+
+	for (SmallAllocatorChunk *E = p_cache->chunks[p_class]; E; E = E->next) {
+		if (E == current) {
+			continue;
+		}
+		if (!E->local_free && E->remote_free.load(std::memory_order_relaxed)) {
+			E->local_free = E->remote_free.exchange(nullptr, std::memory_order_acquire);
+		}
+		if (E->local_free) {
+			p_cache->current[p_class] = E;
+			return _pop_local(E);
+		}
+	}
+
+	SmallAllocatorChunk *chunk = _acquire_chunk();
+	if (!chunk) {
+		return nullptr;
+	}
+
+	chunk->owner = p_cache;
+	chunk->block_size = class_sizes[p_class];
+	chunk->local_free = nullptr;
+	chunk->bump = (uint8_t *)chunk + CHUNK_HEADER_SIZE;
+	chunk->end = (uint8_t *)chunk + CHUNK_SIZE;
+	chunk->next = p_cache->chunks[p_class];
+	p_cache->chunks[p_class] = chunk;
+	p_cache->current[p_class] = chunk;
+
+	void *block = chunk->bump;
+	chunk->bump += chunk->block_size;
+	return block;
+}
+
+void *SmallAllocator::alloc(size_t p_bytes) {
+	if (p_bytes > MAX_SIZE) {
+		return nullptr;
+	}
+
+	SmallAllocatorThreadCache *cache = thread_cache;
+	if (unlikely(!cache)) {
+		cache = _acquire_thread_cache();
+		if (!cache) {
+			return nullptr;
+		}
+	}
+
+	uint32_t size_class = size_classes[(p_bytes + 15) >> 4];
+	SmallAllocatorChunk *chunk = cache->current[size_class];
+	if (likely(chunk)) {
+		if (chunk->local_free) {
+			return _pop_local(chunk);
+		}
+		if (chunk->bump + chunk->block_size <= chunk->end) {
+			void *block = chunk->bump;
+			chunk->bump += chunk->block_size;
+			return block;
+		}
+	}
+
+	return _alloc_slow(cache, size_class);
+}
+
+void SmallAllocator::free(void *p_ptr) {
+	SmallAllocatorChunk *chunk = (SmallAllocatorChunk *)(uintptr_t(p_ptr) & ~uintptr_t(CHUNK_SIZE - 1));
+
+	if (likely(chunk->owner == thread_cache)) {
+		*(void **)p_ptr = chunk->local_free;
+		chunk->local_free = p_ptr;
+		return;
+	}
+
+	void *head = chunk->remote_free.load(std::memory_order_relaxed);
+	do {
+		*(void **)p_ptr = head;
+	} while (!chunk->remote_free.compare_exchange_weak(head, p_ptr, std::memory_order_release, std::memory_order_relaxed));
+}
+
+bool SmallAllocator::owns(const void *p_ptr) {
+	uintptr_t base = uintptr_t(p_ptr) & ~uintptr_t(CHUNK_SIZE - 1);
+	uint32_t slot = _chunk_hash(base);
+	while (true) {
+		uintptr_t entry = chunk_table[slot].load(std::memory_order_acquire);
+		if (entry == base) {
+			return true;
+		}
+		if (entry == 0) {
+			return false;
+		}
+		slot = (slot + 1) & (CHUNK_TABLE_SIZE - 1);
+	}
+}
+
+size_t SmallAllocator::get_block_size(const void *p_ptr) {
+	const SmallAllocatorChunk *chunk = (const SmallAllocatorChunk *)(uintptr_t(p_ptr) & ~uintptr_t(CHUNK_SIZE - 1));
+	return chunk->block_size;
+}
+
+uint64_t SmallAllocator::get_chunk_count() {
+	return chunk_count.load(std::memory_order_relaxed);
+}
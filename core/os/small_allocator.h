@@ -0,0 +1,64 @@
+/*************************************************************************/
+/*  small_allocator.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SMALL_ALLOCATOR_H
+#define SMALL_ALLOCATOR_H
+
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+// Thread caching allocator for small blocks. Memory routes small allocations
+// through it when built with small_allocator=yes.
+//
+// Blocks come from 64 KiB chunks, each split into blocks of a single size
+// class. Threads allocate and free from the chunks they own without locking.
+// Blocks freed by another thread are pushed on a lock-free list of their
+// chunk, which the owner takes over once it runs out of free blocks. When a
+// thread exits, the next new thread adopts its chunks. Chunks are kept for
+// reuse and never given back to the system.
+class SmallAllocator {
+public:
+	enum {
+		MAX_SIZE = 512,
+	};
+
+	// Returns nullptr when the block can't come from a chunk, so the caller
+	// falls back to the system allocator.
+	static void *alloc(size_t p_bytes);
+	static void free(void *p_ptr);
+
+	static bool owns(const void *p_ptr);
+	static size_t get_block_size(const void *p_ptr); ///< p_ptr must be owned.
+
+	static uint64_t get_chunk_count();
+};
+
+#endif // SMALL_ALLOCATOR_H
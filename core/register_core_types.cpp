@@ -66,6 +66,7 @@
 #include "core/os/main_loop.h"
 #include "core/packed_data_container.h"
 #include "core/project_settings.h"
+#include "core/thread_work_pool.h"
 #include "core/translation.h"
 #include "core/undo_redo.h"
 
@@ -87,6 +88,8 @@ static _JSON *_json = nullptr;
 
 static IP *ip = nullptr;
 
+static ThreadWorkPool *thread_work_pool = nullptr;
+
 static _Geometry *_geometry = nullptr;
 
 extern Mutex _global_mutex;
@@ -103,6 +106,14 @@ void register_core_types() {
 	ObjectDB::setup();
 	ResourceCache::setup();
 
+	thread_work_pool = memnew(ThreadWorkPool);
+#ifdef NO_THREADS
+	thread_work_pool->init(0);
+#else
+	thread_work_pool->init();
+#endif
+	ThreadWorkPool::set_singleton(thread_work_pool);
+
 	StringName::setup();
 	ResourceLoader::initialize();
 
@@ -313,4 +324,7 @@ void unregister_core_types() {
 	ResourceCache::clear();
 	CoreStringNames::free();
 	StringName::cleanup();
+
+	ThreadWorkPool::set_singleton(nullptr);
+	memdelete(thread_work_pool);
 }
@@ -31,3 +31,13 @@
 #include "rid_owner.h"
 
 volatile uint64_t RID_AllocBase::base_id = 1;
+
+static std::atomic<uint32_t> thread_shard_counter(0);
+static thread_local uint32_t thread_shard = 0xFFFFFFFF;
+
+uint32_t RID_AllocBase::_get_thread_shard() {
+	if (unlikely(thread_shard == 0xFFFFFFFF)) {
+		thread_shard = thread_shard_counter.fetch_add(1, std::memory_order_relaxed) & 0xFFFF;
+	}
+	return thread_shard;
+}
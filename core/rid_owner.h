@@ -32,6 +32,7 @@
 #define RID_OWNER_H
 
 #include "core/list.h"
+#include "core/local_vector.h"
 #include "core/oa_hash_map.h"
 #include "core/os/memory.h"
 #include "core/print_string.h"
@@ -41,6 +42,7 @@
 #include "core/spin_lock.h"
 
 #include <stdio.h>
+#include <atomic>
 #include <typeinfo>
 
 class RID_AllocBase {
@@ -61,61 +63,167 @@ protected:
 		return _make_from_id(_gen_id());
 	}
 
+	// Small per-thread number, used to spread threads over free list shards.
+	static uint32_t _get_thread_shard();
+
 public:
 	virtual ~RID_AllocBase() {}
 };
 
 template <class T, bool THREAD_SAFE = false>
 class RID_Alloc : public RID_AllocBase {
-	T **chunks = nullptr;
+	// Lookups (getornull, owns) never lock. The chunk tables are only ever
+	// replaced by a bigger copy, published before max_alloc grows, and the old
+	// copies are kept around until destruction since readers may still use them.
+	static constexpr std::memory_order READ_ORDER = THREAD_SAFE ? std::memory_order_acquire : std::memory_order_relaxed;
+	static constexpr std::memory_order WRITE_ORDER = THREAD_SAFE ? std::memory_order_release : std::memory_order_relaxed;
+
+	enum {
+		SHARD_COUNT = 8,
+		SHARD_BATCH = 32, // Free indices moved between a shard and the global free list at once.
+	};
+
+	// When THREAD_SAFE, every thread allocates from and frees to its own shard,
+	// and only takes the global lock to move a batch of indices in or out.
+	struct Shard {
+		SpinLock lock;
+		int32_t alloc_count = 0;
+		LocalVector<uint32_t> free_indices;
+		uint8_t padding[64]; // Keep shards off each other's cache lines.
+	};
+
+	std::atomic<T **> chunks;
+	std::atomic<std::atomic<uint32_t> **> validator_chunks;
 	uint32_t **free_list_chunks = nullptr;
-	uint32_t **validator_chunks = nullptr;
+	uint32_t chunk_table_size = 0;
+	LocalVector<void *> retired_tables;
 
 	uint32_t elements_in_chunk;
-	uint32_t max_alloc = 0;
-	uint32_t alloc_count = 0;
+	std::atomic<uint32_t> max_alloc;
+	uint32_t alloc_count = 0; // Not THREAD_SAFE: allocated count. THREAD_SAFE: indices handed out to shards.
+
+	mutable Shard shards[THREAD_SAFE ? SHARD_COUNT : 1];
 
 	const char *description = nullptr;
 
 	SpinLock spin_lock;
 
-public:
-	RID make_rid(const T &p_value) {
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
+	void _grow() {
+		uint32_t current_max = max_alloc.load(std::memory_order_relaxed);
+		uint32_t chunk_count = current_max / elements_in_chunk;
+
+		if (chunk_count == chunk_table_size) {
+			//grow tables, never in place so readers always see a valid one
+			uint32_t new_size = chunk_table_size == 0 ? 1 : chunk_table_size * 2;
+			T **old_chunks = chunks.load(std::memory_order_relaxed);
+			std::atomic<uint32_t> **old_validators = validator_chunks.load(std::memory_order_relaxed);
+
+			T **new_chunks = (T **)memalloc(sizeof(T *) * new_size);
+			std::atomic<uint32_t> **new_validators = (std::atomic<uint32_t> **)memalloc(sizeof(std::atomic<uint32_t> *) * new_size);
+			for (uint32_t i = 0; i < chunk_count; i++) {
+				new_chunks[i] = old_chunks[i];
+				new_validators[i] = old_validators[i];
+			}
+
+			chunks.store(new_chunks, WRITE_ORDER);
+			validator_chunks.store(new_validators, WRITE_ORDER);
 
-		if (alloc_count == max_alloc) {
-			//allocate a new chunk
-			uint32_t chunk_count = alloc_count == 0 ? 0 : (max_alloc / elements_in_chunk);
-
-			//grow chunks
-			chunks = (T **)memrealloc(chunks, sizeof(T *) * (chunk_count + 1));
-			chunks[chunk_count] = (T *)memalloc(sizeof(T) * elements_in_chunk); //but don't initialize
-
-			//grow validators
-			validator_chunks = (uint32_t **)memrealloc(validator_chunks, sizeof(uint32_t *) * (chunk_count + 1));
-			validator_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
-			//grow free lists
-			free_list_chunks = (uint32_t **)memrealloc(free_list_chunks, sizeof(uint32_t *) * (chunk_count + 1));
-			free_list_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
-
-			//initialize
-			for (uint32_t i = 0; i < elements_in_chunk; i++) {
-				//dont initialize chunk
-				validator_chunks[chunk_count][i] = 0xFFFFFFFF;
-				free_list_chunks[chunk_count][i] = alloc_count + i;
+			if (old_chunks) {
+				if (THREAD_SAFE) {
+					retired_tables.push_back(old_chunks);
+					retired_tables.push_back(old_validators);
+				} else {
+					memfree(old_chunks);
+					memfree(old_validators);
+				}
 			}
 
-			max_alloc += elements_in_chunk;
+			free_list_chunks = (uint32_t **)memrealloc(free_list_chunks, sizeof(uint32_t *) * new_size);
+			chunk_table_size = new_size;
+		}
+
+		chunks.load(std::memory_order_relaxed)[chunk_count] = (T *)memalloc(sizeof(T) * elements_in_chunk); //but don't initialize
+
+		std::atomic<uint32_t> *validators = (std::atomic<uint32_t> *)memalloc(sizeof(std::atomic<uint32_t>) * elements_in_chunk);
+		uint32_t *free_list = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
+		for (uint32_t i = 0; i < elements_in_chunk; i++) {
+			memnew_placement(&validators[i], std::atomic<uint32_t>(0xFFFFFFFF));
+			free_list[i] = current_max + i;
 		}
+		validator_chunks.load(std::memory_order_relaxed)[chunk_count] = validators;
+		free_list_chunks[chunk_count] = free_list;
+
+		max_alloc.store(current_max + elements_in_chunk, WRITE_ORDER);
+	}
 
-		uint32_t free_index = free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk];
+	// Called with spin_lock held.
+	void _refill_shard(Shard &p_shard) {
+		if (alloc_count == max_alloc.load(std::memory_order_relaxed)) {
+			_grow();
+		}
+
+		uint32_t count = MIN(uint32_t(SHARD_BATCH), max_alloc.load(std::memory_order_relaxed) - alloc_count);
+		for (uint32_t i = 0; i < count; i++) {
+			p_shard.free_indices.push_back(free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk]);
+			alloc_count++;
+		}
+	}
+
+	// Called with spin_lock held.
+	void _drain_shard(Shard &p_shard) {
+		for (uint32_t i = 0; i < SHARD_BATCH; i++) {
+			uint32_t last = p_shard.free_indices.size() - 1;
+			alloc_count--;
+			free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk] = p_shard.free_indices[last];
+			p_shard.free_indices.resize(last);
+		}
+	}
+
+	// Shards break the "first alloc_count entries of the free list" order, so
+	// index based access walks the validators instead.
+	uint32_t _find_nth_owned(uint32_t p_nth) const {
+		uint32_t max = max_alloc.load(READ_ORDER);
+		std::atomic<uint32_t> **validators = validator_chunks.load(READ_ORDER);
+		for (uint32_t i = 0; i < max; i++) {
+			if (validators[i / elements_in_chunk][i % elements_in_chunk].load(READ_ORDER) != 0xFFFFFFFF) {
+				if (p_nth == 0) {
+					return i;
+				}
+				p_nth--;
+			}
+		}
+		return 0xFFFFFFFF;
+	}
+
+public:
+	RID make_rid(const T &p_value) {
+		uint32_t free_index;
+
+		if (THREAD_SAFE) {
+			Shard &shard = shards[_get_thread_shard() % SHARD_COUNT];
+			shard.lock.lock();
+			if (shard.free_indices.empty()) {
+				spin_lock.lock();
+				_refill_shard(shard);
+				spin_lock.unlock();
+			}
+			uint32_t last = shard.free_indices.size() - 1;
+			free_index = shard.free_indices[last];
+			shard.free_indices.resize(last);
+			shard.alloc_count++;
+			shard.lock.unlock();
+		} else {
+			if (alloc_count == max_alloc.load(std::memory_order_relaxed)) {
+				_grow();
+			}
+			free_index = free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk];
+			alloc_count++;
+		}
 
 		uint32_t free_chunk = free_index / elements_in_chunk;
 		uint32_t free_element = free_index % elements_in_chunk;
 
-		T *ptr = &chunks[free_chunk][free_element];
+		T *ptr = &chunks.load(READ_ORDER)[free_chunk][free_element];
 		memnew_placement(ptr, T(p_value));
 
 		uint32_t validator = (uint32_t)(_gen_id() & 0xFFFFFFFF);
@@ -123,27 +231,16 @@ public:
 		id <<= 32;
 		id |= free_index;
 
-		validator_chunks[free_chunk][free_element] = validator;
-		alloc_count++;
-
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
-		}
+		// Publish last, so lookups never see a half constructed element.
+		validator_chunks.load(READ_ORDER)[free_chunk][free_element].store(validator, WRITE_ORDER);
 
 		return _make_from_id(id);
 	}
 
 	_FORCE_INLINE_ T *getornull(const RID &p_rid) {
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
-
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(idx >= max_alloc.load(READ_ORDER))) {
 			return nullptr;
 		}
 
@@ -151,33 +248,17 @@ public:
 		uint32_t idx_element = idx % elements_in_chunk;
 
 		uint32_t validator = uint32_t(id >> 32);
-		if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(validator_chunks.load(READ_ORDER)[idx_chunk][idx_element].load(READ_ORDER) != validator)) {
 			return nullptr;
 		}
 
-		T *ptr = &chunks[idx_chunk][idx_element];
-
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
-		}
-
-		return ptr;
+		return &chunks.load(READ_ORDER)[idx_chunk][idx_element];
 	}
 
 	_FORCE_INLINE_ bool owns(const RID &p_rid) {
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
-
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(idx >= max_alloc.load(READ_ORDER))) {
 			return false;
 		}
 
@@ -186,26 +267,13 @@ public:
 
 		uint32_t validator = uint32_t(id >> 32);
 
-		bool owned = validator_chunks[idx_chunk][idx_element] == validator;
-
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
-		}
-
-		return owned;
+		return validator_chunks.load(READ_ORDER)[idx_chunk][idx_element].load(READ_ORDER) == validator;
 	}
 
 	_FORCE_INLINE_ void free(const RID &p_rid) {
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
-
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(idx >= max_alloc.load(READ_ORDER))) {
 			ERR_FAIL();
 		}
 
@@ -213,110 +281,141 @@ public:
 		uint32_t idx_element = idx % elements_in_chunk;
 
 		uint32_t validator = uint32_t(id >> 32);
-		if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
+		std::atomic<uint32_t> &slot_validator = validator_chunks.load(READ_ORDER)[idx_chunk][idx_element];
+
+		if (THREAD_SAFE) {
+			// Claim the slot before destroying it, so two racing frees can't both succeed.
+			uint32_t expected = validator;
+			if (unlikely(!slot_validator.compare_exchange_strong(expected, 0xFFFFFFFF, std::memory_order_acq_rel))) {
+				ERR_FAIL();
 			}
-			ERR_FAIL();
+		} else {
+			if (unlikely(slot_validator.load(std::memory_order_relaxed) != validator)) {
+				ERR_FAIL();
+			}
+			slot_validator.store(0xFFFFFFFF, std::memory_order_relaxed); // go invalid
 		}
 
-		chunks[idx_chunk][idx_element].~T();
-		validator_chunks[idx_chunk][idx_element] = 0xFFFFFFFF; // go invalid
-
-		alloc_count--;
-		free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk] = idx;
+		chunks.load(READ_ORDER)[idx_chunk][idx_element].~T();
 
 		if (THREAD_SAFE) {
-			spin_lock.unlock();
+			Shard &shard = shards[_get_thread_shard() % SHARD_COUNT];
+			shard.lock.lock();
+			shard.free_indices.push_back(idx);
+			shard.alloc_count--;
+			if (shard.free_indices.size() >= SHARD_BATCH * 2) {
+				spin_lock.lock();
+				_drain_shard(shard);
+				spin_lock.unlock();
+			}
+			shard.lock.unlock();
+		} else {
+			alloc_count--;
+			free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk] = idx;
 		}
 	}
 
 	_FORCE_INLINE_ uint32_t get_rid_count() const {
+		if (THREAD_SAFE) {
+			int32_t count = 0;
+			for (int i = 0; i < SHARD_COUNT; i++) {
+				shards[i].lock.lock();
+				count += shards[i].alloc_count;
+				shards[i].lock.unlock();
+			}
+			return uint32_t(count);
+		}
 		return alloc_count;
 	}
 
 	_FORCE_INLINE_ T *get_ptr_by_index(uint32_t p_index) {
-		ERR_FAIL_INDEX_V(p_index, alloc_count, nullptr);
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
-		uint64_t idx = free_list_chunks[p_index / elements_in_chunk][p_index % elements_in_chunk];
-		T *ptr = &chunks[idx / elements_in_chunk][idx % elements_in_chunk];
+		ERR_FAIL_INDEX_V(p_index, get_rid_count(), nullptr);
+		uint32_t idx;
 		if (THREAD_SAFE) {
-			spin_lock.unlock();
+			idx = _find_nth_owned(p_index);
+			ERR_FAIL_COND_V(idx == 0xFFFFFFFF, nullptr);
+		} else {
+			idx = free_list_chunks[p_index / elements_in_chunk][p_index % elements_in_chunk];
 		}
-		return ptr;
+		return &chunks.load(READ_ORDER)[idx / elements_in_chunk][idx % elements_in_chunk];
 	}
 
 	_FORCE_INLINE_ RID get_rid_by_index(uint32_t p_index) {
-		ERR_FAIL_INDEX_V(p_index, alloc_count, RID());
+		ERR_FAIL_INDEX_V(p_index, get_rid_count(), RID());
+		uint32_t idx;
 		if (THREAD_SAFE) {
-			spin_lock.lock();
+			idx = _find_nth_owned(p_index);
+			ERR_FAIL_COND_V(idx == 0xFFFFFFFF, RID());
+		} else {
+			idx = free_list_chunks[p_index / elements_in_chunk][p_index % elements_in_chunk];
 		}
-		uint64_t idx = free_list_chunks[p_index / elements_in_chunk][p_index % elements_in_chunk];
-		uint64_t validator = validator_chunks[idx / elements_in_chunk][idx % elements_in_chunk];
+		uint64_t validator = validator_chunks.load(READ_ORDER)[idx / elements_in_chunk][idx % elements_in_chunk].load(READ_ORDER);
 
-		RID rid = _make_from_id((validator << 32) | idx);
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
-		}
-		return rid;
+		return _make_from_id((validator << 32) | idx);
 	}
 
 	void get_owned_list(List<RID> *p_owned) {
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
-		for (size_t i = 0; i < max_alloc; i++) {
-			uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+		uint32_t max = max_alloc.load(READ_ORDER);
+		std::atomic<uint32_t> **validators = validator_chunks.load(READ_ORDER);
+		for (size_t i = 0; i < max; i++) {
+			uint64_t validator = validators[i / elements_in_chunk][i % elements_in_chunk].load(READ_ORDER);
 			if (validator != 0xFFFFFFFF) {
 				p_owned->push_back(_make_from_id((validator << 32) | i));
 			}
 		}
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
-		}
 	}
 
 	void set_description(const char *p_descrption) {
 		description = p_descrption;
 	}
 
-	RID_Alloc(uint32_t p_target_chunk_byte_size = 4096) {
+	RID_Alloc(uint32_t p_target_chunk_byte_size = 4096) :
+			chunks(nullptr),
+			validator_chunks(nullptr),
+			max_alloc(0) {
 		elements_in_chunk = sizeof(T) > p_target_chunk_byte_size ? 1 : (p_target_chunk_byte_size / sizeof(T));
 	}
 
 	~RID_Alloc() {
-		if (alloc_count) {
+		uint32_t leaked = get_rid_count();
+		uint32_t max = max_alloc.load(std::memory_order_acquire);
+		T **chunk_table = chunks.load(std::memory_order_acquire);
+		std::atomic<uint32_t> **validator_table = validator_chunks.load(std::memory_order_acquire);
+
+		if (leaked) {
 			if (description) {
-				print_error("ERROR: " + itos(alloc_count) + " RID allocations of type '" + description + "' were leaked at exit.");
+				print_error("ERROR: " + itos(leaked) + " RID allocations of type '" + description + "' were leaked at exit.");
 			} else {
 #ifdef NO_SAFE_CAST
-				print_error("ERROR: " + itos(alloc_count) + " RID allocations of type 'unknown' were leaked at exit.");
+				print_error("ERROR: " + itos(leaked) + " RID allocations of type 'unknown' were leaked at exit.");
 #else
-				print_error("ERROR: " + itos(alloc_count) + " RID allocations of type '" + typeid(T).name() + "' were leaked at exit.");
+				print_error("ERROR: " + itos(leaked) + " RID allocations of type '" + typeid(T).name() + "' were leaked at exit.");
 #endif
 			}
 
-			for (size_t i = 0; i < max_alloc; i++) {
-				uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+			for (size_t i = 0; i < max; i++) {
+				uint64_t validator = validator_table[i / elements_in_chunk][i % elements_in_chunk].load(std::memory_order_relaxed);
 				if (validator != 0xFFFFFFFF) {
-					chunks[i / elements_in_chunk][i % elements_in_chunk].~T();
+					chunk_table[i / elements_in_chunk][i % elements_in_chunk].~T();
 				}
 			}
 		}
 
-		uint32_t chunk_count = max_alloc / elements_in_chunk;
+		uint32_t chunk_count = max / elements_in_chunk;
 		for (uint32_t i = 0; i < chunk_count; i++) {
-			memfree(chunks[i]);
-			memfree(validator_chunks[i]);
+			memfree(chunk_table[i]);
+			memfree(validator_table[i]);
 			memfree(free_list_chunks[i]);
 		}
 
-		if (chunks) {
-			memfree(chunks);
+		if (chunk_table) {
+			memfree(chunk_table);
 			memfree(free_list_chunks);
-			memfree(validator_chunks);
+			memfree(validator_table);
+		}
+
+		for (uint32_t i = 0; i < retired_tables.size(); i++) {
+			memfree(retired_tables[i]);
 		}
 	}
 };
@@ -39,42 +39,211 @@ StaticCString StaticCString::create(const char *p_ptr) {
 	return scs;
 }
 
-StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+struct StringName::_Table {
+	uint32_t mask = 0;
+	std::atomic<_Data *> *buckets = nullptr;
+	_Table *retired_next = nullptr;
+};
+
+struct alignas(64) StringName::_Stripe {
+	Mutex mutex;
+	std::atomic<uint32_t> readers = { 0 }; // Lock-free lookups in progress.
+	std::atomic<_Table *> table = { nullptr };
+	uint32_t count = 0;
+	_Data *retired = nullptr; // Unlinked names, linked through prev.
+	_Table *retired_tables = nullptr;
+};
+
+StringName::_Stripe StringName::_stripes[STRING_TABLE_STRIPES];
 
 StringName _scs_create(const char *p_chr) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr)) : StringName());
 }
 
 bool StringName::configured = false;
-Mutex StringName::mutex;
+
+bool StringName::_Data::equals(const char *p_name) const {
+	return cname ? strcmp(cname, p_name) == 0 : name == p_name;
+}
+
+bool StringName::_Data::equals(const CharType *p_name) const {
+	return get_name() == p_name;
+}
+
+bool StringName::_Data::equals(const String &p_name) const {
+	return cname ? p_name == cname : name == p_name;
+}
+
+StringName::_Table *StringName::_table_create(uint32_t p_bits) {
+	_Table *table = memnew(_Table);
+	table->mask = (1 << p_bits) - 1;
+	table->buckets = memnew_arr(std::atomic<_Data *>, table->mask + 1);
+	for (uint32_t i = 0; i <= table->mask; i++) {
+		table->buckets[i].store(nullptr, std::memory_order_relaxed);
+	}
+	return table;
+}
+
+// Lock-free, returns a referenced name or nullptr. Missing a name that is
+// being rehashed is fine, callers fall back to the locked path.
+template <class K>
+StringName::_Data *StringName::_find(uint32_t p_hash, const K &p_name) {
+	_Stripe &stripe = _stripes[p_hash & STRING_TABLE_STRIPE_MASK];
+	stripe.readers.fetch_add(1, std::memory_order_seq_cst);
+
+	_Table *table = stripe.table.load(std::memory_order_acquire);
+	_Data *data = table->buckets[(p_hash >> STRING_TABLE_STRIPE_BITS) & table->mask].load(std::memory_order_acquire);
+	while (data) {
+		// compare hash first
+		if (data->hash == p_hash && data->equals(p_name) && data->refcount.ref()) {
+			break;
+		}
+		data = data->next.load(std::memory_order_acquire);
+	}
+
+	stripe.readers.fetch_sub(1, std::memory_order_release);
+	return data;
+}
+
+// Finds or adds a name with the stripe locked, always returns a referenced name.
+template <class K>
+StringName::_Data *StringName::_intern(uint32_t p_hash, const K &p_name, const char *p_static_name) {
+	_Stripe &stripe = _stripes[p_hash & STRING_TABLE_STRIPE_MASK];
+	MutexLock lock(stripe.mutex);
+
+	_Table *table = stripe.table.load(std::memory_order_relaxed);
+	std::atomic<_Data *> &bucket = table->buckets[(p_hash >> STRING_TABLE_STRIPE_BITS) & table->mask];
+
+	for (_Data *data = bucket.load(std::memory_order_relaxed); data; data = data->next.load(std::memory_order_relaxed)) {
+		// A name found with no references is being removed, add a new one instead.
+		if (data->hash == p_hash && data->equals(p_name) && data->refcount.ref()) {
+			return data;
+		}
+	}
+
+	_Data *data = memnew(_Data);
+	if (p_static_name) {
+		data->cname = p_static_name;
+	} else {
+		data->name = p_name;
+	}
+	data->refcount.init();
+	data->hash = p_hash;
+	data->prev = nullptr;
+
+	_Data *head = bucket.load(std::memory_order_relaxed);
+	data->next.store(head, std::memory_order_relaxed);
+	if (head) {
+		head->prev = data;
+	}
+	bucket.store(data, std::memory_order_release); // Publish once fully built.
+
+	stripe.count++;
+	if (stripe.count > table->mask + 1) {
+		_grow(stripe);
+	}
+	_reclaim(stripe);
+
+	return data;
+}
+
+void StringName::_grow(_Stripe &p_stripe) {
+	_Table *old_table = p_stripe.table.load(std::memory_order_relaxed);
+	uint32_t bits = 0;
+	while ((1u << bits) <= old_table->mask) {
+		bits++;
+	}
+	_Table *table = _table_create(bits + 1);
+
+	// Readers still walking the old chains may be sent to a new one and miss
+	// their name, but never loop or see freed memory.
+	for (uint32_t i = 0; i <= old_table->mask; i++) {
+		_Data *data = old_table->buckets[i].load(std::memory_order_relaxed);
+		while (data) {
+			_Data *next = data->next.load(std::memory_order_relaxed);
+
+			std::atomic<_Data *> &bucket = table->buckets[(data->hash >> STRING_TABLE_STRIPE_BITS) & table->mask];
+			_Data *head = bucket.load(std::memory_order_relaxed);
+			data->prev = nullptr;
+			data->next.store(head, std::memory_order_release);
+			if (head) {
+				head->prev = data;
+			}
+			bucket.store(data, std::memory_order_relaxed);
+
+			data = next;
+		}
+	}
+
+	p_stripe.table.store(table, std::memory_order_release);
+	old_table->retired_next = p_stripe.retired_tables;
+	p_stripe.retired_tables = old_table;
+}
+
+// Frees what was unlinked from the stripe, unless a lock-free reader may still
+// be looking at it. In that case it's retried on the next change to the stripe.
+void StringName::_reclaim(_Stripe &p_stripe, bool p_force) {
+	if (!p_stripe.retired && !p_stripe.retired_tables) {
+		return;
+	}
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (!p_force && p_stripe.readers.load(std::memory_order_seq_cst) != 0) {
+		return;
+	}
+
+	while (p_stripe.retired) {
+		_Data *data = p_stripe.retired;
+		p_stripe.retired = data->prev;
+		memdelete(data);
+	}
+	while (p_stripe.retired_tables) {
+		_Table *table = p_stripe.retired_tables;
+		p_stripe.retired_tables = table->retired_next;
+		memdelete_arr(table->buckets);
+		memdelete(table);
+	}
+}
 
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		_table[i] = nullptr;
+	for (int i = 0; i < STRING_TABLE_STRIPES; i++) {
+		_stripes[i].table.store(_table_create(STRING_TABLE_INITIAL_BITS), std::memory_order_release);
+		_stripes[i].count = 0;
 	}
 	configured = true;
 }
 
 void StringName::cleanup() {
-	MutexLock lock(mutex);
-
 	int lost_strings = 0;
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		while (_table[i]) {
-			_Data *d = _table[i];
-			lost_strings++;
-			if (OS::get_singleton()->is_stdout_verbose()) {
-				if (d->cname) {
-					print_line("Orphan StringName: " + String(d->cname));
-				} else {
-					print_line("Orphan StringName: " + String(d->name));
+	for (int i = 0; i < STRING_TABLE_STRIPES; i++) {
+		_Stripe &stripe = _stripes[i];
+		MutexLock lock(stripe.mutex);
+
+		_Table *table = stripe.table.load(std::memory_order_relaxed);
+		for (uint32_t j = 0; j <= table->mask; j++) {
+			_Data *d = table->buckets[j].load(std::memory_order_relaxed);
+			while (d) {
+				lost_strings++;
+				if (OS::get_singleton()->is_stdout_verbose()) {
+					if (d->cname) {
+						print_line("Orphan StringName: " + String(d->cname));
+					} else {
+						print_line("Orphan StringName: " + String(d->name));
+					}
 				}
-			}
 
-			_table[i] = _table[i]->next;
-			memdelete(d);
+				_Data *next = d->next.load(std::memory_order_relaxed);
+				memdelete(d);
+				d = next;
+			}
 		}
+
+		_reclaim(stripe, true);
+		memdelete_arr(table->buckets);
+		memdelete(table);
+		stripe.table.store(nullptr, std::memory_order_relaxed);
+		stripe.count = 0;
 	}
 	if (lost_strings) {
 		print_verbose("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
@@ -85,21 +254,30 @@ void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(mutex);
+		_Stripe &stripe = _stripes[_data->hash & STRING_TABLE_STRIPE_MASK];
+		MutexLock lock(stripe.mutex);
 
+		_Data *next = _data->next.load(std::memory_order_relaxed);
 		if (_data->prev) {
-			_data->prev->next = _data->next;
+			_data->prev->next.store(next, std::memory_order_release);
 		} else {
-			if (_table[_data->idx] != _data) {
+			_Table *table = stripe.table.load(std::memory_order_relaxed);
+			std::atomic<_Data *> &bucket = table->buckets[(_data->hash >> STRING_TABLE_STRIPE_BITS) & table->mask];
+			if (bucket.load(std::memory_order_relaxed) != _data) {
 				ERR_PRINT("BUG!");
 			}
-			_table[_data->idx] = _data->next;
+			bucket.store(next, std::memory_order_release);
 		}
 
-		if (_data->next) {
-			_data->next->prev = _data->prev;
+		if (next) {
+			next->prev = _data->prev;
 		}
-		memdelete(_data);
+
+		// Keep next as is, so readers currently on this name can move on.
+		_data->prev = stripe.retired;
+		stripe.retired = _data;
+		stripe.count--;
+		_reclaim(stripe);
 	}
 
 	_data = nullptr;
@@ -162,41 +340,12 @@ StringName::StringName(const char *p_name) {
 		return; //empty, ignore
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
+	_data = _find(hash, p_name);
+	if (!_data) {
+		_data = _intern(hash, p_name, nullptr);
 	}
-	_table[idx] = _data;
 }
 
 StringName::StringName(const StaticCString &p_static_string) {
@@ -206,41 +355,12 @@ StringName::StringName(const StaticCString &p_static_string) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_static_string.ptr);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
+	_data = _find(hash, p_static_string.ptr);
+	if (!_data) {
+		_data = _intern(hash, p_static_string.ptr, p_static_string.ptr);
 	}
-	_table[idx] = _data;
 }
 
 StringName::StringName(const String &p_name) {
@@ -252,39 +372,12 @@ StringName::StringName(const String &p_name) {
 		return;
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
-	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_data = _table[idx];
-
-	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
+	_data = _find(hash, p_name);
+	if (!_data) {
+		_data = _intern(hash, p_name, nullptr);
 	}
-	_table[idx] = _data;
 }
 
 StringName StringName::search(const char *p_name) {
@@ -295,23 +388,18 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
-	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
+	_Data *data = _find(hash, p_name);
+	if (!data) {
+		// Rule out a miss caused by a concurrent rehash before giving up.
+		_Stripe &stripe = _stripes[hash & STRING_TABLE_STRIPE_MASK];
+		MutexLock lock(stripe.mutex);
+		data = _find(hash, p_name);
 	}
 
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
+	if (data) {
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
@@ -325,24 +413,17 @@ StringName StringName::search(const CharType *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
+	_Data *data = _find(hash, p_name);
+	if (!data) {
+		_Stripe &stripe = _stripes[hash & STRING_TABLE_STRIPE_MASK];
+		MutexLock lock(stripe.mutex);
+		data = _find(hash, p_name);
 	}
 
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
+	if (data) {
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
@@ -351,24 +432,17 @@ StringName StringName::search(const CharType *p_name) {
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name == "", StringName());
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name()) {
-			break;
-		}
-		_data = _data->next;
+	_Data *data = _find(hash, p_name);
+	if (!data) {
+		_Stripe &stripe = _stripes[hash & STRING_TABLE_STRIPE_MASK];
+		MutexLock lock(stripe.mutex);
+		data = _find(hash, p_name);
 	}
 
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
+	if (data) {
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
@@ -35,17 +35,24 @@
 #include "core/safe_refcount.h"
 #include "core/ustring.h"
 
+#include <atomic>
+
 struct StaticCString {
 	const char *ptr;
 	static StaticCString create(const char *p_ptr);
 };
 
 class StringName {
+	// The table is split in stripes by hash, each with its own lock and its
+	// own growable bucket array. Existing names are found without locking:
+	// chains are only modified with the stripe locked, and unlinked names or
+	// replaced bucket arrays are freed once no lock-free reader is in the stripe.
 	enum {
 
-		STRING_TABLE_BITS = 12,
-		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_STRIPE_BITS = 6,
+		STRING_TABLE_STRIPES = 1 << STRING_TABLE_STRIPE_BITS,
+		STRING_TABLE_STRIPE_MASK = STRING_TABLE_STRIPES - 1,
+		STRING_TABLE_INITIAL_BITS = 6, // Buckets per stripe, grows with the amount of names.
 	};
 
 	struct _Data {
@@ -54,14 +61,27 @@ class StringName {
 		String name;
 
 		String get_name() const { return cname ? String(cname) : name; }
-		int idx = 0;
+		bool equals(const char *p_name) const;
+		bool equals(const CharType *p_name) const;
+		bool equals(const String &p_name) const;
 		uint32_t hash = 0;
-		_Data *prev = nullptr;
-		_Data *next = nullptr;
+		_Data *prev = nullptr; // Only used with the stripe locked, links retired names once unlinked.
+		std::atomic<_Data *> next = { nullptr };
 		_Data() {}
 	};
 
-	static _Data *_table[STRING_TABLE_LEN];
+	struct _Table;
+	struct _Stripe;
+
+	static _Stripe _stripes[STRING_TABLE_STRIPES];
+
+	template <class K>
+	static _Data *_find(uint32_t p_hash, const K &p_name);
+	template <class K>
+	static _Data *_intern(uint32_t p_hash, const K &p_name, const char *p_static_name);
+	static _Table *_table_create(uint32_t p_bits);
+	static void _grow(_Stripe &p_stripe);
+	static void _reclaim(_Stripe &p_stripe, bool p_force = false);
 
 	_Data *_data = nullptr;
 
@@ -74,7 +94,6 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 
-	static Mutex mutex;
 	static void setup();
 	static void cleanup();
 	static bool configured;
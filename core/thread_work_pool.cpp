@@ -32,40 +32,236 @@
 
 #include "core/os/os.h"
 
+ThreadWorkPool *ThreadWorkPool::singleton = nullptr;
+
+static thread_local ThreadWorkPool *current_pool = nullptr;
+static thread_local int current_thread_index = -1;
+
 void ThreadWorkPool::_thread_function(ThreadData *p_thread) {
+	ThreadWorkPool *pool = p_thread->pool;
+	current_pool = pool;
+	current_thread_index = p_thread->index;
+
 	while (true) {
-		p_thread->start.wait();
-		if (p_thread->exit.load()) {
+		Task *task = pool->_pop_task(p_thread->index);
+		if (task) {
+			task->execute();
+			continue;
+		}
+		pool->work_available.wait();
+		if (pool->exit.load()) {
 			break;
 		}
-		p_thread->work->work();
-		p_thread->completed.post();
 	}
 }
 
+int ThreadWorkPool::_get_current_thread_index() const {
+	return current_pool == this ? current_thread_index : -1;
+}
+
+void ThreadWorkPool::_push_task(Task *p_task) {
+	if (thread_count == 0) {
+		p_task->execute();
+		return;
+	}
+
+	int index = _get_current_thread_index();
+	if (index < 0) {
+		index = next_queue.fetch_add(1, std::memory_order_relaxed) % thread_count;
+	}
+
+	TaskQueue &queue = threads[index].queue;
+	queue.lock.lock();
+	queue.tasks.push_back(p_task);
+	queue.lock.unlock();
+
+	work_available.post();
+}
+
+ThreadWorkPool::Task *ThreadWorkPool::_pop_task(int p_thread_index) {
+	Task *task = nullptr;
+
+	if (p_thread_index >= 0) {
+		// Own queue, newest first.
+		TaskQueue &queue = threads[p_thread_index].queue;
+		queue.lock.lock();
+		if (queue.head < queue.tasks.size()) {
+			task = queue.tasks[queue.tasks.size() - 1];
+			queue.tasks.resize(queue.tasks.size() - 1);
+			if (queue.head == queue.tasks.size()) {
+				queue.tasks.clear();
+				queue.head = 0;
+			}
+		}
+		queue.lock.unlock();
+		if (task) {
+			return task;
+		}
+	}
+
+	// Steal the oldest task of another queue.
+	uint32_t start = p_thread_index >= 0 ? p_thread_index + 1 : next_queue.load(std::memory_order_relaxed);
+	for (uint32_t i = 0; i < thread_count; i++) {
+		uint32_t victim = (start + i) % thread_count;
+		if (int(victim) == p_thread_index) {
+			continue;
+		}
+		TaskQueue &queue = threads[victim].queue;
+		queue.lock.lock();
+		if (queue.head < queue.tasks.size()) {
+			task = queue.tasks[queue.head++];
+			if (queue.head == queue.tasks.size()) {
+				queue.tasks.clear();
+				queue.head = 0;
+			}
+		}
+		queue.lock.unlock();
+		if (task) {
+			return task;
+		}
+	}
+
+	return nullptr;
+}
+
+bool ThreadWorkPool::_run_one_task() {
+	if (thread_count == 0) {
+		return false;
+	}
+	Task *task = _pop_task(_get_current_thread_index());
+	if (!task) {
+		return false;
+	}
+	task->execute();
+	return true;
+}
+
+ThreadWorkPool::JobID ThreadWorkPool::_add_job(BaseJob *p_job, const JobID *p_dependencies, int p_dependency_count) {
+	p_job->pool = this;
+	// Hold one extra reference so the job is not queued before all its
+	// dependencies are registered.
+	p_job->pending_dependencies.store(1);
+
+	JobID id;
+	{
+		MutexLock lock(jobs_mutex);
+		id = ++last_job_id;
+		jobs.set(id, p_job);
+
+		for (int i = 0; i < p_dependency_count; i++) {
+			BaseJob **dependency = jobs.getptr(p_dependencies[i]);
+			if (!dependency) {
+				// Already waited on, so already completed.
+				continue;
+			}
+			(*dependency)->lock.lock();
+			if (!(*dependency)->completed) {
+				(*dependency)->dependents.push_back(p_job);
+				p_job->pending_dependencies.fetch_add(1);
+			}
+			(*dependency)->lock.unlock();
+		}
+	}
+
+	if (p_job->pending_dependencies.fetch_sub(1) == 1) {
+		_push_task(p_job);
+	}
+
+	return id;
+}
+
+void ThreadWorkPool::_job_finished(BaseJob *p_job) {
+	LocalVector<BaseJob *> dependents;
+
+	p_job->lock.lock();
+	p_job->completed = true;
+	SWAP(dependents, p_job->dependents);
+	p_job->lock.unlock();
+
+	for (uint32_t i = 0; i < dependents.size(); i++) {
+		if (dependents[i]->pending_dependencies.fetch_sub(1) == 1) {
+			_push_task(dependents[i]);
+		}
+	}
+
+	// Must be the last access, the waiter frees the job right after.
+	p_job->done.post();
+}
+
+bool ThreadWorkPool::is_job_completed(JobID p_job) const {
+	MutexLock lock(jobs_mutex);
+	BaseJob *const *job = jobs.getptr(p_job);
+	if (!job) {
+		return true;
+	}
+	(*job)->lock.lock();
+	bool completed = (*job)->completed;
+	(*job)->lock.unlock();
+	return completed;
+}
+
+void ThreadWorkPool::wait_for_job(JobID p_job) {
+	BaseJob *job;
+	{
+		MutexLock lock(jobs_mutex);
+		BaseJob **job_ptr = jobs.getptr(p_job);
+		ERR_FAIL_COND_MSG(!job_ptr, "Invalid job ID or job already waited on.");
+		job = *job_ptr;
+	}
+
+	bool is_worker = _get_current_thread_index() >= 0;
+	while (!job->done.try_wait()) {
+		if (_run_one_task()) {
+			continue;
+		}
+		if (is_worker) {
+			// Keep looking for work, the job may depend on tasks that are yet to be queued.
+			std::this_thread::yield();
+		} else {
+			job->done.wait();
+			break;
+		}
+	}
+
+	{
+		MutexLock lock(jobs_mutex);
+		jobs.erase(p_job);
+	}
+	memdelete(job);
+}
+
 void ThreadWorkPool::init(int p_thread_count) {
 	ERR_FAIL_COND(threads != nullptr);
 	if (p_thread_count < 0) {
 		p_thread_count = OS::get_singleton()->get_processor_count();
 	}
 
+	exit.store(false);
 	thread_count = p_thread_count;
+	if (thread_count == 0) {
+		return;
+	}
+
 	threads = memnew_arr(ThreadData, thread_count);
 
 	for (uint32_t i = 0; i < thread_count; i++) {
-		threads[i].exit.store(false);
+		threads[i].pool = this;
+		threads[i].index = i;
+	}
+	for (uint32_t i = 0; i < thread_count; i++) {
 		threads[i].thread = memnew(std::thread(ThreadWorkPool::_thread_function, &threads[i]));
 	}
 }
 
 void ThreadWorkPool::finish() {
 	if (threads == nullptr) {
+		thread_count = 0;
 		return;
 	}
 
+	exit.store(true);
 	for (uint32_t i = 0; i < thread_count; i++) {
-		threads[i].exit.store(true);
-		threads[i].start.post();
+		work_available.post();
 	}
 	for (uint32_t i = 0; i < thread_count; i++) {
 		threads[i].thread->join();
@@ -74,6 +270,12 @@ void ThreadWorkPool::finish() {
 
 	memdelete_arr(threads);
 	threads = nullptr;
+	thread_count = 0;
+}
+
+ThreadWorkPool::ThreadWorkPool() {
+	exit.store(false);
+	next_queue.store(0);
 }
 
 ThreadWorkPool::~ThreadWorkPool() {
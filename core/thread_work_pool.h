@@ -31,20 +31,64 @@
 #ifndef THREAD_WORK_POOL_H
 #define THREAD_WORK_POOL_H
 
+#include "core/hash_map.h"
+#include "core/local_vector.h"
 #include "core/os/memory.h"
+#include "core/os/mutex.h"
 #include "core/os/semaphore.h"
+#include "core/spin_lock.h"
+#include "core/vector.h"
 
 #include <atomic>
 #include <thread>
 
+// Persistent pool of worker threads. Each worker owns a task deque: tasks pushed
+// from a worker go to its own deque (LIFO for locality), idle workers and
+// waiting callers steal from the other end of the other deques.
+//
+// Two kinds of work can be submitted:
+// - do_work() is a blocking parallel-for over a range of elements, processed in
+//   chunks of p_grain elements. The calling thread takes part in the work.
+// - add_job() queues a single job, optionally depending on other jobs, and
+//   returns an ID that must be waited on with wait_for_job().
+
 class ThreadWorkPool {
-	std::atomic<uint32_t> index;
+public:
+	typedef int64_t JobID;
 
-	struct BaseWork {
-		std::atomic<uint32_t> *index;
-		uint32_t max_elements;
-		virtual void work() = 0;
-		virtual ~BaseWork() = default;
+	enum {
+		INVALID_JOB_ID = -1
+	};
+
+private:
+	struct Task {
+		virtual void execute() = 0;
+		virtual ~Task() = default;
+	};
+
+	struct BaseWork : public Task {
+		std::atomic<uint32_t> index;
+		std::atomic<uint32_t> pending; // Queued copies of this work not finished yet.
+		uint32_t max_elements = 0;
+		uint32_t grain = 1;
+
+		virtual void process(uint32_t p_from, uint32_t p_to) = 0;
+
+		void process_all() {
+			while (true) {
+				uint32_t from = index.fetch_add(grain, std::memory_order_relaxed);
+				if (from >= max_elements) {
+					break;
+				}
+				uint32_t to = MIN(from + grain, max_elements);
+				process(from, to);
+			}
+		}
+
+		virtual void execute() {
+			process_all();
+			pending.fetch_sub(1, std::memory_order_release);
+		}
 	};
 
 	template <class C, class M, class U>
@@ -52,59 +96,139 @@ class ThreadWorkPool {
 		C *instance;
 		M method;
 		U userdata;
-		virtual void work() {
-			while (true) {
-				uint32_t work_index = index->fetch_add(1, std::memory_order_relaxed);
-				if (work_index >= max_elements) {
-					break;
-				}
-				(instance->*method)(work_index, userdata);
+		virtual void process(uint32_t p_from, uint32_t p_to) {
+			for (uint32_t i = p_from; i < p_to; i++) {
+				(instance->*method)(i, userdata);
 			}
 		}
 	};
 
+	struct BaseJob : public Task {
+		ThreadWorkPool *pool = nullptr;
+		std::atomic<uint32_t> pending_dependencies;
+		SpinLock lock;
+		bool completed = false; // Protected by lock.
+		LocalVector<BaseJob *> dependents; // Protected by lock.
+		Semaphore done;
+
+		virtual void work() = 0;
+
+		virtual void execute() {
+			work();
+			pool->_job_finished(this);
+		}
+	};
+
+	template <class C, class M, class U>
+	struct Job : public BaseJob {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void work() {
+			(instance->*method)(userdata);
+		}
+	};
+
+	struct TaskQueue {
+		SpinLock lock;
+		LocalVector<Task *> tasks;
+		uint32_t head = 0; // Thieves take from here, the owner from the back.
+	};
+
 	struct ThreadData {
-		std::thread *thread;
-		Semaphore start;
-		Semaphore completed;
-		std::atomic<bool> exit;
-		BaseWork *work;
+		ThreadWorkPool *pool = nullptr;
+		uint32_t index = 0;
+		std::thread *thread = nullptr;
+		TaskQueue queue;
 	};
 
 	ThreadData *threads = nullptr;
 	uint32_t thread_count = 0;
+	std::atomic<bool> exit;
+	std::atomic<uint32_t> next_queue;
+	Semaphore work_available;
+
+	Mutex jobs_mutex;
+	HashMap<JobID, BaseJob *> jobs;
+	JobID last_job_id = 0;
+
+	static ThreadWorkPool *singleton;
 
 	static void _thread_function(ThreadData *p_thread);
 
+	int _get_current_thread_index() const;
+	void _push_task(Task *p_task);
+	Task *_pop_task(int p_thread_index);
+	bool _run_one_task();
+
+	JobID _add_job(BaseJob *p_job, const JobID *p_dependencies, int p_dependency_count);
+	void _job_finished(BaseJob *p_job);
+
 public:
+	// Parallel-for: calls (p_instance->*p_method)(i, p_userdata) for every i in
+	// [0, p_elements), and returns once all of them have been processed.
 	template <class C, class M, class U>
-	void do_work(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
-		ERR_FAIL_COND(!threads); //never initialized
+	void do_work(uint32_t p_elements, C *p_instance, M p_method, U p_userdata, uint32_t p_grain = 1) {
+		if (p_elements == 0) {
+			return;
+		}
+		if (p_grain == 0) {
+			p_grain = 1;
+		}
 
-		index.store(0);
+		Work<C, M, U> w;
+		w.instance = p_instance;
+		w.userdata = p_userdata;
+		w.method = p_method;
+		w.index.store(0, std::memory_order_relaxed);
+		w.max_elements = p_elements;
+		w.grain = p_grain;
+
+		// The calling thread takes one share of the chunks itself.
+		uint32_t chunks = (p_elements + p_grain - 1) / p_grain;
+		uint32_t helpers = MIN(thread_count, chunks - 1);
+		w.pending.store(helpers, std::memory_order_relaxed);
+
+		for (uint32_t i = 0; i < helpers; i++) {
+			_push_task(&w);
+		}
 
-		Work<C, M, U> *w = memnew((Work<C, M, U>));
-		w->instance = p_instance;
-		w->userdata = p_userdata;
-		w->method = p_method;
-		w->index = &index;
-		w->max_elements = p_elements;
+		w.process_all();
 
-		for (uint32_t i = 0; i < thread_count; i++) {
-			threads[i].work = w;
-			threads[i].start.post();
-		}
-		for (uint32_t i = 0; i < thread_count; i++) {
-			threads[i].completed.wait();
-			threads[i].work = nullptr;
+		// Remaining copies either run their last chunk or are still queued, in which
+		// case they are stolen here and exit right away.
+		while (w.pending.load(std::memory_order_acquire) > 0) {
+			if (!_run_one_task()) {
+				std::this_thread::yield();
+			}
 		}
+	}
 
-		memdelete(w);
+	// Queues a call to (p_instance->*p_method)(p_userdata), to run once all jobs in
+	// p_dependencies have completed.
+	template <class C, class M, class U>
+	JobID add_job(C *p_instance, M p_method, U p_userdata, const Vector<JobID> &p_dependencies = Vector<JobID>()) {
+		Job<C, M, U> *job = memnew((Job<C, M, U>));
+		job->instance = p_instance;
+		job->method = p_method;
+		job->userdata = p_userdata;
+		return _add_job(job, p_dependencies.ptr(), p_dependencies.size());
 	}
 
+	bool is_job_completed(JobID p_job) const;
+	// Blocks until the job has run and releases it. Waiting from a worker thread
+	// processes other queued tasks in the meantime.
+	void wait_for_job(JobID p_job);
+
+	uint32_t get_thread_count() const { return thread_count; }
+
+	static ThreadWorkPool *get_singleton() { return singleton; }
+	static void set_singleton(ThreadWorkPool *p_pool) { singleton = p_pool; }
+
 	void init(int p_thread_count = -1);
 	void finish();
+	ThreadWorkPool();
 	~ThreadWorkPool();
 };
 
-#endif // THREAD_POOL_H
+#endif // THREAD_WORK_POOL_H
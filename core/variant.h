@@ -120,6 +120,7 @@ public:
 
 private:
 	friend struct _VariantCall;
+	friend class VariantInternal;
 	// Variant takes 20 bytes when real_t is float, and 36 if double
 	// it only allocates extra memory for aabb/matrix.
 
@@ -430,6 +431,25 @@ public:
 	static Vector<StringName> get_method_argument_names(Variant::Type p_type, const StringName &p_method);
 	static bool is_method_const(Variant::Type p_type, const StringName &p_method);
 
+	// Builtin methods can also be looked up once and then called by index, the
+	// index of a method stays valid for the whole run. The validated form skips
+	// the argument checks and default arguments, so it must only be called with
+	// exactly arg_count arguments of the listed types (NIL accepts anything).
+	struct ValidatedBuiltInMethod {
+		typedef void (*Function)(Variant &r_ret, Variant &p_self, const Variant **p_args);
+
+		Function call = nullptr;
+		const Type *arg_types = nullptr;
+		int arg_count = 0;
+		bool returns = false;
+	};
+
+	static int get_builtin_method_index(Variant::Type p_type, const StringName &p_method);
+	static int get_builtin_method_count(Variant::Type p_type);
+	static StringName get_builtin_method_name(Variant::Type p_type, int p_index);
+	static const ValidatedBuiltInMethod *get_validated_builtin_method(Variant::Type p_type, int p_index);
+	void call_builtin_method(int p_index, const Variant **p_args, int p_argcount, Variant *r_ret, Callable::CallError &r_error);
+
 	void set_named(const StringName &p_index, const Variant &p_value, bool *r_valid = nullptr);
 	Variant get_named(const StringName &p_index, bool *r_valid = nullptr) const;
 
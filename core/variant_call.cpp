@@ -34,7 +34,9 @@
 #include "core/core_string_names.h"
 #include "core/crypto/crypto_core.h"
 #include "core/debugger/engine_debugger.h"
+#include "core/hash_map.h"
 #include "core/io/compression.h"
+#include "core/local_vector.h"
 #include "core/object.h"
 #include "core/os/os.h"
 
@@ -47,6 +49,7 @@ struct _VariantCall {
 	}
 
 	struct FuncData {
+		StringName name;
 		int arg_count;
 		Vector<Variant> default_args;
 		Vector<Variant::Type> arg_types;
@@ -57,6 +60,7 @@ struct _VariantCall {
 		bool returns;
 
 		VariantFunc func;
+		Variant::ValidatedBuiltInMethod validated;
 
 		_FORCE_INLINE_ bool verify_arguments(const Variant **p_args, Callable::CallError &r_error) {
 			if (arg_count == 0) {
@@ -125,7 +129,17 @@ struct _VariantCall {
 	};
 
 	struct TypeFunc {
-		Map<StringName, FuncData> functions;
+		LocalVector<FuncData> functions;
+		HashMap<StringName, int> function_indices;
+
+		_FORCE_INLINE_ FuncData *find(const StringName &p_name) {
+			const int *idx = function_indices.getptr(p_name);
+			return idx ? &functions[*idx] : nullptr;
+		}
+		_FORCE_INLINE_ const FuncData *find(const StringName &p_name) const {
+			const int *idx = function_indices.getptr(p_name);
+			return idx ? &functions[*idx] : nullptr;
+		}
 	};
 
 	static TypeFunc *type_funcs;
@@ -144,7 +158,9 @@ struct _VariantCall {
 
 	static void make_func_return_variant(Variant::Type p_type, const StringName &p_name) {
 #ifdef DEBUG_ENABLED
-		type_funcs[p_type].functions[p_name].returns = true;
+		FuncData *fd = type_funcs[p_type].find(p_name);
+		ERR_FAIL_COND(!fd);
+		fd->returns = true;
 #endif
 	}
 
@@ -207,7 +223,30 @@ struct _VariantCall {
 	end:
 
 		funcdata.arg_count = funcdata.arg_types.size();
-		type_funcs[p_type].functions[p_name] = funcdata;
+		funcdata.name = p_name;
+
+		TypeFunc &tf = type_funcs[p_type];
+		FuncData *existing = tf.find(p_name);
+		if (existing) {
+			*existing = funcdata;
+		} else {
+			tf.function_indices[p_name] = tf.functions.size();
+			tf.functions.push_back(funcdata);
+		}
+	}
+
+	// Called once every function is registered, as the table doesn't move anymore.
+	static void make_validated_functions() {
+		for (int i = 0; i < Variant::VARIANT_MAX; i++) {
+			TypeFunc &tf = type_funcs[i];
+			for (uint32_t j = 0; j < tf.functions.size(); j++) {
+				FuncData &fd = tf.functions[j];
+				fd.validated.call = fd.func;
+				fd.validated.arg_types = fd.arg_types.ptr();
+				fd.validated.arg_count = fd.arg_count;
+				fd.validated.returns = fd.returns;
+			}
+		}
 	}
 
 #define VCALL_LOCALMEM0(m_type, m_method) \
@@ -1230,11 +1269,10 @@ void Variant::call_ptr(const StringName &p_method, const Variant **p_args, int p
 	} else {
 		r_error.error = Callable::CallError::CALL_OK;
 
-		Map<StringName, _VariantCall::FuncData>::Element *E = _VariantCall::type_funcs[type].functions.find(p_method);
+		_VariantCall::FuncData *funcdata = _VariantCall::type_funcs[type].find(p_method);
 
-		if (E) {
-			_VariantCall::FuncData &funcdata = E->get();
-			funcdata.call(ret, *this, p_args, p_argcount, r_error);
+		if (funcdata) {
+			funcdata->call(ret, *this, p_args, p_argcount, r_error);
 
 		} else {
 			//handle vararg functions manually
@@ -1270,6 +1308,47 @@ void Variant::call_ptr(const StringName &p_method, const Variant **p_args, int p
 	}
 }
 
+int Variant::get_builtin_method_index(Variant::Type p_type, const StringName &p_method) {
+	ERR_FAIL_INDEX_V(p_type, VARIANT_MAX, -1);
+	const int *idx = _VariantCall::type_funcs[p_type].function_indices.getptr(p_method);
+	return idx ? *idx : -1;
+}
+
+int Variant::get_builtin_method_count(Variant::Type p_type) {
+	ERR_FAIL_INDEX_V(p_type, VARIANT_MAX, 0);
+	return _VariantCall::type_funcs[p_type].functions.size();
+}
+
+StringName Variant::get_builtin_method_name(Variant::Type p_type, int p_index) {
+	ERR_FAIL_INDEX_V(p_type, VARIANT_MAX, StringName());
+	const _VariantCall::TypeFunc &tf = _VariantCall::type_funcs[p_type];
+	ERR_FAIL_INDEX_V(p_index, (int)tf.functions.size(), StringName());
+	return tf.functions[p_index].name;
+}
+
+const Variant::ValidatedBuiltInMethod *Variant::get_validated_builtin_method(Variant::Type p_type, int p_index) {
+	ERR_FAIL_INDEX_V(p_type, VARIANT_MAX, nullptr);
+	const _VariantCall::TypeFunc &tf = _VariantCall::type_funcs[p_type];
+	ERR_FAIL_INDEX_V(p_index, (int)tf.functions.size(), nullptr);
+	return &tf.functions[p_index].validated;
+}
+
+void Variant::call_builtin_method(int p_index, const Variant **p_args, int p_argcount, Variant *r_ret, Callable::CallError &r_error) {
+	_VariantCall::TypeFunc &tf = _VariantCall::type_funcs[type];
+	if (unlikely(p_index < 0 || p_index >= (int)tf.functions.size())) {
+		r_error.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
+		return;
+	}
+
+	r_error.error = Callable::CallError::CALL_OK;
+	Variant ret;
+	tf.functions[p_index].call(ret, *this, p_args, p_argcount, r_error);
+
+	if (r_error.error == Callable::CallError::CALL_OK && r_ret) {
+		*r_ret = ret;
+	}
+}
+
 #define VCALL(m_type, m_method) _VariantCall::_call_##m_type##_##m_method
 
 Variant Variant::construct(const Variant::Type p_type, const Variant **p_args, int p_argcount, Callable::CallError &r_error, bool p_strict) {
@@ -1484,76 +1563,76 @@ bool Variant::has_method(const StringName &p_method) const {
 	}
 
 	const _VariantCall::TypeFunc &tf = _VariantCall::type_funcs[type];
-	return tf.functions.has(p_method);
+	return tf.function_indices.has(p_method);
 }
 
 Vector<Variant::Type> Variant::get_method_argument_types(Variant::Type p_type, const StringName &p_method) {
 	const _VariantCall::TypeFunc &tf = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = tf.functions.find(p_method);
-	if (!E) {
+	const _VariantCall::FuncData *fd = tf.find(p_method);
+	if (!fd) {
 		return Vector<Variant::Type>();
 	}
 
-	return E->get().arg_types;
+	return fd->arg_types;
 }
 
 bool Variant::is_method_const(Variant::Type p_type, const StringName &p_method) {
 	const _VariantCall::TypeFunc &tf = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = tf.functions.find(p_method);
-	if (!E) {
+	const _VariantCall::FuncData *fd = tf.find(p_method);
+	if (!fd) {
 		return false;
 	}
 
-	return E->get()._const;
+	return fd->_const;
 }
 
 Vector<StringName> Variant::get_method_argument_names(Variant::Type p_type, const StringName &p_method) {
 	const _VariantCall::TypeFunc &tf = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = tf.functions.find(p_method);
-	if (!E) {
+	const _VariantCall::FuncData *fd = tf.find(p_method);
+	if (!fd) {
 		return Vector<StringName>();
 	}
 
-	return E->get().arg_names;
+	return fd->arg_names;
 }
 
 Variant::Type Variant::get_method_return_type(Variant::Type p_type, const StringName &p_method, bool *r_has_return) {
 	const _VariantCall::TypeFunc &tf = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = tf.functions.find(p_method);
-	if (!E) {
+	const _VariantCall::FuncData *fd = tf.find(p_method);
+	if (!fd) {
 		return Variant::NIL;
 	}
 
 	if (r_has_return) {
-		*r_has_return = E->get().returns;
+		*r_has_return = fd->returns;
 	}
 
-	return E->get().return_type;
+	return fd->return_type;
 }
 
 Vector<Variant> Variant::get_method_default_arguments(Variant::Type p_type, const StringName &p_method) {
 	const _VariantCall::TypeFunc &tf = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = tf.functions.find(p_method);
-	if (!E) {
+	const _VariantCall::FuncData *fd = tf.find(p_method);
+	if (!fd) {
 		return Vector<Variant>();
 	}
 
-	return E->get().default_args;
+	return fd->default_args;
 }
 
 void Variant::get_method_list(List<MethodInfo> *p_list) const {
 	const _VariantCall::TypeFunc &tf = _VariantCall::type_funcs[type];
 
-	for (const Map<StringName, _VariantCall::FuncData>::Element *E = tf.functions.front(); E; E = E->next()) {
-		const _VariantCall::FuncData &fd = E->get();
+	for (uint32_t f = 0; f < tf.functions.size(); f++) {
+		const _VariantCall::FuncData &fd = tf.functions[f];
 
 		MethodInfo mi;
-		mi.name = E->key();
+		mi.name = fd.name;
 
 		if (fd._const) {
 			mi.flags |= METHOD_FLAG_CONST;
@@ -2359,6 +2438,8 @@ void register_variant_methods() {
 	_VariantCall::add_variant_constant(Variant::PLANE, "PLANE_XY", Plane(Vector3(0, 0, 1), 0));
 
 	_VariantCall::add_variant_constant(Variant::QUAT, "IDENTITY", Quat(0, 0, 0, 1));
+
+	_VariantCall::make_validated_functions();
 }
 
 void unregister_variant_methods() {
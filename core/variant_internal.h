@@ -0,0 +1,89 @@
+/*************************************************************************/
+/*  variant_internal.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef VARIANT_INTERNAL_H
+#define VARIANT_INTERNAL_H
+
+#include "core/variant.h"
+
+// Direct access to the payload of simple Variant types, for hot paths (such
+// as script VMs) that already know the type of a value and want to skip the
+// type switch in the conversion operators. Callers must check get_type()
+// before using the getters; the setters convert the Variant in place.
+
+class VariantInternal {
+public:
+	_FORCE_INLINE_ static bool *get_bool(Variant *v) { return &v->_data._bool; }
+	_FORCE_INLINE_ static const bool *get_bool(const Variant *v) { return &v->_data._bool; }
+	_FORCE_INLINE_ static int64_t *get_int(Variant *v) { return &v->_data._int; }
+	_FORCE_INLINE_ static const int64_t *get_int(const Variant *v) { return &v->_data._int; }
+	_FORCE_INLINE_ static double *get_float(Variant *v) { return &v->_data._float; }
+	_FORCE_INLINE_ static const double *get_float(const Variant *v) { return &v->_data._float; }
+	_FORCE_INLINE_ static Vector2i *get_vector2i(Variant *v) { return reinterpret_cast<Vector2i *>(v->_data._mem); }
+	_FORCE_INLINE_ static const Vector2i *get_vector2i(const Variant *v) { return reinterpret_cast<const Vector2i *>(v->_data._mem); }
+	_FORCE_INLINE_ static Vector3 *get_vector3(Variant *v) { return reinterpret_cast<Vector3 *>(v->_data._mem); }
+	_FORCE_INLINE_ static const Vector3 *get_vector3(const Variant *v) { return reinterpret_cast<const Vector3 *>(v->_data._mem); }
+	_FORCE_INLINE_ static Vector3i *get_vector3i(Variant *v) { return reinterpret_cast<Vector3i *>(v->_data._mem); }
+	_FORCE_INLINE_ static const Vector3i *get_vector3i(const Variant *v) { return reinterpret_cast<const Vector3i *>(v->_data._mem); }
+
+	// Unvalidated, the pointer may be stray; see Variant::get_validated_object().
+	_FORCE_INLINE_ static Object *get_object(const Variant *v) { return v->_get_obj().obj; }
+	_FORCE_INLINE_ static ObjectID get_object_id(const Variant *v) { return v->_get_obj().id; }
+
+	// Reads INT or FLOAT as double, the same promotion Variant::evaluate() applies.
+	_FORCE_INLINE_ static double get_number(const Variant *v) {
+		return v->type == Variant::INT ? double(v->_data._int) : v->_data._float;
+	}
+
+	_FORCE_INLINE_ static void set_bool(Variant *v, bool p_value) {
+		_retype(v, Variant::BOOL);
+		v->_data._bool = p_value;
+	}
+	_FORCE_INLINE_ static void set_int(Variant *v, int64_t p_value) {
+		_retype(v, Variant::INT);
+		v->_data._int = p_value;
+	}
+	_FORCE_INLINE_ static void set_float(Variant *v, double p_value) {
+		_retype(v, Variant::FLOAT);
+		v->_data._float = p_value;
+	}
+
+private:
+	_FORCE_INLINE_ static void _retype(Variant *v, Variant::Type p_type) {
+		if (v->type != p_type) {
+			if (v->type > Variant::FLOAT) {
+				v->clear();
+			}
+			v->type = p_type;
+		}
+	}
+};
+
+#endif // VARIANT_INTERNAL_H
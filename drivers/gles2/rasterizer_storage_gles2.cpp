@@ -3532,6 +3532,20 @@ void RasterizerStorageGLES2::skeleton_bone_set_transform(RID p_skeleton, int p_b
 	}
 }
 
+void RasterizerStorageGLES2::skeleton_set_buffer(RID p_skeleton, const Vector<float> &p_buffer) {
+	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
+	ERR_FAIL_COND(!skeleton);
+
+	ERR_FAIL_COND(skeleton->use_2d);
+	ERR_FAIL_COND(p_buffer.size() != skeleton->size * 4 * 3);
+
+	skeleton->bone_data = p_buffer;
+
+	if (!skeleton->update_list.in_list()) {
+		skeleton_update_list.add(&skeleton->update_list);
+	}
+}
+
 Transform RasterizerStorageGLES2::skeleton_bone_get_transform(RID p_skeleton, int p_bone) const {
 	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
 	ERR_FAIL_COND_V(!skeleton, Transform());
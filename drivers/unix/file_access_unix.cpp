@@ -41,6 +41,7 @@
 #include <errno.h>
 
 #if defined(UNIX_ENABLED)
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -153,6 +154,14 @@ void FileAccessUnix::close() {
 		return;
 	}
 
+#if defined(UNIX_ENABLED)
+	if (map_ptr) {
+		munmap(map_ptr, map_len);
+		map_ptr = nullptr;
+		map_len = 0;
+	}
+#endif
+
 	fclose(f);
 	f = nullptr;
 
@@ -246,6 +255,35 @@ int FileAccessUnix::get_buffer(uint8_t *p_dst, int p_length) const {
 	return read;
 };
 
+const uint8_t *FileAccessUnix::map_read_only() {
+	ERR_FAIL_COND_V_MSG(!f, nullptr, "File must be opened before use.");
+
+#if defined(UNIX_ENABLED)
+	if (map_ptr) {
+		return (const uint8_t *)map_ptr;
+	}
+	if (flags != READ) {
+		return nullptr; // The mapping would not see later writes through the FILE buffer.
+	}
+
+	struct stat st;
+	if (fstat(fileno(f), &st) != 0 || st.st_size <= 0) {
+		return nullptr;
+	}
+
+	void *ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	if (ptr == MAP_FAILED) {
+		return nullptr;
+	}
+
+	map_ptr = ptr;
+	map_len = st.st_size;
+	return (const uint8_t *)map_ptr;
+#else
+	return nullptr;
+#endif
+}
+
 Error FileAccessUnix::get_error() const {
 	return last_error;
 }
@@ -48,6 +48,8 @@ class FileAccessUnix : public FileAccess {
 	String save_path;
 	String path;
 	String path_src;
+	void *map_ptr = nullptr;
+	size_t map_len = 0;
 
 	static FileAccess *create_libc();
 
@@ -70,6 +72,7 @@ public:
 
 	virtual uint8_t get_8() const; ///< get a byte
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *map_read_only();
 
 	virtual Error get_error() const; ///< get last error
 
@@ -59,16 +59,10 @@ Error EditorSceneImporterGLTF::_parse_json(const String &p_path, GLTFState &stat
 		return err;
 	}
 
-	Vector<uint8_t> array;
-	array.resize(f->get_len());
-	f->get_buffer(array.ptrw(), array.size());
-	String text;
-	text.parse_utf8((const char *)array.ptr(), array.size());
-
 	String err_txt;
 	int err_line;
 	Variant v;
-	err = JSON::parse(text, v, err_txt, err_line);
+	err = JSON::parse_file(f, v, err_txt, err_line);
 	if (err != OK) {
 		_err_print_error("", p_path.utf8().get_data(), err_line, err_txt.utf8().get_data(), ERR_HANDLER_SCRIPT);
 		return err;
@@ -99,13 +93,10 @@ Error EditorSceneImporterGLTF::_parse_glb(const String &p_path, GLTFState &state
 	uint32_t len = f->get_buffer(json_data.ptrw(), chunk_length);
 	ERR_FAIL_COND_V(len != chunk_length, ERR_FILE_CORRUPT);
 
-	String text;
-	text.parse_utf8((const char *)json_data.ptr(), json_data.size());
-
 	String err_txt;
 	int err_line;
 	Variant v;
-	err = JSON::parse(text, v, err_txt, err_line);
+	err = JSON::parse_utf8(json_data.ptr(), json_data.size(), v, err_txt, err_line);
 	if (err != OK) {
 		_err_print_error("", p_path.utf8().get_data(), err_line, err_txt.utf8().get_data(), ERR_HANDLER_SCRIPT);
 		return err;
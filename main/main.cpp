@@ -1174,6 +1174,8 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 	Engine::get_singleton()->set_physics_jitter_fix(GLOBAL_DEF("physics/common/physics_jitter_fix", 0.5));
 	Engine::get_singleton()->set_target_fps(GLOBAL_DEF("debug/settings/fps/force_fps", 0));
 	ProjectSettings::get_singleton()->set_custom_property_info("debug/settings/fps/force_fps", PropertyInfo(Variant::INT, "debug/settings/fps/force_fps", PROPERTY_HINT_RANGE, "0,120,1,or_greater"));
+	Memory::set_sample_interval(GLOBAL_DEF("debug/settings/memory/allocation_sample_interval", 0));
+	ProjectSettings::get_singleton()->set_custom_property_info("debug/settings/memory/allocation_sample_interval", PropertyInfo(Variant::INT, "debug/settings/memory/allocation_sample_interval", PROPERTY_HINT_RANGE, "0,1048576,1,or_greater"));
 
 	GLOBAL_DEF("debug/settings/stdout/print_fps", false);
 	GLOBAL_DEF("debug/settings/stdout/verbose_stdout", false);
@@ -35,6 +35,7 @@
 #include "scene/main/node.h"
 #include "scene/main/scene_tree.h"
 #include "servers/audio_server.h"
+#include "servers/navigation_server_3d.h"
 #include "servers/physics_server_2d.h"
 #include "servers/physics_server_3d.h"
 #include "servers/rendering_server.h"
@@ -71,6 +72,16 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(NAVIGATION_3D_LINK_REBUILD_TIME);
+	BIND_ENUM_CONSTANT(NAVIGATION_3D_LINK_REBUILT_REGIONS);
+	BIND_ENUM_CONSTANT(MESSAGE_QUEUE_LAST_FLUSH);
+	BIND_ENUM_CONSTANT(MESSAGE_QUEUE_FLUSH_MAX);
+	BIND_ENUM_CONSTANT(MEMORY_UNTAGGED);
+	BIND_ENUM_CONSTANT(MEMORY_RENDERER);
+	BIND_ENUM_CONSTANT(MEMORY_PHYSICS);
+	BIND_ENUM_CONSTANT(MEMORY_SCRIPTING);
+	BIND_ENUM_CONSTANT(MEMORY_RESOURCES);
+	BIND_ENUM_CONSTANT(MEMORY_AUDIO);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -115,6 +126,16 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/output_latency",
+		"navigation_3d/link_rebuild_time",
+		"navigation_3d/link_rebuilt_regions",
+		"message_queue/last_flush",
+		"message_queue/flush_max",
+		"memory/untagged",
+		"memory/renderer",
+		"memory/physics",
+		"memory/scripting",
+		"memory/resources",
+		"memory/audio",
 
 	};
 
@@ -177,6 +198,26 @@ float Performance::get_monitor(Monitor p_monitor) const {
 			return PhysicsServer3D::get_singleton()->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY:
 			return AudioServer::get_singleton()->get_output_latency();
+		case NAVIGATION_3D_LINK_REBUILD_TIME:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_LINK_REBUILD_TIME_USEC) / 1000000.0;
+		case NAVIGATION_3D_LINK_REBUILT_REGIONS:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_LINK_REBUILT_REGIONS);
+		case MESSAGE_QUEUE_LAST_FLUSH:
+			return MessageQueue::get_singleton()->get_last_flush_message_count();
+		case MESSAGE_QUEUE_FLUSH_MAX:
+			return MessageQueue::get_singleton()->get_max_flush_message_count();
+		case MEMORY_UNTAGGED:
+			return Memory::get_tag_usage(Memory::TAG_UNTAGGED);
+		case MEMORY_RENDERER:
+			return Memory::get_tag_usage(Memory::TAG_RENDERER);
+		case MEMORY_PHYSICS:
+			return Memory::get_tag_usage(Memory::TAG_PHYSICS);
+		case MEMORY_SCRIPTING:
+			return Memory::get_tag_usage(Memory::TAG_SCRIPTING);
+		case MEMORY_RESOURCES:
+			return Memory::get_tag_usage(Memory::TAG_RESOURCES);
+		case MEMORY_AUDIO:
+			return Memory::get_tag_usage(Memory::TAG_AUDIO);
 
 		default: {
 		}
@@ -217,6 +258,16 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
 
 	};
 
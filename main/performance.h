@@ -78,6 +78,16 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		NAVIGATION_3D_LINK_REBUILD_TIME,
+		NAVIGATION_3D_LINK_REBUILT_REGIONS,
+		MESSAGE_QUEUE_LAST_FLUSH,
+		MESSAGE_QUEUE_FLUSH_MAX,
+		MEMORY_UNTAGGED,
+		MEMORY_RENDERER,
+		MEMORY_PHYSICS,
+		MEMORY_SCRIPTING,
+		MEMORY_RESOURCES,
+		MEMORY_AUDIO,
 		MONITOR_MAX
 	};
 
@@ -0,0 +1,239 @@
+/*************************************************************************/
+/*  test_allocator.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_allocator.h"
+
+#include "core/os/os.h"
+#include "core/os/small_allocator.h"
+#include "core/os/thread.h"
+#include "scene/2d/node_2d.h"
+#include "scene/resources/packed_scene.h"
+
+namespace TestAllocator {
+
+static uint64_t _checksum(const uint8_t *p_data, size_t p_size) {
+	uint64_t sum = 0;
+	for (size_t i = 0; i < p_size; i++) {
+		sum = sum * 31 + p_data[i];
+	}
+	return sum;
+}
+
+// Allocates blocks on one thread and frees them on another, the way queued
+// messages and resources loaded in the background are released.
+struct CrossThreadData {
+	Vector<uint8_t *> blocks;
+	bool pass = true;
+};
+
+static void _free_blocks(void *p_ud) {
+	CrossThreadData &data = *(CrossThreadData *)p_ud;
+	for (int i = 0; i < data.blocks.size(); i++) {
+		uint8_t *block = data.blocks[i];
+		size_t size = 1 + i % 500;
+		for (size_t j = 0; j < size; j++) {
+			if (block[j] != uint8_t(i)) {
+				data.pass = false;
+				break;
+			}
+		}
+		memfree(block);
+	}
+}
+
+static bool _test_cross_thread_free() {
+	CrossThreadData data;
+	for (int round = 0; round < 4; round++) {
+		data.blocks.resize(50000);
+		for (int i = 0; i < data.blocks.size(); i++) {
+			size_t size = 1 + i % 500;
+			data.blocks.write[i] = (uint8_t *)memalloc(size);
+			memset(data.blocks[i], uint8_t(i), size);
+		}
+
+		Thread *thread = Thread::create(_free_blocks, &data);
+		Thread::wait_to_finish(thread);
+	}
+	return data.pass;
+}
+
+static bool _test_realloc() {
+	bool pass = true;
+	uint8_t *block = nullptr;
+	size_t size = 0;
+	// Grow through the small size classes into system blocks and back down.
+	for (int step = 0; step < 80; step++) {
+		size_t new_size = step < 40 ? (step + 1) * 24 : (80 - step) * 24;
+		block = (uint8_t *)memrealloc(block, new_size);
+		for (size_t i = 0; i < MIN(size, new_size); i++) {
+			pass = pass && block[i] == uint8_t(i * 7);
+		}
+		for (size_t i = 0; i < new_size; i++) {
+			block[i] = uint8_t(i * 7);
+		}
+		size = new_size;
+	}
+	memfree(block);
+	return pass;
+}
+
+static double _alloc_free_msec(bool p_memalloc, int p_count, int p_rounds) {
+	OS *os = OS::get_singleton();
+	Vector<void *> blocks;
+	blocks.resize(p_count);
+
+	uint64_t from = os->get_ticks_usec();
+	for (int round = 0; round < p_rounds; round++) {
+		for (int i = 0; i < p_count; i++) {
+			size_t size = 16 + (i * 7) % 240;
+			blocks.write[i] = p_memalloc ? memalloc(size) : malloc(size);
+		}
+		for (int i = 0; i < p_count; i++) {
+			if (p_memalloc) {
+				memfree(blocks[i]);
+			} else {
+				free(blocks[i]);
+			}
+		}
+	}
+	return (os->get_ticks_usec() - from) / 1000.0;
+}
+
+static Node *_make_scene() {
+	Node2D *root = memnew(Node2D);
+	root->set_name("Enemy");
+	for (int i = 0; i < 8; i++) {
+		Node2D *part = memnew(Node2D);
+		part->set_name("Part" + itos(i));
+		part->set_position(Vector2(i, -i));
+		root->add_child(part);
+		part->set_owner(root);
+	}
+	return root;
+}
+
+static double _instancing_msec(const Ref<PackedScene> &p_scene, int p_count, bool &r_pass) {
+	OS *os = OS::get_singleton();
+	Vector<Node *> nodes;
+	nodes.resize(p_count);
+
+	uint64_t from = os->get_ticks_usec();
+	for (int i = 0; i < p_count; i++) {
+		nodes.write[i] = p_scene->instance();
+	}
+	for (int i = 0; i < p_count; i++) {
+		r_pass = r_pass && nodes[i]->get_child_count() == 8;
+		memdelete(nodes[i]);
+	}
+	return (os->get_ticks_usec() - from) / 1000.0;
+}
+
+static double _dictionary_churn_msec(int p_count, bool &r_pass) {
+	OS *os = OS::get_singleton();
+
+	uint64_t from = os->get_ticks_usec();
+	Array kept;
+	for (int i = 0; i < p_count; i++) {
+		Dictionary d;
+		d["name"] = "item";
+		d["id"] = i;
+		d["position"] = Vector2(i, i);
+		d["tags"] = Array();
+
+		// Copies and erases, like a state snapshot being diffed every frame.
+		Dictionary copy = d.duplicate();
+		copy.erase("tags");
+		copy["dirty"] = true;
+		if (i % 16 == 0) {
+			kept.push_back(copy);
+		}
+	}
+	r_pass = r_pass && kept.size() == (p_count + 15) / 16 && Dictionary(kept[1])["id"] == Variant(16);
+	return (os->get_ticks_usec() - from) / 1000.0;
+}
+
+static double _string_building_msec(int p_count, bool &r_pass) {
+	OS *os = OS::get_singleton();
+
+	uint64_t from = os->get_ticks_usec();
+	uint64_t sum = 0;
+	for (int i = 0; i < p_count; i++) {
+		String s = "Node" + itos(i);
+		s += "/";
+		s += String::num(i * 0.5);
+		Vector<String> parts = s.split("/");
+		CharString utf8 = parts[0].utf8();
+		sum += _checksum((const uint8_t *)utf8.get_data(), utf8.length());
+	}
+	r_pass = r_pass && sum != 0;
+	return (os->get_ticks_usec() - from) / 1000.0;
+}
+
+MainLoop *test() {
+	OS *os = OS::get_singleton();
+
+#ifdef SMALL_ALLOCATOR_ENABLED
+	os->print("Small allocator enabled (blocks up to %d bytes).\n", SmallAllocator::MAX_SIZE);
+#else
+	os->print("Small allocator disabled, build with small_allocator=yes to compare.\n");
+#endif
+
+	bool pass = _test_cross_thread_free();
+	os->print("cross thread free test %s.\n", pass ? "passed" : "FAILED");
+	bool realloc_pass = _test_realloc();
+	os->print("realloc test %s.\n", realloc_pass ? "passed" : "FAILED");
+	pass = pass && realloc_pass;
+
+	os->print("100000 small blocks, 20 rounds:\n");
+	os->print("\tmemalloc/memfree: %.2f msec\n", _alloc_free_msec(true, 100000, 20));
+	os->print("\tmalloc/free: %.2f msec\n", _alloc_free_msec(false, 100000, 20));
+
+	Node *source = _make_scene();
+	Ref<PackedScene> scene;
+	scene.instance();
+	Error err = scene->pack(source);
+	memdelete(source);
+	pass = pass && err == OK;
+
+	if (err == OK) {
+		os->print("instance and free 20000 scenes: %.2f msec\n", _instancing_msec(scene, 20000, pass));
+	}
+	os->print("dictionary churn, 100000 dictionaries: %.2f msec\n", _dictionary_churn_msec(100000, pass));
+	os->print("string building, 100000 strings: %.2f msec\n", _string_building_msec(100000, pass));
+
+#ifdef SMALL_ALLOCATOR_ENABLED
+	os->print("%d chunks in use.\n", (int)SmallAllocator::get_chunk_count());
+#endif
+
+	os->print("Allocator test %s\n", pass ? "passed" : "FAILED");
+	return nullptr;
+}
+
+} // namespace TestAllocator
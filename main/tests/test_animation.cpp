@@ -0,0 +1,178 @@
+/*************************************************************************/
+/*  test_animation.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_animation.h"
+
+#include "core/os/os.h"
+#include "scene/resources/animation.h"
+
+namespace TestAnimation {
+
+enum {
+	KEY_COUNT = 9,
+	SAMPLE_COUNT = 241,
+};
+
+static const float KEY_STEP = 0.25;
+static const float SAMPLE_STEP = 0.01;
+
+// Rotations past PI have a negative largest component, which is the sign smallest
+// three compression normalizes away.
+static Quat _key_rotation(int p_track, int p_key) {
+	return Quat(Vector3(1, p_key * 0.3, -0.5 + p_track * 0.2).normalized(), 2.5 + p_key * 0.4);
+}
+
+// Shaped like an imported skeletal animation: baked tracks sharing their key
+// times, plus a value track and a track with keys of its own in between.
+static Ref<Animation> _make_animation() {
+	Ref<Animation> anim;
+	anim.instance();
+	anim->set_length((KEY_COUNT - 1) * KEY_STEP);
+
+	const Animation::InterpolationType interpolations[] = {
+		Animation::INTERPOLATION_LINEAR,
+		Animation::INTERPOLATION_LINEAR,
+		Animation::INTERPOLATION_CUBIC,
+		Animation::INTERPOLATION_CUBIC,
+		Animation::INTERPOLATION_NEAREST,
+		Animation::INTERPOLATION_LINEAR,
+	};
+
+	for (int i = 0; i < 6; i++) {
+		if (i == 2) {
+			int value_track = anim->add_track(Animation::TYPE_VALUE);
+			anim->track_set_path(value_track, NodePath("Skeleton:visible"));
+			anim->track_insert_key(value_track, 0, true);
+		}
+
+		int track = anim->add_track(Animation::TYPE_TRANSFORM);
+		anim->track_set_path(track, NodePath("Skeleton:bone_" + itos(i)));
+		anim->track_set_interpolation_type(track, interpolations[i]);
+
+		for (int j = 0; j < KEY_COUNT; j++) {
+			// The nearest track has its own key times, the last one a constant rotation and scale.
+			float time = i == 4 ? j * KEY_STEP * 0.9 + 0.1 : j * KEY_STEP;
+			Vector3 loc(Math::sin(j * 0.7 + i), j * 0.2 - 1, Math::cos(j * 1.3) * (i + 1));
+			Quat rot = i == 5 ? _key_rotation(i, 0) : _key_rotation(i, j);
+			Vector3 scale = i == 5 ? Vector3(1, 1, 1) : Vector3(1, 1, 1) + Vector3(0.1, 0.2, 0.3) * j;
+			anim->transform_track_insert_key(track, time, loc, rot, scale);
+		}
+	}
+
+	// Tracks that share key times but not the loop wrap need a span of their own.
+	anim->track_set_interpolation_loop_wrap(4, false);
+
+	return anim;
+}
+
+static float _sample_time(int p_sample) {
+	return p_sample * SAMPLE_STEP - 0.1;
+}
+
+MainLoop *test() {
+	OS *os = OS::get_singleton();
+
+	Ref<Animation> anim = _make_animation();
+	int track_count = anim->get_track_count();
+
+	// Reference values from the uncompressed tracks, without and with looping.
+	Vector<Animation::TransformTrackSample> expected;
+	expected.resize(2 * SAMPLE_COUNT * track_count);
+	for (int loop = 0; loop < 2; loop++) {
+		anim->set_loop(loop);
+		for (int i = 0; i < SAMPLE_COUNT; i++) {
+			for (int j = 0; j < track_count; j++) {
+				Animation::TransformTrackSample &s = expected.write[(loop * SAMPLE_COUNT + i) * track_count + j];
+				if (anim->track_get_type(j) == Animation::TYPE_TRANSFORM) {
+					s.valid = anim->transform_track_interpolate(j, _sample_time(i), &s.loc, &s.rot, &s.scale) == OK;
+				}
+			}
+		}
+	}
+
+	anim->compress(false);
+
+	bool pass = true;
+	for (int i = 0; i < track_count; i++) {
+		if (anim->track_get_type(i) == Animation::TYPE_TRANSFORM && !anim->transform_track_is_compressed(i)) {
+			os->print("Track %d was not compressed.\n", i);
+			pass = false;
+		}
+	}
+
+	float loc_error = 0;
+	float rot_error = 0;
+	float scale_error = 0;
+	Vector<Animation::TransformTrackSample> samples;
+	samples.resize(track_count);
+	for (int loop = 0; loop < 2; loop++) {
+		anim->set_loop(loop);
+		for (int i = 0; i < SAMPLE_COUNT; i++) {
+			anim->transform_tracks_sample(_sample_time(i), samples.ptrw());
+
+			for (int j = 0; j < track_count; j++) {
+				const Animation::TransformTrackSample &e = expected[(loop * SAMPLE_COUNT + i) * track_count + j];
+				const Animation::TransformTrackSample &s = samples[j];
+				if (s.valid != e.valid) {
+					os->print("Track %d at %.2f: valid is %d, expected %d.\n", j, _sample_time(i), s.valid, e.valid);
+					pass = false;
+					continue;
+				}
+				if (!s.valid) {
+					continue;
+				}
+
+				// Sampling a single compressed track gives exactly the same result.
+				Vector3 loc;
+				Quat rot;
+				Vector3 scale;
+				anim->transform_track_interpolate(j, _sample_time(i), &loc, &rot, &scale);
+				if (loc != s.loc || rot != s.rot || scale != s.scale) {
+					os->print("Track %d at %.2f: batched sample differs from transform_track_interpolate().\n", j, _sample_time(i));
+					pass = false;
+				}
+
+				loc_error = MAX(loc_error, (s.loc - e.loc).length());
+				rot_error = MAX(rot_error, 2 * Math::acos(MIN(1.0f, Math::abs(s.rot.dot(e.rot)))));
+				scale_error = MAX(scale_error, (s.scale - e.scale).length());
+			}
+		}
+	}
+
+	// 16 bit locations and scales over ranges of a few units, 15 bit rotation
+	// components (the angle is limited by the float precision of acos()).
+	os->print("Max error: location %f, rotation %f rad, scale %f\n", loc_error, rot_error, scale_error);
+	pass = pass && loc_error < 0.001 && rot_error < 0.01 && scale_error < 0.001;
+
+	os->print("Animation test %s\n", pass ? "passed" : "FAILED");
+	return nullptr;
+}
+
+} // namespace TestAnimation
@@ -0,0 +1,253 @@
+/*************************************************************************/
+/*  test_broadphase.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_broadphase.h"
+
+#include "core/math/random_number_generator.h"
+#include "core/os/os.h"
+#include "servers/physics_2d/body_2d_sw.h"
+#include "servers/physics_2d/broad_phase_2d_bvh.h"
+#include "servers/physics_2d/broad_phase_2d_hash_grid.h"
+#include "servers/physics_3d/body_3d_sw.h"
+#include "servers/physics_3d/broad_phase_3d_bvh.h"
+#include "servers/physics_3d/broad_phase_octree.h"
+
+namespace TestBroadphase {
+
+static const int BODY_COUNT = 10000;
+static const int STEP_COUNT = 60;
+static const int STATIC_EVERY = 4; // One in four bodies never moves.
+
+static void *_pair(void *p_A, int p_subindex_A, void *p_B, int p_subindex_B, void *p_userdata) {
+	(*(int *)p_userdata)++;
+	return nullptr;
+}
+
+static void _unpair(void *p_A, int p_subindex_A, void *p_B, int p_subindex_B, void *p_data, void *p_userdata) {
+	(*(int *)p_userdata)--;
+}
+
+static void *_pair_3d(CollisionObject3DSW *p_A, int p_subindex_A, CollisionObject3DSW *p_B, int p_subindex_B, void *p_userdata) {
+	return _pair(p_A, p_subindex_A, p_B, p_subindex_B, p_userdata);
+}
+
+static void _unpair_3d(CollisionObject3DSW *p_A, int p_subindex_A, CollisionObject3DSW *p_B, int p_subindex_B, void *p_data, void *p_userdata) {
+	_unpair(p_A, p_subindex_A, p_B, p_subindex_B, p_data, p_userdata);
+}
+
+static void *_pair_2d(CollisionObject2DSW *p_A, int p_subindex_A, CollisionObject2DSW *p_B, int p_subindex_B, void *p_userdata) {
+	return _pair(p_A, p_subindex_A, p_B, p_subindex_B, p_userdata);
+}
+
+static void _unpair_2d(CollisionObject2DSW *p_A, int p_subindex_A, CollisionObject2DSW *p_B, int p_subindex_B, void *p_data, void *p_userdata) {
+	_unpair(p_A, p_subindex_A, p_B, p_subindex_B, p_data, p_userdata);
+}
+
+static bool _same_counts(const Vector<int> &p_a, const Vector<int> &p_b) {
+	if (p_a.size() != p_b.size()) {
+		return false;
+	}
+	for (int i = 0; i < p_a.size(); i++) {
+		if (p_a[i] != p_b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Runs the same motion on a broadphase and returns the pair count after every step.
+static Vector<int> _run_3d(BroadPhase3DSW *p_bp, const Vector<Body3DSW *> &p_bodies, const Vector<AABB> &p_start, const Vector<Vector3> &p_velocity, uint64_t &r_usec) {
+	int pairs = 0;
+	p_bp->set_pair_callback(_pair_3d, &pairs);
+	p_bp->set_unpair_callback(_unpair_3d, &pairs);
+
+	Vector<BroadPhase3DSW::ID> ids;
+	ids.resize(p_bodies.size());
+	Vector<AABB> aabbs = p_start;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < p_bodies.size(); i++) {
+		ids.write[i] = p_bp->create(p_bodies[i]);
+		p_bp->set_static(ids[i], (i % STATIC_EVERY) == 0);
+		p_bp->move(ids[i], aabbs[i]);
+	}
+	p_bp->update();
+
+	Vector<int> counts;
+	for (int s = 0; s < STEP_COUNT; s++) {
+		for (int i = 0; i < p_bodies.size(); i++) {
+			if ((i % STATIC_EVERY) == 0) {
+				continue;
+			}
+			aabbs.write[i].position += p_velocity[i];
+			p_bp->move(ids[i], aabbs[i]);
+		}
+		p_bp->update();
+		counts.push_back(pairs);
+	}
+
+	r_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	for (int i = 0; i < ids.size(); i++) {
+		p_bp->remove(ids[i]);
+	}
+	if (pairs != 0) {
+		counts.push_back(-1); // Every pair must be released on removal.
+	}
+	return counts;
+}
+
+static Vector<int> _run_2d(BroadPhase2DSW *p_bp, const Vector<Body2DSW *> &p_bodies, const Vector<Rect2> &p_start, const Vector<Vector2> &p_velocity, uint64_t &r_usec) {
+	int pairs = 0;
+	p_bp->set_pair_callback(_pair_2d, &pairs);
+	p_bp->set_unpair_callback(_unpair_2d, &pairs);
+
+	Vector<BroadPhase2DSW::ID> ids;
+	ids.resize(p_bodies.size());
+	Vector<Rect2> rects = p_start;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < p_bodies.size(); i++) {
+		ids.write[i] = p_bp->create(p_bodies[i]);
+		p_bp->set_static(ids[i], (i % STATIC_EVERY) == 0);
+		p_bp->move(ids[i], rects[i]);
+	}
+	p_bp->update();
+
+	Vector<int> counts;
+	for (int s = 0; s < STEP_COUNT; s++) {
+		for (int i = 0; i < p_bodies.size(); i++) {
+			if ((i % STATIC_EVERY) == 0) {
+				continue;
+			}
+			rects.write[i].position += p_velocity[i];
+			p_bp->move(ids[i], rects[i]);
+		}
+		p_bp->update();
+		counts.push_back(pairs);
+	}
+
+	r_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	for (int i = 0; i < ids.size(); i++) {
+		p_bp->remove(ids[i]);
+	}
+	if (pairs != 0) {
+		counts.push_back(-1);
+	}
+	return counts;
+}
+
+static bool _test_3d() {
+	RandomNumberGenerator rng;
+	rng.set_seed(1234);
+
+	Vector<Body3DSW *> bodies;
+	Vector<AABB> aabbs;
+	Vector<Vector3> velocity;
+	for (int i = 0; i < BODY_COUNT; i++) {
+		bodies.push_back(memnew(Body3DSW));
+		Vector3 pos(rng.randf_range(-500, 500), rng.randf_range(-50, 50), rng.randf_range(-500, 500));
+		// Mostly small bodies with a few large ones, which is the worst case for the octree.
+		Vector3 size = Vector3(1, 1, 1) * ((i % 100) == 0 ? rng.randf_range(20, 60) : rng.randf_range(0.5, 3));
+		aabbs.push_back(AABB(pos, size));
+		velocity.push_back(Vector3(rng.randf_range(-1, 1), rng.randf_range(-0.2, 0.2), rng.randf_range(-1, 1)) * 0.25);
+	}
+
+	uint64_t octree_usec = 0;
+	BroadPhase3DSW *octree = BroadPhaseOctree::_create();
+	Vector<int> octree_counts = _run_3d(octree, bodies, aabbs, velocity, octree_usec);
+	memdelete(octree);
+
+	uint64_t bvh_usec = 0;
+	BroadPhase3DSW *bvh = BroadPhase3DBVH::_create();
+	Vector<int> bvh_counts = _run_3d(bvh, bodies, aabbs, velocity, bvh_usec);
+	memdelete(bvh);
+
+	for (int i = 0; i < bodies.size(); i++) {
+		memdelete(bodies[i]);
+	}
+
+	bool pass = _same_counts(octree_counts, bvh_counts);
+	OS::get_singleton()->print("3D, %d bodies, %d steps, %d pairs at the end.\n", BODY_COUNT, STEP_COUNT, bvh_counts[STEP_COUNT - 1]);
+	OS::get_singleton()->print("\toctree: %.3f msec per step\n", octree_usec / 1000.0 / STEP_COUNT);
+	OS::get_singleton()->print("\tbvh: %.3f msec per step\n", bvh_usec / 1000.0 / STEP_COUNT);
+	OS::get_singleton()->print("\tpair counts %s\n", pass ? "match" : "DIFFER");
+	return pass;
+}
+
+static bool _test_2d() {
+	RandomNumberGenerator rng;
+	rng.set_seed(4321);
+
+	Vector<Body2DSW *> bodies;
+	Vector<Rect2> rects;
+	Vector<Vector2> velocity;
+	for (int i = 0; i < BODY_COUNT; i++) {
+		bodies.push_back(memnew(Body2DSW));
+		Vector2 pos(rng.randf_range(-10000, 10000), rng.randf_range(-10000, 10000));
+		Vector2 size = Vector2(1, 1) * ((i % 100) == 0 ? rng.randf_range(400, 1200) : rng.randf_range(8, 64));
+		rects.push_back(Rect2(pos, size));
+		velocity.push_back(Vector2(rng.randf_range(-1, 1), rng.randf_range(-1, 1)) * 5.0);
+	}
+
+	uint64_t grid_usec = 0;
+	BroadPhase2DSW *grid = BroadPhase2DHashGrid::_create();
+	Vector<int> grid_counts = _run_2d(grid, bodies, rects, velocity, grid_usec);
+	memdelete(grid);
+
+	uint64_t bvh_usec = 0;
+	BroadPhase2DSW *bvh = BroadPhase2DBVH::_create();
+	Vector<int> bvh_counts = _run_2d(bvh, bodies, rects, velocity, bvh_usec);
+	memdelete(bvh);
+
+	for (int i = 0; i < bodies.size(); i++) {
+		memdelete(bodies[i]);
+	}
+
+	bool pass = _same_counts(grid_counts, bvh_counts);
+	OS::get_singleton()->print("2D, %d bodies, %d steps, %d pairs at the end.\n", BODY_COUNT, STEP_COUNT, bvh_counts[STEP_COUNT - 1]);
+	OS::get_singleton()->print("\thash grid: %.3f msec per step\n", grid_usec / 1000.0 / STEP_COUNT);
+	OS::get_singleton()->print("\tbvh: %.3f msec per step\n", bvh_usec / 1000.0 / STEP_COUNT);
+	OS::get_singleton()->print("\tpair counts %s\n", pass ? "match" : "DIFFER");
+	return pass;
+}
+
+MainLoop *test() {
+	bool pass = _test_3d();
+	pass = _test_2d() && pass;
+
+	OS::get_singleton()->print("Broadphase test %s\n", pass ? "passed" : "FAILED");
+	return nullptr;
+}
+
+} // namespace TestBroadphase
@@ -0,0 +1,226 @@
+/*************************************************************************/
+/*  test_compact_ordered_hash_map.cpp                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_compact_ordered_hash_map.h"
+
+#include "core/compact_ordered_hash_map.h"
+#include "core/ordered_hash_map.h"
+#include "core/os/os.h"
+#include "core/variant.h"
+
+namespace TestCompactOrderedHashMap {
+
+typedef OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> ListMap;
+typedef CompactOrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> CompactMap;
+
+// Keys like the ones Dictionaries get from game state and network messages.
+static Vector<Variant> _make_keys(int p_count) {
+	Vector<Variant> keys;
+	keys.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		keys.write[i] = (i % 2) ? Variant("key_" + itos(i)) : Variant(i * 7919);
+	}
+	return keys;
+}
+
+struct Timings {
+	uint64_t insert = 0;
+	uint64_t lookup = 0;
+	uint64_t iterate = 0;
+	uint64_t erase = 0;
+	int64_t checksum = 0;
+};
+
+static void _bench_list(const Vector<Variant> &p_keys, int p_map_count, Timings &r_timings) {
+	OS *os = OS::get_singleton();
+	Vector<ListMap *> maps;
+	for (int m = 0; m < p_map_count; m++) {
+		maps.push_back(memnew(ListMap));
+	}
+
+	uint64_t from = os->get_ticks_usec();
+	for (int m = 0; m < p_map_count; m++) {
+		for (int i = 0; i < p_keys.size(); i++) {
+			(*maps[m])[p_keys[i]] = i;
+		}
+	}
+	r_timings.insert += os->get_ticks_usec() - from;
+
+	from = os->get_ticks_usec();
+	for (int m = 0; m < p_map_count; m++) {
+		for (int i = 0; i < p_keys.size(); i++) {
+			ListMap::Element E = maps[m]->find(p_keys[i]);
+			r_timings.checksum += E ? int(E.get()) : -1;
+		}
+	}
+	r_timings.lookup += os->get_ticks_usec() - from;
+
+	from = os->get_ticks_usec();
+	for (int m = 0; m < p_map_count; m++) {
+		for (ListMap::Element E = maps[m]->front(); E; E = E.next()) {
+			r_timings.checksum += int(E.get());
+		}
+	}
+	r_timings.iterate += os->get_ticks_usec() - from;
+
+	from = os->get_ticks_usec();
+	for (int m = 0; m < p_map_count; m++) {
+		for (int i = 0; i < p_keys.size(); i += 2) {
+			maps[m]->erase(p_keys[i]);
+		}
+		for (ListMap::Element E = maps[m]->front(); E; E = E.next()) {
+			r_timings.checksum += int(E.get());
+		}
+		memdelete(maps[m]);
+	}
+	r_timings.erase += os->get_ticks_usec() - from;
+}
+
+static void _bench_compact(const Vector<Variant> &p_keys, int p_map_count, Timings &r_timings) {
+	OS *os = OS::get_singleton();
+	Vector<CompactMap *> maps;
+	for (int m = 0; m < p_map_count; m++) {
+		maps.push_back(memnew(CompactMap));
+	}
+
+	uint64_t from = os->get_ticks_usec();
+	for (int m = 0; m < p_map_count; m++) {
+		for (int i = 0; i < p_keys.size(); i++) {
+			(*maps[m])[p_keys[i]] = i;
+		}
+	}
+	r_timings.insert += os->get_ticks_usec() - from;
+
+	from = os->get_ticks_usec();
+	for (int m = 0; m < p_map_count; m++) {
+		for (int i = 0; i < p_keys.size(); i++) {
+			const Variant *v = maps[m]->getptr(p_keys[i]);
+			r_timings.checksum += v ? int(*v) : -1;
+		}
+	}
+	r_timings.lookup += os->get_ticks_usec() - from;
+
+	from = os->get_ticks_usec();
+	for (int m = 0; m < p_map_count; m++) {
+		for (int i = maps[m]->front_position(); i >= 0; i = maps[m]->next_position(i)) {
+			r_timings.checksum += int(maps[m]->get_value(i));
+		}
+	}
+	r_timings.iterate += os->get_ticks_usec() - from;
+
+	from = os->get_ticks_usec();
+	for (int m = 0; m < p_map_count; m++) {
+		for (int i = 0; i < p_keys.size(); i += 2) {
+			maps[m]->erase(p_keys[i]);
+		}
+		for (int i = maps[m]->front_position(); i >= 0; i = maps[m]->next_position(i)) {
+			r_timings.checksum += int(maps[m]->get_value(i));
+		}
+		memdelete(maps[m]);
+	}
+	r_timings.erase += os->get_ticks_usec() - from;
+}
+
+static bool _test_order() {
+	CompactMap map;
+	for (int i = 0; i < 100; i++) {
+		map[i] = i * 2;
+	}
+	Variant *first = map.getptr(0);
+	for (int i = 100; i < 1000; i++) {
+		map[i] = i * 2;
+	}
+	bool pass = first == map.getptr(0); // Inserting must not move existing values.
+
+	for (int i = 0; i < 1000; i += 3) {
+		pass = pass && map.erase(i);
+	}
+	pass = pass && !map.erase(0) && !map.has(3) && map.has(1);
+	map[0] = 0; // Erased and reinserted keys go last.
+
+	int expected = 1;
+	int count = 0;
+	int last = -1;
+	for (int i = map.front_position(); i >= 0; i = map.next_position(i)) {
+		int key = map.get_key(i);
+		if (count < map.size() - 1) {
+			pass = pass && key == expected && int(map.get_value(i)) == key * 2;
+			expected += (expected % 3 == 1) ? 1 : 2;
+		}
+		last = key;
+		count++;
+	}
+	pass = pass && count == map.size() && last == 0;
+
+	// Erasing most entries compacts the holes away.
+	for (int i = 0; i < 990; i++) {
+		map.erase(i);
+	}
+	pass = pass && map.size() == 6 && map.get_position_count() <= 6 + 8 && int(map.get_key(map.front_position())) == 991;
+
+	return pass;
+}
+
+MainLoop *test() {
+	OS *os = OS::get_singleton();
+
+	bool pass = _test_order();
+
+	struct Case {
+		const char *name;
+		int keys;
+		int maps;
+	};
+	Case cases[] = {
+		{ "small", 8, 100000 },
+		{ "medium", 128, 5000 },
+		{ "large", 200000, 2 },
+	};
+
+	for (int c = 0; c < 3; c++) {
+		Vector<Variant> keys = _make_keys(cases[c].keys);
+		Timings list;
+		Timings compact;
+		_bench_list(keys, cases[c].maps, list);
+		_bench_compact(keys, cases[c].maps, compact);
+
+		os->print("%s: %d maps of %d keys\n", cases[c].name, cases[c].maps, cases[c].keys);
+		os->print("\tinsert: %.2f msec (list) / %.2f msec (compact)\n", list.insert / 1000.0, compact.insert / 1000.0);
+		os->print("\tlookup: %.2f msec (list) / %.2f msec (compact)\n", list.lookup / 1000.0, compact.lookup / 1000.0);
+		os->print("\titerate: %.2f msec (list) / %.2f msec (compact)\n", list.iterate / 1000.0, compact.iterate / 1000.0);
+		os->print("\terase: %.2f msec (list) / %.2f msec (compact)\n", list.erase / 1000.0, compact.erase / 1000.0);
+		pass = pass && list.checksum == compact.checksum;
+	}
+
+	os->print("CompactOrderedHashMap test %s\n", pass ? "passed" : "FAILED");
+	return nullptr;
+}
+
+} // namespace TestCompactOrderedHashMap
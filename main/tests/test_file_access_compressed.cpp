@@ -0,0 +1,189 @@
+/*************************************************************************/
+/*  test_file_access_compressed.cpp                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_file_access_compressed.h"
+
+#include "core/io/file_access_compressed.h"
+#include "core/math/random_pcg.h"
+#include "core/os/dir_access.h"
+#include "core/os/os.h"
+
+namespace TestFileAccessCompressed {
+
+enum {
+	BLOCK_SIZE = 4096,
+	BLOCK_COUNT = 24, // More than the cached and read ahead blocks together, so seeks evict.
+};
+
+// Compressible, but different in every block so reading the wrong one shows.
+static Vector<uint8_t> _make_data(int p_size) {
+	Vector<uint8_t> data;
+	data.resize(p_size);
+	uint8_t *w = data.ptrw();
+	RandomPCG rng(p_size);
+	for (int i = 0; i < p_size; i++) {
+		w[i] = uint8_t((i * 13) ^ (i / BLOCK_SIZE) ^ (rng.rand() & 3));
+	}
+	return data;
+}
+
+static bool _write_file(const String &p_path, const Vector<uint8_t> &p_data) {
+	FileAccessCompressed *fac = memnew(FileAccessCompressed);
+	fac->configure("GCPF", Compression::MODE_ZSTD, BLOCK_SIZE);
+	if (fac->_open(p_path, FileAccess::WRITE) != OK) {
+		memdelete(fac);
+		return false;
+	}
+	fac->store_buffer(p_data.ptr(), p_data.size());
+	fac->close();
+	memdelete(fac);
+	return true;
+}
+
+// Seeks to p_from and reads p_length bytes, which may go past the end.
+static bool _check_read(FileAccessCompressed *p_file, const Vector<uint8_t> &p_data, int p_from, int p_length) {
+	static Vector<uint8_t> buf;
+	buf.resize(p_length);
+
+	p_file->seek(p_from);
+	int expected = MIN(p_length, p_data.size() - p_from);
+	int read = p_file->get_buffer(buf.ptrw(), p_length);
+
+	if (read != expected || memcmp(buf.ptr(), &p_data[p_from], expected) != 0) {
+		OS::get_singleton()->print("\tRead of %d bytes at %d returned %d bytes, expected %d.\n", p_length, p_from, read, expected);
+		return false;
+	}
+	if (p_file->get_position() != size_t(p_from + read)) {
+		OS::get_singleton()->print("\tRead of %d bytes at %d left the position at %d.\n", p_length, p_from, int(p_file->get_position()));
+		return false;
+	}
+	// Only reading past the end sets EOF, not reading up to it.
+	if (p_file->eof_reached() != (expected < p_length)) {
+		OS::get_singleton()->print("\tRead of %d bytes at %d has the wrong EOF state.\n", p_length, p_from);
+		return false;
+	}
+	return true;
+}
+
+static bool _test_file(const String &p_path, int p_size) {
+	OS *os = OS::get_singleton();
+	os->print("\n%d bytes, %d blocks\n", p_size, p_size / BLOCK_SIZE + 1);
+
+	Vector<uint8_t> data = _make_data(p_size);
+	if (!_write_file(p_path, data)) {
+		os->print("Can't write %s.\n", p_path.utf8().get_data());
+		return false;
+	}
+
+	FileAccessCompressed *fac = memnew(FileAccessCompressed);
+	fac->configure("GCPF", Compression::MODE_ZSTD, BLOCK_SIZE);
+	if (fac->_open(p_path, FileAccess::READ) != OK) {
+		os->print("Can't open %s.\n", p_path.utf8().get_data());
+		memdelete(fac);
+		return false;
+	}
+
+	bool pass = fac->get_len() == size_t(p_size);
+
+	// Sequential reads, served from the read ahead blocks.
+	bool sequential = true;
+	for (int from = 0; from < p_size; from += 777) {
+		sequential = sequential && _check_read(fac, data, from, 777);
+	}
+	fac->seek(0);
+	for (int i = 0; i < p_size; i++) {
+		if (fac->get_8() != data[i]) {
+			os->print("\tget_8() at %d returned the wrong byte.\n", i);
+			sequential = false;
+			break;
+		}
+	}
+	sequential = sequential && !fac->eof_reached() && fac->get_position() == size_t(p_size);
+	fac->get_8();
+	sequential = sequential && fac->eof_reached();
+	os->print("Sequential: %s\n", sequential ? "OK" : "FAILED");
+	pass = pass && sequential;
+
+	// Reads ending exactly at a block boundary and at the end of the file.
+	bool boundaries = true;
+	for (int i = 1; i < BLOCK_COUNT; i++) {
+		boundaries = boundaries && _check_read(fac, data, i * BLOCK_SIZE - 100, 100);
+		boundaries = boundaries && fac->get_8() == data[i * BLOCK_SIZE];
+		boundaries = boundaries && _check_read(fac, data, (i - 1) * BLOCK_SIZE, BLOCK_SIZE);
+	}
+	uint8_t byte;
+	boundaries = boundaries && _check_read(fac, data, p_size - 100, 100);
+	boundaries = boundaries && fac->get_buffer(&byte, 1) == 0 && fac->eof_reached();
+	boundaries = boundaries && _check_read(fac, data, p_size - BLOCK_SIZE, BLOCK_SIZE);
+	boundaries = boundaries && fac->get_8() == 0 && fac->eof_reached();
+	boundaries = boundaries && _check_read(fac, data, p_size - 50, 100);
+	fac->seek_end();
+	boundaries = boundaries && fac->get_position() == size_t(p_size) && !fac->eof_reached();
+	boundaries = boundaries && fac->get_buffer(&byte, 1) == 0 && fac->eof_reached();
+	os->print("Block boundaries and EOF: %s\n", boundaries ? "OK" : "FAILED");
+	pass = pass && boundaries;
+
+	// Back into cached blocks, far enough to evict them, then back to evicted ones.
+	bool seeks = true;
+	const int blocks[] = { 5, 4, 6, 7, 20, 4, 0, 1, 2, 23, 12, 13, 11, 5 };
+	for (uint32_t i = 0; i < sizeof(blocks) / sizeof(blocks[0]); i++) {
+		seeks = seeks && _check_read(fac, data, blocks[i] * BLOCK_SIZE + 300, BLOCK_SIZE / 2);
+	}
+
+	// Random spans, some of them over several blocks or past the end.
+	RandomPCG rng;
+	for (int i = 0; i < 2000; i++) {
+		int from = rng.rand() % p_size;
+		int length = 1 + rng.rand() % (3 * BLOCK_SIZE);
+		seeks = seeks && _check_read(fac, data, from, length);
+	}
+	os->print("Random seeks: %s\n", seeks ? "OK" : "FAILED");
+	pass = pass && seeks;
+
+	fac->close();
+	memdelete(fac);
+	DirAccess::remove_file_or_error(p_path);
+	return pass;
+}
+
+MainLoop *test() {
+	OS *os = OS::get_singleton();
+	String path = os->get_cache_path().plus_file("test_file_access_compressed.bin");
+
+	// With a partial last block, and with a length that is a multiple of the block
+	// size, which is stored with an empty last block.
+	bool pass = _test_file(path, BLOCK_COUNT * BLOCK_SIZE + 1234);
+	pass = _test_file(path, BLOCK_COUNT * BLOCK_SIZE) && pass;
+
+	os->print("\nFileAccessCompressed test %s\n", pass ? "passed" : "FAILED");
+	return nullptr;
+}
+
+} // namespace TestFileAccessCompressed
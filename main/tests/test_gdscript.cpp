@@ -530,9 +530,17 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 			String txt = itos(ip) + " ";
 
 			switch (code[ip]) {
-				case GDScriptFunction::OPCODE_OPERATOR: {
+				case GDScriptFunction::OPCODE_OPERATOR:
+				case GDScriptFunction::OPCODE_OPERATOR_INT:
+				case GDScriptFunction::OPCODE_OPERATOR_FLOAT: {
 					int op = code[ip + 1];
-					txt += " op ";
+					if (code[ip] == GDScriptFunction::OPCODE_OPERATOR_INT) {
+						txt += " op_int ";
+					} else if (code[ip] == GDScriptFunction::OPCODE_OPERATOR_FLOAT) {
+						txt += " op_float ";
+					} else {
+						txt += " op ";
+					}
 
 					String opname = Variant::get_operator_name(Variant::Operator(op));
 
@@ -572,7 +580,7 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					txt += func.get_global_name(code[ip + 2]);
 					txt += "\"]=";
 					txt += DADDR(3);
-					incr += 4;
+					incr += 5;
 
 				} break;
 				case GDScriptFunction::OPCODE_GET_NAMED: {
@@ -583,7 +591,28 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					txt += "[\"";
 					txt += func.get_global_name(code[ip + 2]);
 					txt += "\"]";
-					incr += 4;
+					incr += 5;
+
+				} break;
+				case GDScriptFunction::OPCODE_SET_NAMED_VECTOR3: {
+					txt += " set_named_vector3 ";
+					txt += DADDR(2);
+					txt += "[\"";
+					txt += func.get_global_name(code[ip + 3]);
+					txt += "\"]=";
+					txt += DADDR(4);
+					incr += 6;
+
+				} break;
+				case GDScriptFunction::OPCODE_GET_NAMED_VECTOR3: {
+					txt += " get_named_vector3 ";
+					txt += DADDR(4);
+					txt += "=";
+					txt += DADDR(2);
+					txt += "[\"";
+					txt += func.get_global_name(code[ip + 3]);
+					txt += "\"]";
+					incr += 6;
 
 				} break;
 				case GDScriptFunction::OPCODE_SET_MEMBER: {
@@ -592,7 +621,7 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					txt += func.get_global_name(code[ip + 1]);
 					txt += "\"]=";
 					txt += DADDR(2);
-					incr += 3;
+					incr += 4;
 
 				} break;
 				case GDScriptFunction::OPCODE_GET_MEMBER: {
@@ -602,7 +631,7 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					txt += "[\"";
 					txt += func.get_global_name(code[ip + 1]);
 					txt += "\"]";
-					incr += 3;
+					incr += 4;
 
 				} break;
 				case GDScriptFunction::OPCODE_ASSIGN: {
@@ -731,7 +760,7 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 
 					int argc = code[ip + 1];
 					if (ret) {
-						txt += DADDR(4 + argc) + "=";
+						txt += DADDR(5 + argc) + "=";
 					}
 
 					txt += DADDR(2) + ".";
@@ -742,11 +771,32 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 						if (i > 0) {
 							txt += ", ";
 						}
-						txt += DADDR(4 + i);
+						txt += DADDR(5 + i);
 					}
 					txt += ")";
 
-					incr = 5 + argc;
+					incr = 6 + argc;
+
+				} break;
+				case GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED: {
+					txt += " call-validated ";
+
+					int argc = code[ip + 1];
+					txt += DADDR(5 + argc) + "=";
+
+					txt += DADDR(2) + ".";
+					txt += String(func.get_global_name(code[ip + 3]));
+					txt += "(";
+
+					for (int i = 0; i < argc; i++) {
+						if (i > 0) {
+							txt += ", ";
+						}
+						txt += DADDR(5 + i);
+					}
+					txt += ")";
+
+					incr = 6 + argc;
 
 				} break;
 				case GDScriptFunction::OPCODE_CALL_BUILT_IN: {
@@ -829,6 +879,24 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 
 					incr = 3;
 				} break;
+				case GDScriptFunction::OPCODE_JUMP_IF_NOT_COMPARE:
+				case GDScriptFunction::OPCODE_JUMP_IF_NOT_COMPARE_INT:
+				case GDScriptFunction::OPCODE_JUMP_IF_NOT_COMPARE_FLOAT: {
+					if (code[ip] == GDScriptFunction::OPCODE_JUMP_IF_NOT_COMPARE_INT) {
+						txt += " jump-if-not_int ";
+					} else if (code[ip] == GDScriptFunction::OPCODE_JUMP_IF_NOT_COMPARE_FLOAT) {
+						txt += " jump-if-not_float ";
+					} else {
+						txt += " jump-if-not ";
+					}
+					txt += DADDR(2);
+					txt += " " + Variant::get_operator_name(Variant::Operator(code[ip + 1])) + " ";
+					txt += DADDR(3);
+					txt += " to ";
+					txt += itos(code[ip + 4]);
+
+					incr = 5;
+				} break;
 				case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT: {
 					txt += " jump-to-default-argument ";
 					incr = 1;
@@ -839,6 +907,16 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 
 					incr = 2;
 
+				} break;
+				case GDScriptFunction::OPCODE_ITERATE_BEGIN_RANGE: {
+					txt += " for-range-init " + DADDR(4) + " in " + DADDR(2) + " counter " + DADDR(1) + " end " + itos(code[ip + 3]);
+					incr += 5;
+
+				} break;
+				case GDScriptFunction::OPCODE_ITERATE_RANGE: {
+					txt += " for-range-loop " + DADDR(4) + " in " + DADDR(2) + " counter " + DADDR(1) + " end " + itos(code[ip + 3]);
+					incr += 5;
+
 				} break;
 				case GDScriptFunction::OPCODE_ITERATE_BEGIN: {
 					txt += " for-init " + DADDR(4) + " in " + DADDR(2) + " counter " + DADDR(1) + " end " + itos(code[ip + 3]);
@@ -883,7 +961,140 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 	}
 }
 
+struct NumericBenchmark {
+	const char *name;
+	const char *code;
+};
+
+// Each loop is written with static types. The untyped variant is the same
+// source with the annotations stripped, so it compiles to generic opcodes.
+static const NumericBenchmark numeric_benchmarks[] = {
+	{ "int arithmetic",
+			"static func run(n: int):\n"
+			"\tvar s: int = 0\n"
+			"\tvar i: int = 0\n"
+			"\twhile i < n:\n"
+			"\t\ts = (s + i * 3 - (i & 7)) % 1000003\n"
+			"\t\ti += 1\n"
+			"\treturn s\n" },
+	{ "float arithmetic",
+			"static func run(n: int):\n"
+			"\tvar x: float = 0.0\n"
+			"\tvar v: float = 1.0\n"
+			"\tvar i: int = 0\n"
+			"\twhile i < n:\n"
+			"\t\tv = v * 0.999 + 0.5\n"
+			"\t\tx += v / 3.0 - i * 0.25\n"
+			"\t\ti += 1\n"
+			"\treturn x\n" },
+	{ "nested int loops",
+			"static func run(n: int):\n"
+			"\tvar s: int = 0\n"
+			"\tvar i: int = 0\n"
+			"\twhile i < n / 100:\n"
+			"\t\tvar j: int = 0\n"
+			"\t\twhile j < 100:\n"
+			"\t\t\tif j > i:\n"
+			"\t\t\t\ts += j - i\n"
+			"\t\t\tj += 1\n"
+			"\t\ti += 1\n"
+			"\treturn s\n" },
+	{ "range loops",
+			"static func run(n: int):\n"
+			"\tvar s: int = 0\n"
+			"\tfor i in range(n / 10):\n"
+			"\t\tfor j in range(1, 11):\n"
+			"\t\t\tif j != 5:\n"
+			"\t\t\t\ts += j\n"
+			"\treturn s\n" },
+	{ "Vector3 components",
+			"static func run(n: int):\n"
+			"\tvar p: Vector3 = Vector3()\n"
+			"\tvar vel: Vector3 = Vector3(1, 2, 3)\n"
+			"\tvar i: int = 0\n"
+			"\twhile i < n:\n"
+			"\t\tp.x += vel.x * 0.016\n"
+			"\t\tp.y += vel.y * 0.016 - 0.1\n"
+			"\t\tif p.y < 0.0:\n"
+			"\t\t\tp.y = -p.y\n"
+			"\t\tp.z = p.x - p.y\n"
+			"\t\ti += 1\n"
+			"\treturn p\n" },
+	{ "builtin method calls",
+			"static func run(n: int):\n"
+			"\tvar a: Vector3 = Vector3(1, 2, 3)\n"
+			"\tvar b: Vector3 = Vector3(0.5, 0.25, 2)\n"
+			"\tvar s: float = 0.0\n"
+			"\tvar i: int = 0\n"
+			"\twhile i < n:\n"
+			"\t\ts += a.dot(b)\n"
+			"\t\tb = b.cross(a).normalized()\n"
+			"\t\ti += 1\n"
+			"\treturn s\n" },
+	{ "native calls and properties",
+			"static func run(n: int):\n"
+			"\tvar node = Node2D.new()\n"
+			"\tvar i: int = 0\n"
+			"\twhile i < n:\n"
+			"\t\tnode.position += Vector2(1, 0)\n"
+			"\t\tnode.set_rotation(node.get_rotation() + 0.001)\n"
+			"\t\ti += 1\n"
+			"\tvar r = node.position.x + node.rotation\n"
+			"\tnode.free()\n"
+			"\treturn r\n" },
+};
+
+static Ref<GDScript> _compile_benchmark(const String &p_code) {
+	Ref<GDScript> gds;
+	gds.instance();
+	gds->set_source_code(p_code);
+	if (gds->reload() != OK) {
+		return Ref<GDScript>();
+	}
+	return gds;
+}
+
+static uint64_t _run_benchmark(Object *p_script, int p_iterations, Variant &r_result) {
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	r_result = p_script->call("run", p_iterations);
+	return OS::get_singleton()->get_ticks_usec() - from;
+}
+
+static void _benchmark_numeric_loops() {
+	const int iterations = 2000000;
+
+	print_line("GDScript numeric loops, " + itos(iterations) + " iterations each.");
+
+	for (uint32_t i = 0; i < sizeof(numeric_benchmarks) / sizeof(NumericBenchmark); i++) {
+		const NumericBenchmark &bench = numeric_benchmarks[i];
+
+		String typed_code = bench.code;
+		String untyped_code = typed_code.replace(": int", "").replace(": float", "").replace(": Vector3", "");
+
+		Ref<GDScript> typed = _compile_benchmark(typed_code);
+		Ref<GDScript> untyped = _compile_benchmark(untyped_code);
+		ERR_CONTINUE_MSG(typed.is_null() || untyped.is_null(), "Could not compile benchmark: " + String(bench.name));
+
+		Variant typed_result;
+		Variant untyped_result;
+		uint64_t untyped_usec = _run_benchmark(untyped.ptr(), iterations, untyped_result);
+		uint64_t typed_usec = _run_benchmark(typed.ptr(), iterations, typed_result);
+
+		String speedup = typed_usec > 0 ? rtos(double(untyped_usec) / double(typed_usec)).pad_decimals(2) + "x" : "-";
+		print_line(String(bench.name) + ": untyped " + itos(untyped_usec) + " usec, typed " + itos(typed_usec) + " usec, speedup " + speedup);
+
+		if (typed_result != untyped_result) {
+			print_line("\tResults differ: untyped " + String(untyped_result) + ", typed " + String(typed_result));
+		}
+	}
+}
+
 MainLoop *test(TestType p_type) {
+	if (p_type == TEST_BENCHMARK) {
+		_benchmark_numeric_loops();
+		return nullptr;
+	}
+
 	List<String> cmdlargs = OS::get_singleton()->get_cmdline_args();
 
 	if (cmdlargs.empty()) {
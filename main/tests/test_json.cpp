@@ -0,0 +1,233 @@
+/*************************************************************************/
+/*  test_json.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_json.h"
+
+#include "core/io/json.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+
+namespace TestJSON {
+
+// Shaped like the entity dumps the servers exchange: many small objects with
+// short strings, a few numbers and some nesting.
+static Variant _make_document(int p_entities) {
+	Array entities;
+	for (int i = 0; i < p_entities; i++) {
+		Dictionary e;
+		e["id"] = i;
+		e["name"] = "entity_" + itos(i);
+		e["description"] = String::utf8("Line one\nLine \"two\" with café and €") + itos(i % 97);
+		Array pos;
+		pos.push_back(i * 0.5);
+		pos.push_back(-i * 0.25);
+		pos.push_back(i % 13);
+		e["position"] = pos;
+		Array tags;
+		tags.push_back("tag_" + itos(i % 7));
+		tags.push_back("group_" + itos(i % 31));
+		e["tags"] = tags;
+		Dictionary flags;
+		flags["visible"] = (i % 3) != 0;
+		flags["parent"] = Variant();
+		e["flags"] = flags;
+		entities.push_back(e);
+	}
+	Dictionary root;
+	root["version"] = 3;
+	root["entities"] = entities;
+	return root;
+}
+
+// Only counts events, to measure the tokenizer on its own.
+class CountingVisitor : public JSON::Visitor {
+public:
+	int containers = 0;
+	int keys = 0;
+	int values = 0;
+
+	virtual bool begin_object() {
+		containers++;
+		return true;
+	}
+	virtual bool end_object() { return true; }
+	virtual bool begin_array() {
+		containers++;
+		return true;
+	}
+	virtual bool end_array() { return true; }
+	virtual bool key(const char *p_utf8, int p_len) {
+		keys++;
+		return true;
+	}
+	virtual bool string_value(const char *p_utf8, int p_len) {
+		values++;
+		return true;
+	}
+	virtual bool number_value(double p_value) {
+		values++;
+		return true;
+	}
+	virtual bool bool_value(bool p_value) {
+		values++;
+		return true;
+	}
+	virtual bool null_value() {
+		values++;
+		return true;
+	}
+};
+
+static bool _test_compatibility() {
+	const char *docs[] = {
+		"{\"a\": [1, 2.5, true, false, null], \"b\": \"x\\ny\\u00e9\"}",
+		"[1, 2, ]",
+		"{\"a\": {\"b\": []}, }",
+		"\"\\u20ac \\t\"",
+		"[1 2]",
+		"{\"a\" 1}",
+		"[nope]",
+		"[\n\n\"unterminated",
+		"[1-2]",
+		"[1.2.3]",
+		"[-]",
+		"[1e]",
+		"[1e+5, -0.5e-3, 12., 7E2]",
+		"[123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890, 0.00000000000000000000000000000000000000000000000000000000000000000000000000000000000015]",
+		"\xef\xbb\xbf{\"bom\": 1}",
+		"{\"a\" @}",
+		"[1 @]",
+		"{\"a\": 1",
+		"{\"a\": 1 ",
+		"{\"a\":",
+		"{\"a\": ",
+		"{\"a\"",
+		"{ ",
+		"[1,",
+		"[\n",
+		"[[1]",
+	};
+
+	bool pass = true;
+	for (int i = 0; i < (int)(sizeof(docs) / sizeof(docs[0])); i++) {
+		String text = String::utf8(docs[i]);
+
+		Variant old_ret;
+		String old_err;
+		int old_line;
+		Error old_error = JSON::parse(text, old_ret, old_err, old_line);
+
+		Variant new_ret;
+		String new_err;
+		int new_line;
+		Error new_error = JSON::parse_utf8((const uint8_t *)docs[i], strlen(docs[i]), new_ret, new_err, new_line);
+
+		if (old_error != new_error || (old_error == OK && JSON::print(old_ret) != JSON::print(new_ret)) || (old_error != OK && (old_err != new_err || old_line != new_line))) {
+			OS::get_singleton()->print("Mismatch parsing: %s\n", docs[i]);
+			pass = false;
+		}
+	}
+	return pass;
+}
+
+MainLoop *test() {
+	OS *os = OS::get_singleton();
+
+	bool pass = _test_compatibility();
+
+	Variant doc = _make_document(50000);
+
+	uint64_t from = os->get_ticks_usec();
+	CharString old_text = JSON::print(doc, "\t").utf8();
+	uint64_t old_print = os->get_ticks_usec() - from;
+
+	from = os->get_ticks_usec();
+	Vector<uint8_t> new_text = JSON::print_utf8(doc, "\t");
+	uint64_t new_print = os->get_ticks_usec() - from;
+
+	pass = pass && new_text.size() == old_text.length() && memcmp(new_text.ptr(), old_text.get_data(), new_text.size()) == 0;
+
+	double mb = new_text.size() / (1024.0 * 1024.0);
+	os->print("Document: %.2f MiB\n", mb);
+	os->print("print: %.2f msec (String) / %.2f msec (UTF-8 writer)\n", old_print / 1000.0, new_print / 1000.0);
+
+	// The old path has to decode to a wide String before it can parse.
+	String err_str;
+	int err_line;
+	from = os->get_ticks_usec();
+	String text;
+	text.parse_utf8((const char *)new_text.ptr(), new_text.size());
+	Variant old_ret;
+	Error err = JSON::parse(text, old_ret, err_str, err_line);
+	uint64_t old_parse = os->get_ticks_usec() - from;
+	pass = pass && err == OK;
+
+	from = os->get_ticks_usec();
+	Variant new_ret;
+	err = JSON::parse_utf8(new_text.ptr(), new_text.size(), new_ret, err_str, err_line);
+	uint64_t new_parse = os->get_ticks_usec() - from;
+	pass = pass && err == OK;
+
+	from = os->get_ticks_usec();
+	CountingVisitor counter;
+	err = JSON::parse_utf8(new_text.ptr(), new_text.size(), &counter, err_str, err_line);
+	uint64_t visit_parse = os->get_ticks_usec() - from;
+	pass = pass && err == OK && counter.keys == 50000 * 8 + 2;
+
+	os->print("parse: %.2f msec (String) / %.2f msec (UTF-8 DOM) / %.2f msec (UTF-8 visitor)\n", old_parse / 1000.0, new_parse / 1000.0, visit_parse / 1000.0);
+	os->print("\t%.1f / %.1f / %.1f MiB/s\n", mb / (old_parse / 1000000.0), mb / (new_parse / 1000000.0), mb / (visit_parse / 1000000.0));
+
+	// Numbers come back as floats from both parsers, so compare them to each other.
+	pass = pass && JSON::print(old_ret) == JSON::print(new_ret);
+
+	String path = os->get_cache_path().plus_file("test_json.json");
+	FileAccess *f = FileAccess::open(path, FileAccess::WRITE);
+	if (f) {
+		f->store_buffer(new_text.ptr(), new_text.size());
+		memdelete(f);
+
+		f = FileAccess::open(path, FileAccess::READ);
+		from = os->get_ticks_usec();
+		Variant file_ret;
+		err = JSON::parse_file(f, file_ret, err_str, err_line);
+		uint64_t file_parse = os->get_ticks_usec() - from;
+		memdelete(f);
+		DirAccess::remove_file_or_error(path);
+
+		pass = pass && err == OK && JSON::print(file_ret) == JSON::print(new_ret);
+		os->print("parse file: %.2f msec (UTF-8 DOM)\n", file_parse / 1000.0);
+	}
+
+	os->print("JSON test %s\n", pass ? "passed" : "FAILED");
+	return nullptr;
+}
+
+} // namespace TestJSON
@@ -34,18 +34,31 @@
 
 #ifdef DEBUG_ENABLED
 
+#include "test_allocator.h"
+#include "test_animation.h"
 #include "test_astar.h"
+#include "test_broadphase.h"
 #include "test_class_db.h"
+#include "test_compact_ordered_hash_map.h"
+#include "test_file_access_compressed.h"
 #include "test_gdscript.h"
 #include "test_gui.h"
+#include "test_json.h"
 #include "test_math.h"
+#include "test_navigation.h"
 #include "test_oa_hash_map.h"
 #include "test_ordered_hash_map.h"
+#include "test_pack.h"
+#include "test_packed_scene.h"
 #include "test_physics_2d.h"
 #include "test_physics_3d.h"
 #include "test_render.h"
+#include "test_replication.h"
+#include "test_rid.h"
 #include "test_shader_lang.h"
 #include "test_string.h"
+#include "test_string_name.h"
+#include "test_thread_work_pool.h"
 
 const char **tests_get_names() {
 	static const char *test_names[] = {
@@ -62,8 +75,22 @@ const char **tests_get_names() {
 		"gd_parser",
 		"gd_compiler",
 		"gd_bytecode",
+		"gd_benchmark",
 		"ordered_hash_map",
 		"astar",
+		"thread_work_pool",
+		"navigation",
+		"rid",
+		"pack",
+		"packed_scene",
+		"broadphase",
+		"string_name",
+		"compact_ordered_hash_map",
+		"json",
+		"allocator",
+		"file_access_compressed",
+		"animation",
+		"replication",
 		nullptr
 	};
 
@@ -125,6 +152,10 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestGDScript::test(TestGDScript::TEST_BYTECODE);
 	}
 
+	if (p_test == "gd_benchmark") {
+		return TestGDScript::test(TestGDScript::TEST_BENCHMARK);
+	}
+
 	if (p_test == "ordered_hash_map") {
 		return TestOrderedHashMap::test();
 	}
@@ -133,6 +164,58 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestAStar::test();
 	}
 
+	if (p_test == "thread_work_pool") {
+		return TestThreadWorkPool::test();
+	}
+
+	if (p_test == "navigation") {
+		return TestNavigation::test();
+	}
+
+	if (p_test == "rid") {
+		return TestRID::test();
+	}
+
+	if (p_test == "pack") {
+		return TestPack::test();
+	}
+
+	if (p_test == "packed_scene") {
+		return TestPackedScene::test();
+	}
+
+	if (p_test == "broadphase") {
+		return TestBroadphase::test();
+	}
+
+	if (p_test == "string_name") {
+		return TestStringName::test();
+	}
+
+	if (p_test == "compact_ordered_hash_map") {
+		return TestCompactOrderedHashMap::test();
+	}
+
+	if (p_test == "json") {
+		return TestJSON::test();
+	}
+
+	if (p_test == "allocator") {
+		return TestAllocator::test();
+	}
+
+	if (p_test == "file_access_compressed") {
+		return TestFileAccessCompressed::test();
+	}
+
+	if (p_test == "animation") {
+		return TestAnimation::test();
+	}
+
+	if (p_test == "replication") {
+		return TestReplication::test();
+	}
+
 	print_line("Unknown test: " + p_test);
 	return nullptr;
 }
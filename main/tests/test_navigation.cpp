@@ -0,0 +1,326 @@
+/*************************************************************************/
+/*  test_navigation.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_navigation.h"
+
+#include "core/math/math_funcs.h"
+#include "core/os/os.h"
+#include "scene/resources/navigation_mesh.h"
+#include "servers/navigation_server_3d.h"
+
+namespace TestNavigation {
+
+// A flat grid of p_size * p_size square polygons, one unit wide each.
+static Ref<NavigationMesh> _create_grid_mesh(int p_size) {
+	Ref<NavigationMesh> mesh;
+	mesh.instance();
+
+	Vector<Vector3> vertices;
+	vertices.resize((p_size + 1) * (p_size + 1));
+	for (int z = 0; z <= p_size; z++) {
+		for (int x = 0; x <= p_size; x++) {
+			vertices.write[z * (p_size + 1) + x] = Vector3(x, 0, z);
+		}
+	}
+	mesh->set_vertices(vertices);
+
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			Vector<int> polygon;
+			polygon.push_back(z * (p_size + 1) + x);
+			polygon.push_back(z * (p_size + 1) + x + 1);
+			polygon.push_back((z + 1) * (p_size + 1) + x + 1);
+			polygon.push_back((z + 1) * (p_size + 1) + x);
+			mesh->add_polygon(polygon);
+		}
+	}
+
+	return mesh;
+}
+
+struct GridMap {
+	RID map;
+	RID region;
+	int size = 0;
+};
+
+static GridMap _create_grid_map(int p_size) {
+	NavigationServer3D *ns = NavigationServer3D::get_singleton_mut();
+
+	GridMap grid;
+	grid.size = p_size;
+	grid.map = ns->map_create();
+	ns->map_set_active(grid.map, true);
+	grid.region = ns->region_create();
+	ns->region_set_map(grid.region, grid.map);
+	ns->region_set_navmesh(grid.region, _create_grid_mesh(p_size));
+
+	// Applies the commands and syncs the map.
+	ns->process(0.0);
+
+	return grid;
+}
+
+static void _free_grid_map(const GridMap &p_grid) {
+	NavigationServer3D *ns = NavigationServer3D::get_singleton_mut();
+	ns->free(p_grid.region);
+	ns->free(p_grid.map);
+	ns->process(0.0);
+}
+
+static Vector3 _random_point(const GridMap &p_grid, real_t p_height) {
+	return Vector3(Math::random(0.0f, (float)p_grid.size), p_height, Math::random(0.0f, (float)p_grid.size));
+}
+
+static void _test_closest_point(const GridMap &p_grid) {
+	const NavigationServer3D *ns = NavigationServer3D::get_singleton();
+
+	bool pass = true;
+	for (int i = 0; i < 1000 && pass; i++) {
+		Vector3 point = _random_point(p_grid, 5.0);
+		Vector3 closest = ns->map_get_closest_point(p_grid.map, point);
+		pass = closest.is_equal_approx(Vector3(point.x, 0, point.z));
+	}
+	for (int i = 0; i < 100 && pass; i++) {
+		// Outside of the grid, the closest point is on its border.
+		Vector3 point = _random_point(p_grid, 0.0) + Vector3(p_grid.size + 3, 0, 0);
+		Vector3 closest = ns->map_get_closest_point(p_grid.map, point);
+		pass = closest.is_equal_approx(Vector3(p_grid.size, 0, point.z));
+	}
+	for (int i = 0; i < 100 && pass; i++) {
+		Vector3 point = _random_point(p_grid, 0.0);
+		Vector3 hit = ns->map_get_closest_point_to_segment(p_grid.map, point + Vector3(0, 5, 0), point - Vector3(0, 5, 0));
+		pass = hit.is_equal_approx(point);
+	}
+
+	OS::get_singleton()->print("Closest point queries on a %dx%d grid %s.\n", p_grid.size, p_grid.size, pass ? "passed" : "FAILED");
+}
+
+static void _benchmark_short_paths(const GridMap &p_grid) {
+	const NavigationServer3D *ns = NavigationServer3D::get_singleton();
+	const int queries = 2000;
+
+	// Short paths, so the cost is dominated by finding the start and end polygons.
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	int found = 0;
+	for (int i = 0; i < queries; i++) {
+		Vector3 origin = _random_point(p_grid, 0.0);
+		Vector3 destination = origin + Vector3(Math::random(-2.0f, 2.0f), 0, Math::random(-2.0f, 2.0f));
+		if (ns->map_get_path(p_grid.map, origin, destination, true).size()) {
+			found++;
+		}
+	}
+	uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - from, (uint64_t)1);
+
+	OS::get_singleton()->print("%8d polygons: %10.0f short paths/s (%d found)\n", p_grid.size * p_grid.size, queries * 1000000.0 / elapsed, found);
+}
+
+static void _benchmark_long_paths(const GridMap &p_grid) {
+	const NavigationServer3D *ns = NavigationServer3D::get_singleton();
+	const int queries = MAX(4, 32768 / p_grid.size);
+
+	// Cross map paths, between two opposite borders, so the search expands most of the map.
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	int found = 0;
+	for (int i = 0; i < queries; i++) {
+		Vector3 origin(0.5, 0, Math::random(0.0f, (float)p_grid.size));
+		Vector3 destination(p_grid.size - 0.5, 0, Math::random(0.0f, (float)p_grid.size));
+		Vector<Vector3> path = ns->map_get_path(p_grid.map, origin, destination, true);
+		if (path.size() && path[path.size() - 1].is_equal_approx(destination)) {
+			found++;
+		}
+	}
+	uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - from, (uint64_t)1);
+
+	OS::get_singleton()->print("%8d polygons: %10.3f ms per long path (%d/%d found)\n", p_grid.size * p_grid.size, elapsed / (queries * 1000.0), found, queries);
+}
+
+static void _benchmark_batched_paths(const GridMap &p_grid) {
+	const NavigationServer3D *ns = NavigationServer3D::get_singleton();
+	const int queries = 2000;
+
+	Vector<Vector3> origins;
+	Vector<Vector3> destinations;
+	for (int i = 0; i < queries; i++) {
+		Vector3 origin = _random_point(p_grid, 0.0);
+		origins.push_back(origin);
+		destinations.push_back(origin + Vector3(Math::random(-8.0f, 8.0f), 0, Math::random(-8.0f, 8.0f)));
+	}
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < queries; i++) {
+		ns->map_get_path(p_grid.map, origins[i], destinations[i], true);
+	}
+	uint64_t single_usec = MAX(OS::get_singleton()->get_ticks_usec() - from, (uint64_t)1);
+
+	from = OS::get_singleton()->get_ticks_usec();
+	Array paths = ns->map_get_paths(p_grid.map, origins, destinations, true);
+	uint64_t batch_usec = MAX(OS::get_singleton()->get_ticks_usec() - from, (uint64_t)1);
+
+	bool pass = paths.size() == queries;
+	for (int i = 0; pass && i < queries; i += 97) {
+		pass = paths[i] == Variant(ns->map_get_path(p_grid.map, origins[i], destinations[i], true));
+	}
+
+	OS::get_singleton()->print("%8d polygons: %10.0f paths/s one by one, %10.0f paths/s batched (%s)\n", p_grid.size * p_grid.size, queries * 1000000.0 / single_usec, queries * 1000000.0 / batch_usec, pass ? "same paths" : "FAILED");
+}
+
+// A p_tiles * p_tiles world of grid regions, where a single tile moves
+// away and comes back, like a streamed world does.
+static void _test_streamed_tiles(int p_tile_size, int p_tiles) {
+	NavigationServer3D *ns = NavigationServer3D::get_singleton_mut();
+	Ref<NavigationMesh> mesh = _create_grid_mesh(p_tile_size);
+
+	RID map = ns->map_create();
+	ns->map_set_active(map, true);
+	Vector<RID> tiles;
+	for (int z = 0; z < p_tiles; z++) {
+		for (int x = 0; x < p_tiles; x++) {
+			RID region = ns->region_create();
+			ns->region_set_map(region, map);
+			ns->region_set_transform(region, Transform(Basis(), Vector3(x * p_tile_size, 0, z * p_tile_size)));
+			ns->region_set_navmesh(region, mesh);
+			tiles.push_back(region);
+		}
+	}
+	ns->process(0.0);
+	uint64_t first_usec = ns->get_process_info(NavigationServer3D::INFO_LINK_REBUILD_TIME_USEC);
+
+	const real_t world_size = p_tile_size * p_tiles;
+	const Vector3 origin(0.5, 0, 0.5);
+	const Vector3 destination(world_size - 0.5, 0, world_size - 0.5);
+
+	Vector<Vector3> path = ns->map_get_path(map, origin, destination, false);
+	bool pass = path.size() && path[path.size() - 1].is_equal_approx(destination);
+
+	// Move the middle tile away and back.
+	const RID tile = tiles[(p_tiles / 2) * p_tiles + p_tiles / 2];
+	const Transform tile_transform(Basis(), Vector3((p_tiles / 2) * p_tile_size, 0, (p_tiles / 2) * p_tile_size));
+	const int moves = 20;
+	uint64_t incremental_usec = 0;
+	for (int i = 0; i < moves; i++) {
+		ns->region_set_transform(tile, Transform(Basis(), Vector3(0, 1000, 0)));
+		ns->process(0.0);
+		incremental_usec += ns->get_process_info(NavigationServer3D::INFO_LINK_REBUILD_TIME_USEC);
+		pass = pass && ns->get_process_info(NavigationServer3D::INFO_LINK_REBUILT_REGIONS) == 1;
+
+		ns->region_set_transform(tile, tile_transform);
+		ns->process(0.0);
+		incremental_usec += ns->get_process_info(NavigationServer3D::INFO_LINK_REBUILD_TIME_USEC);
+	}
+
+	// The tile is linked again with its neighbours.
+	Vector3 tile_center = tile_transform.origin + Vector3(p_tile_size * 0.5, 0, p_tile_size * 0.5);
+	path = ns->map_get_path(map, origin, tile_center, false);
+	pass = pass && path.size() && path[path.size() - 1].is_equal_approx(tile_center);
+	path = ns->map_get_path(map, origin, destination, false);
+	pass = pass && path.size() && path[path.size() - 1].is_equal_approx(destination);
+
+	// A connection setting change relinks the whole map.
+	ns->map_set_edge_connection_margin(map, ns->map_get_edge_connection_margin(map) * 0.5);
+	ns->process(0.0);
+	uint64_t full_usec = ns->get_process_info(NavigationServer3D::INFO_LINK_REBUILD_TIME_USEC);
+	pass = pass && ns->get_process_info(NavigationServer3D::INFO_LINK_REBUILT_REGIONS) == p_tiles * p_tiles;
+
+	OS::get_singleton()->print("%8d polygons in %d tiles: first link %.2f ms, full relink %.2f ms, moving one tile %.2f ms (%s)\n", p_tile_size * p_tile_size * p_tiles * p_tiles, p_tiles * p_tiles, first_usec / 1000.0, full_usec / 1000.0, incremental_usec / (moves * 2 * 1000.0), pass ? "passed" : "FAILED");
+
+	for (int i = 0; i < tiles.size(); i++) {
+		ns->free(tiles[i]);
+	}
+	ns->free(map);
+	ns->process(0.0);
+}
+
+// Two regions side by side, one freed while the server doesn't sync the map:
+// the queries must ignore its polygons from then on.
+static void _test_freed_region() {
+	NavigationServer3D *ns = NavigationServer3D::get_singleton_mut();
+	Ref<NavigationMesh> mesh = _create_grid_mesh(8);
+
+	RID map = ns->map_create();
+	ns->map_set_active(map, true);
+	RID left = ns->region_create();
+	ns->region_set_map(left, map);
+	ns->region_set_navmesh(left, mesh);
+	RID right = ns->region_create();
+	ns->region_set_map(right, map);
+	ns->region_set_transform(right, Transform(Basis(), Vector3(8, 0, 0)));
+	ns->region_set_navmesh(right, mesh);
+	ns->process(0.0);
+
+	const Vector3 origin(0.5, 0, 4);
+	const Vector3 destination(12, 0, 4);
+	Vector<Vector3> path = ns->map_get_path(map, origin, destination, true);
+	bool pass = path.size() && path[path.size() - 1].is_equal_approx(destination);
+
+	ns->set_active(false);
+	ns->free(right);
+	ns->process(0.0);
+
+	pass = pass && ns->map_get_closest_point(map, destination).is_equal_approx(Vector3(8, 0, 4));
+	pass = pass && ns->map_get_closest_point_owner(map, destination) == left;
+	pass = pass && ns->map_get_closest_point_to_segment(map, destination + Vector3(0, 5, 0), destination - Vector3(0, 5, 0)).is_equal_approx(Vector3(8, 0, 4));
+	path = ns->map_get_path(map, origin, destination, true);
+	pass = pass && path.size() && path[path.size() - 1].is_equal_approx(Vector3(8, 0, 4));
+
+	ns->set_active(true);
+	ns->process(0.0);
+	pass = pass && ns->map_get_closest_point_owner(map, destination) == left;
+
+	OS::get_singleton()->print("Queries after freeing a region %s.\n", pass ? "passed" : "FAILED");
+
+	ns->free(left);
+	ns->free(map);
+	ns->process(0.0);
+}
+
+MainLoop *test() {
+	OS::get_singleton()->print("\n\nTesting navigation.\n");
+
+	Math::seed(0);
+
+	const int sizes[] = { 16, 64, 256, 0 };
+	for (int i = 0; sizes[i]; i++) {
+		GridMap grid = _create_grid_map(sizes[i]);
+		_test_closest_point(grid);
+		_benchmark_short_paths(grid);
+		_benchmark_long_paths(grid);
+		_benchmark_batched_paths(grid);
+		_free_grid_map(grid);
+	}
+
+	_test_freed_region();
+	_test_streamed_tiles(16, 4);
+	_test_streamed_tiles(32, 8);
+
+	return nullptr;
+}
+
+} // namespace TestNavigation
@@ -0,0 +1,219 @@
+/*************************************************************************/
+/*  test_pack.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_pack.h"
+
+#include "core/io/file_access_pack.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "core/version.h"
+
+namespace TestPack {
+
+static const int FILE_COUNT = 50000;
+static const int FILE_SIZE = 256;
+
+static String _file_path(int p_index) {
+	return "res://test_pack/dir_" + itos(p_index % 100) + "/file_" + itos(p_index) + ".bin";
+}
+
+// Same layout PCKPacker writes, without going through 50k source files on disk.
+static bool _write_pack(const String &p_path, const Vector<String> &p_files) {
+	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE);
+	if (!f) {
+		return false;
+	}
+
+	f->store_32(PACK_HEADER_MAGIC);
+	f->store_32(PACK_FORMAT_VERSION);
+	f->store_32(VERSION_MAJOR);
+	f->store_32(VERSION_MINOR);
+	f->store_32(VERSION_PATCH);
+	for (int i = 0; i < 16; i++) {
+		f->store_32(0); // reserved
+	}
+
+	f->store_32(p_files.size());
+
+	// Each index entry is the path, the offset, the size and an empty md5.
+	uint64_t ofs = f->get_position();
+	for (int i = 0; i < p_files.size(); i++) {
+		ofs += 4 + p_files[i].utf8().length() + 8 + 8 + 16;
+	}
+
+	for (int i = 0; i < p_files.size(); i++) {
+		f->store_pascal_string(p_files[i]);
+		f->store_64(ofs + uint64_t(i) * FILE_SIZE);
+		f->store_64(FILE_SIZE);
+		for (int j = 0; j < 4; j++) {
+			f->store_32(0);
+		}
+	}
+
+	uint8_t buf[FILE_SIZE];
+	for (int i = 0; i < p_files.size(); i++) {
+		for (int j = 0; j < FILE_SIZE; j++) {
+			buf[j] = uint8_t(i + j);
+		}
+		f->store_buffer(buf, FILE_SIZE);
+	}
+
+	f->close();
+	memdelete(f);
+	return true;
+}
+
+static uint64_t _read_all(const Vector<String> &p_files, bool p_view, bool &r_pass) {
+	uint64_t checksum = 0;
+	uint8_t buf[FILE_SIZE];
+
+	for (int i = 0; i < p_files.size(); i++) {
+		FileAccess *f = FileAccess::open(p_files[i], FileAccess::READ);
+		if (!f) {
+			r_pass = false;
+			continue;
+		}
+
+		const uint8_t *data = p_view ? f->get_buffer_view(FILE_SIZE) : nullptr;
+		if (!data) {
+			if (p_view || f->get_buffer(buf, FILE_SIZE) != FILE_SIZE) {
+				r_pass = false;
+			}
+			data = buf;
+		}
+		for (int j = 0; j < FILE_SIZE; j++) {
+			checksum += data[j];
+		}
+		if (data[0] != uint8_t(i)) {
+			r_pass = false;
+		}
+
+		memdelete(f);
+	}
+
+	return checksum;
+}
+
+MainLoop *test() {
+	OS *os = OS::get_singleton();
+	PackedData *packed_data = PackedData::get_singleton();
+
+	if (!packed_data) {
+		os->print("No PackedData singleton, can't run the pack test.\n");
+		return nullptr;
+	}
+
+	String pack_path = os->get_cache_path().plus_file("test_pack_" + itos(FILE_COUNT) + ".pck");
+
+	Vector<String> files;
+	files.resize(FILE_COUNT);
+	for (int i = 0; i < FILE_COUNT; i++) {
+		files.write[i] = _file_path(i);
+	}
+
+	if (!_write_pack(pack_path, files)) {
+		os->print("Can't write the test pack to %s.\n", pack_path.utf8().get_data());
+		return nullptr;
+	}
+
+	bool pass = true;
+	bool was_disabled = packed_data->is_disabled();
+	bool was_mapping = packed_data->is_memory_mapping_enabled();
+	packed_data->set_disabled(false);
+
+	os->print("Synthetic pack with %d files of %d bytes:\n", FILE_COUNT, FILE_SIZE);
+
+	// Copying reads: each open reopens the pack, seeks, and reads through get_buffer().
+	packed_data->set_memory_mapping_enabled(false);
+
+	uint64_t from = os->get_ticks_usec();
+	if (packed_data->add_pack(pack_path, false) != OK) {
+		pass = false;
+	}
+	os->print("\tindex load: %.2f msec\n", (os->get_ticks_usec() - from) / 1000.0);
+
+	from = os->get_ticks_usec();
+	uint64_t checksum = _read_all(files, false, pass);
+	os->print("\tcopying reads, first pass: %.2f msec\n", (os->get_ticks_usec() - from) / 1000.0);
+
+	from = os->get_ticks_usec();
+	if (_read_all(files, false, pass) != checksum) {
+		pass = false;
+	}
+	os->print("\tcopying reads, warm pass: %.2f msec\n", (os->get_ticks_usec() - from) / 1000.0);
+
+	// Mapped reads: the pack stays open, files are views into the mapping.
+	packed_data->set_memory_mapping_enabled(true);
+	packed_data->add_pack(pack_path, true);
+
+	FileAccess *probe = FileAccess::open(files[0], FileAccess::READ);
+	bool mapped = probe && probe->get_buffer_view(FILE_SIZE) != nullptr;
+	if (probe) {
+		memdelete(probe);
+	}
+
+	if (mapped) {
+		from = os->get_ticks_usec();
+		if (_read_all(files, true, pass) != checksum) {
+			pass = false;
+		}
+		os->print("\tmapped views, first pass: %.2f msec\n", (os->get_ticks_usec() - from) / 1000.0);
+
+		from = os->get_ticks_usec();
+		if (_read_all(files, true, pass) != checksum) {
+			pass = false;
+		}
+		os->print("\tmapped views, warm pass: %.2f msec\n", (os->get_ticks_usec() - from) / 1000.0);
+
+		from = os->get_ticks_usec();
+		if (_read_all(files, false, pass) != checksum) {
+			pass = false;
+		}
+		os->print("\tmapped copies, warm pass: %.2f msec\n", (os->get_ticks_usec() - from) / 1000.0);
+	} else {
+		os->print("\tmemory mapping not supported here, skipped the mapped passes.\n");
+	}
+
+	// The pack was just written, so its pages are cached already: the first
+	// pass measures lookups and first touch of the mapping, not disk reads.
+	os->print("pack test %s.\n", pass ? "passed" : "FAILED");
+
+	packed_data->set_memory_mapping_enabled(was_mapping);
+	packed_data->set_disabled(was_disabled);
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->remove(pack_path);
+	memdelete(da);
+
+	return nullptr;
+}
+
+} // namespace TestPack
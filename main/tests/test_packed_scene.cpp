@@ -0,0 +1,236 @@
+/*************************************************************************/
+/*  test_packed_scene.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_packed_scene.h"
+
+#include "core/io/resource_format_binary.h"
+#include "core/io/resource_saver.h"
+#include "core/os/dir_access.h"
+#include "core/os/os.h"
+#include "scene/2d/node_2d.h"
+#include "scene/main/timer.h"
+#include "scene/resources/packed_scene.h"
+
+namespace TestPackedScene {
+
+// Something shaped like a projectile: a few transforms, a timer and some trail points.
+static Node *_make_projectile() {
+	Node2D *root = memnew(Node2D);
+	root->set_name("Projectile");
+	root->set_position(Vector2(10, 20));
+	root->set_rotation(0.5);
+	root->set_z_index(3);
+
+	Node2D *visual = memnew(Node2D);
+	visual->set_name("Visual");
+	visual->set_scale(Vector2(2, 2));
+	visual->set_modulate(Color(1, 0.5, 0.25));
+	root->add_child(visual);
+	visual->set_owner(root);
+
+	Timer *lifetime = memnew(Timer);
+	lifetime->set_name("Lifetime");
+	lifetime->set_wait_time(3.5);
+	lifetime->set_one_shot(true);
+	root->add_child(lifetime);
+	lifetime->set_owner(root);
+
+	Node2D *trail = memnew(Node2D);
+	trail->set_name("Trail");
+	root->add_child(trail);
+	trail->set_owner(root);
+
+	for (int i = 0; i < 4; i++) {
+		Node2D *point = memnew(Node2D);
+		point->set_name("Point" + itos(i));
+		point->set_position(Vector2(-8 * (i + 1), 0));
+		point->set_z_index(-i);
+		trail->add_child(point);
+		point->set_owner(root);
+	}
+
+	return root;
+}
+
+static bool _check_projectile(Node *p_node) {
+	Node2D *root = Object::cast_to<Node2D>(p_node);
+	if (!root || root->get_position() != Vector2(10, 20) || root->get_z_index() != 3) {
+		return false;
+	}
+
+	Node2D *visual = Object::cast_to<Node2D>(root->get_node_or_null(NodePath("Visual")));
+	if (!visual || visual->get_scale() != Vector2(2, 2) || visual->get_modulate() != Color(1, 0.5, 0.25)) {
+		return false;
+	}
+
+	Timer *lifetime = Object::cast_to<Timer>(root->get_node_or_null(NodePath("Lifetime")));
+	if (!lifetime || lifetime->get_wait_time() != 3.5 || !lifetime->is_one_shot()) {
+		return false;
+	}
+
+	for (int i = 0; i < 4; i++) {
+		Node2D *point = Object::cast_to<Node2D>(root->get_node_or_null(NodePath("Trail/Point" + itos(i))));
+		if (!point || point->get_position() != Vector2(-8 * (i + 1), 0) || point->get_z_index() != -i || point->get_owner() != root) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static double _spawns_per_second(const Ref<PackedScene> &p_scene, PackedScene::GenEditState p_edit_state, int p_count) {
+	OS *os = OS::get_singleton();
+	Vector<Node *> spawned;
+	spawned.resize(p_count);
+
+	uint64_t from = os->get_ticks_usec();
+	for (int i = 0; i < p_count; i++) {
+		spawned.write[i] = p_scene->instance(p_edit_state);
+	}
+	uint64_t usec = MAX(os->get_ticks_usec() - from, (uint64_t)1);
+
+	for (int i = 0; i < p_count; i++) {
+		memdelete(spawned[i]);
+	}
+
+	return p_count * 1000000.0 / usec;
+}
+
+// Loading with sub threads, resources that nothing else references are set up
+// by tasks of their own, the scene that bundles them all does not join them.
+static bool _test_threaded_groups() {
+	OS *os = OS::get_singleton();
+
+	Node2D *root = memnew(Node2D);
+	root->set_name("Root");
+	Ref<CanvasItemMaterial> shared;
+	shared.instance();
+	shared->set_blend_mode(CanvasItemMaterial::BLEND_MODE_ADD);
+	for (int i = 0; i < 6; i++) {
+		Node2D *child = memnew(Node2D);
+		child->set_name("Child" + itos(i));
+		if (i < 4) {
+			Ref<CanvasItemMaterial> material;
+			material.instance();
+			material->set_blend_mode(CanvasItemMaterial::BLEND_MODE_MUL);
+			child->set_material(material);
+		} else {
+			child->set_material(shared);
+		}
+		root->add_child(child);
+		child->set_owner(root);
+	}
+
+	Ref<PackedScene> scene;
+	scene.instance();
+	Error err = scene->pack(root);
+	memdelete(root);
+
+	String path = os->get_cache_path().plus_file("test_packed_scene.scn");
+	if (err == OK) {
+		err = ResourceSaver::save(path, scene);
+	}
+	FileAccess *f = err == OK ? FileAccess::open(path, FileAccess::READ) : nullptr;
+	if (!f) {
+		os->print("Saving the threaded load test scene failed.\n");
+		return false;
+	}
+
+	ResourceLoaderBinary loader;
+	loader.set_use_sub_threads(true);
+	loader.set_local_path(path);
+	loader.open(f);
+	err = loader.load();
+	DirAccess::remove_file_or_error(path);
+
+	// The four materials of their own and the shared one.
+	bool pass = err == OK && loader.get_threaded_group_count() == 5;
+	os->print("threaded load: %d groups\n", loader.get_threaded_group_count());
+
+	Ref<PackedScene> loaded = loader.get_resource();
+	Node *node = loaded.is_valid() ? loaded->instance() : nullptr;
+	if (!node) {
+		return false;
+	}
+
+	Ref<Material> materials[6];
+	for (int i = 0; i < 6; i++) {
+		Node2D *child = Object::cast_to<Node2D>(node->get_node_or_null(NodePath("Child" + itos(i))));
+		materials[i] = child ? child->get_material() : Ref<Material>();
+	}
+	for (int i = 0; i < 4; i++) {
+		Ref<CanvasItemMaterial> material = materials[i];
+		pass = pass && material.is_valid() && material->get_blend_mode() == CanvasItemMaterial::BLEND_MODE_MUL && material != materials[i + 1];
+	}
+	Ref<CanvasItemMaterial> loaded_shared = materials[4];
+	pass = pass && loaded_shared.is_valid() && loaded_shared->get_blend_mode() == CanvasItemMaterial::BLEND_MODE_ADD && materials[5] == materials[4];
+
+	memdelete(node);
+	return pass;
+}
+
+MainLoop *test() {
+	OS *os = OS::get_singleton();
+
+	Node *source = _make_projectile();
+	Ref<PackedScene> scene;
+	scene.instance();
+	Error err = scene->pack(source);
+	memdelete(source);
+
+	if (err != OK) {
+		os->print("Packing the test scene failed.\n");
+		return nullptr;
+	}
+
+	bool pass = true;
+	for (int i = 0; i < 3; i++) {
+		// The first run builds the plan, the next ones use it.
+		Node *node = scene->instance();
+		pass = pass && _check_projectile(node);
+		memdelete(node);
+	}
+	Node *node = scene->instance(PackedScene::GEN_EDIT_STATE_INSTANCE);
+	pass = pass && _check_projectile(node);
+	memdelete(node);
+
+	os->print("instance test %s.\n", pass ? "passed" : "FAILED");
+
+	os->print("threaded load test %s.\n", _test_threaded_groups() ? "passed" : "FAILED");
+
+	const int count = 20000;
+	os->print("Spawning %d instances of a %d node scene:\n", count, scene->get_state()->get_node_count());
+	os->print("\tresolved by name (editor instancing): %.0f spawns per second\n", _spawns_per_second(scene, PackedScene::GEN_EDIT_STATE_INSTANCE, count));
+	os->print("\tinstancing plan: %.0f spawns per second\n", _spawns_per_second(scene, PackedScene::GEN_EDIT_STATE_DISABLED, count));
+
+	return nullptr;
+}
+
+} // namespace TestPackedScene
@@ -0,0 +1,370 @@
+/*************************************************************************/
+/*  test_replication.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_replication.h"
+
+#include "core/io/multiplayer_api.h"
+#include "core/io/networked_multiplayer_peer.h"
+#include "core/os/os.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+
+namespace TestReplication {
+
+// Hands packets to the other peer in the same process, dropping the unreliable
+// ones (replication states and acknowledgements) on request.
+class LoopbackPeer : public NetworkedMultiplayerPeer {
+	struct Packet {
+		int from = 0;
+		Vector<uint8_t> data;
+	};
+
+	List<Packet> incoming;
+	Packet current;
+	TransferMode transfer_mode = TRANSFER_MODE_RELIABLE;
+
+public:
+	int id = 0;
+	LoopbackPeer *remote = nullptr;
+	bool drop_unreliable = false;
+	Vector<uint8_t> last_replicate; // Last replication packet put, dropped or not.
+
+	virtual int get_available_packet_count() const { return incoming.size(); }
+
+	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size) {
+		ERR_FAIL_COND_V(incoming.empty(), ERR_UNAVAILABLE);
+		current = incoming.front()->get();
+		incoming.pop_front();
+		*r_buffer = current.data.ptr();
+		r_buffer_size = current.data.size();
+		return OK;
+	}
+
+	virtual Error put_packet(const uint8_t *p_buffer, int p_buffer_size) {
+		Vector<uint8_t> data;
+		data.resize(p_buffer_size);
+		copymem(data.ptrw(), p_buffer, p_buffer_size);
+
+		if (p_buffer_size && p_buffer[0] == MultiplayerAPI::NETWORK_COMMAND_REPLICATE) {
+			last_replicate = data;
+		}
+		if (drop_unreliable && transfer_mode != TRANSFER_MODE_RELIABLE) {
+			return OK;
+		}
+
+		Packet packet;
+		packet.from = id;
+		packet.data = data;
+		remote->incoming.push_back(packet);
+		return OK;
+	}
+
+	virtual int get_max_packet_size() const { return 1 << 16; }
+
+	virtual void set_transfer_mode(TransferMode p_mode) { transfer_mode = p_mode; }
+	virtual TransferMode get_transfer_mode() const { return transfer_mode; }
+	virtual void set_target_peer(int p_peer_id) {}
+	virtual int get_packet_peer() const { return incoming.empty() ? 0 : incoming.front()->get().from; }
+	virtual bool is_server() const { return id == 1; }
+	virtual void poll() {}
+	virtual int get_unique_id() const { return id; }
+	virtual void set_refuse_new_connections(bool p_enable) {}
+	virtual bool is_refusing_new_connections() const { return false; }
+	virtual ConnectionStatus get_connection_status() const { return CONNECTION_CONNECTED; }
+};
+
+// Ticks are sent by the test rather than by poll(), which paces them in real time.
+class LoopbackMultiplayerAPI : public MultiplayerAPI {
+public:
+	void send_tick() { _replication_send(); }
+};
+
+// Properties of every replicated type, counting the values set with another type.
+class ReplicatedBody : public Node {
+	GDCLASS(ReplicatedBody, Node);
+
+protected:
+	bool _set(const StringName &p_name, const Variant &p_value) {
+		Variant::Type type = Variant::NIL;
+		if (p_name == "health") {
+			health = p_value;
+			type = Variant::INT;
+		} else if (p_name == "speed") {
+			speed = p_value;
+			type = Variant::FLOAT;
+		} else if (p_name == "aim") {
+			aim = p_value;
+			type = Variant::VECTOR2;
+		} else if (p_name == "position") {
+			position = p_value;
+			type = Variant::VECTOR3;
+		} else if (p_name == "cell") {
+			cell = p_value;
+			type = Variant::VECTOR3I;
+		} else {
+			return false;
+		}
+		if (p_value.get_type() != type) {
+			wrong_types++;
+		}
+		return true;
+	}
+
+	bool _get(const StringName &p_name, Variant &r_ret) const {
+		if (p_name == "health") {
+			r_ret = health;
+		} else if (p_name == "speed") {
+			r_ret = speed;
+		} else if (p_name == "aim") {
+			r_ret = aim;
+		} else if (p_name == "position") {
+			r_ret = position;
+		} else if (p_name == "cell") {
+			r_ret = cell;
+		} else {
+			return false;
+		}
+		return true;
+	}
+
+public:
+	int health = 100;
+	float speed = 0;
+	Vector2 aim;
+	Vector3 position;
+	Vector3i cell;
+	int wrong_types = 0;
+};
+
+enum {
+	PROPERTY_HEALTH = 1 << 0,
+	PROPERTY_SPEED = 1 << 1,
+	PROPERTY_AIM = 1 << 2,
+	PROPERTY_POSITION = 1 << 3,
+	PROPERTY_CELL = 1 << 4,
+};
+
+static void _add_properties(MultiplayerAPI *p_api, Node *p_node) {
+	p_api->replication_add_property(p_node, "health", 0.5); // Not a float, warns and is sent as is.
+	p_api->replication_add_property(p_node, "speed", 0.01);
+	p_api->replication_add_property(p_node, "aim", 0.01);
+	p_api->replication_add_property(p_node, "position", 0.001);
+	p_api->replication_add_property(p_node, "cell");
+}
+
+static uint64_t _read_varint(const Vector<uint8_t> &p_packet, int &r_ofs) {
+	uint64_t value = 0;
+	for (int shift = 0; r_ofs < p_packet.size(); shift += 7) {
+		uint8_t byte = p_packet[r_ofs++];
+		value |= uint64_t(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			break;
+		}
+	}
+	return value;
+}
+
+// The tick and baseline tick of a replication packet, and the masks of its only node.
+struct ReplicatePacket {
+	uint64_t tick = 0;
+	uint64_t base_tick = 0;
+	uint64_t changed = 0;
+	uint64_t delta = 0;
+};
+
+static ReplicatePacket _read_packet(const Vector<uint8_t> &p_packet) {
+	ReplicatePacket rp;
+	int ofs = 1;
+	rp.tick = _read_varint(p_packet, ofs);
+	rp.base_tick = _read_varint(p_packet, ofs);
+	if (ofs < p_packet.size()) {
+		_read_varint(p_packet, ofs); // Path id.
+		rp.changed = _read_varint(p_packet, ofs);
+		rp.delta = _read_varint(p_packet, ofs);
+	}
+	return rp;
+}
+
+// Quantized values are within half a step, the others are exact.
+static bool _same_state(const ReplicatedBody *p_source, const ReplicatedBody *p_copy) {
+	const float eps = 0.00001;
+	return p_copy->wrong_types == 0 &&
+		   p_copy->health == p_source->health &&
+		   p_copy->cell == p_source->cell &&
+		   Math::abs(p_copy->speed - p_source->speed) <= 0.005 + eps &&
+		   Math::abs(p_copy->aim.x - p_source->aim.x) <= 0.005 + eps &&
+		   Math::abs(p_copy->aim.y - p_source->aim.y) <= 0.005 + eps &&
+		   Math::abs(p_copy->position.x - p_source->position.x) <= 0.0005 + eps &&
+		   Math::abs(p_copy->position.y - p_source->position.y) <= 0.0005 + eps &&
+		   Math::abs(p_copy->position.z - p_source->position.z) <= 0.0005 + eps;
+}
+
+// Sends a tick and delivers everything: the state, then the acknowledgement.
+static void _step(LoopbackMultiplayerAPI *p_server, LoopbackMultiplayerAPI *p_client) {
+	p_server->send_tick();
+	p_client->poll();
+	p_server->poll();
+}
+
+static bool _report(const char *p_what, bool p_pass) {
+	OS::get_singleton()->print("%s: %s\n", p_what, p_pass ? "OK" : "FAILED");
+	return p_pass;
+}
+
+static bool _test(Node *p_root) {
+	Ref<LoopbackPeer> server_peer;
+	server_peer.instance();
+	Ref<LoopbackPeer> client_peer;
+	client_peer.instance();
+	server_peer->id = 1;
+	server_peer->remote = client_peer.ptr();
+	client_peer->id = 2;
+	client_peer->remote = server_peer.ptr();
+
+	Ref<LoopbackMultiplayerAPI> server;
+	server.instance();
+	Ref<LoopbackMultiplayerAPI> client;
+	client.instance();
+
+	// Both sides in the same tree, under roots of their own.
+	Node *server_root = memnew(Node);
+	server_root->set_name("Server");
+	p_root->add_child(server_root);
+	Node *client_root = memnew(Node);
+	client_root->set_name("Client");
+	p_root->add_child(client_root);
+
+	ReplicatedBody *source = memnew(ReplicatedBody);
+	source->set_name("Body");
+	source->set_custom_multiplayer(server);
+	source->set_network_master(1);
+	server_root->add_child(source);
+	ReplicatedBody *copy = memnew(ReplicatedBody);
+	copy->set_name("Body");
+	copy->set_custom_multiplayer(client);
+	copy->set_network_master(1);
+	client_root->add_child(copy);
+
+	server->set_root_node(server_root);
+	server->set_network_peer(server_peer);
+	server->set_replication_tick_rate(0);
+	server->_add_peer(2);
+	client->set_root_node(client_root);
+	client->set_network_peer(client_peer);
+	client->set_replication_tick_rate(0);
+	client->_add_peer(1);
+
+	_add_properties(server.ptr(), source);
+	_add_properties(client.ptr(), copy);
+
+	bool pass = true;
+
+	// The first tick can't carry the node, the client only learns its path then.
+	// Its acknowledgement is lost, so nothing can serve as a baseline.
+	client_peer->drop_unreliable = true;
+	_step(server.ptr(), client.ptr());
+	client_peer->drop_unreliable = false;
+
+	source->health = 75;
+	source->speed = 3.14159;
+	source->aim = Vector2(0.7071, -0.7071);
+	source->position = Vector3(12.3456, -0.5, 100.25);
+	source->cell = Vector3i(3, -4, 5);
+	_step(server.ptr(), client.ptr());
+	ReplicatePacket rp = _read_packet(server_peer->last_replicate);
+	pass &= _report("Full state without a baseline", rp.tick == 2 && rp.base_tick == 0 && rp.changed == 0x1F && rp.delta == 0 && _same_state(source, copy));
+	int full_size = server_peer->last_replicate.size();
+
+	source->speed = 4.2;
+	_step(server.ptr(), client.ptr());
+	rp = _read_packet(server_peer->last_replicate);
+	pass &= _report("Delta against the acknowledged tick", rp.base_tick == 2 && rp.changed == PROPERTY_SPEED && rp.delta == PROPERTY_SPEED && server_peer->last_replicate.size() < full_size && _same_state(source, copy));
+
+	// Lost states are not resent, the next delta against the last acknowledged one carries them.
+	server_peer->drop_unreliable = true;
+	source->health = 50;
+	source->position.x += 1;
+	_step(server.ptr(), client.ptr());
+	server_peer->drop_unreliable = false;
+	bool lost = copy->health == 75;
+	source->aim = Vector2(1, 0);
+	_step(server.ptr(), client.ptr());
+	rp = _read_packet(server_peer->last_replicate);
+	pass &= _report("Recovery after a dropped packet", lost && rp.tick == 5 && rp.base_tick == 3 && rp.changed == (PROPERTY_HEALTH | PROPERTY_AIM | PROPERTY_POSITION) && _same_state(source, copy));
+
+	// Without acknowledgements, deltas stay against tick 5 until it leaves the history.
+	client_peer->drop_unreliable = true;
+	bool window = true;
+	while (server->get_replication_tick() < 37) {
+		source->speed += 0.1;
+		source->cell.x += 1;
+		_step(server.ptr(), client.ptr());
+		rp = _read_packet(server_peer->last_replicate);
+		uint64_t expected_base = rp.tick < 5 + 32 ? 5 : 0;
+		uint64_t expected_changed = expected_base ? PROPERTY_SPEED | PROPERTY_CELL : 0x1F;
+		window = window && rp.base_tick == expected_base && rp.changed == expected_changed && _same_state(source, copy);
+	}
+	client_peer->drop_unreliable = false;
+	source->health = 10;
+	_step(server.ptr(), client.ptr());
+	rp = _read_packet(server_peer->last_replicate);
+	window = window && rp.tick == 38 && rp.base_tick == 0 && _same_state(source, copy);
+	source->health = 20;
+	_step(server.ptr(), client.ptr());
+	rp = _read_packet(server_peer->last_replicate);
+	window = window && rp.base_tick == 38 && rp.changed == PROPERTY_HEALTH && _same_state(source, copy);
+	pass &= _report("Acknowledgement out of the 32 tick window", window);
+
+	server->set_network_peer(Ref<NetworkedMultiplayerPeer>());
+	client->set_network_peer(Ref<NetworkedMultiplayerPeer>());
+	p_root->remove_child(server_root);
+	p_root->remove_child(client_root);
+	memdelete(server_root);
+	memdelete(client_root);
+
+	return pass;
+}
+
+class TestMainLoop : public SceneTree {
+public:
+	virtual void init() {
+		SceneTree::init();
+
+		bool pass = _test(get_root());
+		OS::get_singleton()->print("Replication test %s\n", pass ? "passed" : "FAILED");
+		quit();
+	}
+};
+
+MainLoop *test() {
+	return memnew(TestMainLoop);
+}
+
+} // namespace TestReplication
@@ -0,0 +1,173 @@
+/*************************************************************************/
+/*  test_rid.cpp                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_rid.h"
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/rid_owner.h"
+
+namespace TestRID {
+
+struct Element {
+	uint32_t a = 0;
+	uint32_t b = 0;
+};
+
+struct ThreadData {
+	RID_Owner<Element, true> *owner = nullptr;
+	const RID *shared = nullptr;
+	uint32_t shared_count = 0;
+	uint32_t iterations = 0;
+	SpinLock *lock = nullptr; // When set, every lookup is serialized like the old allocator did.
+	std::atomic<uint32_t> *errors = nullptr;
+};
+
+static void _lookup_thread(void *p_ud) {
+	ThreadData &data = *(ThreadData *)p_ud;
+	uint32_t errors = 0;
+	for (uint32_t i = 0; i < data.iterations; i++) {
+		if (data.lock) {
+			data.lock->lock();
+		}
+		Element *e = data.owner->getornull(data.shared[i % data.shared_count]);
+		if (data.lock) {
+			data.lock->unlock();
+		}
+		if (!e || e->a != e->b) {
+			errors++;
+		}
+	}
+	data.errors->fetch_add(errors);
+}
+
+static void _churn_thread(void *p_ud) {
+	ThreadData &data = *(ThreadData *)p_ud;
+	uint32_t errors = 0;
+	LocalVector<RID> mine;
+	for (uint32_t i = 0; i < data.iterations; i++) {
+		Element *e = data.owner->getornull(data.shared[i % data.shared_count]);
+		if (!e || e->a != e->b) {
+			errors++;
+		}
+		if (i % 4 == 0) {
+			Element n;
+			n.a = i;
+			n.b = i;
+			mine.push_back(data.owner->make_rid(n));
+		}
+		if (i % 8 == 0) {
+			RID rid = mine[mine.size() - 1];
+			mine.resize(mine.size() - 1);
+			data.owner->free(rid);
+			if (data.owner->owns(rid)) {
+				errors++;
+			}
+		}
+	}
+	for (uint32_t i = 0; i < mine.size(); i++) {
+		data.owner->free(mine[i]);
+	}
+	data.errors->fetch_add(errors);
+}
+
+static uint64_t _run_threads(int p_thread_count, void (*p_func)(void *), ThreadData &p_data) {
+	Vector<Thread *> threads;
+	threads.resize(p_thread_count);
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_thread_count; i++) {
+		threads.write[i] = Thread::create(p_func, &p_data);
+	}
+	for (int i = 0; i < p_thread_count; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+	return OS::get_singleton()->get_ticks_usec() - from;
+}
+
+MainLoop *test() {
+	OS *os = OS::get_singleton();
+	const int thread_count = MAX(2, os->get_processor_count());
+	const uint32_t shared_count = 1024;
+	const uint32_t iterations = 1000000;
+
+	RID_Owner<Element, true> owner;
+	LocalVector<RID> shared;
+	for (uint32_t i = 0; i < shared_count; i++) {
+		Element e;
+		e.a = i;
+		e.b = i;
+		shared.push_back(owner.make_rid(e));
+	}
+
+	std::atomic<uint32_t> errors;
+	errors.store(0);
+
+	ThreadData data;
+	data.owner = &owner;
+	data.shared = &shared[0];
+	data.shared_count = shared_count;
+	data.iterations = iterations;
+	data.errors = &errors;
+
+	os->print("Threads: %d, %d lookups each.\n", thread_count, iterations);
+
+	// Benchmark: concurrent lookups, serialized (as before) against lock-free.
+	SpinLock lock;
+	data.lock = &lock;
+	uint64_t locked_usec = _run_threads(thread_count, _lookup_thread, data);
+	data.lock = nullptr;
+	uint64_t lock_free_usec = _run_threads(thread_count, _lookup_thread, data);
+
+	double total = double(thread_count) * iterations;
+	os->print("\tlocked lookups: %.2f ns per lookup\n", locked_usec * 1000.0 / total);
+	os->print("\tlock-free lookups: %.2f ns per lookup\n", lock_free_usec * 1000.0 / total);
+
+	// Lookups racing with allocation and frees on every thread, which also grows the chunk tables.
+	uint64_t churn_usec = _run_threads(thread_count, _churn_thread, data);
+	os->print("\tlookups with make_rid/free churn: %.2f ns per iteration\n", churn_usec * 1000.0 / total);
+
+	bool pass = errors.load() == 0 && owner.get_rid_count() == shared_count;
+
+	List<RID> owned;
+	owner.get_owned_list(&owned);
+	pass = pass && owned.size() == int(shared_count);
+
+	for (uint32_t i = 0; i < shared_count; i++) {
+		owner.free(shared[i]);
+	}
+	pass = pass && owner.get_rid_count() == 0 && !owner.owns(shared[0]);
+
+	os->print("RID_Owner thread safety test %s.\n", pass ? "passed" : "FAILED");
+
+	return nullptr;
+}
+
+} // namespace TestRID
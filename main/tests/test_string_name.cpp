@@ -0,0 +1,160 @@
+/*************************************************************************/
+/*  test_string_name.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_string_name.h"
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string_name.h"
+
+#include <atomic>
+
+namespace TestStringName {
+
+static const int NAME_COUNT = 200000;
+
+struct ThreadData {
+	const String *names = nullptr;
+	std::atomic<uint32_t> next_thread;
+	int thread_count = 0;
+	int rounds = 0;
+	std::atomic<uint32_t> errors;
+	StringName *interned = nullptr; // Names kept alive during the lookup benchmark.
+};
+
+// Every thread interns all names, starting at a different offset, so most
+// constructions race with another thread adding or finding the same name.
+static void _intern_thread(void *p_ud) {
+	ThreadData &data = *(ThreadData *)p_ud;
+	uint32_t offset = data.next_thread.fetch_add(1) * (NAME_COUNT / data.thread_count);
+	uint32_t errors = 0;
+	for (int r = 0; r < data.rounds; r++) {
+		for (int i = 0; i < NAME_COUNT; i++) {
+			const String &name = data.names[(offset + i) % NAME_COUNT];
+			StringName sn(name);
+			if (String(sn) != name) {
+				errors++;
+			}
+		}
+	}
+	data.errors.fetch_add(errors);
+}
+
+// Names already exist, so this is the lock-free path only.
+static void _lookup_thread(void *p_ud) {
+	ThreadData &data = *(ThreadData *)p_ud;
+	uint32_t offset = data.next_thread.fetch_add(1) * (NAME_COUNT / data.thread_count);
+	uint32_t errors = 0;
+	for (int r = 0; r < data.rounds; r++) {
+		for (int i = 0; i < NAME_COUNT; i++) {
+			uint32_t idx = (offset + i) % NAME_COUNT;
+			StringName sn(data.names[idx]);
+			if (sn != data.interned[idx]) {
+				errors++;
+			}
+			if (StringName::search(data.names[idx]) != sn) {
+				errors++;
+			}
+		}
+	}
+	data.errors.fetch_add(errors);
+}
+
+static uint64_t _run_threads(int p_thread_count, void (*p_func)(void *), ThreadData &p_data) {
+	p_data.next_thread.store(0);
+	p_data.thread_count = p_thread_count;
+
+	Vector<Thread *> threads;
+	threads.resize(p_thread_count);
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_thread_count; i++) {
+		threads.write[i] = Thread::create(p_func, &p_data);
+	}
+	for (int i = 0; i < p_thread_count; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+	return OS::get_singleton()->get_ticks_usec() - from;
+}
+
+MainLoop *test() {
+	OS *os = OS::get_singleton();
+	const int thread_count = MAX(2, os->get_processor_count());
+
+	Vector<String> names;
+	names.resize(NAME_COUNT);
+	for (int i = 0; i < NAME_COUNT; i++) {
+		names.write[i] = "test_string_name_" + itos(i);
+	}
+
+	ThreadData data;
+	data.names = names.ptr();
+	data.rounds = 2;
+	data.errors.store(0);
+
+	os->print("Threads: %d, %d names.\n", thread_count, NAME_COUNT);
+
+	// Names are released at the end of each construction, so this measures
+	// insertion and removal with every thread contending for the same names.
+	uint64_t single_usec = _run_threads(1, _intern_thread, data);
+	uint64_t multi_usec = _run_threads(thread_count, _intern_thread, data);
+	double single_ops = double(NAME_COUNT) * data.rounds;
+	double multi_ops = single_ops * thread_count;
+	os->print("\tintern and release, 1 thread: %.2f ns per name\n", single_usec * 1000.0 / single_ops);
+	os->print("\tintern and release, %d threads: %.2f ns per name\n", thread_count, multi_usec * 1000.0 / multi_ops);
+
+	Vector<StringName> interned;
+	interned.resize(NAME_COUNT);
+	for (int i = 0; i < NAME_COUNT; i++) {
+		interned.write[i] = names[i];
+	}
+	data.interned = interned.ptrw();
+
+	single_usec = _run_threads(1, _lookup_thread, data);
+	multi_usec = _run_threads(thread_count, _lookup_thread, data);
+	os->print("\tlookup existing, 1 thread: %.2f ns per name\n", single_usec * 1000.0 / single_ops);
+	os->print("\tlookup existing, %d threads: %.2f ns per name\n", thread_count, multi_usec * 1000.0 / multi_ops);
+
+	bool pass = data.errors.load() == 0;
+
+	// Once released, names must be gone from the table.
+	interned.clear();
+	for (int i = 0; i < NAME_COUNT; i += 1000) {
+		if (StringName::search(names[i]) != StringName()) {
+			pass = false;
+		}
+	}
+
+	os->print("StringName thread safety test %s.\n", pass ? "passed" : "FAILED");
+
+	return nullptr;
+}
+
+} // namespace TestStringName
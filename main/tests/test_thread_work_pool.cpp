@@ -0,0 +1,183 @@
+/*************************************************************************/
+/*  test_thread_work_pool.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_thread_work_pool.h"
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+#include "core/thread_work_pool.h"
+
+namespace TestThreadWorkPool {
+
+struct Counter {
+	std::atomic<uint32_t> calls;
+	uint32_t *order = nullptr;
+	std::atomic<uint32_t> order_pos;
+
+	void count(uint32_t p_index, uint32_t *p_values) {
+		p_values[p_index] = p_index * 2;
+		calls.fetch_add(1);
+	}
+
+	void record(uint32_t p_id) {
+		order[order_pos.fetch_add(1)] = p_id;
+	}
+};
+
+// What thread_process_array used to do: one fresh thread per core, per call.
+struct SpawnData {
+	Counter *counter;
+	uint32_t *values;
+	uint32_t elements;
+	uint32_t index;
+};
+
+static void _spawn_thread_func(void *p_ud) {
+	SpawnData &data = *(SpawnData *)p_ud;
+	while (true) {
+		uint32_t index = atomic_increment(&data.index) - 1;
+		if (index >= data.elements) {
+			break;
+		}
+		data.counter->count(index, data.values);
+	}
+}
+
+static void _spawn_per_call(uint32_t p_elements, Counter *p_counter, uint32_t *p_values) {
+	SpawnData data;
+	data.counter = p_counter;
+	data.values = p_values;
+	data.elements = p_elements;
+	data.index = 0;
+
+	Vector<Thread *> threads;
+	threads.resize(OS::get_singleton()->get_processor_count());
+	for (int i = 0; i < threads.size(); i++) {
+		threads.write[i] = Thread::create(_spawn_thread_func, &data);
+	}
+	for (int i = 0; i < threads.size(); i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+}
+
+MainLoop *test() {
+	OS *os = OS::get_singleton();
+
+	ThreadWorkPool pool;
+	pool.init();
+	os->print("Worker threads: %d\n", pool.get_thread_count());
+
+	const uint32_t elements = 1024;
+	uint32_t *values = memnew_arr(uint32_t, elements);
+
+	// Every element processed exactly once, for several grain sizes.
+	{
+		const uint32_t grains[] = { 1, 7, 64, 4096 };
+		bool pass = true;
+		for (int g = 0; g < 4; g++) {
+			Counter counter;
+			counter.calls.store(0);
+			for (uint32_t i = 0; i < elements; i++) {
+				values[i] = 0;
+			}
+			pool.do_work(elements, &counter, &Counter::count, values, grains[g]);
+			if (counter.calls.load() != elements) {
+				pass = false;
+			}
+			for (uint32_t i = 0; i < elements; i++) {
+				if (values[i] != i * 2) {
+					pass = false;
+				}
+			}
+		}
+		os->print("do_work coverage test %s.\n", pass ? "passed" : "FAILED");
+	}
+
+	// Job dependencies: a chain must run in order.
+	{
+		const int chain = 64;
+		uint32_t order[chain];
+		Counter counter;
+		counter.order = order;
+		counter.order_pos.store(0);
+
+		Vector<ThreadWorkPool::JobID> ids;
+		ThreadWorkPool::JobID previous = ThreadWorkPool::INVALID_JOB_ID;
+		for (int i = 0; i < chain; i++) {
+			Vector<ThreadWorkPool::JobID> deps;
+			if (previous != ThreadWorkPool::INVALID_JOB_ID) {
+				deps.push_back(previous);
+			}
+			previous = pool.add_job(&counter, &Counter::record, uint32_t(i), deps);
+			ids.push_back(previous);
+		}
+		for (int i = 0; i < ids.size(); i++) {
+			pool.wait_for_job(ids[i]);
+		}
+
+		bool pass = counter.order_pos.load() == chain;
+		for (int i = 0; pass && i < chain; i++) {
+			pass = order[i] == uint32_t(i);
+		}
+		os->print("job dependency test %s.\n", pass ? "passed" : "FAILED");
+	}
+
+	// Benchmark: dispatch overhead, spawn-per-call against the persistent pool.
+	{
+		const int iterations = 200;
+		Counter counter;
+		counter.calls.store(0);
+
+		uint64_t from = os->get_ticks_usec();
+		for (int i = 0; i < iterations; i++) {
+			_spawn_per_call(elements, &counter, values);
+		}
+		uint64_t spawn_usec = os->get_ticks_usec() - from;
+
+		from = os->get_ticks_usec();
+		for (int i = 0; i < iterations; i++) {
+			pool.do_work(elements, &counter, &Counter::count, values, 16);
+		}
+		uint64_t pool_usec = os->get_ticks_usec() - from;
+
+		os->print("Dispatch of %d elements, %d iterations:\n", elements, iterations);
+		os->print("\tspawn per call: %.2f usec per dispatch\n", double(spawn_usec) / iterations);
+		os->print("\tpersistent pool: %.2f usec per dispatch\n", double(pool_usec) / iterations);
+	}
+
+	memdelete_arr(values);
+	pool.finish();
+
+	return nullptr;
+}
+
+} // namespace TestThreadWorkPool
@@ -31,6 +31,7 @@
 #include "gd_navigation_server.h"
 
 #include "core/os/mutex.h"
+#include "core/thread_work_pool.h"
 
 #ifndef _3D_DISABLED
 #include "navigation_mesh_generator.h"
@@ -207,6 +208,124 @@ Vector<Vector3> GdNavigationServer::map_get_path(RID p_map, Vector3 p_origin, Ve
 	return map->get_path(p_origin, p_destination, p_optimize);
 }
 
+Array GdNavigationServer::map_get_paths(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize) const {
+	const NavMap *map = map_owner.getornull(p_map);
+	ERR_FAIL_COND_V(map == nullptr, Array());
+	ERR_FAIL_COND_V(p_origins.size() != p_destinations.size(), Array());
+
+	std::vector<PathQuery> queries(p_origins.size());
+	for (int i(0); i < p_origins.size(); i++) {
+		queries[i].map = map;
+		queries[i].origin = p_origins[i];
+		queries[i].destination = p_destinations[i];
+		queries[i].optimize = p_optimize;
+	}
+
+	{
+		// The map must not be synced while the queries read it.
+		auto mut_this = const_cast<GdNavigationServer *>(this);
+		MutexLock lock(mut_this->operations_mutex);
+		compute_path_queries(queries.data(), queries.size());
+	}
+
+	Array paths;
+	paths.resize(queries.size());
+	for (size_t i(0); i < queries.size(); i++) {
+		paths[i] = queries[i].path;
+	}
+	return paths;
+}
+
+void GdNavigationServer::map_get_paths_async(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize, Object *p_receiver, StringName p_method, Variant p_udata) const {
+	ERR_FAIL_COND(p_origins.size() != p_destinations.size());
+	ERR_FAIL_COND(p_receiver == nullptr);
+
+	AsyncPathQueries queries;
+	queries.map = p_map;
+	queries.origins = p_origins;
+	queries.destinations = p_destinations;
+	queries.optimize = p_optimize;
+	queries.receiver = p_receiver->get_instance_id();
+	queries.method = p_method;
+	queries.udata = p_udata;
+
+	auto mut_this = const_cast<GdNavigationServer *>(this);
+	MutexLock lock(mut_this->async_path_queries_mutex);
+	mut_this->async_path_queries.push_back(queries);
+}
+
+void GdNavigationServer::compute_path_query(uint32_t p_index, PathQuery *p_queries) const {
+	PathQuery &query = p_queries[p_index];
+	query.path = query.map->get_path(query.origin, query.destination, query.optimize);
+}
+
+void GdNavigationServer::compute_path_queries(PathQuery *p_queries, uint32_t p_count) const {
+	// `NavMap::get_path` only reads the map, so the queries can run in parallel.
+	ThreadWorkPool::get_singleton()->do_work(p_count, this, &GdNavigationServer::compute_path_query, p_queries);
+}
+
+void GdNavigationServer::dispatch_async_path_queries() {
+	std::vector<AsyncPathQueries> requests;
+	{
+		MutexLock lock(async_path_queries_mutex);
+		requests.swap(async_path_queries);
+	}
+
+	if (requests.empty()) {
+		return;
+	}
+
+	// All the queued requests are flattened, so many small requests still
+	// spread over the worker threads.
+	std::vector<PathQuery> queries;
+	std::vector<uint32_t> request_query_from(requests.size());
+	{
+		// The maps must not be synced or freed while the queries read them.
+		MutexLock lock(operations_mutex);
+		for (size_t r(0); r < requests.size(); r++) {
+			request_query_from[r] = queries.size();
+
+			const NavMap *map = map_owner.getornull(requests[r].map);
+			if (map == nullptr) {
+				ERR_PRINT("Invalid map, the async path queries are dropped.");
+				requests[r].receiver = ObjectID();
+				continue;
+			}
+
+			for (int i(0); i < requests[r].origins.size(); i++) {
+				PathQuery query;
+				query.map = map;
+				query.origin = requests[r].origins[i];
+				query.destination = requests[r].destinations[i];
+				query.optimize = requests[r].optimize;
+				queries.push_back(query);
+			}
+		}
+
+		compute_path_queries(queries.data(), queries.size());
+	}
+
+	// The receivers are called without holding the lock, so they can use the server.
+	for (size_t r(0); r < requests.size(); r++) {
+		Object *receiver = ObjectDB::get_instance(requests[r].receiver);
+		if (receiver == nullptr) {
+			continue;
+		}
+
+		Array paths;
+		paths.resize(requests[r].origins.size());
+		for (int i(0); i < paths.size(); i++) {
+			paths[i] = queries[request_query_from[r] + i].path;
+		}
+
+		Callable::CallError call_error;
+		const Variant paths_variant = paths;
+		const Variant *vp[2] = { &paths_variant, &requests[r].udata };
+		int argc = (requests[r].udata.get_type() == Variant::NIL) ? 1 : 2;
+		receiver->call(requests[r].method, vp, argc, call_error);
+	}
+}
+
 Vector3 GdNavigationServer::map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
 	const NavMap *map = map_owner.getornull(p_map);
 	ERR_FAIL_COND_V(map == nullptr, Vector3());
@@ -483,18 +602,38 @@ void GdNavigationServer::flush_queries() {
 void GdNavigationServer::process(real_t p_delta_time) {
 	flush_queries();
 
-	if (!active) {
-		return;
+	if (active) {
+		// In c++ we can't be sure that this is performed in the main thread
+		// even with mutable functions.
+		MutexLock lock(operations_mutex);
+		link_rebuild_usec = 0;
+		link_rebuilt_regions = 0;
+		for (int i(0); i < active_maps.size(); i++) {
+			active_maps[i]->sync();
+			active_maps[i]->step(p_delta_time);
+			active_maps[i]->dispatch_callbacks();
+
+			link_rebuild_usec += active_maps[i]->get_link_rebuild_usec();
+			link_rebuilt_regions += active_maps[i]->get_link_rebuild_regions();
+		}
 	}
 
-	// In c++ we can't be sure that this is performed in the main thread
-	// even with mutable functions.
-	MutexLock lock(operations_mutex);
-	for (int i(0); i < active_maps.size(); i++) {
-		active_maps[i]->sync();
-		active_maps[i]->step(p_delta_time);
-		active_maps[i]->dispatch_callbacks();
+	// Async path queries are answered even while the server is inactive, so
+	// their callers are never left waiting.
+	dispatch_async_path_queries();
+}
+
+int GdNavigationServer::get_process_info(ProcessInfo p_info) const {
+	switch (p_info) {
+		case INFO_LINK_REBUILD_TIME_USEC: {
+			return link_rebuild_usec;
+		} break;
+		case INFO_LINK_REBUILT_REGIONS: {
+			return link_rebuilt_regions;
+		} break;
 	}
+
+	return 0;
 }
 
 #undef COMMAND_1
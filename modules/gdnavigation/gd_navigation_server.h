@@ -74,6 +74,27 @@ class GdNavigationServer : public NavigationServer3D {
 
 	std::vector<SetCommand *> commands;
 
+	struct PathQuery {
+		const NavMap *map = nullptr;
+		Vector3 origin;
+		Vector3 destination;
+		bool optimize = false;
+		Vector<Vector3> path;
+	};
+
+	struct AsyncPathQueries {
+		RID map;
+		Vector<Vector3> origins;
+		Vector<Vector3> destinations;
+		bool optimize = false;
+		ObjectID receiver;
+		StringName method;
+		Variant udata;
+	};
+
+	Mutex async_path_queries_mutex;
+	std::vector<AsyncPathQueries> async_path_queries;
+
 	mutable RID_PtrOwner<NavMap> map_owner;
 	mutable RID_PtrOwner<NavRegion> region_owner;
 	mutable RID_PtrOwner<RvoAgent> agent_owner;
@@ -81,6 +102,10 @@ class GdNavigationServer : public NavigationServer3D {
 	bool active = true;
 	Vector<NavMap *> active_maps;
 
+	// Stats of the last process.
+	uint64_t link_rebuild_usec = 0;
+	uint32_t link_rebuilt_regions = 0;
+
 public:
 	GdNavigationServer();
 	virtual ~GdNavigationServer();
@@ -101,6 +126,8 @@ public:
 	virtual real_t map_get_edge_connection_margin(RID p_map) const;
 
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize) const;
+	virtual Array map_get_paths(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize) const;
+	virtual void map_get_paths_async(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize, Object *p_receiver, StringName p_method, Variant p_udata = Variant()) const;
 
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const;
@@ -133,6 +160,13 @@ public:
 
 	void flush_queries();
 	virtual void process(real_t p_delta_time);
+
+	virtual int get_process_info(ProcessInfo p_info) const;
+
+private:
+	void compute_path_query(uint32_t p_index, PathQuery *p_queries) const;
+	void compute_path_queries(PathQuery *p_queries, uint32_t p_count) const;
+	void dispatch_async_path_queries();
 };
 
 #undef COMMAND_1
@@ -30,7 +30,8 @@
 
 #include "nav_map.h"
 
-#include "core/os/threaded_array_processor.h"
+#include "core/os/os.h"
+#include "core/thread_work_pool.h"
 #include "nav_region.h"
 #include "rvo_agent.h"
 
@@ -42,6 +43,81 @@
 
 #define USE_ENTRY_POINT
 
+/// The `get_path` search state. Each thread has its own, so the queries
+/// don't allocate once the buffers have grown to the map size.
+struct PathQueryScratch {
+	struct OpenEntry {
+		float cost;
+		uint32_t id;
+
+		// Inverted, the heap keeps the least cost on top.
+		bool operator<(const OpenEntry &p_other) const {
+			return cost > p_other.cost;
+		}
+	};
+
+	std::vector<gd::NavigationPoly> navigation_polys;
+	std::vector<OpenEntry> open_heap;
+
+	/// Per map polygon, the `navigation_polys` id; valid when its stamp is
+	/// the current query one, so nothing needs clearing between queries.
+	std::vector<uint32_t> poly_stamps;
+	std::vector<uint32_t> poly_navigation_ids;
+	uint32_t stamp = 0;
+
+	void begin(size_t p_polygon_count) {
+		navigation_polys.clear();
+		open_heap.clear();
+		if (poly_stamps.size() < p_polygon_count) {
+			poly_stamps.resize(p_polygon_count, 0);
+			poly_navigation_ids.resize(p_polygon_count);
+		}
+		stamp++;
+		if (unlikely(stamp == 0)) {
+			std::fill(poly_stamps.begin(), poly_stamps.end(), 0);
+			stamp = 1;
+		}
+	}
+
+	int find(const gd::Polygon *p_poly) const {
+		return poly_stamps[p_poly->id] == stamp ? int(poly_navigation_ids[p_poly->id]) : -1;
+	}
+
+	gd::NavigationPoly &add(const gd::Polygon *p_poly) {
+		const uint32_t id = navigation_polys.size();
+		navigation_polys.push_back(gd::NavigationPoly(p_poly));
+		navigation_polys.back().self_id = id;
+		poly_stamps[p_poly->id] = stamp;
+		poly_navigation_ids[p_poly->id] = id;
+		return navigation_polys.back();
+	}
+
+	void push_open(uint32_t p_id, float p_cost) {
+		OpenEntry entry;
+		entry.cost = p_cost;
+		entry.id = p_id;
+		open_heap.push_back(entry);
+		std::push_heap(open_heap.begin(), open_heap.end());
+	}
+
+	uint32_t pop_open() {
+		std::pop_heap(open_heap.begin(), open_heap.end());
+		const uint32_t id = open_heap.back().id;
+		open_heap.pop_back();
+		return id;
+	}
+};
+
+static thread_local PathQueryScratch path_query_scratch;
+
+static _FORCE_INLINE_ float _heuristic(const gd::NavigationPoly &p_poly, const Vector3 &p_end_point) {
+#ifdef USE_ENTRY_POINT
+	return p_poly.entry.distance_to(p_end_point);
+#else
+	return p_poly.poly->center.distance_to(p_end_point);
+#endif
+}
+
 void NavMap::set_up(Vector3 p_up) {
 	up = p_up;
 	regenerate_polygons = true;
@@ -71,37 +147,11 @@ gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 }
 
 Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize) const {
-	const gd::Polygon *begin_poly = nullptr;
-	const gd::Polygon *end_poly = nullptr;
+	// Find the initial poly and the end poly on this map.
 	Vector3 begin_point;
 	Vector3 end_point;
-	float begin_d = 1e20;
-	float end_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance between the origin/destination
-		for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
-			Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			Vector3 spoint = f.get_closest_point_to(p_origin);
-			float dpoint = spoint.distance_to(p_origin);
-			if (dpoint < begin_d) {
-				begin_d = dpoint;
-				begin_poly = &p;
-				begin_point = spoint;
-			}
-
-			spoint = f.get_closest_point_to(p_destination);
-			dpoint = spoint.distance_to(p_destination);
-			if (dpoint < end_d) {
-				end_d = dpoint;
-				end_poly = &p;
-				end_point = spoint;
-			}
-		}
-	}
+	const gd::Polygon *begin_poly = get_closest_polygon(p_origin, begin_point);
+	const gd::Polygon *end_poly = get_closest_polygon(p_destination, end_point);
 
 	if (!begin_poly || !end_poly) {
 		// No path
@@ -116,88 +166,28 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
-	std::vector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.reserve(polygons.size() * 0.75);
+	// The search state lives in a per thread arena, reused by all the queries.
+	PathQueryScratch &scratch = path_query_scratch;
+	scratch.begin(polygons.size());
+	std::vector<gd::NavigationPoly> &navigation_polys = scratch.navigation_polys;
+	std::vector<PathQueryScratch::OpenEntry> &open_heap = scratch.open_heap;
 
 	// The elements indices in the `navigation_polys`.
 	int least_cost_id(-1);
-	List<uint32_t> open_list;
 	bool found_route = false;
 
-	navigation_polys.push_back(gd::NavigationPoly(begin_poly));
 	{
-		least_cost_id = 0;
-		gd::NavigationPoly *least_cost_poly = &navigation_polys[least_cost_id];
-		least_cost_poly->self_id = least_cost_id;
-		least_cost_poly->entry = begin_point;
+		gd::NavigationPoly &np = scratch.add(begin_poly);
+		np.entry = begin_point;
+		scratch.push_open(0, begin_point.distance_to(end_point));
 	}
 
-	open_list.push_back(0);
-
 	const gd::Polygon *reachable_end = nullptr;
 	float reachable_d = 1e30;
 	bool is_reachable = true;
 
 	while (found_route == false) {
-		{
-			// Takes the current least_cost_poly neighbors and compute the traveled_distance of each
-			for (size_t i = 0; i < navigation_polys[least_cost_id].poly->edges.size(); i++) {
-				gd::NavigationPoly *least_cost_poly = &navigation_polys[least_cost_id];
-
-				const gd::Edge &edge = least_cost_poly->poly->edges[i];
-				if (!edge.other_polygon) {
-					continue;
-				}
-
-#ifdef USE_ENTRY_POINT
-				Vector3 edge_line[2] = {
-					least_cost_poly->poly->points[i].pos,
-					least_cost_poly->poly->points[(i + 1) % least_cost_poly->poly->points.size()].pos
-				};
-
-				const Vector3 new_entry = Geometry::get_closest_point_to_segment(least_cost_poly->entry, edge_line);
-				const float new_distance = least_cost_poly->entry.distance_to(new_entry) + least_cost_poly->traveled_distance;
-#else
-				const float new_distance = least_cost_poly->poly->center.distance_to(edge.other_polygon->center) + least_cost_poly->traveled_distance;
-#endif
-
-				auto it = std::find(
-						navigation_polys.begin(),
-						navigation_polys.end(),
-						gd::NavigationPoly(edge.other_polygon));
-
-				if (it != navigation_polys.end()) {
-					// Oh this was visited already, can we win the cost?
-					if (it->traveled_distance > new_distance) {
-						it->prev_navigation_poly_id = least_cost_id;
-						it->back_navigation_edge = edge.other_edge;
-						it->traveled_distance = new_distance;
-#ifdef USE_ENTRY_POINT
-						it->entry = new_entry;
-#endif
-					}
-				} else {
-					// Add to open neighbours
-
-					navigation_polys.push_back(gd::NavigationPoly(edge.other_polygon));
-					gd::NavigationPoly *np = &navigation_polys[navigation_polys.size() - 1];
-
-					np->self_id = navigation_polys.size() - 1;
-					np->prev_navigation_poly_id = least_cost_id;
-					np->back_navigation_edge = edge.other_edge;
-					np->traveled_distance = new_distance;
-#ifdef USE_ENTRY_POINT
-					np->entry = new_entry;
-#endif
-					open_list.push_back(navigation_polys.size() - 1);
-				}
-			}
-		}
-
-		// Removes the least cost polygon from the open list so we can advance.
-		open_list.erase(least_cost_id);
-
-		if (open_list.size() == 0) {
+		if (open_heap.empty()) {
 			// When the open list is empty at this point the End Polygon is not reachable
 			// so use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
@@ -209,7 +199,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 			// Set as end point the furthest reachable point.
 			end_poly = reachable_end;
-			end_d = 1e20;
+			float end_d = 1e20;
 			for (size_t point_id = 2; point_id < end_poly->points.size(); point_id++) {
 				Face3 f(end_poly->points[point_id - 2].pos, end_poly->points[point_id - 1].pos, end_poly->points[point_id].pos);
 				Vector3 spoint = f.get_closest_point_to(p_destination);
@@ -221,11 +211,10 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			}
 
 			// Reset open and navigation_polys
-			gd::NavigationPoly np = navigation_polys[0];
-			navigation_polys.clear();
-			navigation_polys.push_back(np);
-			open_list.clear();
-			open_list.push_back(0);
+			scratch.begin(polygons.size());
+			gd::NavigationPoly &np = scratch.add(begin_poly);
+			np.entry = begin_point;
+			scratch.push_open(0, begin_point.distance_to(end_point));
 
 			reachable_end = nullptr;
 
@@ -233,22 +222,12 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		}
 
 		// Now take the new least_cost_poly from the open list.
-		least_cost_id = -1;
-		float least_cost = 1e30;
-
-		for (auto element = open_list.front(); element != nullptr; element = element->next()) {
-			gd::NavigationPoly *np = &navigation_polys[element->get()];
-			float cost = np->traveled_distance;
-#ifdef USE_ENTRY_POINT
-			cost += np->entry.distance_to(end_point);
-#else
-			cost += np->poly->center.distance_to(end_point);
-#endif
-			if (cost < least_cost) {
-				least_cost_id = np->self_id;
-				least_cost = cost;
-			}
+		least_cost_id = scratch.pop_open();
+		if (navigation_polys[least_cost_id].closed) {
+			// Stale entry, this poly was reached again with a smaller cost.
+			continue;
 		}
+		navigation_polys[least_cost_id].closed = true;
 
 		// Stores the further reachable end polygon, in case our goal is not reachable.
 		if (is_reachable) {
@@ -259,14 +238,62 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			}
 		}
 
-		ERR_BREAK(least_cost_id == -1);
-
 		// Check if we reached the end
 		if (navigation_polys[least_cost_id].poly == end_poly) {
 			// Yep, done!!
 			found_route = true;
 			break;
 		}
+
+		// Takes the current least_cost_poly neighbors and compute the traveled_distance of each
+		for (size_t i = 0; i < navigation_polys[least_cost_id].poly->edges.size(); i++) {
+			gd::NavigationPoly *least_cost_poly = &navigation_polys[least_cost_id];
+
+			const gd::Edge &edge = least_cost_poly->poly->edges[i];
+			if (!edge.other_polygon) {
+				continue;
+			}
+
+#ifdef USE_ENTRY_POINT
+			Vector3 edge_line[2] = {
+				least_cost_poly->poly->points[i].pos,
+				least_cost_poly->poly->points[(i + 1) % least_cost_poly->poly->points.size()].pos
+			};
+
+			const Vector3 new_entry = Geometry::get_closest_point_to_segment(least_cost_poly->entry, edge_line);
+			const float new_distance = least_cost_poly->entry.distance_to(new_entry) + least_cost_poly->traveled_distance;
+#else
+			const float new_distance = least_cost_poly->poly->center.distance_to(edge.other_polygon->center) + least_cost_poly->traveled_distance;
+#endif
+
+			int other_id = scratch.find(edge.other_polygon);
+			if (other_id != -1) {
+				// Oh this was visited already, can we win the cost?
+				gd::NavigationPoly &np = navigation_polys[other_id];
+				if (np.traveled_distance > new_distance) {
+					np.prev_navigation_poly_id = least_cost_id;
+					np.back_navigation_edge = edge.other_edge;
+					np.traveled_distance = new_distance;
+#ifdef USE_ENTRY_POINT
+					np.entry = new_entry;
+#endif
+					if (!np.closed) {
+						scratch.push_open(other_id, new_distance + _heuristic(np, end_point));
+					}
+				}
+			} else {
+				// Add to open neighbours
+				gd::NavigationPoly &np = scratch.add(edge.other_polygon);
+
+				np.prev_navigation_poly_id = least_cost_id;
+				np.back_navigation_edge = edge.other_edge;
+				np.traveled_distance = new_distance;
+#ifdef USE_ENTRY_POINT
+				np.entry = new_entry;
+#endif
+				scratch.push_open(np.self_id, new_distance + _heuristic(np, end_point));
+			}
+		}
 	}
 
 	if (found_route) {
@@ -384,32 +411,82 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 }
 
 Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
-	bool use_collision = p_use_collision;
+	if (bvh_nodes.empty()) {
+		return Vector3();
+	}
+
+	uint32_t stack[64]; // The tree is balanced, its depth is at most log2 of the polygon count.
+	int stack_size = 0;
+
+	// Look for the intersection with the polygons nearest to `p_from`.
+	bool collided = false;
 	Vector3 closest_point;
 	real_t closest_point_d = 1e20;
 
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
+	stack[stack_size++] = 0;
+	while (stack_size) {
+		const gd::PolygonBVHNode &node = bvh_nodes[stack[--stack_size]];
+		if (!node.aabb.intersects_segment(p_from, p_to)) {
+			continue;
+		}
 
-		// For each point cast a face and check the distance to the segment
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			Vector3 inters;
-			if (f.intersects_segment(p_from, p_to, &inters)) {
-				const real_t d = closest_point_d = p_from.distance_to(inters);
-				if (use_collision == false) {
-					closest_point = inters;
-					use_collision = true;
-					closest_point_d = d;
-				} else if (closest_point_d > d) {
-					closest_point = inters;
-					closest_point_d = d;
+		if (node.left != -1) {
+			stack[stack_size++] = node.left;
+			stack[stack_size++] = node.right;
+			continue;
+		}
+
+		for (uint32_t i = node.polygon_from; i < node.polygon_from + node.polygon_count; i++) {
+			if (!polygons[bvh_polygons[i]]) {
+				continue; // Its region was removed after the last sync.
+			}
+			const gd::Polygon &p = *polygons[bvh_polygons[i]];
+
+			// For each point cast a face and check the distance to the segment
+			for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
+				const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+				Vector3 inters;
+				if (f.intersects_segment(p_from, p_to, &inters)) {
+					const real_t d = p_from.distance_to(inters);
+					if (d < closest_point_d) {
+						closest_point = inters;
+						closest_point_d = d;
+						collided = true;
+					}
 				}
 			}
 		}
+	}
+
+	if (collided || p_use_collision) {
+		return closest_point;
+	}
+
+	// No intersection, take the polygon edge point closest to the segment.
+	stack[stack_size++] = 0;
+	while (stack_size) {
+		const gd::PolygonBVHNode &node = bvh_nodes[stack[--stack_size]];
+
+		// Lower bound of the distance between the segment and the node.
+		Vector3 segment[2] = { p_from, p_to };
+		const Vector3 center = node.aabb.position + node.aabb.size * 0.5;
+		const real_t node_d = center.distance_to(Geometry::get_closest_point_to_segment(center, segment)) - node.aabb.size.length() * 0.5;
+		if (node_d >= closest_point_d) {
+			continue;
+		}
+
+		if (node.left != -1) {
+			stack[stack_size++] = node.left;
+			stack[stack_size++] = node.right;
+			continue;
+		}
+
+		for (uint32_t i = node.polygon_from; i < node.polygon_from + node.polygon_count; i++) {
+			if (!polygons[bvh_polygons[i]]) {
+				continue; // Its region was removed after the last sync.
+			}
+			const gd::Polygon &p = *polygons[bvh_polygons[i]];
 
-		if (use_collision == false) {
 			for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
 				Vector3 a, b;
 
@@ -434,94 +511,59 @@ Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector
 }
 
 Vector3 NavMap::get_closest_point(const Vector3 &p_point) const {
-	// TODO this is really not optimal, please redesign the API to directly return all this data
-
 	Vector3 closest_point;
-	real_t closest_point_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_d = d;
-			}
-		}
-	}
-
+	get_closest_polygon(p_point, closest_point);
 	return closest_point;
 }
 
 Vector3 NavMap::get_closest_point_normal(const Vector3 &p_point) const {
-	// TODO this is really not optimal, please redesign the API to directly return all this data
-
 	Vector3 closest_point;
 	Vector3 closest_point_normal;
-	real_t closest_point_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_normal = f.get_plane().normal;
-				closest_point_d = d;
-			}
-		}
-	}
-
+	get_closest_polygon(p_point, closest_point, &closest_point_normal);
 	return closest_point_normal;
 }
 
 RID NavMap::get_closest_point_owner(const Vector3 &p_point) const {
-	// TODO this is really not optimal, please redesign the API to directly return all this data
-
 	Vector3 closest_point;
-	RID closest_point_owner;
-	real_t closest_point_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_owner = p.owner->get_self();
-				closest_point_d = d;
-			}
-		}
+	const gd::Polygon *closest_polygon = get_closest_polygon(p_point, closest_point);
+	if (!closest_polygon) {
+		return RID();
 	}
-
-	return closest_point_owner;
+	return closest_polygon->owner->get_self();
 }
 
 void NavMap::add_region(NavRegion *p_region) {
 	regions.push_back(p_region);
-	regenerate_links = true;
+	// Linked on the next sync.
+	p_region->scratch_polygons();
 }
 
 void NavMap::remove_region(NavRegion *p_region) {
 	std::vector<NavRegion *>::iterator it = std::find(regions.begin(), regions.end(), p_region);
 	if (it != regions.end()) {
 		regions.erase(it);
-		regenerate_links = true;
+		unlink_region(p_region);
+
+		// The region polygons may be freed before the next sync, the queries
+		// skip them until the polygons and the BVH are rebuilt.
+		std::vector<gd::Polygon> &region_polygons = p_region->get_polygons();
+		for (size_t poly_id(0); poly_id < region_polygons.size(); poly_id++) {
+			const gd::Polygon *poly = &region_polygons[poly_id];
+			if (poly->id < polygons.size() && polygons[poly->id] == poly) {
+				polygons[poly->id] = nullptr;
+			}
+		}
+
+		// Forget the candidates that point inside this region.
+		for (size_t i(0); i < free_edge_candidates.size(); i++) {
+			if (free_edge_candidates[i].poly->owner == p_region) {
+				free_edge_candidates[i] = free_edge_candidates.back();
+				free_edge_candidates.pop_back();
+				i--;
+			}
+		}
+
+		regions_changed = true;
 	}
 }
 
@@ -565,163 +607,440 @@ void NavMap::sync() {
 		for (size_t r(0); r < regions.size(); r++) {
 			regions[r]->scratch_polygons();
 		}
-		regenerate_links = true;
 	}
 
-	for (size_t r(0); r < regions.size(); r++) {
-		if (regions[r]->sync()) {
-			regenerate_links = true;
-		}
-	}
+	const uint64_t rebuild_from = OS::get_singleton()->get_ticks_usec();
+	uint32_t rebuilt_regions = 0;
 
 	if (regenerate_links) {
-		// Copy all region polygons in the map.
-		int count = 0;
+		// Relink everything, the connection settings changed.
+		connections.clear();
+		free_edge_candidates.clear();
+
 		for (size_t r(0); r < regions.size(); r++) {
-			count += regions[r]->get_polygons().size();
+			std::vector<gd::Polygon> &region_polygons = regions[r]->get_polygons();
+			for (size_t poly_id(0); poly_id < region_polygons.size(); poly_id++) {
+				std::vector<gd::Edge> &edges = region_polygons[poly_id].edges;
+				for (size_t e(0); e < edges.size(); e++) {
+					edges[e] = gd::Edge();
+				}
+			}
 		}
 
-		polygons.resize(count);
-		count = 0;
+		for (size_t r(0); r < regions.size(); r++) {
+			regions[r]->sync();
+			link_region(regions[r]);
+		}
+		rebuilt_regions = regions.size();
 
+	} else {
+		// Only the changed regions are unlinked, rebuilt and linked again.
+		// All of them are unlinked first, so the others never link against
+		// polygons that are about to go.
 		for (size_t r(0); r < regions.size(); r++) {
-			std::copy(
-					regions[r]->get_polygons().data(),
-					regions[r]->get_polygons().data() + regions[r]->get_polygons().size(),
-					polygons.begin() + count);
+			if (regions[r]->is_dirty()) {
+				unlink_region(regions[r]);
+				rebuilt_regions++;
+			}
+		}
+
+		if (rebuilt_regions) {
+			// The candidates inside the changed regions will be relinked anyway.
+			for (size_t i(0); i < free_edge_candidates.size(); i++) {
+				if (free_edge_candidates[i].poly->owner->is_dirty()) {
+					free_edge_candidates[i] = free_edge_candidates.back();
+					free_edge_candidates.pop_back();
+					i--;
+				}
+			}
+
+			for (size_t r(0); r < regions.size(); r++) {
+				if (regions[r]->is_dirty()) {
+					regions[r]->sync();
+					link_region(regions[r]);
+				}
+			}
+		}
+	}
+
+	const bool links_changed = regenerate_links || rebuilt_regions || regions_changed;
 
-			count += regions[r]->get_polygons().size();
+	if (links_changed) {
+		connect_free_edges();
+
+		// Collect all the region polygons in the map, and give them a map wide id.
+		polygons.clear();
+		for (size_t r(0); r < regions.size(); r++) {
+			std::vector<gd::Polygon> &region_polygons = regions[r]->get_polygons();
+			for (size_t poly_id(0); poly_id < region_polygons.size(); poly_id++) {
+				region_polygons[poly_id].id = polygons.size();
+				polygons.push_back(&region_polygons[poly_id]);
+			}
 		}
 
-		// Connects the `Edges` of all the `Polygons` of all `Regions` each other.
-		Map<gd::EdgeKey, gd::Connection> connections;
+		build_polygon_bvh();
+		map_update_id = map_update_id + 1 % 9999999;
 
-		for (size_t poly_id(0); poly_id < polygons.size(); poly_id++) {
-			gd::Polygon &poly(polygons[poly_id]);
+		link_rebuild_usec = OS::get_singleton()->get_ticks_usec() - rebuild_from;
+		link_rebuild_regions = rebuilt_regions;
+	} else {
+		link_rebuild_usec = 0;
+		link_rebuild_regions = 0;
+	}
 
-			for (size_t p(0); p < poly.points.size(); p++) {
-				int next_point = (p + 1) % poly.points.size();
-				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+	if (agents_dirty) {
+		std::vector<RVO::Agent *> raw_agents;
+		raw_agents.reserve(agents.size());
+		for (size_t i(0); i < agents.size(); i++) {
+			raw_agents.push_back(agents[i]->get_agent());
+		}
+		rvo.buildAgentTree(raw_agents);
+	}
 
-				Map<gd::EdgeKey, gd::Connection>::Element *connection = connections.find(ek);
-				if (!connection) {
-					// Nothing yet
-					gd::Connection c;
-					c.A = &poly;
-					c.A_edge = p;
-					c.B = nullptr;
-					c.B_edge = -1;
-					connections[ek] = c;
+	regenerate_polygons = false;
+	regenerate_links = false;
+	regions_changed = false;
+	agents_dirty = false;
+}
 
-				} else if (connection->get().B == nullptr) {
-					CRASH_COND(connection->get().A == nullptr); // Unreachable
+void NavMap::unlink_region(NavRegion *p_region) {
+	std::vector<gd::Polygon> &region_polygons = p_region->get_polygons();
+
+	for (size_t poly_id(0); poly_id < region_polygons.size(); poly_id++) {
+		gd::Polygon &poly(region_polygons[poly_id]);
+
+		for (size_t p(0); p < poly.points.size(); p++) {
+			// Break the link from the other side too, the other edge becomes free.
+			gd::Edge &edge = poly.edges[p];
+			if (edge.other_polygon) {
+				gd::Polygon *other_poly = edge.other_polygon;
+				gd::Edge &other_edge = other_poly->edges[edge.other_edge];
+				if (other_edge.other_polygon == &poly) {
+					other_edge = gd::Edge();
+					if (other_poly->owner != p_region) {
+						gd::FreeEdge free_edge;
+						free_edge.poly = other_poly;
+						free_edge.edge_id = edge.other_edge;
+						free_edge_candidates.push_back(free_edge);
+					}
+				}
+				edge = gd::Edge();
+			}
 
-					// Connect the two Polygons by this edge
-					connection->get().B = &poly;
-					connection->get().B_edge = p;
+			int next_point = (p + 1) % poly.points.size();
+			gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
 
-					connection->get().A->edges[connection->get().A_edge].this_edge = connection->get().A_edge;
-					connection->get().A->edges[connection->get().A_edge].other_polygon = connection->get().B;
-					connection->get().A->edges[connection->get().A_edge].other_edge = connection->get().B_edge;
+			gd::Connection *connection = connections.getptr(ek);
+			if (!connection) {
+				continue;
+			}
 
-					connection->get().B->edges[connection->get().B_edge].this_edge = connection->get().B_edge;
-					connection->get().B->edges[connection->get().B_edge].other_polygon = connection->get().A;
-					connection->get().B->edges[connection->get().B_edge].other_edge = connection->get().A_edge;
+			if (connection->B == &poly) {
+				connection->B = nullptr;
+				connection->B_edge = -1;
+			} else if (connection->A == &poly) {
+				if (connection->B) {
+					connection->A = connection->B;
+					connection->A_edge = connection->B_edge;
+					connection->B = nullptr;
+					connection->B_edge = -1;
 				} else {
-					// The edge is already connected with another edge, skip.
-					ERR_PRINT("Attempted to merge a navigation mesh triangle edge with another already-merged edge. This happens when the Navigation3D's `cell_size` is different from the one used to generate the navigation mesh. This will cause navigation problem.");
+					connections.erase(ek);
 				}
 			}
 		}
+	}
+}
+
+void NavMap::link_region(NavRegion *p_region) {
+	std::vector<gd::Polygon> &region_polygons = p_region->get_polygons();
+
+	// Connects the `Edges` of the region `Polygons` with the ones sharing the same points.
+	for (size_t poly_id(0); poly_id < region_polygons.size(); poly_id++) {
+		gd::Polygon &poly(region_polygons[poly_id]);
+
+		for (size_t p(0); p < poly.points.size(); p++) {
+			int next_point = (p + 1) % poly.points.size();
+			gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+
+			gd::Connection *connection = connections.getptr(ek);
+			if (!connection) {
+				// Nothing yet
+				gd::Connection c;
+				c.A = &poly;
+				c.A_edge = p;
+				c.B = nullptr;
+				c.B_edge = -1;
+				connections.set(ek, c);
+
+				gd::FreeEdge free_edge;
+				free_edge.poly = &poly;
+				free_edge.edge_id = p;
+				free_edge_candidates.push_back(free_edge);
+
+			} else if (connection->B == nullptr) {
+				CRASH_COND(connection->A == nullptr); // Unreachable
+
+				// A shared edge wins over a near edge connection, free that one.
+				gd::Edge &a_edge = connection->A->edges[connection->A_edge];
+				if (a_edge.other_polygon) {
+					a_edge.other_polygon->edges[a_edge.other_edge] = gd::Edge();
+
+					gd::FreeEdge free_edge;
+					free_edge.poly = a_edge.other_polygon;
+					free_edge.edge_id = a_edge.other_edge;
+					free_edge_candidates.push_back(free_edge);
+				}
+
+				// Connect the two Polygons by this edge
+				connection->B = &poly;
+				connection->B_edge = p;
+
+				connection->A->edges[connection->A_edge].this_edge = connection->A_edge;
+				connection->A->edges[connection->A_edge].other_polygon = connection->B;
+				connection->A->edges[connection->A_edge].other_edge = connection->B_edge;
 
-		// Takes all the free edges.
-		std::vector<gd::FreeEdge> free_edges;
-		free_edges.reserve(connections.size());
-
-		for (auto connection_element = connections.front(); connection_element; connection_element = connection_element->next()) {
-			if (connection_element->get().B == nullptr) {
-				CRASH_COND(connection_element->get().A == nullptr); // Unreachable
-				CRASH_COND(connection_element->get().A_edge < 0); // Unreachable
-
-				// This is a free edge
-				uint32_t id(free_edges.size());
-				free_edges.push_back(gd::FreeEdge());
-				free_edges[id].is_free = true;
-				free_edges[id].poly = connection_element->get().A;
-				free_edges[id].edge_id = connection_element->get().A_edge;
-				uint32_t point_0(free_edges[id].edge_id);
-				uint32_t point_1((free_edges[id].edge_id + 1) % free_edges[id].poly->points.size());
-				Vector3 pos_0 = free_edges[id].poly->points[point_0].pos;
-				Vector3 pos_1 = free_edges[id].poly->points[point_1].pos;
-				Vector3 relative = pos_1 - pos_0;
-				free_edges[id].edge_center = (pos_0 + pos_1) / 2.0;
-				free_edges[id].edge_dir = relative.normalized();
-				free_edges[id].edge_len_squared = relative.length_squared();
+				connection->B->edges[connection->B_edge].this_edge = connection->B_edge;
+				connection->B->edges[connection->B_edge].other_polygon = connection->A;
+				connection->B->edges[connection->B_edge].other_edge = connection->A_edge;
+			} else {
+				// The edge is already connected with another edge, skip.
+				ERR_PRINT("Attempted to merge a navigation mesh triangle edge with another already-merged edge. This happens when the Navigation3D's `cell_size` is different from the one used to generate the navigation mesh. This will cause navigation problem.");
 			}
 		}
+	}
+}
+
+static void _init_free_edge(gd::FreeEdge &r_edge) {
+	uint32_t point_0(r_edge.edge_id);
+	uint32_t point_1((r_edge.edge_id + 1) % r_edge.poly->points.size());
+	Vector3 pos_0 = r_edge.poly->points[point_0].pos;
+	Vector3 pos_1 = r_edge.poly->points[point_1].pos;
+	Vector3 relative = pos_1 - pos_0;
+	r_edge.edge_center = (pos_0 + pos_1) / 2.0;
+	r_edge.edge_dir = relative.normalized();
+	r_edge.edge_len_squared = relative.length_squared();
+}
+
+void NavMap::connect_free_edges() {
+	if (free_edge_candidates.empty()) {
+		return;
+	}
+
+	// Takes all the free edges.
+	std::vector<gd::FreeEdge> free_edges;
+	for (const gd::EdgeKey *ek = connections.next(nullptr); ek; ek = connections.next(ek)) {
+		const gd::Connection &connection = connections.get(*ek);
+		if (connection.B == nullptr && connection.A->edges[connection.A_edge].other_polygon == nullptr) {
+			CRASH_COND(connection.A_edge < 0); // Unreachable
+
+			// This is a free edge
+			free_edges.push_back(gd::FreeEdge());
+			free_edges.back().poly = connection.A;
+			free_edges.back().edge_id = connection.A_edge;
+			_init_free_edge(free_edges.back());
+		}
+	}
 
-		const float ecm_squared(edge_connection_margin * edge_connection_margin);
+	const float ecm_squared(edge_connection_margin * edge_connection_margin);
 #define LEN_TOLLERANCE 0.1
 #define DIR_TOLLERANCE 0.9
-		// In front of tolerance
+	// In front of tolerance
 #define IFO_TOLLERANCE 0.5
 
-		// Find the compatible near edges.
-		//
-		// Note:
-		// Considering that the edges must be compatible (for obvious reasons)
-		// to be connected, create new polygons to remove that small gap is
-		// not really useful and would result in wasteful computation during
-		// connection, integration and path finding.
-		for (size_t i(0); i < free_edges.size(); i++) {
-			if (!free_edges[i].is_free) {
+	// Find the compatible near edges, only the candidates need a look: the
+	// other free edges were already checked against each other.
+	//
+	// Note:
+	// Considering that the edges must be compatible (for obvious reasons)
+	// to be connected, create new polygons to remove that small gap is
+	// not really useful and would result in wasteful computation during
+	// connection, integration and path finding.
+	for (size_t i(0); i < free_edge_candidates.size(); i++) {
+		gd::FreeEdge &edge = free_edge_candidates[i];
+		if (edge.poly->edges[edge.edge_id].other_polygon) {
+			// Linked meanwhile.
+			continue;
+		}
+		_init_free_edge(edge);
+
+		for (size_t y(0); y < free_edges.size(); y++) {
+			gd::FreeEdge &other_edge = free_edges[y];
+			if (edge.poly->owner == other_edge.poly->owner || other_edge.poly->edges[other_edge.edge_id].other_polygon) {
 				continue;
 			}
-			gd::FreeEdge &edge = free_edges[i];
-			for (size_t y(0); y < free_edges.size(); y++) {
-				gd::FreeEdge &other_edge = free_edges[y];
-				if (i == y || !other_edge.is_free || edge.poly->owner == other_edge.poly->owner) {
-					continue;
-				}
 
-				Vector3 rel_centers = other_edge.edge_center - edge.edge_center;
-				if (ecm_squared > rel_centers.length_squared() // Are enough closer?
-						&& ABS(edge.edge_len_squared - other_edge.edge_len_squared) < LEN_TOLLERANCE // Are the same length?
-						&& ABS(edge.edge_dir.dot(other_edge.edge_dir)) > DIR_TOLLERANCE // Are aligned?
-						&& ABS(rel_centers.normalized().dot(edge.edge_dir)) < IFO_TOLLERANCE // Are one in front the other?
-				) {
-					// The edges can be connected
-					edge.is_free = false;
-					other_edge.is_free = false;
-
-					edge.poly->edges[edge.edge_id].this_edge = edge.edge_id;
-					edge.poly->edges[edge.edge_id].other_edge = other_edge.edge_id;
-					edge.poly->edges[edge.edge_id].other_polygon = other_edge.poly;
-
-					other_edge.poly->edges[other_edge.edge_id].this_edge = other_edge.edge_id;
-					other_edge.poly->edges[other_edge.edge_id].other_edge = edge.edge_id;
-					other_edge.poly->edges[other_edge.edge_id].other_polygon = edge.poly;
-				}
+			Vector3 rel_centers = other_edge.edge_center - edge.edge_center;
+			if (ecm_squared > rel_centers.length_squared() // Are enough closer?
+					&& ABS(edge.edge_len_squared - other_edge.edge_len_squared) < LEN_TOLLERANCE // Are the same length?
+					&& ABS(edge.edge_dir.dot(other_edge.edge_dir)) > DIR_TOLLERANCE // Are aligned?
+					&& ABS(rel_centers.normalized().dot(edge.edge_dir)) < IFO_TOLLERANCE // Are one in front the other?
+			) {
+				// The edges can be connected
+				edge.poly->edges[edge.edge_id].this_edge = edge.edge_id;
+				edge.poly->edges[edge.edge_id].other_edge = other_edge.edge_id;
+				edge.poly->edges[edge.edge_id].other_polygon = other_edge.poly;
+
+				other_edge.poly->edges[other_edge.edge_id].this_edge = other_edge.edge_id;
+				other_edge.poly->edges[other_edge.edge_id].other_edge = edge.edge_id;
+				other_edge.poly->edges[other_edge.edge_id].other_polygon = edge.poly;
+				break;
 			}
 		}
 	}
 
-	if (regenerate_links) {
-		map_update_id = map_update_id + 1 % 9999999;
+	free_edge_candidates.clear();
+}
+
+static real_t _aabb_distance_squared(const AABB &p_aabb, const Vector3 &p_point) {
+	const Vector3 end = p_aabb.position + p_aabb.size;
+	real_t d = 0.0;
+	for (int axis = 0; axis < 3; axis++) {
+		if (p_point[axis] < p_aabb.position[axis]) {
+			d += (p_aabb.position[axis] - p_point[axis]) * (p_aabb.position[axis] - p_point[axis]);
+		} else if (p_point[axis] > end[axis]) {
+			d += (p_point[axis] - end[axis]) * (p_point[axis] - end[axis]);
+		}
 	}
+	return d;
+}
 
-	if (agents_dirty) {
-		std::vector<RVO::Agent *> raw_agents;
-		raw_agents.reserve(agents.size());
-		for (size_t i(0); i < agents.size(); i++) {
-			raw_agents.push_back(agents[i]->get_agent());
+void NavMap::build_polygon_bvh() {
+	bvh_nodes.clear();
+	bvh_polygons.resize(polygons.size());
+
+	if (polygons.empty()) {
+		return;
+	}
+
+	std::vector<AABB> polygon_aabbs(polygons.size());
+	for (size_t i(0); i < polygons.size(); i++) {
+		const gd::Polygon &p = *polygons[i];
+		AABB aabb;
+		if (!p.points.empty()) {
+			aabb.position = p.points[0].pos;
+			for (size_t point_id = 1; point_id < p.points.size(); point_id++) {
+				aabb.expand_to(p.points[point_id].pos);
+			}
 		}
-		rvo.buildAgentTree(raw_agents);
+		// The polygons are flat, keep the segment tests robust.
+		polygon_aabbs[i] = aabb.grow(CMP_EPSILON);
+		bvh_polygons[i] = i;
 	}
 
-	regenerate_polygons = false;
-	regenerate_links = false;
-	agents_dirty = false;
+	bvh_nodes.reserve(polygons.size() / 2 + 1);
+	build_polygon_bvh_node(polygon_aabbs, 0, polygons.size());
+}
+
+int NavMap::build_polygon_bvh_node(std::vector<AABB> &p_polygon_aabbs, uint32_t p_from, uint32_t p_count) {
+	const uint32_t max_leaf_polygons = 4;
+
+	int node_id = bvh_nodes.size();
+	bvh_nodes.push_back(gd::PolygonBVHNode());
+
+	AABB aabb = p_polygon_aabbs[bvh_polygons[p_from]];
+	AABB centers(aabb.position + aabb.size * 0.5, Vector3());
+	for (uint32_t i = p_from + 1; i < p_from + p_count; i++) {
+		const AABB &polygon_aabb = p_polygon_aabbs[bvh_polygons[i]];
+		aabb.merge_with(polygon_aabb);
+		centers.expand_to(polygon_aabb.position + polygon_aabb.size * 0.5);
+	}
+	bvh_nodes[node_id].aabb = aabb;
+
+	if (p_count <= max_leaf_polygons) {
+		bvh_nodes[node_id].polygon_from = p_from;
+		bvh_nodes[node_id].polygon_count = p_count;
+		return node_id;
+	}
+
+	// Median split along the axis where the polygon centers spread the most.
+	const int axis = centers.get_longest_axis_index();
+	const uint32_t half = p_count / 2;
+	std::nth_element(
+			bvh_polygons.begin() + p_from,
+			bvh_polygons.begin() + p_from + half,
+			bvh_polygons.begin() + p_from + p_count,
+			[&p_polygon_aabbs, axis](uint32_t p_a, uint32_t p_b) {
+				const AABB &a = p_polygon_aabbs[p_a];
+				const AABB &b = p_polygon_aabbs[p_b];
+				return a.position[axis] + a.size[axis] * 0.5 < b.position[axis] + b.size[axis] * 0.5;
+			});
+
+	// Build the children first, `bvh_nodes` may be reallocated.
+	const int left = build_polygon_bvh_node(p_polygon_aabbs, p_from, half);
+	const int right = build_polygon_bvh_node(p_polygon_aabbs, p_from + half, p_count - half);
+	bvh_nodes[node_id].left = left;
+	bvh_nodes[node_id].right = right;
+	return node_id;
+}
+
+const gd::Polygon *NavMap::get_closest_polygon(const Vector3 &p_point, Vector3 &r_closest_point, Vector3 *r_closest_normal) const {
+	if (bvh_nodes.empty()) {
+		return nullptr;
+	}
+
+	const gd::Polygon *closest_polygon = nullptr;
+	real_t closest_point_d = 1e20;
+
+	uint32_t stack[64]; // The tree is balanced, its depth is at most log2 of the polygon count.
+	int stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size) {
+		const gd::PolygonBVHNode &node = bvh_nodes[stack[--stack_size]];
+
+		if (node.left != -1) {
+			// Visit the nearest child first, and skip the children that can't be closer.
+			const real_t left_d = _aabb_distance_squared(bvh_nodes[node.left].aabb, p_point);
+			const real_t right_d = _aabb_distance_squared(bvh_nodes[node.right].aabb, p_point);
+			const real_t best_d = closest_point_d * closest_point_d;
+			if (left_d < right_d) {
+				if (right_d < best_d) {
+					stack[stack_size++] = node.right;
+				}
+				if (left_d < best_d) {
+					stack[stack_size++] = node.left;
+				}
+			} else {
+				if (left_d < best_d) {
+					stack[stack_size++] = node.left;
+				}
+				if (right_d < best_d) {
+					stack[stack_size++] = node.right;
+				}
+			}
+			continue;
+		}
+
+		if (_aabb_distance_squared(node.aabb, p_point) >= closest_point_d * closest_point_d) {
+			// A nearer polygon was found since this leaf was queued.
+			continue;
+		}
+
+		for (uint32_t i = node.polygon_from; i < node.polygon_from + node.polygon_count; i++) {
+			if (!polygons[bvh_polygons[i]]) {
+				continue; // Its region was removed after the last sync.
+			}
+			const gd::Polygon &p = *polygons[bvh_polygons[i]];
+
+			// For each point cast a face and check the distance to the point
+			for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
+				const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+				const Vector3 inters = f.get_closest_point_to(p_point);
+				const real_t d = inters.distance_to(p_point);
+				if (d < closest_point_d) {
+					closest_point_d = d;
+					closest_polygon = &p;
+					r_closest_point = inters;
+					if (r_closest_normal) {
+						*r_closest_normal = f.get_plane().normal;
+					}
+				}
+			}
+		}
+	}
+
+	return closest_polygon;
 }
 
 void NavMap::compute_single_step(uint32_t index, RvoAgent **agent) {
@@ -732,7 +1051,7 @@ void NavMap::compute_single_step(uint32_t index, RvoAgent **agent) {
 void NavMap::step(real_t p_deltatime) {
 	deltatime = p_deltatime;
 	if (controlled_agents.size() > 0) {
-		thread_process_array(
+		ThreadWorkPool::get_singleton()->do_work(
 				controlled_agents.size(),
 				this,
 				&NavMap::compute_single_step,
@@ -33,6 +33,7 @@
 
 #include "nav_rid.h"
 
+#include "core/hash_map.h"
 #include "core/math/math_defs.h"
 #include "nav_utils.h"
 #include <KdTree.h>
@@ -59,10 +60,27 @@ class NavMap : public NavRid {
 	bool regenerate_polygons = true;
 	bool regenerate_links = true;
 
+	/// A region was removed, its polygons must leave the map.
+	bool regions_changed = false;
+
 	std::vector<NavRegion *> regions;
 
-	/// Map polygons
-	std::vector<gd::Polygon> polygons;
+	/// Map polygons, owned by the regions. The polygons of a region removed
+	/// since the last sync are nullptr.
+	std::vector<const gd::Polygon *> polygons;
+
+	/// The polygons edges, by welded points. Kept between syncs so that a
+	/// region change only unlinks and links that region polygons.
+	HashMap<gd::EdgeKey, gd::Connection, gd::EdgeKeyHasher> connections;
+
+	/// Edges that lost their link since the last sync, and may now be
+	/// connected to a near edge of another region.
+	std::vector<gd::FreeEdge> free_edge_candidates;
+
+	/// Bounding volume hierarchy over the map polygons, rebuilt together with
+	/// the links and used by all the closest point queries.
+	std::vector<gd::PolygonBVHNode> bvh_nodes;
+	std::vector<uint32_t> bvh_polygons;
 
 	/// Rvo world
 	RVO::KdTree rvo;
@@ -82,6 +100,10 @@ class NavMap : public NavRid {
 	/// Change the id each time the map is updated.
 	uint32_t map_update_id = 0;
 
+	/// Time spent relinking the polygons in the last sync, in microseconds.
+	uint64_t link_rebuild_usec = 0;
+	uint32_t link_rebuild_regions = 0;
+
 public:
 	NavMap() {}
 
@@ -128,11 +150,27 @@ public:
 		return map_update_id;
 	}
 
+	uint64_t get_link_rebuild_usec() const {
+		return link_rebuild_usec;
+	}
+
+	uint32_t get_link_rebuild_regions() const {
+		return link_rebuild_regions;
+	}
+
 	void sync();
 	void step(real_t p_deltatime);
 	void dispatch_callbacks();
 
 private:
+	void unlink_region(NavRegion *p_region);
+	void link_region(NavRegion *p_region);
+	void connect_free_edges();
+
+	void build_polygon_bvh();
+	int build_polygon_bvh_node(std::vector<AABB> &p_polygon_aabbs, uint32_t p_from, uint32_t p_count);
+	const gd::Polygon *get_closest_polygon(const Vector3 &p_point, Vector3 &r_closest_point, Vector3 *r_closest_normal = nullptr) const;
+
 	void compute_single_step(uint32_t index, RvoAgent **agent);
 	void clip_path(const std::vector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const;
 };
@@ -61,6 +61,10 @@ public:
 		polygons_dirty = true;
 	}
 
+	bool is_dirty() const {
+		return polygons_dirty;
+	}
+
 	void set_map(NavMap *p_map);
 	NavMap *get_map() const {
 		return map;
@@ -80,6 +84,11 @@ public:
 		return polygons;
 	}
 
+	/// The map links the polygons edges in place.
+	std::vector<gd::Polygon> &get_polygons() {
+		return polygons;
+	}
+
 	bool sync();
 
 private:
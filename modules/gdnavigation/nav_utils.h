@@ -31,6 +31,8 @@
 #ifndef NAV_UTILS_H
 #define NAV_UTILS_H
 
+#include "core/hashfuncs.h"
+#include "core/math/aabb.h"
 #include "core/math/vector3.h"
 
 #include <vector>
@@ -63,6 +65,10 @@ struct EdgeKey {
 		return (a.key == p_key.a.key) ? (b.key < p_key.b.key) : (a.key < p_key.a.key);
 	}
 
+	bool operator==(const EdgeKey &p_key) const {
+		return a.key == p_key.a.key && b.key == p_key.b.key;
+	}
+
 	EdgeKey(const PointKey &p_a = PointKey(), const PointKey &p_b = PointKey()) :
 			a(p_a),
 			b(p_b) {
@@ -72,6 +78,12 @@ struct EdgeKey {
 	}
 };
 
+struct EdgeKeyHasher {
+	static _FORCE_INLINE_ uint32_t hash(const EdgeKey &p_key) {
+		return hash_djb2_one_32(hash_one_uint64(p_key.b.key), hash_one_uint64(p_key.a.key));
+	}
+};
+
 struct Point {
 	Vector3 pos;
 	PointKey key;
@@ -93,6 +105,9 @@ struct Edge {
 struct Polygon {
 	NavRegion *owner;
 
+	/// The index of this `Polygon` in the map polygons.
+	uint32_t id = 0;
+
 	/// The points of this `Polygon`
 	std::vector<Point> points;
 
@@ -127,6 +142,8 @@ struct NavigationPoly {
 	Vector3 entry;
 	/// The distance to the destination.
 	float traveled_distance = 0.0;
+	/// Already expanded by the search.
+	bool closed = false;
 
 	NavigationPoly(const Polygon *p_poly) :
 			poly(p_poly) {}
@@ -141,13 +158,24 @@ struct NavigationPoly {
 };
 
 struct FreeEdge {
-	bool is_free;
 	Polygon *poly;
 	uint32_t edge_id;
 	Vector3 edge_center;
 	Vector3 edge_dir;
 	float edge_len_squared;
 };
+
+struct PolygonBVHNode {
+	AABB aabb;
+
+	/// The children nodes, -1 on leaves.
+	int left = -1;
+	int right = -1;
+
+	/// The range of polygon ids, in `NavMap::bvh_polygons`, owned by a leaf.
+	uint32_t polygon_from = 0;
+	uint32_t polygon_count = 0;
+};
 } // namespace gd
 
 #endif // NAV_UTILS_H
@@ -529,6 +529,8 @@ void GDScript::_set_subclass_path(Ref<GDScript> &p_sc, const String &p_path) {
 }
 
 Error GDScript::reload(bool p_keep_state) {
+	MemoryTagScope memory_tag(Memory::TAG_SCRIPTING);
+
 	bool has_instances;
 	{
 		MutexLock lock(GDScriptLanguage::singleton->lock);
@@ -2180,6 +2182,7 @@ GDScriptLanguage::GDScriptLanguage() {
 	_debug_parse_err_file = "";
 
 	profiling = false;
+	script_version = 0;
 	script_frame_time = 0;
 
 	_debug_call_stack_pos = 0;
@@ -387,6 +387,8 @@ class GDScriptLanguage : public ScriptLanguage {
 	bool profiling;
 	uint64_t script_frame_time;
 
+	std::atomic<uint32_t> script_version;
+
 	Map<String, ObjectID> orphan_subclasses;
 
 public:
@@ -471,6 +473,11 @@ public:
 
 	_FORCE_INLINE_ static GDScriptLanguage *get_singleton() { return singleton; }
 
+	// Bumped whenever a script is compiled. Inline caches that depend on the
+	// members of a script only trust entries filled at the current version.
+	_FORCE_INLINE_ uint32_t get_script_version() const { return script_version.load(std::memory_order_acquire); }
+	_FORCE_INLINE_ void bump_script_version() { script_version.fetch_add(1, std::memory_order_acq_rel); }
+
 	virtual String get_name() const;
 
 	/* LANGUAGE FUNCTIONS */
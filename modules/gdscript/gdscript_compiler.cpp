@@ -74,6 +74,92 @@ void GDScriptCompiler::_set_error(const String &p_error, const GDScriptParser::N
 	}
 }
 
+GDScriptFunction::Opcode GDScriptCompiler::_get_operator_opcode(Variant::Operator op, const GDScriptParser::DataType &p_a, const GDScriptParser::DataType &p_b) const {
+	// Only used when the parser knows both operands are numbers. The VM checks
+	// the types again and falls back to OPCODE_OPERATOR, since they may be inferred.
+	if (!p_a.has_type || !p_b.has_type || p_a.is_meta_type || p_b.is_meta_type) {
+		return GDScriptFunction::OPCODE_OPERATOR;
+	}
+	if (p_a.kind != GDScriptParser::DataType::BUILTIN || p_b.kind != GDScriptParser::DataType::BUILTIN) {
+		return GDScriptFunction::OPCODE_OPERATOR;
+	}
+
+	Variant::Type a = p_a.builtin_type;
+	Variant::Type b = p_b.builtin_type;
+
+	switch (op) {
+		case Variant::OP_EQUAL:
+		case Variant::OP_NOT_EQUAL:
+		case Variant::OP_LESS:
+		case Variant::OP_LESS_EQUAL:
+		case Variant::OP_GREATER:
+		case Variant::OP_GREATER_EQUAL:
+		case Variant::OP_ADD:
+		case Variant::OP_SUBTRACT:
+		case Variant::OP_MULTIPLY:
+		case Variant::OP_DIVIDE:
+		case Variant::OP_NEGATE:
+		case Variant::OP_POSITIVE: {
+			if (a == Variant::INT && b == Variant::INT) {
+				return GDScriptFunction::OPCODE_OPERATOR_INT;
+			}
+			if ((a == Variant::FLOAT || a == Variant::INT) && (b == Variant::FLOAT || b == Variant::INT)) {
+				return GDScriptFunction::OPCODE_OPERATOR_FLOAT;
+			}
+		} break;
+		case Variant::OP_MODULE:
+		case Variant::OP_SHIFT_LEFT:
+		case Variant::OP_SHIFT_RIGHT:
+		case Variant::OP_BIT_AND:
+		case Variant::OP_BIT_OR:
+		case Variant::OP_BIT_XOR:
+		case Variant::OP_BIT_NEGATE: {
+			if (a == Variant::INT && b == Variant::INT) {
+				return GDScriptFunction::OPCODE_OPERATOR_INT;
+			}
+		} break;
+		default: {
+		}
+	}
+
+	return GDScriptFunction::OPCODE_OPERATOR;
+}
+
+const Variant::ValidatedBuiltInMethod *GDScriptCompiler::_get_validated_builtin_method(const GDScriptParser::Node *p_base, const StringName &p_method, int p_argcount) const {
+	const GDScriptParser::DataType &base_type = p_base->get_datatype();
+	if (!base_type.has_type || base_type.is_meta_type || base_type.kind != GDScriptParser::DataType::BUILTIN || base_type.builtin_type == Variant::NIL || base_type.builtin_type == Variant::OBJECT) {
+		return nullptr;
+	}
+
+	int index = Variant::get_builtin_method_index(base_type.builtin_type, p_method);
+	if (index < 0) {
+		return nullptr;
+	}
+
+	// Calls relying on default arguments go through the regular path.
+	const Variant::ValidatedBuiltInMethod *method = Variant::get_validated_builtin_method(base_type.builtin_type, index);
+	if (!method || method->arg_count != p_argcount) {
+		return nullptr;
+	}
+	return method;
+}
+
+int GDScriptCompiler::_get_vector3_axis(const GDScriptParser::Node *p_base, const StringName &p_name) const {
+	const GDScriptParser::DataType &base_type = p_base->get_datatype();
+	if (!base_type.has_type || base_type.is_meta_type || base_type.kind != GDScriptParser::DataType::BUILTIN || base_type.builtin_type != Variant::VECTOR3) {
+		return -1;
+	}
+
+	if (p_name == "x") {
+		return Vector3::AXIS_X;
+	} else if (p_name == "y") {
+		return Vector3::AXIS_Y;
+	} else if (p_name == "z") {
+		return Vector3::AXIS_Z;
+	}
+	return -1;
+}
+
 bool GDScriptCompiler::_create_unary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level) {
 	ERR_FAIL_COND_V(on->arguments.size() != 1, false);
 
@@ -82,7 +168,9 @@ bool GDScriptCompiler::_create_unary_operator(CodeGen &codegen, const GDScriptPa
 		return false;
 	}
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+	const GDScriptParser::DataType &type_a = on->arguments[0]->get_datatype();
+
+	codegen.opcodes.push_back(_get_operator_opcode(op, type_a, type_a)); // perform operator
 	codegen.opcodes.push_back(op); //which operator
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_a); // argument 2 (repeated)
@@ -106,7 +194,7 @@ bool GDScriptCompiler::_create_binary_operator(CodeGen &codegen, const GDScriptP
 		return false;
 	}
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+	codegen.opcodes.push_back(_get_operator_opcode(op, on->arguments[0]->get_datatype(), on->arguments[1]->get_datatype())); // perform operator
 	codegen.opcodes.push_back(op); //which operator
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_b); // argument 2 (unary only takes one parameter)
@@ -173,6 +261,109 @@ GDScriptDataType GDScriptCompiler::_gdtype_from_datatype(const GDScriptParser::D
 	return result;
 }
 
+int GDScriptCompiler::_parse_jump_if_not(CodeGen &codegen, const GDScriptParser::Node *p_condition, int p_stack_level) {
+	// Conditions that are a single comparison are fused with the jump, so the
+	// result never goes through a stack temporary.
+	if (p_condition->type == GDScriptParser::Node::TYPE_OPERATOR) {
+		const GDScriptParser::OperatorNode *on = static_cast<const GDScriptParser::OperatorNode *>(p_condition);
+
+		Variant::Operator op = Variant::OP_MAX;
+		switch (on->op) {
+			case GDScriptParser::OperatorNode::OP_EQUAL: {
+				op = Variant::OP_EQUAL;
+			} break;
+			case GDScriptParser::OperatorNode::OP_NOT_EQUAL: {
+				op = Variant::OP_NOT_EQUAL;
+			} break;
+			case GDScriptParser::OperatorNode::OP_LESS: {
+				op = Variant::OP_LESS;
+			} break;
+			case GDScriptParser::OperatorNode::OP_LESS_EQUAL: {
+				op = Variant::OP_LESS_EQUAL;
+			} break;
+			case GDScriptParser::OperatorNode::OP_GREATER: {
+				op = Variant::OP_GREATER;
+			} break;
+			case GDScriptParser::OperatorNode::OP_GREATER_EQUAL: {
+				op = Variant::OP_GREATER_EQUAL;
+			} break;
+			default: {
+			}
+		}
+
+		if (op != Variant::OP_MAX) {
+			ERR_FAIL_COND_V(on->arguments.size() != 2, -1);
+
+			int slevel = p_stack_level;
+			int src_address_a = _parse_expression(codegen, on->arguments[0], slevel);
+			if (src_address_a < 0) {
+				return -1;
+			}
+			if (src_address_a & GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) {
+				slevel++; //uses stack for return, increase stack
+			}
+
+			int src_address_b = _parse_expression(codegen, on->arguments[1], slevel);
+			if (src_address_b < 0) {
+				return -1;
+			}
+
+			switch (_get_operator_opcode(op, on->arguments[0]->get_datatype(), on->arguments[1]->get_datatype())) {
+				case GDScriptFunction::OPCODE_OPERATOR_INT: {
+					codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP_IF_NOT_COMPARE_INT);
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_FLOAT: {
+					codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP_IF_NOT_COMPARE_FLOAT);
+				} break;
+				default: {
+					codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP_IF_NOT_COMPARE);
+				}
+			}
+			codegen.opcodes.push_back(op);
+			codegen.opcodes.push_back(src_address_a);
+			codegen.opcodes.push_back(src_address_b);
+			int jump_addr = codegen.opcodes.size();
+			codegen.opcodes.push_back(0); //temporary
+			return jump_addr;
+		}
+	}
+
+	int ret = _parse_expression(codegen, p_condition, p_stack_level, false);
+	if (ret < 0) {
+		return -1;
+	}
+
+	codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP_IF_NOT);
+	codegen.opcodes.push_back(ret);
+	int jump_addr = codegen.opcodes.size();
+	codegen.opcodes.push_back(0); //temporary
+	return jump_addr;
+}
+
+bool GDScriptCompiler::_is_integer_range(const GDScriptParser::Node *p_container) const {
+	// The parser turns range() into an int, Vector2i or Vector3i (constant or
+	// constructed), which the range iteration opcodes step without Variant calls.
+	Variant::Type type = Variant::NIL;
+
+	if (p_container->type == GDScriptParser::Node::TYPE_CONSTANT) {
+		type = static_cast<const GDScriptParser::ConstantNode *>(p_container)->value.get_type();
+	} else if (p_container->type == GDScriptParser::Node::TYPE_OPERATOR) {
+		const GDScriptParser::OperatorNode *on = static_cast<const GDScriptParser::OperatorNode *>(p_container);
+		if (on->op == GDScriptParser::OperatorNode::OP_CALL && on->arguments.size() > 0 && on->arguments[0]->type == GDScriptParser::Node::TYPE_TYPE) {
+			type = static_cast<const GDScriptParser::TypeNode *>(on->arguments[0])->vtype;
+		}
+	}
+
+	if (type == Variant::NIL) {
+		const GDScriptParser::DataType &datatype = p_container->get_datatype();
+		if (datatype.has_type && !datatype.is_meta_type && datatype.kind == GDScriptParser::DataType::BUILTIN) {
+			type = datatype.builtin_type;
+		}
+	}
+
+	return type == Variant::INT || type == Variant::VECTOR2I || type == Variant::VECTOR3I;
+}
+
 int GDScriptCompiler::_parse_assign_right_expression(CodeGen &codegen, const GDScriptParser::OperatorNode *p_expression, int p_stack_level, int p_index_addr) {
 	Variant::Operator var_op = Variant::OP_MAX;
 
@@ -259,6 +450,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 				codegen.opcodes.push_back(codegen.get_name_map_pos(identifier)); // argument 2 (unary only takes one parameter)
 				int dst_addr = (p_stack_level) | (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS);
 				codegen.opcodes.push_back(dst_addr); // append the stack level as destination address of the opcode
+				codegen.opcodes.push_back(codegen.alloc_inline_cache());
 				codegen.alloc_stack(p_stack_level);
 				return dst_addr;
 			}
@@ -659,11 +851,24 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							arguments.push_back(ret);
 						}
 
-						codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
+						StringName method_name = static_cast<const GDScriptParser::IdentifierNode *>(on->arguments[1])->name;
+						const Variant::ValidatedBuiltInMethod *validated = _get_validated_builtin_method(on->arguments[0], method_name, on->arguments.size() - 2);
+						int call_slot;
+						if (validated) {
+							// Same layout as OPCODE_CALL, with the resolved method in place of the inline cache.
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED);
+							call_slot = codegen.get_validated_builtin_call_pos(on->arguments[0]->get_datatype().builtin_type, validated);
+						} else {
+							codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
+							call_slot = codegen.alloc_inline_cache();
+						}
 						codegen.opcodes.push_back(on->arguments.size() - 2);
 						codegen.alloc_call(on->arguments.size() - 2);
 						for (int i = 0; i < arguments.size(); i++) {
 							codegen.opcodes.push_back(arguments[i]);
+							if (i == 1) {
+								codegen.opcodes.push_back(call_slot); // after base and method name
+							}
 						}
 					}
 				} break;
@@ -729,7 +934,25 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							}
 						}
 
-						index = codegen.get_name_map_pos(static_cast<GDScriptParser::IdentifierNode *>(on->arguments[1])->name);
+						StringName name = static_cast<GDScriptParser::IdentifierNode *>(on->arguments[1])->name;
+						index = codegen.get_name_map_pos(name);
+
+						int axis = _get_vector3_axis(on->arguments[0], name);
+						if (axis != -1) {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_GET_NAMED_VECTOR3);
+							codegen.opcodes.push_back(axis);
+						} else {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_GET_NAMED);
+						}
+						codegen.opcodes.push_back(from);
+						codegen.opcodes.push_back(index);
+
+						// Named gets keep their inline cache slot after the destination.
+						int dst_addr = (p_stack_level) | (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS);
+						codegen.opcodes.push_back(dst_addr);
+						codegen.opcodes.push_back(codegen.alloc_inline_cache());
+						codegen.alloc_stack(p_stack_level);
+						return dst_addr;
 
 					} else {
 						if (on->arguments[1]->type == GDScriptParser::Node::TYPE_CONSTANT && static_cast<const GDScriptParser::ConstantNode *>(on->arguments[1])->value.get_type() == Variant::STRING) {
@@ -756,6 +979,14 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 					codegen.opcodes.push_back(from); // argument 1
 					codegen.opcodes.push_back(index); // argument 2 (unary only takes one parameter)
 
+					if (named) {
+						int dst_addr = (p_stack_level) | (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS);
+						codegen.opcodes.push_back(dst_addr);
+						codegen.opcodes.push_back(codegen.alloc_inline_cache());
+						codegen.alloc_stack(p_stack_level);
+						return dst_addr;
+					}
+
 				} break;
 				case GDScriptParser::OperatorNode::OP_AND: {
 					// AND operator with early out on failure
@@ -1060,6 +1291,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							// recover and assign at the end, this allows stuff like
 							// position.x+=2.0
 							// in Node2D
+							setchain.push_back(codegen.alloc_inline_cache());
 							setchain.push_back(prev_pos);
 							setchain.push_back(codegen.get_name_map_pos(assign_property));
 							setchain.push_back(GDScriptFunction::OPCODE_SET_MEMBER);
@@ -1102,9 +1334,15 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							int dst_pos = (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) | slevel;
 
 							codegen.opcodes.push_back(dst_pos);
+							if (named) {
+								codegen.opcodes.push_back(codegen.alloc_inline_cache());
+							}
 
 							//add in reverse order, since it will be reverted
 
+							if (named) {
+								setchain.push_back(codegen.alloc_inline_cache());
+							}
 							setchain.push_back(dst_pos);
 							setchain.push_back(key_idx);
 							setchain.push_back(prev_pos);
@@ -1140,10 +1378,19 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							return set_value;
 						}
 
-						codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_SET_NAMED : GDScriptFunction::OPCODE_SET);
+						int axis = named ? _get_vector3_axis(op->arguments[0], static_cast<const GDScriptParser::IdentifierNode *>(op->arguments[1])->name) : -1;
+						if (axis != -1) {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_SET_NAMED_VECTOR3);
+							codegen.opcodes.push_back(axis);
+						} else {
+							codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_SET_NAMED : GDScriptFunction::OPCODE_SET);
+						}
 						codegen.opcodes.push_back(prev_pos);
 						codegen.opcodes.push_back(set_index);
 						codegen.opcodes.push_back(set_value);
+						if (named) {
+							codegen.opcodes.push_back(codegen.alloc_inline_cache());
+						}
 
 						for (int i = 0; i < setchain.size(); i++) {
 							codegen.opcodes.push_back(setchain[i]);
@@ -1166,6 +1413,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						codegen.opcodes.push_back(GDScriptFunction::OPCODE_SET_MEMBER);
 						codegen.opcodes.push_back(codegen.get_name_map_pos(name));
 						codegen.opcodes.push_back(src_address);
+						codegen.opcodes.push_back(codegen.alloc_inline_cache());
 
 						return GDScriptFunction::ADDR_TYPE_NIL << GDScriptFunction::ADDR_BITS;
 					} else {
@@ -1401,16 +1649,11 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 					} break;
 
 					case GDScriptParser::ControlFlowNode::CF_IF: {
-						int ret2 = _parse_expression(codegen, cf->arguments[0], p_stack_level, false);
-						if (ret2 < 0) {
+						int else_addr = _parse_jump_if_not(codegen, cf->arguments[0], p_stack_level);
+						if (else_addr < 0) {
 							return ERR_PARSE_ERROR;
 						}
 
-						codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-						codegen.opcodes.push_back(ret2);
-						int else_addr = codegen.opcodes.size();
-						codegen.opcodes.push_back(0); //temporary
-
 						Error err = _parse_block(codegen, cf->body, p_stack_level, p_break_addr, p_continue_addr);
 						if (err) {
 							return err;
@@ -1455,8 +1698,10 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 						codegen.opcodes.push_back(container_pos);
 						codegen.opcodes.push_back(ret2);
 
+						bool integer_range = _is_integer_range(cf->arguments[1]);
+
 						//begin loop
-						codegen.opcodes.push_back(GDScriptFunction::OPCODE_ITERATE_BEGIN);
+						codegen.opcodes.push_back(integer_range ? GDScriptFunction::OPCODE_ITERATE_BEGIN_RANGE : GDScriptFunction::OPCODE_ITERATE_BEGIN);
 						codegen.opcodes.push_back(counter_pos);
 						codegen.opcodes.push_back(container_pos);
 						codegen.opcodes.push_back(codegen.opcodes.size() + 4);
@@ -1469,7 +1714,7 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 						codegen.opcodes.push_back(0); //skip code for next
 						//next loop
 						int continue_pos = codegen.opcodes.size();
-						codegen.opcodes.push_back(GDScriptFunction::OPCODE_ITERATE);
+						codegen.opcodes.push_back(integer_range ? GDScriptFunction::OPCODE_ITERATE_RANGE : GDScriptFunction::OPCODE_ITERATE);
 						codegen.opcodes.push_back(counter_pos);
 						codegen.opcodes.push_back(container_pos);
 						codegen.opcodes.push_back(break_pos);
@@ -1495,13 +1740,11 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 						codegen.opcodes.push_back(0);
 						int continue_addr = codegen.opcodes.size();
 
-						int ret2 = _parse_expression(codegen, cf->arguments[0], p_stack_level, false);
-						if (ret2 < 0) {
+						int jump_addr = _parse_jump_if_not(codegen, cf->arguments[0], p_stack_level);
+						if (jump_addr < 0) {
 							return ERR_PARSE_ERROR;
 						}
-						codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-						codegen.opcodes.push_back(ret2);
-						codegen.opcodes.push_back(break_addr);
+						codegen.opcodes.write[jump_addr] = break_addr;
 						Error err = _parse_block(codegen, cf->body, p_stack_level, break_addr, continue_addr);
 						if (err) {
 							return err;
@@ -1618,6 +1861,7 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	codegen.stack_max = 0;
 	codegen.current_line = 0;
 	codegen.call_max = 0;
+	codegen.inline_cache_count = 0;
 	codegen.debug_stack = EngineDebugger::is_active();
 	Vector<StringName> argnames;
 
@@ -1762,6 +2006,10 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 		gdfunc->_global_names_count = 0;
 	}
 
+	gdfunc->validated_builtin_calls = codegen.validated_builtin_calls;
+	gdfunc->_validated_builtin_calls_ptr = gdfunc->validated_builtin_calls.ptr();
+	gdfunc->_validated_builtin_call_count = gdfunc->validated_builtin_calls.size();
+
 #ifdef TOOLS_ENABLED
 	// Named globals
 	if (codegen.named_globals.size()) {
@@ -1796,6 +2044,10 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	gdfunc->_argument_count = p_func ? p_func->arguments.size() : 0;
 	gdfunc->_stack_size = codegen.stack_max;
 	gdfunc->_call_size = codegen.call_max;
+	if (codegen.inline_cache_count) {
+		gdfunc->_inline_caches_ptr = memnew_arr(GDScriptFunction::InlineCache, codegen.inline_cache_count);
+	}
+	gdfunc->_inline_cache_count = codegen.inline_cache_count;
 	gdfunc->name = func_name;
 #ifdef DEBUG_ENABLED
 	if (EngineDebugger::is_active()) {
@@ -2190,6 +2442,10 @@ Error GDScriptCompiler::compile(const GDScriptParser *p_parser, GDScript *p_scri
 	// The best fully qualified name for a base level script is its file path
 	p_script->fully_qualified_name = p_script->path;
 
+	// Member functions and indices are about to change, so cached lookups
+	// against this script (or any other one) must not be trusted anymore.
+	GDScriptLanguage::get_singleton()->bump_script_version();
+
 	// Create scripts for subclasses beforehand so they can be referenced
 	_make_scripts(p_script, static_cast<const GDScriptParser::ClassNode *>(root), p_keep_state);
 
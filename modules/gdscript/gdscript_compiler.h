@@ -109,6 +109,20 @@ class GDScriptCompiler {
 			return ret;
 		}
 
+		Vector<GDScriptFunction::ValidatedBuiltInCall> validated_builtin_calls;
+		int get_validated_builtin_call_pos(Variant::Type p_type, const Variant::ValidatedBuiltInMethod *p_method) {
+			for (int i = 0; i < validated_builtin_calls.size(); i++) {
+				if (validated_builtin_calls[i].method == p_method && validated_builtin_calls[i].base_type == p_type) {
+					return i;
+				}
+			}
+			GDScriptFunction::ValidatedBuiltInCall vcall;
+			vcall.base_type = p_type;
+			vcall.method = p_method;
+			validated_builtin_calls.push_back(vcall);
+			return validated_builtin_calls.size() - 1;
+		}
+
 		int get_constant_pos(const Variant &p_constant) {
 			if (constant_map.has(p_constant)) {
 				return constant_map[p_constant];
@@ -129,10 +143,14 @@ class GDScriptCompiler {
 				call_max = p_params;
 			}
 		}
+		int alloc_inline_cache() {
+			return inline_cache_count++;
+		}
 
 		int current_line;
 		int stack_max;
 		int call_max;
+		int inline_cache_count;
 	};
 
 	bool _is_class_member_property(CodeGen &codegen, const StringName &p_name);
@@ -140,11 +158,17 @@ class GDScriptCompiler {
 
 	void _set_error(const String &p_error, const GDScriptParser::Node *p_node);
 
+	GDScriptFunction::Opcode _get_operator_opcode(Variant::Operator op, const GDScriptParser::DataType &p_a, const GDScriptParser::DataType &p_b) const;
+	const Variant::ValidatedBuiltInMethod *_get_validated_builtin_method(const GDScriptParser::Node *p_base, const StringName &p_method, int p_argcount) const;
+	int _get_vector3_axis(const GDScriptParser::Node *p_base, const StringName &p_name) const;
 	bool _create_unary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level);
 	bool _create_binary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level, bool p_initializer = false, int p_index_addr = 0);
 
 	GDScriptDataType _gdtype_from_datatype(const GDScriptParser::DataType &p_datatype) const;
 
+	int _parse_jump_if_not(CodeGen &codegen, const GDScriptParser::Node *p_condition, int p_stack_level);
+	bool _is_integer_range(const GDScriptParser::Node *p_container) const;
+
 	int _parse_assign_right_expression(CodeGen &codegen, const GDScriptParser::OperatorNode *p_expression, int p_stack_level, int p_index_addr = 0);
 	int _parse_expression(CodeGen &codegen, const GDScriptParser::Node *p_expression, int p_stack_level, bool p_root = false, bool p_initializer = false, int p_index_addr = 0);
 	Error _parse_block(CodeGen &codegen, const GDScriptParser::BlockNode *p_block, int p_stack_level = 0, int p_break_addr = -1, int p_continue_addr = -1);
@@ -30,7 +30,9 @@
 
 #include "gdscript_function.h"
 
+#include "core/core_string_names.h"
 #include "core/os/os.h"
+#include "core/variant_internal.h"
 #include "gdscript.h"
 #include "gdscript_functions.h"
 
@@ -126,6 +128,28 @@ Variant *GDScriptFunction::_get_variant(int p_address, GDScriptInstance *p_insta
 	return nullptr;
 }
 
+// Stack slots and local constants make up almost all operands. Test for them
+// first with plain branches, which predict far better per call site than the
+// jump table in _get_variant().
+Variant *GDScriptFunction::_get_variant_fast(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant &static_ref, Variant *p_stack, String &r_error) const {
+	int address = p_address & ADDR_MASK;
+	int type = (p_address & ADDR_TYPE_MASK) >> ADDR_BITS;
+
+	if (likely(type == ADDR_TYPE_STACK || type == ADDR_TYPE_STACK_VARIABLE)) {
+#ifdef DEBUG_ENABLED
+		ERR_FAIL_INDEX_V(address, _stack_size, nullptr);
+#endif
+		return &p_stack[address];
+	}
+	if (type == ADDR_TYPE_LOCAL_CONSTANT) {
+#ifdef DEBUG_ENABLED
+		ERR_FAIL_INDEX_V(address, _constant_count, nullptr);
+#endif
+		return &_constants_ptr[address];
+	}
+	return _get_variant(p_address, p_instance, p_script, self, static_ref, p_stack, r_error);
+}
+
 #ifdef DEBUG_ENABLED
 static String _get_var_type(const Variant *p_var) {
 	String basestr;
@@ -184,16 +208,280 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 	return err_text;
 }
 
+GDScriptFunction::InlineCache::InlineCache() {
+	sequence.store(0, std::memory_order_relaxed);
+	for (int i = 0; i < ENTRY_MAX; i++) {
+		entries[i].class_key.store(nullptr, std::memory_order_relaxed);
+		entries[i].script.store(nullptr, std::memory_order_relaxed);
+		entries[i].script_version.store(0, std::memory_order_relaxed);
+		entries[i].method.store(nullptr, std::memory_order_relaxed);
+		entries[i].index.store(-1, std::memory_order_relaxed);
+	}
+}
+
+bool GDScriptFunction::InlineCache::lookup(const void *p_class_key, const GDScript *p_script, uint32_t p_version, MethodBind *&r_method, int &r_index) const {
+	uint32_t seq = sequence.load(std::memory_order_acquire);
+	if (seq & 1) {
+		return false; // Being written to, treat as a miss.
+	}
+
+	bool found = false;
+	for (int i = 0; i < ENTRY_MAX; i++) {
+		const Entry &e = entries[i];
+		if (e.class_key.load(std::memory_order_relaxed) == p_class_key && e.script.load(std::memory_order_relaxed) == p_script && e.script_version.load(std::memory_order_relaxed) == p_version) {
+			r_method = e.method.load(std::memory_order_relaxed);
+			r_index = e.index.load(std::memory_order_relaxed);
+			found = true;
+			break;
+		}
+	}
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return found && sequence.load(std::memory_order_relaxed) == seq;
+}
+
+void GDScriptFunction::InlineCache::store(const void *p_class_key, const GDScript *p_script, uint32_t p_version, MethodBind *p_method, int p_index) {
+	uint32_t seq = sequence.load(std::memory_order_relaxed);
+	if ((seq & 1) || !sequence.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire)) {
+		return; // Another thread is storing, this lookup will be redone next time.
+	}
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Entry &e = entries[used++ % ENTRY_MAX];
+	e.class_key.store(p_class_key, std::memory_order_relaxed);
+	e.script.store(p_script, std::memory_order_relaxed);
+	e.script_version.store(p_version, std::memory_order_relaxed);
+	e.method.store(p_method, std::memory_order_relaxed);
+	e.index.store(p_index, std::memory_order_relaxed);
+
+	sequence.store(seq + 2, std::memory_order_release);
+}
+
+Object *GDScriptFunction::_get_cache_receiver(const Variant *p_base, const GDScript *&r_script) {
+	if (p_base->get_type() != Variant::OBJECT) {
+		return nullptr;
+	}
+
+	Object *obj = VariantInternal::get_object(p_base);
+	if (unlikely(!obj)) {
+		return nullptr;
+	}
+#ifdef DEBUG_ENABLED
+	// Leave stray pointers to the generic path, which reports them.
+	ObjectID id = VariantInternal::get_object_id(p_base);
+	if (EngineDebugger::is_active() && !id.is_reference() && ObjectDB::get_instance(id) == nullptr) {
+		return nullptr;
+	}
+#endif
+
+	r_script = nullptr;
+	ScriptInstance *si = obj->get_script_instance();
+	if (si) {
+		// Only GDScript members can be checked for shadowing native ones.
+		if (si->get_language() != GDScriptLanguage::get_singleton() || si->is_placeholder()) {
+			return nullptr;
+		}
+		r_script = static_cast<GDScriptInstance *>(si)->script.ptr();
+	}
+
+	return obj;
+}
+
+bool GDScriptFunction::_call_cached(InlineCache *p_cache, Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, Callable::CallError &r_err) {
+	if (p_base->get_type() != Variant::OBJECT) {
+		// Builtin types are keyed on small integers, which can't collide with
+		// the class name pointers used for objects, and remember the index of
+		// the method in the builtin method table.
+		const void *type_key = reinterpret_cast<const void *>(uintptr_t(p_base->get_type()) + 1);
+		MethodBind *unused;
+		int index;
+		if (!p_cache->lookup(type_key, nullptr, 0, unused, index)) {
+			index = Variant::get_builtin_method_index(p_base->get_type(), p_method);
+			p_cache->store(type_key, nullptr, 0, nullptr, index);
+		}
+		if (index < 0) {
+			return false; // Vararg methods such as Callable.call() aren't in the table.
+		}
+
+		p_base->call_builtin_method(index, p_args, p_argcount, r_ret, r_err);
+		return true;
+	}
+
+	const GDScript *gds;
+	Object *obj = _get_cache_receiver(p_base, gds);
+	if (!obj) {
+		return false;
+	}
+
+	const void *class_key = obj->get_class_name().data_unique_pointer();
+	uint32_t version = gds ? GDScriptLanguage::get_singleton()->get_script_version() : 0;
+	MethodBind *method;
+	int index;
+
+	if (!p_cache->lookup(class_key, gds, version, method, index)) {
+		method = nullptr;
+		// free() is special cased by Object::call(), and scripts override call() itself.
+		if (p_method != CoreStringNames::get_singleton()->_free && !Object::cast_to<Script>(obj)) {
+			const GDScript *sptr = gds;
+			while (sptr && !sptr->member_functions.has(p_method)) {
+				sptr = sptr->_base;
+			}
+			if (!sptr) {
+				method = ClassDB::get_method(obj->get_class_name(), p_method);
+			}
+		}
+		p_cache->store(class_key, gds, version, method, -1);
+	}
+
+	if (!method) {
+		return false;
+	}
+
+	Variant ret = obj->call_method_bind(method, p_args, p_argcount, r_err);
+	if (r_ret) {
+		*r_ret = ret;
+	}
+	return true;
+}
+
+bool GDScriptFunction::_get_cached(InlineCache *p_cache, const Variant *p_base, const StringName &p_name, Variant *r_ret) {
+	const GDScript *gds;
+	Object *obj = _get_cache_receiver(p_base, gds);
+	if (!obj) {
+		return false;
+	}
+
+	const void *class_key = obj->get_class_name().data_unique_pointer();
+	uint32_t version = gds ? GDScriptLanguage::get_singleton()->get_script_version() : 0;
+	MethodBind *method;
+	int index;
+
+	if (!p_cache->lookup(class_key, gds, version, method, index)) {
+		// Mirrors the order of Object::get(): script members, constants and
+		// _get() win over native properties.
+		bool shadowed = Object::cast_to<Script>(obj) != nullptr || (gds && gds->member_indices.has(p_name));
+		for (const GDScript *sptr = gds; sptr && !shadowed; sptr = sptr->_base) {
+			shadowed = sptr->constants.has(p_name) || sptr->member_functions.has(GDScriptLanguage::get_singleton()->strings._get);
+		}
+		method = shadowed ? nullptr : ClassDB::get_property_getter_bind(obj->get_class_name(), p_name);
+		p_cache->store(class_key, gds, version, method, -1);
+	}
+
+	if (!method) {
+		return false;
+	}
+
+	Callable::CallError ce;
+	*r_ret = obj->call_method_bind(method, nullptr, 0, ce);
+	return true;
+}
+
+bool GDScriptFunction::_set_cached(InlineCache *p_cache, const Variant *p_base, const StringName &p_name, const Variant *p_value) {
+	const GDScript *gds;
+	Object *obj = _get_cache_receiver(p_base, gds);
+	if (!obj) {
+		return false;
+	}
+#ifdef TOOLS_ENABLED
+	// Object::set() flags the object as edited, let it do so the first time.
+	if (!obj->is_edited()) {
+		return false;
+	}
+#endif
+
+	const void *class_key = obj->get_class_name().data_unique_pointer();
+	uint32_t version = gds ? GDScriptLanguage::get_singleton()->get_script_version() : 0;
+	MethodBind *method;
+	int index;
+
+	if (!p_cache->lookup(class_key, gds, version, method, index)) {
+		// Script members and _set() win over native properties, as in Object::set().
+		bool shadowed = Object::cast_to<Script>(obj) != nullptr || (gds && gds->member_indices.has(p_name));
+		for (const GDScript *sptr = gds; sptr && !shadowed; sptr = sptr->_base) {
+			shadowed = sptr->member_functions.has(GDScriptLanguage::get_singleton()->strings._set);
+		}
+		index = -1;
+		method = shadowed ? nullptr : ClassDB::get_property_setter_bind(obj->get_class_name(), p_name, &index);
+		p_cache->store(class_key, gds, version, method, index);
+	}
+
+	if (!method) {
+		return false;
+	}
+
+	// On error the generic path runs the setter again to report it.
+	Callable::CallError ce;
+	if (index >= 0) {
+		Variant idx = index;
+		const Variant *args[2] = { &idx, p_value };
+		obj->call_method_bind(method, args, 2, ce);
+	} else {
+		obj->call_method_bind(method, &p_value, 1, ce);
+	}
+	return ce.error == Callable::CallError::CALL_OK;
+}
+
+bool GDScriptFunction::_get_member_cached(InlineCache *p_cache, Object *p_owner, const StringName &p_name, Variant *r_ret) {
+	// Members of the owner are looked up on its native class only, see
+	// ClassDB::get_property(), so the class is the whole key.
+	const void *class_key = p_owner->get_class_name().data_unique_pointer();
+	MethodBind *method;
+	int index;
+
+	if (!p_cache->lookup(class_key, nullptr, 0, method, index)) {
+		method = ClassDB::get_property_getter_bind(p_owner->get_class_name(), p_name);
+		p_cache->store(class_key, nullptr, 0, method, -1);
+	}
+
+	if (!method) {
+		return false;
+	}
+
+	Callable::CallError ce;
+	*r_ret = p_owner->call_method_bind(method, nullptr, 0, ce);
+	return true;
+}
+
+bool GDScriptFunction::_set_member_cached(InlineCache *p_cache, Object *p_owner, const StringName &p_name, const Variant *p_value) {
+	const void *class_key = p_owner->get_class_name().data_unique_pointer();
+	MethodBind *method;
+	int index;
+
+	if (!p_cache->lookup(class_key, nullptr, 0, method, index)) {
+		index = -1;
+		method = ClassDB::get_property_setter_bind(p_owner->get_class_name(), p_name, &index);
+		p_cache->store(class_key, nullptr, 0, method, index);
+	}
+
+	if (!method) {
+		return false;
+	}
+
+	Callable::CallError ce;
+	if (index >= 0) {
+		Variant idx = index;
+		const Variant *args[2] = { &idx, p_value };
+		p_owner->call_method_bind(method, args, 2, ce);
+	} else {
+		p_owner->call_method_bind(method, &p_value, 1, ce);
+	}
+	return ce.error == Callable::CallError::CALL_OK;
+}
+
 #if defined(__GNUC__)
 #define OPCODES_TABLE                         \
 	static const void *switch_table_ops[] = { \
 		&&OPCODE_OPERATOR,                    \
+		&&OPCODE_OPERATOR_INT,                \
+		&&OPCODE_OPERATOR_FLOAT,              \
 		&&OPCODE_EXTENDS_TEST,                \
 		&&OPCODE_IS_BUILTIN,                  \
 		&&OPCODE_SET,                         \
 		&&OPCODE_GET,                         \
 		&&OPCODE_SET_NAMED,                   \
 		&&OPCODE_GET_NAMED,                   \
+		&&OPCODE_SET_NAMED_VECTOR3,           \
+		&&OPCODE_GET_NAMED_VECTOR3,           \
 		&&OPCODE_SET_MEMBER,                  \
 		&&OPCODE_GET_MEMBER,                  \
 		&&OPCODE_ASSIGN,                      \
@@ -210,6 +498,7 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 		&&OPCODE_CONSTRUCT_DICTIONARY,        \
 		&&OPCODE_CALL,                        \
 		&&OPCODE_CALL_RETURN,                 \
+		&&OPCODE_CALL_BUILTIN_TYPE_VALIDATED, \
 		&&OPCODE_CALL_BUILT_IN,               \
 		&&OPCODE_CALL_SELF,                   \
 		&&OPCODE_CALL_SELF_BASE,              \
@@ -219,10 +508,15 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 		&&OPCODE_JUMP,                        \
 		&&OPCODE_JUMP_IF,                     \
 		&&OPCODE_JUMP_IF_NOT,                 \
+		&&OPCODE_JUMP_IF_NOT_COMPARE,         \
+		&&OPCODE_JUMP_IF_NOT_COMPARE_INT,     \
+		&&OPCODE_JUMP_IF_NOT_COMPARE_FLOAT,   \
 		&&OPCODE_JUMP_TO_DEF_ARGUMENT,        \
 		&&OPCODE_RETURN,                      \
 		&&OPCODE_ITERATE_BEGIN,               \
 		&&OPCODE_ITERATE,                     \
+		&&OPCODE_ITERATE_BEGIN_RANGE,         \
+		&&OPCODE_ITERATE_RANGE,               \
 		&&OPCODE_ASSERT,                      \
 		&&OPCODE_BREAKPOINT,                  \
 		&&OPCODE_LINE,                        \
@@ -254,6 +548,7 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 
 Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err, CallState *p_state) {
 	OPCODES_TABLE;
+	MemoryTagScope memory_tag(Memory::TAG_SCRIPTING);
 
 	if (!_code_ptr) {
 		return Variant();
@@ -382,10 +677,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #define CHECK_SPACE(m_space) \
 	GD_ERR_BREAK((ip + m_space) > _code_size)
 
-#define GET_VARIANT_PTR(m_v, m_code_ofs)                                                                   \
-	Variant *m_v;                                                                                          \
-	m_v = _get_variant(_code_ptr[ip + m_code_ofs], p_instance, script, self, static_ref, stack, err_text); \
-	if (unlikely(!m_v))                                                                                    \
+#define GET_VARIANT_PTR(m_v, m_code_ofs)                                                                       \
+	Variant *m_v;                                                                                              \
+	m_v = _get_variant_fast(_code_ptr[ip + m_code_ofs], p_instance, script, self, static_ref, stack, err_text); \
+	if (unlikely(!m_v))                                                                                        \
 		OPCODE_BREAK;
 
 #else
@@ -393,7 +688,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #define CHECK_SPACE(m_space)
 #define GET_VARIANT_PTR(m_v, m_code_ofs) \
 	Variant *m_v;                        \
-	m_v = _get_variant(_code_ptr[ip + m_code_ofs], p_instance, script, self, static_ref, stack, err_text);
+	m_v = _get_variant_fast(_code_ptr[ip + m_code_ofs], p_instance, script, self, static_ref, stack, err_text);
 
 #endif
 
@@ -421,6 +716,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 		OPCODE_SWITCH(_code_ptr[ip]) {
 			OPCODE(OPCODE_OPERATOR) {
+			generic_operator:
 				CHECK_SPACE(5);
 
 				bool valid;
@@ -455,6 +751,171 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_OPERATOR_INT) {
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				// Operand types are only inferred by the parser, so they are still
+				// checked here. Anything unexpected, including operations that would
+				// fail, takes the generic path so errors are reported the same way.
+				if (unlikely(a->get_type() != Variant::INT || b->get_type() != Variant::INT)) {
+					goto generic_operator;
+				}
+
+				GET_VARIANT_PTR(dst, 4);
+
+				int64_t va = *VariantInternal::get_int(a);
+				int64_t vb = *VariantInternal::get_int(b);
+
+				switch (_code_ptr[ip + 1]) {
+					case Variant::OP_EQUAL: {
+						VariantInternal::set_bool(dst, va == vb);
+					} break;
+					case Variant::OP_NOT_EQUAL: {
+						VariantInternal::set_bool(dst, va != vb);
+					} break;
+					case Variant::OP_LESS: {
+						VariantInternal::set_bool(dst, va < vb);
+					} break;
+					case Variant::OP_LESS_EQUAL: {
+						VariantInternal::set_bool(dst, va <= vb);
+					} break;
+					case Variant::OP_GREATER: {
+						VariantInternal::set_bool(dst, va > vb);
+					} break;
+					case Variant::OP_GREATER_EQUAL: {
+						VariantInternal::set_bool(dst, va >= vb);
+					} break;
+					case Variant::OP_ADD: {
+						VariantInternal::set_int(dst, va + vb);
+					} break;
+					case Variant::OP_SUBTRACT: {
+						VariantInternal::set_int(dst, va - vb);
+					} break;
+					case Variant::OP_MULTIPLY: {
+						VariantInternal::set_int(dst, va * vb);
+					} break;
+					case Variant::OP_DIVIDE: {
+						if (unlikely(vb == 0)) {
+							goto generic_operator;
+						}
+						VariantInternal::set_int(dst, va / vb);
+					} break;
+					case Variant::OP_MODULE: {
+						if (unlikely(vb == 0)) {
+							goto generic_operator;
+						}
+						VariantInternal::set_int(dst, va % vb);
+					} break;
+					case Variant::OP_NEGATE: {
+						VariantInternal::set_int(dst, -va);
+					} break;
+					case Variant::OP_POSITIVE: {
+						VariantInternal::set_int(dst, va);
+					} break;
+					case Variant::OP_SHIFT_LEFT: {
+						if (unlikely(vb < 0 || vb >= 64)) {
+							goto generic_operator;
+						}
+						VariantInternal::set_int(dst, va << vb);
+					} break;
+					case Variant::OP_SHIFT_RIGHT: {
+						if (unlikely(vb < 0 || vb >= 64)) {
+							goto generic_operator;
+						}
+						VariantInternal::set_int(dst, va >> vb);
+					} break;
+					case Variant::OP_BIT_AND: {
+						VariantInternal::set_int(dst, va & vb);
+					} break;
+					case Variant::OP_BIT_OR: {
+						VariantInternal::set_int(dst, va | vb);
+					} break;
+					case Variant::OP_BIT_XOR: {
+						VariantInternal::set_int(dst, va ^ vb);
+					} break;
+					case Variant::OP_BIT_NEGATE: {
+						VariantInternal::set_int(dst, ~va);
+					} break;
+					default: {
+						goto generic_operator;
+					}
+				}
+
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_OPERATOR_FLOAT) {
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				// At least one operand must be a float, otherwise the generic
+				// path is needed to keep integer semantics.
+				Variant::Type ta = a->get_type();
+				Variant::Type tb = b->get_type();
+				if (unlikely(!(ta == Variant::FLOAT && (tb == Variant::FLOAT || tb == Variant::INT)) && !(tb == Variant::FLOAT && ta == Variant::INT))) {
+					goto generic_operator;
+				}
+
+				GET_VARIANT_PTR(dst, 4);
+
+				double va = VariantInternal::get_number(a);
+				double vb = VariantInternal::get_number(b);
+
+				switch (_code_ptr[ip + 1]) {
+					case Variant::OP_EQUAL: {
+						VariantInternal::set_bool(dst, va == vb);
+					} break;
+					case Variant::OP_NOT_EQUAL: {
+						VariantInternal::set_bool(dst, va != vb);
+					} break;
+					case Variant::OP_LESS: {
+						VariantInternal::set_bool(dst, va < vb);
+					} break;
+					case Variant::OP_LESS_EQUAL: {
+						VariantInternal::set_bool(dst, va <= vb);
+					} break;
+					case Variant::OP_GREATER: {
+						VariantInternal::set_bool(dst, va > vb);
+					} break;
+					case Variant::OP_GREATER_EQUAL: {
+						VariantInternal::set_bool(dst, va >= vb);
+					} break;
+					case Variant::OP_ADD: {
+						VariantInternal::set_float(dst, va + vb);
+					} break;
+					case Variant::OP_SUBTRACT: {
+						VariantInternal::set_float(dst, va - vb);
+					} break;
+					case Variant::OP_MULTIPLY: {
+						VariantInternal::set_float(dst, va * vb);
+					} break;
+					case Variant::OP_DIVIDE: {
+						if (unlikely(vb == 0)) {
+							goto generic_operator;
+						}
+						VariantInternal::set_float(dst, va / vb);
+					} break;
+					case Variant::OP_NEGATE: {
+						VariantInternal::set_float(dst, -va);
+					} break;
+					case Variant::OP_POSITIVE: {
+						VariantInternal::set_float(dst, va);
+					} break;
+					default: {
+						goto generic_operator;
+					}
+				}
+
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_EXTENDS_TEST) {
 				CHECK_SPACE(4);
 
@@ -603,7 +1064,8 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_NAMED) {
-				CHECK_SPACE(3);
+			generic_set_named:
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(dst, 1);
 				GET_VARIANT_PTR(value, 3);
@@ -613,6 +1075,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				int cache = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache < 0 || cache >= _inline_cache_count);
+				if (_set_cached(&_inline_caches_ptr[cache], dst, *index, value)) {
+					ip += 5;
+					DISPATCH_OPCODE;
+				}
+
 				bool valid;
 				dst->set_named(*index, *value, &valid);
 
@@ -623,12 +1092,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_NAMED) {
-				CHECK_SPACE(4);
+			generic_get_named:
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(src, 1);
 				GET_VARIANT_PTR(dst, 3);
@@ -638,6 +1108,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				int cache = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache < 0 || cache >= _inline_cache_count);
+				if (_get_cached(&_inline_caches_ptr[cache], src, *index, dst)) {
+					ip += 5;
+					DISPATCH_OPCODE;
+				}
+
 				bool valid;
 #ifdef DEBUG_ENABLED
 				//allow better error message in cases where src and dst are the same stack position
@@ -657,17 +1134,65 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 				*dst = ret;
 #endif
-				ip += 4;
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_SET_NAMED_VECTOR3) {
+				CHECK_SPACE(6);
+
+				// Same layout as OPCODE_SET_NAMED with the axis in front, so the
+				// generic path can be taken by skipping it.
+				GET_VARIANT_PTR(dst, 2);
+				GET_VARIANT_PTR(value, 4);
+
+				int axis = _code_ptr[ip + 1];
+				GD_ERR_BREAK(axis < 0 || axis > Vector3::AXIS_Z);
+
+				if (unlikely(dst->get_type() != Variant::VECTOR3 || !value->is_num())) {
+					ip += 1;
+					goto generic_set_named;
+				}
+
+				(*VariantInternal::get_vector3(dst))[axis] = VariantInternal::get_number(value);
+				ip += 6;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_GET_NAMED_VECTOR3) {
+				CHECK_SPACE(6);
+
+				GET_VARIANT_PTR(src, 2);
+
+				int axis = _code_ptr[ip + 1];
+				GD_ERR_BREAK(axis < 0 || axis > Vector3::AXIS_Z);
+
+				if (unlikely(src->get_type() != Variant::VECTOR3)) {
+					ip += 1;
+					goto generic_get_named;
+				}
+
+				GET_VARIANT_PTR(dst, 4);
+
+				VariantInternal::set_float(dst, (*VariantInternal::get_vector3(src))[axis]);
+				ip += 6;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_MEMBER) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(4);
 				int indexname = _code_ptr[ip + 1];
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 				GET_VARIANT_PTR(src, 2);
 
+				int cache = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cache < 0 || cache >= _inline_cache_count);
+				if (_set_member_cached(&_inline_caches_ptr[cache], p_instance->owner, *index, src)) {
+					ip += 4;
+					DISPATCH_OPCODE;
+				}
+
 				bool valid;
 #ifndef DEBUG_ENABLED
 				ClassDB::set_property(p_instance->owner, *index, *src, &valid);
@@ -681,17 +1206,24 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 3;
+				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_MEMBER) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(4);
 				int indexname = _code_ptr[ip + 1];
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 				GET_VARIANT_PTR(dst, 2);
 
+				int cache = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cache < 0 || cache >= _inline_cache_count);
+				if (_get_member_cached(&_inline_caches_ptr[cache], p_instance->owner, *index, dst)) {
+					ip += 4;
+					DISPATCH_OPCODE;
+				}
+
 #ifndef DEBUG_ENABLED
 				ClassDB::get_property(p_instance->owner, *index, *dst);
 #else
@@ -701,7 +1233,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 3;
+				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
@@ -1006,7 +1538,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 				bool call_ret = _code_ptr[ip] == OPCODE_CALL_RETURN;
 
 				int argc = _code_ptr[ip + 1];
@@ -1016,8 +1548,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[nameg];
 
+				int cache = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache < 0 || cache >= _inline_cache_count);
+
 				GD_ERR_BREAK(argc < 0);
-				ip += 4;
+				ip += 5;
 				CHECK_SPACE(argc + 1);
 				Variant **argptrs = call_args;
 
@@ -1035,11 +1570,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 #endif
 				Callable::CallError err;
+				Variant *ret = nullptr;
 				if (call_ret) {
-					GET_VARIANT_PTR(ret, argc);
+					GET_VARIANT_PTR(dst, argc);
+					ret = dst;
+				}
+				if (!_call_cached(&_inline_caches_ptr[cache], base, *methodname, (const Variant **)argptrs, argc, ret, err)) {
 					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
-				} else {
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, nullptr, err);
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -1078,6 +1615,55 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_CALL_BUILTIN_TYPE_VALIDATED) {
+				CHECK_SPACE(5);
+
+				int argc = _code_ptr[ip + 1];
+				GET_VARIANT_PTR(base, 2);
+				int nameg = _code_ptr[ip + 3];
+
+				GD_ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
+				const StringName *methodname = &_global_names_ptr[nameg];
+
+				int vcall_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(vcall_idx < 0 || vcall_idx >= _validated_builtin_call_count);
+				const ValidatedBuiltInCall &vcall = _validated_builtin_calls_ptr[vcall_idx];
+
+				GD_ERR_BREAK(argc < 0);
+				ip += 5;
+				CHECK_SPACE(argc + 1);
+				Variant **argptrs = call_args;
+
+				// Types were inferred by the compiler, but values of other types
+				// (null, or an int passed for a float) can still show up. Those
+				// take the regular path, which converts or reports them.
+				bool validated = base->get_type() == vcall.base_type && argc == vcall.method->arg_count;
+				for (int i = 0; i < argc; i++) {
+					GET_VARIANT_PTR(v, i);
+					argptrs[i] = v;
+					validated = validated && (vcall.method->arg_types[i] == Variant::NIL || vcall.method->arg_types[i] == v->get_type());
+				}
+
+				GET_VARIANT_PTR(ret, argc);
+				Callable::CallError err;
+				if (likely(validated)) {
+					Variant r;
+					vcall.method->call(r, *base, (const Variant **)argptrs);
+					*ret = r;
+				} else {
+					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
+				}
+#ifdef DEBUG_ENABLED
+				if (err.error != Callable::CallError::CALL_OK) {
+					err_text = _get_call_error(err, "function '" + String(*methodname) + "' in base '" + _get_var_type(base) + "'", (const Variant **)argptrs);
+					OPCODE_BREAK;
+				}
+#endif
+
+				ip += argc + 1;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_CALL_BUILT_IN) {
 				CHECK_SPACE(4);
 
@@ -1345,6 +1931,139 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_JUMP_IF_NOT_COMPARE) {
+			generic_jump_if_not_compare:
+				CHECK_SPACE(5);
+
+				bool valid;
+				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
+				GD_ERR_BREAK(op >= Variant::OP_MAX);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				Variant ret;
+				Variant::evaluate(op, *a, *b, ret, valid);
+#ifdef DEBUG_ENABLED
+				if (!valid) {
+					if (ret.get_type() == Variant::STRING) {
+						//return a string when invalid with the error
+						err_text = ret;
+						err_text += " in operator '" + Variant::get_operator_name(op) + "'.";
+					} else {
+						err_text = "Invalid operands '" + Variant::get_type_name(a->get_type()) + "' and '" + Variant::get_type_name(b->get_type()) + "' in operator '" + Variant::get_operator_name(op) + "'.";
+					}
+					OPCODE_BREAK;
+				}
+#endif
+				if (!ret.booleanize()) {
+					int to = _code_ptr[ip + 4];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 5;
+				}
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_JUMP_IF_NOT_COMPARE_INT) {
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				if (unlikely(a->get_type() != Variant::INT || b->get_type() != Variant::INT)) {
+					goto generic_jump_if_not_compare;
+				}
+
+				int64_t va = *VariantInternal::get_int(a);
+				int64_t vb = *VariantInternal::get_int(b);
+				bool result;
+
+				switch (_code_ptr[ip + 1]) {
+					case Variant::OP_EQUAL: {
+						result = va == vb;
+					} break;
+					case Variant::OP_NOT_EQUAL: {
+						result = va != vb;
+					} break;
+					case Variant::OP_LESS: {
+						result = va < vb;
+					} break;
+					case Variant::OP_LESS_EQUAL: {
+						result = va <= vb;
+					} break;
+					case Variant::OP_GREATER: {
+						result = va > vb;
+					} break;
+					case Variant::OP_GREATER_EQUAL: {
+						result = va >= vb;
+					} break;
+					default: {
+						goto generic_jump_if_not_compare;
+					}
+				}
+
+				if (!result) {
+					int to = _code_ptr[ip + 4];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 5;
+				}
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_JUMP_IF_NOT_COMPARE_FLOAT) {
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				Variant::Type ta = a->get_type();
+				Variant::Type tb = b->get_type();
+				if (unlikely(!(ta == Variant::FLOAT && (tb == Variant::FLOAT || tb == Variant::INT)) && !(tb == Variant::FLOAT && ta == Variant::INT))) {
+					goto generic_jump_if_not_compare;
+				}
+
+				double va = VariantInternal::get_number(a);
+				double vb = VariantInternal::get_number(b);
+				bool result;
+
+				switch (_code_ptr[ip + 1]) {
+					case Variant::OP_EQUAL: {
+						result = va == vb;
+					} break;
+					case Variant::OP_NOT_EQUAL: {
+						result = va != vb;
+					} break;
+					case Variant::OP_LESS: {
+						result = va < vb;
+					} break;
+					case Variant::OP_LESS_EQUAL: {
+						result = va <= vb;
+					} break;
+					case Variant::OP_GREATER: {
+						result = va > vb;
+					} break;
+					case Variant::OP_GREATER_EQUAL: {
+						result = va >= vb;
+					} break;
+					default: {
+						goto generic_jump_if_not_compare;
+					}
+				}
+
+				if (!result) {
+					int to = _code_ptr[ip + 4];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 5;
+				}
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_JUMP_TO_DEF_ARGUMENT) {
 				CHECK_SPACE(2);
 				ip = _default_arg_ptr[defarg];
@@ -1362,6 +2081,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 
 			OPCODE(OPCODE_ITERATE_BEGIN) {
+			generic_iterate_begin:
 				CHECK_SPACE(8); //space for this a regular iterate
 
 				GET_VARIANT_PTR(counter, 1);
@@ -1394,6 +2114,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_ITERATE) {
+			generic_iterate:
 				CHECK_SPACE(4);
 
 				GET_VARIANT_PTR(counter, 1);
@@ -1425,6 +2146,98 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_ITERATE_BEGIN_RANGE) {
+				CHECK_SPACE(8);
+
+				GET_VARIANT_PTR(counter, 1);
+				GET_VARIANT_PTR(container, 2);
+
+				// Same semantics as Variant::iter_init() for the values range() is
+				// turned into by the parser: int, Vector2i and Vector3i.
+				int64_t from;
+				int64_t to;
+				int64_t step;
+				switch (container->get_type()) {
+					case Variant::INT: {
+						from = 0;
+						to = *VariantInternal::get_int(container);
+						step = 1;
+					} break;
+					case Variant::VECTOR2I: {
+						const Vector2i *v = VariantInternal::get_vector2i(container);
+						from = v->x;
+						to = v->y;
+						step = 1;
+					} break;
+					case Variant::VECTOR3I: {
+						const Vector3i *v = VariantInternal::get_vector3i(container);
+						from = v->x;
+						to = v->y;
+						step = v->z;
+					} break;
+					default: {
+						goto generic_iterate_begin;
+					}
+				}
+
+				VariantInternal::set_int(counter, from);
+
+				if (from == to || (from < to) != (step > 0) || step == 0) {
+					int jumpto = _code_ptr[ip + 3];
+					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+					ip = jumpto;
+				} else {
+					GET_VARIANT_PTR(iterator, 4);
+					VariantInternal::set_int(iterator, from);
+					ip += 5; //skip regular iterate which is always next
+				}
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_ITERATE_RANGE) {
+				CHECK_SPACE(4);
+
+				GET_VARIANT_PTR(counter, 1);
+				GET_VARIANT_PTR(container, 2);
+
+				if (unlikely(counter->get_type() != Variant::INT)) {
+					goto generic_iterate;
+				}
+
+				int64_t idx = *VariantInternal::get_int(counter);
+				bool done;
+				switch (container->get_type()) {
+					case Variant::INT: {
+						idx++;
+						done = idx >= *VariantInternal::get_int(container);
+					} break;
+					case Variant::VECTOR2I: {
+						idx++;
+						done = idx >= VariantInternal::get_vector2i(container)->y;
+					} break;
+					case Variant::VECTOR3I: {
+						const Vector3i *v = VariantInternal::get_vector3i(container);
+						idx += v->z;
+						done = (v->z < 0 && idx <= v->y) || (v->z > 0 && idx >= v->y);
+					} break;
+					default: {
+						goto generic_iterate;
+					}
+				}
+
+				if (done) {
+					int jumpto = _code_ptr[ip + 3];
+					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+					ip = jumpto;
+				} else {
+					*VariantInternal::get_int(counter) = idx;
+					GET_VARIANT_PTR(iterator, 4);
+					VariantInternal::set_int(iterator, idx);
+					ip += 5; //loop again
+				}
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_ASSERT) {
 				CHECK_SPACE(3);
 
@@ -1689,6 +2502,10 @@ GDScriptFunction::GDScriptFunction() :
 		function_list(this) {
 	_stack_size = 0;
 	_call_size = 0;
+	_inline_caches_ptr = nullptr;
+	_inline_cache_count = 0;
+	_validated_builtin_calls_ptr = nullptr;
+	_validated_builtin_call_count = 0;
 	rpc_mode = MultiplayerAPI::RPC_MODE_DISABLED;
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
@@ -1714,6 +2531,10 @@ GDScriptFunction::GDScriptFunction() :
 }
 
 GDScriptFunction::~GDScriptFunction() {
+	if (_inline_caches_ptr) {
+		memdelete_arr(_inline_caches_ptr);
+	}
+
 #ifdef DEBUG_ENABLED
 
 	MutexLock lock(GDScriptLanguage::get_singleton()->lock);
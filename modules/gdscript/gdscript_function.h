@@ -39,6 +39,8 @@
 #include "core/string_name.h"
 #include "core/variant.h"
 
+#include <atomic>
+
 class GDScriptInstance;
 class GDScript;
 
@@ -158,12 +160,16 @@ class GDScriptFunction {
 public:
 	enum Opcode {
 		OPCODE_OPERATOR,
+		OPCODE_OPERATOR_INT,
+		OPCODE_OPERATOR_FLOAT,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_IS_BUILTIN,
 		OPCODE_SET,
 		OPCODE_GET,
 		OPCODE_SET_NAMED,
 		OPCODE_GET_NAMED,
+		OPCODE_SET_NAMED_VECTOR3,
+		OPCODE_GET_NAMED_VECTOR3,
 		OPCODE_SET_MEMBER,
 		OPCODE_GET_MEMBER,
 		OPCODE_ASSIGN,
@@ -180,6 +186,7 @@ public:
 		OPCODE_CONSTRUCT_DICTIONARY,
 		OPCODE_CALL,
 		OPCODE_CALL_RETURN,
+		OPCODE_CALL_BUILTIN_TYPE_VALIDATED,
 		OPCODE_CALL_BUILT_IN,
 		OPCODE_CALL_SELF,
 		OPCODE_CALL_SELF_BASE,
@@ -189,10 +196,15 @@ public:
 		OPCODE_JUMP,
 		OPCODE_JUMP_IF,
 		OPCODE_JUMP_IF_NOT,
+		OPCODE_JUMP_IF_NOT_COMPARE,
+		OPCODE_JUMP_IF_NOT_COMPARE_INT,
+		OPCODE_JUMP_IF_NOT_COMPARE_FLOAT,
 		OPCODE_JUMP_TO_DEF_ARGUMENT,
 		OPCODE_RETURN,
 		OPCODE_ITERATE_BEGIN,
 		OPCODE_ITERATE,
+		OPCODE_ITERATE_BEGIN_RANGE,
+		OPCODE_ITERATE_RANGE,
 		OPCODE_ASSERT,
 		OPCODE_BREAKPOINT,
 		OPCODE_LINE,
@@ -222,9 +234,44 @@ public:
 		StringName identifier;
 	};
 
+	// A builtin method resolved at compile time, for bases of a known type.
+	struct ValidatedBuiltInCall {
+		Variant::Type base_type = Variant::NIL;
+		const Variant::ValidatedBuiltInMethod *method = nullptr;
+	};
+
 private:
 	friend class GDScriptCompiler;
 
+	// Remembers, per call site, which MethodBind a name resolved to for the last
+	// few receiver classes (and GDScript, for script instances), so calls and
+	// property accesses on native objects skip the script member lookups and
+	// the ClassDB hash walk. A null method is a negative entry: that receiver
+	// must take the generic path. Readers never lock; the entries are guarded
+	// by a sequence counter and a writer that loses the race doesn't store.
+	struct InlineCache {
+		enum {
+			ENTRY_MAX = 4
+		};
+
+		struct Entry {
+			std::atomic<const void *> class_key;
+			std::atomic<const GDScript *> script;
+			std::atomic<uint32_t> script_version;
+			std::atomic<MethodBind *> method;
+			std::atomic<int> index;
+		};
+
+		std::atomic<uint32_t> sequence;
+		uint32_t used = 0;
+		Entry entries[ENTRY_MAX];
+
+		_FORCE_INLINE_ bool lookup(const void *p_class_key, const GDScript *p_script, uint32_t p_version, MethodBind *&r_method, int &r_index) const;
+		void store(const void *p_class_key, const GDScript *p_script, uint32_t p_version, MethodBind *p_method, int p_index);
+
+		InlineCache();
+	};
+
 	StringName source;
 
 	mutable Variant nil;
@@ -232,6 +279,8 @@ private:
 	int _constant_count;
 	const StringName *_global_names_ptr;
 	int _global_names_count;
+	const ValidatedBuiltInCall *_validated_builtin_calls_ptr;
+	int _validated_builtin_call_count;
 #ifdef TOOLS_ENABLED
 	const StringName *_named_globals_ptr;
 	int _named_globals_count;
@@ -244,6 +293,8 @@ private:
 	int _stack_size;
 	int _call_size;
 	int _initial_line;
+	InlineCache *_inline_caches_ptr;
+	int _inline_cache_count;
 	bool _static;
 	MultiplayerAPI::RPCMode rpc_mode;
 
@@ -252,6 +303,7 @@ private:
 	StringName name;
 	Vector<Variant> constants;
 	Vector<StringName> global_names;
+	Vector<ValidatedBuiltInCall> validated_builtin_calls;
 #ifdef TOOLS_ENABLED
 	Vector<StringName> named_globals;
 #endif
@@ -267,8 +319,16 @@ private:
 	List<StackDebug> stack_debug;
 
 	_FORCE_INLINE_ Variant *_get_variant(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant &static_ref, Variant *p_stack, String &r_error) const;
+	_FORCE_INLINE_ Variant *_get_variant_fast(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant &static_ref, Variant *p_stack, String &r_error) const;
 	_FORCE_INLINE_ String _get_call_error(const Callable::CallError &p_err, const String &p_where, const Variant **argptrs) const;
 
+	static _FORCE_INLINE_ Object *_get_cache_receiver(const Variant *p_base, const GDScript *&r_script);
+	static _FORCE_INLINE_ bool _call_cached(InlineCache *p_cache, Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, Callable::CallError &r_err);
+	static _FORCE_INLINE_ bool _get_cached(InlineCache *p_cache, const Variant *p_base, const StringName &p_name, Variant *r_ret);
+	static _FORCE_INLINE_ bool _set_cached(InlineCache *p_cache, const Variant *p_base, const StringName &p_name, const Variant *p_value);
+	static _FORCE_INLINE_ bool _get_member_cached(InlineCache *p_cache, Object *p_owner, const StringName &p_name, Variant *r_ret);
+	static _FORCE_INLINE_ bool _set_member_cached(InlineCache *p_cache, Object *p_owner, const StringName &p_name, const Variant *p_value);
+
 	friend class GDScriptLanguage;
 
 	SelfList<GDScriptFunction> function_list;
@@ -35,6 +35,7 @@
 #include "core/project_settings.h"
 #include "core/type_info.h"
 #include "scene/3d/physics_body_3d.h"
+#include "scene/main/scene_tree.h"
 #include "scene/resources/surface_tool.h"
 #include "scene/scene_string_names.h"
 
@@ -221,142 +222,210 @@ void Skeleton3D::_update_process_order() {
 	process_order_dirty = false;
 }
 
-void Skeleton3D::_notification(int p_what) {
-	switch (p_what) {
-		case NOTIFICATION_UPDATE_SKELETON: {
-			RenderingServer *rs = RenderingServer::get_singleton();
-			Bone *bonesptr = bones.ptrw();
-			int len = bones.size();
+void Skeleton3D::_update_begin() {
+	_update_process_order();
 
-			_update_process_order();
+	int len = bones.size();
+	bones.ptrw(); // Make sure the bones are not shared, _update_poses() may run on another thread.
+	bone_global_poses.resize(len);
 
-			const int *order = process_order.ptr();
+	//update skin bindings
+	for (Set<SkinReference *>::Element *E = skin_bindings.front(); E; E = E->next()) {
+		const Skin *skin = E->get()->skin.operator->();
+		RID skeleton = E->get()->skeleton;
+		uint32_t bind_count = skin->get_bind_count();
+
+		if (E->get()->bind_count != bind_count) {
+			RS::get_singleton()->skeleton_allocate(skeleton, bind_count);
+			E->get()->bind_count = bind_count;
+			E->get()->skin_bone_indices.resize(bind_count);
+			E->get()->skin_bone_indices_ptrs = E->get()->skin_bone_indices.ptrw();
+		}
 
-			for (int i = 0; i < len; i++) {
-				Bone &b = bonesptr[order[i]];
+		if (E->get()->skeleton_version != version) {
+			for (uint32_t i = 0; i < bind_count; i++) {
+				StringName bind_name = skin->get_bind_name(i);
+
+				if (bind_name != StringName()) {
+					//bind name used, use this
+					bool found = false;
+					for (int j = 0; j < len; j++) {
+						if (bones[j].name == bind_name) {
+							E->get()->skin_bone_indices_ptrs[i] = j;
+							found = true;
+							break;
+						}
+					}
 
-				if (b.global_pose_override_amount >= 0.999) {
-					b.pose_global = b.global_pose_override;
+					if (!found) {
+						ERR_PRINT("Skin bind #" + itos(i) + " contains named bind '" + String(bind_name) + "' but Skeleton3D has no bone by that name.");
+						E->get()->skin_bone_indices_ptrs[i] = 0;
+					}
+				} else if (skin->get_bind_bone(i) >= 0) {
+					int bind_index = skin->get_bind_bone(i);
+					if (bind_index >= len) {
+						ERR_PRINT("Skin bind #" + itos(i) + " contains bone index bind: " + itos(bind_index) + " , which is greater than the skeleton bone count: " + itos(len) + ".");
+						E->get()->skin_bone_indices_ptrs[i] = 0;
+					} else {
+						E->get()->skin_bone_indices_ptrs[i] = bind_index;
+					}
 				} else {
-					if (b.disable_rest) {
-						if (b.enabled) {
-							Transform pose = b.pose;
-							if (b.custom_pose_enable) {
-								pose = b.custom_pose * pose;
-							}
-							if (b.parent >= 0) {
-								b.pose_global = bonesptr[b.parent].pose_global * pose;
-							} else {
-								b.pose_global = pose;
-							}
+					ERR_PRINT("Skin bind #" + itos(i) + " does not contain a name nor a bone index.");
+					E->get()->skin_bone_indices_ptrs[i] = 0;
+				}
+			}
+
+			E->get()->skeleton_version = version;
+		}
+
+		E->get()->skin_buffer.resize(bind_count * 12);
+	}
+}
+
+void Skeleton3D::_update_poses() {
+	Bone *bonesptr = bones.ptrw();
+	int len = bones.size();
+
+	if (len) {
+		Transform *globals = &bone_global_poses[0];
+		const int *order = process_order.ptr();
+
+		for (int i = 0; i < len; i++) {
+			int idx = order[i];
+			Bone &b = bonesptr[idx];
+
+			if (b.global_pose_override_amount >= 0.999) {
+				globals[idx] = b.global_pose_override;
+			} else {
+				if (b.disable_rest) {
+					if (b.enabled) {
+						Transform pose = b.pose;
+						if (b.custom_pose_enable) {
+							pose = b.custom_pose * pose;
+						}
+						if (b.parent >= 0) {
+							globals[idx] = globals[b.parent] * pose;
 						} else {
-							if (b.parent >= 0) {
-								b.pose_global = bonesptr[b.parent].pose_global;
-							} else {
-								b.pose_global = Transform();
-							}
+							globals[idx] = pose;
 						}
-
 					} else {
-						if (b.enabled) {
-							Transform pose = b.pose;
-							if (b.custom_pose_enable) {
-								pose = b.custom_pose * pose;
-							}
-							if (b.parent >= 0) {
-								b.pose_global = bonesptr[b.parent].pose_global * (b.rest * pose);
-							} else {
-								b.pose_global = b.rest * pose;
-							}
+						if (b.parent >= 0) {
+							globals[idx] = globals[b.parent];
 						} else {
-							if (b.parent >= 0) {
-								b.pose_global = bonesptr[b.parent].pose_global * b.rest;
-							} else {
-								b.pose_global = b.rest;
-							}
+							globals[idx] = Transform();
 						}
 					}
 
-					if (b.global_pose_override_amount >= CMP_EPSILON) {
-						b.pose_global = b.pose_global.interpolate_with(b.global_pose_override, b.global_pose_override_amount);
+				} else {
+					if (b.enabled) {
+						Transform pose = b.pose;
+						if (b.custom_pose_enable) {
+							pose = b.custom_pose * pose;
+						}
+						if (b.parent >= 0) {
+							globals[idx] = globals[b.parent] * (b.rest * pose);
+						} else {
+							globals[idx] = b.rest * pose;
+						}
+					} else {
+						if (b.parent >= 0) {
+							globals[idx] = globals[b.parent] * b.rest;
+						} else {
+							globals[idx] = b.rest;
+						}
 					}
 				}
 
-				if (b.global_pose_override_reset) {
-					b.global_pose_override_amount = 0.0;
+				if (b.global_pose_override_amount >= CMP_EPSILON) {
+					globals[idx] = globals[idx].interpolate_with(b.global_pose_override, b.global_pose_override_amount);
 				}
+			}
 
-				for (List<ObjectID>::Element *E = b.nodes_bound.front(); E; E = E->next()) {
-					Object *obj = ObjectDB::get_instance(E->get());
-					ERR_CONTINUE(!obj);
-					Node3D *node_3d = Object::cast_to<Node3D>(obj);
-					ERR_CONTINUE(!node_3d);
-					node_3d->set_transform(b.pose_global);
-				}
+			if (b.global_pose_override_reset) {
+				b.global_pose_override_amount = 0.0;
 			}
+		}
+	}
 
-			//update skins
-			for (Set<SkinReference *>::Element *E = skin_bindings.front(); E; E = E->next()) {
-				const Skin *skin = E->get()->skin.operator->();
-				RID skeleton = E->get()->skeleton;
-				uint32_t bind_count = skin->get_bind_count();
-
-				if (E->get()->bind_count != bind_count) {
-					RS::get_singleton()->skeleton_allocate(skeleton, bind_count);
-					E->get()->bind_count = bind_count;
-					E->get()->skin_bone_indices.resize(bind_count);
-					E->get()->skin_bone_indices_ptrs = E->get()->skin_bone_indices.ptrw();
-				}
+	//compute skin matrices
+	for (Set<SkinReference *>::Element *E = skin_bindings.front(); E; E = E->next()) {
+		const Skin *skin = E->get()->skin.operator->();
+		uint32_t bind_count = E->get()->bind_count;
+		float *dataptr = E->get()->skin_buffer.ptrw();
+
+		for (uint32_t i = 0; i < bind_count; i++) {
+			uint32_t bone_index = E->get()->skin_bone_indices_ptrs[i];
+			ERR_CONTINUE(bone_index >= (uint32_t)len);
+			Transform t = bone_global_poses[bone_index] * skin->get_bind_pose(i);
+
+			float *row = &dataptr[i * 12];
+			row[0] = t.basis.elements[0][0];
+			row[1] = t.basis.elements[0][1];
+			row[2] = t.basis.elements[0][2];
+			row[3] = t.origin.x;
+			row[4] = t.basis.elements[1][0];
+			row[5] = t.basis.elements[1][1];
+			row[6] = t.basis.elements[1][2];
+			row[7] = t.origin.y;
+			row[8] = t.basis.elements[2][0];
+			row[9] = t.basis.elements[2][1];
+			row[10] = t.basis.elements[2][2];
+			row[11] = t.origin.z;
+		}
+	}
+}
 
-				if (E->get()->skeleton_version != version) {
-					for (uint32_t i = 0; i < bind_count; i++) {
-						StringName bind_name = skin->get_bind_name(i);
-
-						if (bind_name != StringName()) {
-							//bind name used, use this
-							bool found = false;
-							for (int j = 0; j < len; j++) {
-								if (bonesptr[j].name == bind_name) {
-									E->get()->skin_bone_indices_ptrs[i] = j;
-									found = true;
-									break;
-								}
-							}
-
-							if (!found) {
-								ERR_PRINT("Skin bind #" + itos(i) + " contains named bind '" + String(bind_name) + "' but Skeleton3D has no bone by that name.");
-								E->get()->skin_bone_indices_ptrs[i] = 0;
-							}
-						} else if (skin->get_bind_bone(i) >= 0) {
-							int bind_index = skin->get_bind_bone(i);
-							if (bind_index >= len) {
-								ERR_PRINT("Skin bind #" + itos(i) + " contains bone index bind: " + itos(bind_index) + " , which is greater than the skeleton bone count: " + itos(len) + ".");
-								E->get()->skin_bone_indices_ptrs[i] = 0;
-							} else {
-								E->get()->skin_bone_indices_ptrs[i] = bind_index;
-							}
-						} else {
-							ERR_PRINT("Skin bind #" + itos(i) + " does not contain a name nor a bone index.");
-							E->get()->skin_bone_indices_ptrs[i] = 0;
-						}
-					}
+void Skeleton3D::_update_end() {
+	const Bone *bonesptr = bones.ptr();
+	int len = bones.size();
 
-					E->get()->skeleton_version = version;
-				}
+	for (int i = 0; i < len; i++) {
+		for (const List<ObjectID>::Element *E = bonesptr[i].nodes_bound.front(); E; E = E->next()) {
+			Object *obj = ObjectDB::get_instance(E->get());
+			ERR_CONTINUE(!obj);
+			Node3D *node_3d = Object::cast_to<Node3D>(obj);
+			ERR_CONTINUE(!node_3d);
+			node_3d->set_transform(bone_global_poses[i]);
+		}
+	}
 
-				for (uint32_t i = 0; i < bind_count; i++) {
-					uint32_t bone_index = E->get()->skin_bone_indices_ptrs[i];
-					ERR_CONTINUE(bone_index >= (uint32_t)len);
-					rs->skeleton_bone_set_transform(skeleton, i, bonesptr[bone_index].pose_global * skin->get_bind_pose(i));
-				}
-			}
+	//update skins
+	RenderingServer *rs = RenderingServer::get_singleton();
+	for (Set<SkinReference *>::Element *E = skin_bindings.front(); E; E = E->next()) {
+		if (E->get()->bind_count) {
+			rs->skeleton_set_buffer(E->get()->skeleton, E->get()->skin_buffer);
+		}
+	}
 
-			dirty = false;
+	dirty = false;
 
 #ifdef TOOLS_ENABLED
-			emit_signal(SceneStringNames::get_singleton()->pose_updated);
+	emit_signal(SceneStringNames::get_singleton()->pose_updated);
 #endif // TOOLS_ENABLED
+}
 
+void Skeleton3D::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_ENTER_TREE: {
+			if (dirty) {
+				get_tree()->skeleton_update_list.add(&skeleton_update);
+			}
+		} break;
+		case NOTIFICATION_EXIT_TREE: {
+			if (skeleton_update.in_list()) {
+				// Still pending, update it through the message queue instead.
+				get_tree()->skeleton_update_list.remove(&skeleton_update);
+				MessageQueue::get_singleton()->push_notification(this, NOTIFICATION_UPDATE_SKELETON);
+			}
+		} break;
+		case NOTIFICATION_UPDATE_SKELETON: {
+			if (skeleton_update.in_list()) {
+				get_tree()->skeleton_update_list.remove(&skeleton_update);
+			}
+
+			_update_begin();
+			_update_poses();
+			_update_end();
 		} break;
 
 #ifndef _3D_DISABLED
@@ -399,10 +468,10 @@ void Skeleton3D::set_bone_global_pose_override(int p_bone, const Transform &p_po
 
 Transform Skeleton3D::get_bone_global_pose(int p_bone) const {
 	ERR_FAIL_INDEX_V(p_bone, bones.size(), Transform());
-	if (dirty) {
+	if (dirty || (int)bone_global_poses.size() != bones.size()) {
 		const_cast<Skeleton3D *>(this)->notification(NOTIFICATION_UPDATE_SKELETON);
 	}
-	return bones[p_bone].pose_global;
+	return bone_global_poses[p_bone];
 }
 
 // skeleton creation api
@@ -599,7 +668,12 @@ void Skeleton3D::_make_dirty() {
 		return;
 	}
 
-	MessageQueue::get_singleton()->push_notification(this, NOTIFICATION_UPDATE_SKELETON);
+	if (is_inside_tree()) {
+		// Updated in a batch with the other dirty skeletons by SceneTree.
+		get_tree()->skeleton_update_list.add(&skeleton_update);
+	} else {
+		MessageQueue::get_singleton()->push_notification(this, NOTIFICATION_UPDATE_SKELETON);
+	}
 	dirty = true;
 }
 
@@ -912,7 +986,8 @@ void Skeleton3D::_bind_methods() {
 	BIND_CONSTANT(NOTIFICATION_UPDATE_SKELETON);
 }
 
-Skeleton3D::Skeleton3D() {
+Skeleton3D::Skeleton3D() :
+		skeleton_update(this) {
 	animate_physical_bones = true;
 	dirty = false;
 	version = 1;
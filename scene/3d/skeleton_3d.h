@@ -31,7 +31,9 @@
 #ifndef SKELETON_3D_H
 #define SKELETON_3D_H
 
+#include "core/local_vector.h"
 #include "core/rid.h"
+#include "core/self_list.h"
 #include "scene/3d/node_3d.h"
 #include "scene/resources/skin.h"
 
@@ -54,6 +56,7 @@ class SkinReference : public Reference {
 	uint64_t skeleton_version = 0;
 	Vector<uint32_t> skin_bone_indices;
 	uint32_t *skin_bone_indices_ptrs;
+	Vector<float> skin_buffer; // 3x4 bone matrices, uploaded with a single skeleton_set_buffer() call.
 	void _skin_changed();
 
 protected:
@@ -70,6 +73,7 @@ class Skeleton3D : public Node3D {
 
 private:
 	friend class SkinReference;
+	friend class SceneTree;
 
 	Set<SkinReference *> skin_bindings;
 
@@ -86,7 +90,6 @@ private:
 		Transform rest;
 
 		Transform pose;
-		Transform pose_global;
 
 		bool custom_pose_enable;
 		Transform custom_pose;
@@ -121,8 +124,17 @@ private:
 	Vector<int> process_order;
 	bool process_order_dirty;
 
+	// Global poses live outside of Bone so the update writes to one tightly packed array.
+	LocalVector<Transform> bone_global_poses;
+
 	void _make_dirty();
 	bool dirty;
+	SelfList<Skeleton3D> skeleton_update;
+
+	// The update is split so SceneTree can run the pose phase of all dirty skeletons in parallel.
+	void _update_begin();
+	void _update_poses();
+	void _update_end();
 
 	uint64_t version;
 
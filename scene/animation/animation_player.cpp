@@ -328,6 +328,13 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 	Animation *a = p_anim->animation.operator->();
 	bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
 
+	// Transform tracks are all sampled in one batch up front.
+	int sample_count = a->get_track_count();
+	transform_samples.resize(sample_count);
+	if (sample_count) {
+		a->transform_tracks_sample(p_time, &transform_samples[0]);
+	}
+
 	for (int i = 0; i < a->get_track_count(); i++) {
 		// If an animation changes this animation (or it animates itself)
 		// we need to recreate our animation cache
@@ -355,17 +362,14 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 					continue;
 				}
 
-				Vector3 loc;
-				Quat rot;
-				Vector3 scale;
-
-				Error err = a->transform_track_interpolate(i, p_time, &loc, &rot, &scale);
-				//ERR_CONTINUE(err!=OK); //used for testing, should be removed
-
-				if (err != OK) {
+				if (i >= sample_count || !transform_samples[i].valid) {
 					continue;
 				}
 
+				const Vector3 &loc = transform_samples[i].loc;
+				const Quat &rot = transform_samples[i].rot;
+				const Vector3 &scale = transform_samples[i].scale;
+
 				if (nc->accum_pass != accum_pass) {
 					ERR_CONTINUE(cache_update_size >= NODE_CACHE_UPDATE_MAX);
 					cache_update[cache_update_size++] = nc;
@@ -31,6 +31,7 @@
 #ifndef ANIMATION_PLAYER_H
 #define ANIMATION_PLAYER_H
 
+#include "core/local_vector.h"
 #include "scene/2d/node_2d.h"
 #include "scene/3d/node_3d.h"
 #include "scene/3d/skeleton_3d.h"
@@ -158,6 +159,8 @@ private:
 	int cache_update_bezier_size;
 	Set<TrackNodeCache *> playing_caches;
 
+	LocalVector<Animation::TransformTrackSample> transform_samples;
+
 	uint64_t accum_pass;
 	float speed_scale;
 	float default_blend_time;
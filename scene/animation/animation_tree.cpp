@@ -822,6 +822,7 @@ void AnimationTree::_process_graph(float p_delta) {
 			float time = as.time;
 			float delta = as.delta;
 			bool seeked = as.seeked;
+			bool transforms_sampled = false;
 
 			for (int i = 0; i < a->get_track_count(); i++) {
 				NodePath path = a->track_get_path(i);
@@ -903,12 +904,24 @@ void AnimationTree::_process_graph(float p_delta) {
 							prev_time = 0;
 
 						} else {
+							if (!transforms_sampled) {
+								// Sample every transform track of this animation in one batch.
+								transform_samples.resize(a->get_track_count());
+								a->transform_tracks_sample(time, &transform_samples[0]);
+								transforms_sampled = true;
+							}
+
 							Vector3 loc;
 							Quat rot;
 							Vector3 scale;
 
-							Error err = a->transform_track_interpolate(i, time, &loc, &rot, &scale);
-							//ERR_CONTINUE(err!=OK); //used for testing, should be removed
+							Error err = ERR_UNAVAILABLE;
+							if (i < (int)transform_samples.size() && transform_samples[i].valid) {
+								loc = transform_samples[i].loc;
+								rot = transform_samples[i].rot;
+								scale = transform_samples[i].scale;
+								err = OK;
+							}
 
 							if (t->process_pass != process_pass) {
 								t->process_pass = process_pass;
@@ -32,6 +32,7 @@
 #define ANIMATION_GRAPH_PLAYER_H
 
 #include "animation_player.h"
+#include "core/local_vector.h"
 #include "scene/3d/node_3d.h"
 #include "scene/3d/skeleton_3d.h"
 #include "scene/resources/animation.h"
@@ -266,6 +267,8 @@ private:
 	uint64_t setup_pass;
 	uint64_t process_pass;
 
+	LocalVector<Animation::TransformTrackSample> transform_samples;
+
 	bool started;
 
 	NodePath root_motion_track;
@@ -40,7 +40,9 @@
 #include "core/os/os.h"
 #include "core/print_string.h"
 #include "core/project_settings.h"
+#include "core/thread_work_pool.h"
 #include "node.h"
+#include "scene/3d/skeleton_3d.h"
 #include "scene/debugger/scene_debugger.h"
 #include "scene/resources/dynamic_font.h"
 #include "scene/resources/material.h"
@@ -159,6 +161,39 @@ void SceneTree::flush_transform_notifications() {
 	}
 }
 
+void SceneTree::_update_skeleton_poses(uint32_t p_index, Skeleton3D **p_skeletons) {
+	p_skeletons[p_index]->_update_poses();
+}
+
+void SceneTree::_flush_skeleton_updates() {
+	if (!skeleton_update_list.first()) {
+		return;
+	}
+
+	skeleton_updates.clear();
+	while (SelfList<Skeleton3D> *E = skeleton_update_list.first()) {
+		skeleton_updates.push_back(E->self());
+		skeleton_update_list.remove(E);
+	}
+
+	// Only the pose computation is thread safe, everything touching other nodes
+	// or the rendering server stays on this thread.
+	uint32_t count = skeleton_updates.size();
+	for (uint32_t i = 0; i < count; i++) {
+		skeleton_updates[i]->_update_begin();
+	}
+
+	if (count > 1) {
+		ThreadWorkPool::get_singleton()->do_work(count, this, &SceneTree::_update_skeleton_poses, &skeleton_updates[0]);
+	} else {
+		skeleton_updates[0]->_update_poses();
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		skeleton_updates[i]->_update_end();
+	}
+}
+
 void SceneTree::_flush_ugc() {
 	ugc_locked = true;
 
@@ -419,6 +454,7 @@ bool SceneTree::iteration(float p_time) {
 	_notify_group_pause("physics_process", Node::NOTIFICATION_PHYSICS_PROCESS);
 	_flush_ugc();
 	MessageQueue::get_singleton()->flush(); //small little hack
+	_flush_skeleton_updates();
 	flush_transform_notifications();
 	call_group_flags(GROUP_CALL_REALTIME, "_viewports", "update_worlds");
 	root_lock--;
@@ -455,6 +491,7 @@ bool SceneTree::idle(float p_time) {
 
 	_flush_ugc();
 	MessageQueue::get_singleton()->flush(); //small little hack
+	_flush_skeleton_updates();
 	flush_transform_notifications(); //transforms after world update, to avoid unnecessary enter/exit notifications
 	call_group_flags(GROUP_CALL_REALTIME, "_viewports", "update_worlds");
 
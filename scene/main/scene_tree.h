@@ -32,6 +32,7 @@
 #define SCENE_MAIN_LOOP_H
 
 #include "core/io/multiplayer_api.h"
+#include "core/local_vector.h"
 #include "core/os/main_loop.h"
 #include "core/os/thread_safe.h"
 #include "core/self_list.h"
@@ -47,6 +48,7 @@ class Window;
 class Material;
 class Mesh;
 class SceneDebugger;
+class Skeleton3D;
 
 class SceneTreeTimer : public Reference {
 	GDCLASS(SceneTreeTimer, Reference);
@@ -187,10 +189,16 @@ private:
 	//optimization
 	friend class CanvasItem;
 	friend class Node3D;
+	friend class Skeleton3D;
 	friend class Viewport;
 
 	SelfList<Node>::List xform_change_list;
 
+	SelfList<Skeleton3D>::List skeleton_update_list;
+	LocalVector<Skeleton3D *> skeleton_updates;
+	void _update_skeleton_poses(uint32_t p_index, Skeleton3D **p_skeletons);
+	void _flush_skeleton_updates();
+
 #ifdef DEBUG_ENABLED // No live editor in release build.
 	friend class LiveEditor;
 #endif
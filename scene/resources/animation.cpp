@@ -76,6 +76,8 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 			track_set_imported(track, p_value);
 		} else if (what == "enabled") {
 			track_set_enabled(track, p_value);
+		} else if (what == "compressed") {
+			transform_track_set_compressed(track, p_value);
 		} else if (what == "keys" || what == "key_values") {
 			if (track_get_type(track) == TYPE_TRANSFORM) {
 				TransformTrack *tt = static_cast<TransformTrack *>(tracks[track]);
@@ -83,6 +85,8 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 				int vcount = values.size();
 				ERR_FAIL_COND_V(vcount % 12, false); // should be multiple of 11
 
+				_transform_track_decompress(tt);
+
 				const float *r = values.ptr();
 
 				tt->transforms.resize(vcount / 12);
@@ -352,6 +356,8 @@ bool Animation::_get(const StringName &p_name, Variant &r_ret) const {
 			r_ret = track_is_imported(track);
 		} else if (what == "enabled") {
 			r_ret = track_is_enabled(track);
+		} else if (what == "compressed") {
+			r_ret = transform_track_is_compressed(track);
 		} else if (what == "keys") {
 			if (track_get_type(track) == TYPE_TRANSFORM) {
 				Vector<float> keys;
@@ -579,6 +585,10 @@ void Animation::_get_property_list(List<PropertyInfo> *p_list) const {
 		p_list->push_back(PropertyInfo(Variant::BOOL, "tracks/" + itos(i) + "/imported", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::BOOL, "tracks/" + itos(i) + "/enabled", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::ARRAY, "tracks/" + itos(i) + "/keys", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
+		if (tracks[i]->type == TYPE_TRANSFORM && static_cast<const TransformTrack *>(tracks[i])->compressed) {
+			// Listed after the keys so loading compresses them once they are set.
+			p_list->push_back(PropertyInfo(Variant::BOOL, "tracks/" + itos(i) + "/compressed", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
+		}
 	}
 }
 
@@ -629,6 +639,7 @@ void Animation::remove_track(int p_track) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
 			_clear(tt->transforms);
+			_clear(tt->compressed_keys);
 
 		} break;
 		case TYPE_VALUE: {
@@ -772,22 +783,254 @@ void Animation::_clear(T &p_keys) {
 	p_keys.clear();
 }
 
+/* TRANSFORM TRACK COMPRESSION */
+
+static _FORCE_INLINE_ uint16_t _quantize_unit(float p_value, uint16_t p_max) {
+	return CLAMP(Math::fast_ftoi(p_value * p_max + 0.5f), 0, p_max);
+}
+
+static void _compress_vector3s(const Vector<Vector3> &p_values, Vector3 &r_min, Vector3 &r_range, Vector<uint16_t> &r_quantized) {
+	int count = p_values.size();
+	const Vector3 *src = p_values.ptr();
+
+	Vector3 min = src[0];
+	Vector3 max = src[0];
+	for (int i = 1; i < count; i++) {
+		for (int j = 0; j < 3; j++) {
+			min[j] = MIN(min[j], src[i][j]);
+			max[j] = MAX(max[j], src[i][j]);
+		}
+	}
+
+	r_min = min;
+	r_range = max - min;
+	r_quantized.clear();
+
+	if (r_range.is_equal_approx(Vector3())) {
+		r_range = Vector3();
+		return; // Constant, r_min holds the value.
+	}
+
+	r_quantized.resize(count * 3);
+	uint16_t *dst = r_quantized.ptrw();
+	for (int i = 0; i < count; i++) {
+		for (int j = 0; j < 3; j++) {
+			float c = r_range[j] > 0 ? (src[i][j] - min[j]) / r_range[j] : 0;
+			dst[i * 3 + j] = _quantize_unit(c, 0xFFFF);
+		}
+	}
+}
+
+static _FORCE_INLINE_ Vector3 _decompress_vector3(const Vector3 &p_min, const Vector3 &p_range, const Vector<uint16_t> &p_quantized, int p_index) {
+	if (p_quantized.empty()) {
+		return p_min;
+	}
+	const uint16_t *q = &p_quantized[p_index * 3];
+	const float s = 1.0f / 0xFFFF;
+	return Vector3(p_min.x + p_range.x * (q[0] * s), p_min.y + p_range.y * (q[1] * s), p_min.z + p_range.z * (q[2] * s));
+}
+
+// Smallest three: drop the largest component (recomputed from the unit length),
+// store the other three in 15 bits each, the dropped index in the first two top
+// bits and its sign in the third. q and -q are the same rotation, but keeping the
+// sign of the keys keeps cubic interpolation (cubic_slerp() does not pick the
+// shortest path between the outer keys) the same as on uncompressed tracks.
+static void _compress_quat(const Quat &p_quat, uint16_t *r_quantized) {
+	Quat q = p_quat.normalized();
+	float c[4] = { q.x, q.y, q.z, q.w };
+
+	int largest = 0;
+	for (int i = 1; i < 4; i++) {
+		if (Math::abs(c[i]) > Math::abs(c[largest])) {
+			largest = i;
+		}
+	}
+	float sign = c[largest] < 0 ? -1.0f : 1.0f;
+
+	int ofs = 0;
+	for (int i = 0; i < 4; i++) {
+		if (i == largest) {
+			continue;
+		}
+		float v = c[i] * sign * (float)Math_SQRT2; // Remaining components are within +-sqrt(0.5).
+		r_quantized[ofs++] = _quantize_unit(v * 0.5f + 0.5f, 0x7FFF);
+	}
+
+	r_quantized[0] |= (largest & 1) << 15;
+	r_quantized[1] |= (largest >> 1) << 15;
+	r_quantized[2] |= (sign < 0 ? 1 : 0) << 15;
+}
+
+static _FORCE_INLINE_ Quat _decompress_quat(const uint16_t *p_quantized) {
+	int largest = (p_quantized[0] >> 15) | ((p_quantized[1] >> 15) << 1);
+	float c[4];
+	float sum = 0;
+
+	int ofs = 0;
+	for (int i = 0; i < 4; i++) {
+		if (i == largest) {
+			continue;
+		}
+		float v = ((p_quantized[ofs++] & 0x7FFF) * (1.0f / 0x7FFF) * 2.0f - 1.0f) * (float)Math_SQRT12;
+		c[i] = v;
+		sum += v * v;
+	}
+	c[largest] = Math::sqrt(MAX(0.0f, 1.0f - sum));
+
+	if (p_quantized[2] >> 15) {
+		return Quat(-c[0], -c[1], -c[2], -c[3]);
+	}
+	return Quat(c[0], c[1], c[2], c[3]);
+}
+
+int Animation::_transform_track_get_key_count(const TransformTrack *p_track) const {
+	return p_track->compressed ? p_track->compressed_keys.size() : p_track->transforms.size();
+}
+
+const Animation::Key &Animation::_transform_track_get_key_time(const TransformTrack *p_track, int p_key) const {
+	if (p_track->compressed) {
+		return p_track->compressed_keys[p_key];
+	}
+	return p_track->transforms[p_key];
+}
+
+void Animation::_transform_track_decode_key(const TransformTrack *p_track, int p_key, TransformKey &r_key) const {
+	if (!p_track->compressed) {
+		r_key = p_track->transforms[p_key].value;
+		return;
+	}
+
+	r_key.loc = _decompress_vector3(p_track->loc_min, p_track->loc_range, p_track->loc, p_key);
+	r_key.rot = p_track->rot.empty() ? p_track->rot_constant : _decompress_quat(&p_track->rot[p_key * 3]);
+	r_key.scale = _decompress_vector3(p_track->scale_min, p_track->scale_range, p_track->scale, p_key);
+}
+
+void Animation::_transform_track_compress(TransformTrack *p_track) {
+	if (p_track->compressed) {
+		return;
+	}
+
+	int count = p_track->transforms.size();
+	const TKey<TransformKey> *src = p_track->transforms.ptr();
+
+	Vector<Key> keys;
+	keys.resize(count);
+	Vector<Vector3> locs;
+	locs.resize(count);
+	Vector<Vector3> scales;
+	scales.resize(count);
+
+	bool rot_constant = true;
+	for (int i = 0; i < count; i++) {
+		keys.write[i].time = src[i].time;
+		keys.write[i].transition = src[i].transition;
+		locs.write[i] = src[i].value.loc;
+		scales.write[i] = src[i].value.scale;
+		rot_constant = rot_constant && src[i].value.rot.is_equal_approx(src[0].value.rot);
+	}
+
+	// Share the key times with another compressed track when they match, which is
+	// the common case for imported (baked) animations.
+	for (int i = 0; i < tracks.size(); i++) {
+		if (tracks[i]->type != TYPE_TRANSFORM) {
+			continue;
+		}
+		const TransformTrack *other = static_cast<const TransformTrack *>(tracks[i]);
+		if (other == p_track || !other->compressed || other->compressed_keys.size() != count) {
+			continue;
+		}
+		if (count && memcmp(other->compressed_keys.ptr(), keys.ptr(), sizeof(Key) * count) != 0) {
+			continue;
+		}
+		keys = other->compressed_keys;
+		break;
+	}
+
+	p_track->compressed_keys = keys;
+
+	if (count) {
+		_compress_vector3s(locs, p_track->loc_min, p_track->loc_range, p_track->loc);
+		_compress_vector3s(scales, p_track->scale_min, p_track->scale_range, p_track->scale);
+	}
+
+	p_track->rot.clear();
+	p_track->rot_constant = Quat();
+	if (count && rot_constant) {
+		p_track->rot_constant = src[0].value.rot;
+	} else if (count) {
+		p_track->rot.resize(count * 3);
+		uint16_t *dst = p_track->rot.ptrw();
+		for (int i = 0; i < count; i++) {
+			_compress_quat(src[i].value.rot, &dst[i * 3]);
+		}
+	}
+
+	p_track->transforms.clear();
+	p_track->compressed = true;
+}
+
+void Animation::_transform_track_decompress(TransformTrack *p_track) {
+	if (!p_track->compressed) {
+		return;
+	}
+
+	int count = p_track->compressed_keys.size();
+	p_track->transforms.resize(count);
+	for (int i = 0; i < count; i++) {
+		TKey<TransformKey> &tk = p_track->transforms.write[i];
+		tk.time = p_track->compressed_keys[i].time;
+		tk.transition = p_track->compressed_keys[i].transition;
+		_transform_track_decode_key(p_track, i, tk.value);
+	}
+
+	p_track->compressed = false;
+	p_track->compressed_keys.clear();
+	p_track->loc.clear();
+	p_track->rot.clear();
+	p_track->scale.clear();
+}
+
+void Animation::transform_track_set_compressed(int p_track, bool p_compressed) {
+	ERR_FAIL_INDEX(p_track, tracks.size());
+	Track *t = tracks[p_track];
+	ERR_FAIL_COND(t->type != TYPE_TRANSFORM);
+
+	TransformTrack *tt = static_cast<TransformTrack *>(t);
+	if (p_compressed) {
+		_transform_track_compress(tt);
+	} else {
+		_transform_track_decompress(tt);
+	}
+	emit_changed();
+}
+
+bool Animation::transform_track_is_compressed(int p_track) const {
+	ERR_FAIL_INDEX_V(p_track, tracks.size(), false);
+	Track *t = tracks[p_track];
+	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, false);
+
+	return static_cast<TransformTrack *>(t)->compressed;
+}
+
 Error Animation::transform_track_get_key(int p_track, int p_key, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const {
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), ERR_INVALID_PARAMETER);
 	Track *t = tracks[p_track];
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, ERR_INVALID_PARAMETER);
-	ERR_FAIL_INDEX_V(p_key, tt->transforms.size(), ERR_INVALID_PARAMETER);
+	ERR_FAIL_INDEX_V(p_key, _transform_track_get_key_count(tt), ERR_INVALID_PARAMETER);
+
+	TransformKey key;
+	_transform_track_decode_key(tt, p_key, key);
 
 	if (r_loc) {
-		*r_loc = tt->transforms[p_key].value.loc;
+		*r_loc = key.loc;
 	}
 	if (r_rot) {
-		*r_rot = tt->transforms[p_key].value.rot;
+		*r_rot = key.rot;
 	}
 	if (r_scale) {
-		*r_scale = tt->transforms[p_key].value.scale;
+		*r_scale = key.scale;
 	}
 
 	return OK;
@@ -799,6 +1042,7 @@ int Animation::transform_track_insert_key(int p_track, float p_time, const Vecto
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, -1);
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
+	_transform_track_decompress(tt);
 
 	TKey<TransformKey> tkey;
 	tkey.time = p_time;
@@ -824,6 +1068,7 @@ void Animation::track_remove_key(int p_track, int p_idx) {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_idx, tt->transforms.size());
 			tt->transforms.remove(p_idx);
 
@@ -870,11 +1115,11 @@ int Animation::track_find_key(int p_track, float p_time, bool p_exact) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			int k = _find(tt->transforms, p_time);
-			if (k < 0 || k >= tt->transforms.size()) {
+			int k = tt->compressed ? _find(tt->compressed_keys, p_time) : _find(tt->transforms, p_time);
+			if (k < 0 || k >= _transform_track_get_key_count(tt)) {
 				return -1;
 			}
-			if (tt->transforms[k].time != p_time && p_exact) {
+			if (_transform_track_get_key_time(tt, k).time != p_time && p_exact) {
 				return -1;
 			}
 			return k;
@@ -1054,7 +1299,7 @@ int Animation::track_get_key_count(int p_track) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			return tt->transforms.size();
+			return _transform_track_get_key_count(tt);
 		} break;
 		case TYPE_VALUE: {
 			ValueTrack *vt = static_cast<ValueTrack *>(t);
@@ -1089,12 +1334,15 @@ Variant Animation::track_get_key_value(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), Variant());
+			ERR_FAIL_INDEX_V(p_key_idx, _transform_track_get_key_count(tt), Variant());
+
+			TransformKey key;
+			_transform_track_decode_key(tt, p_key_idx, key);
 
 			Dictionary d;
-			d["location"] = tt->transforms[p_key_idx].value.loc;
-			d["rotation"] = tt->transforms[p_key_idx].value.rot;
-			d["scale"] = tt->transforms[p_key_idx].value.scale;
+			d["location"] = key.loc;
+			d["rotation"] = key.rot;
+			d["scale"] = key.scale;
 
 			return d;
 		} break;
@@ -1157,8 +1405,8 @@ float Animation::track_get_key_time(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
-			return tt->transforms[p_key_idx].time;
+			ERR_FAIL_INDEX_V(p_key_idx, _transform_track_get_key_count(tt), -1);
+			return _transform_track_get_key_time(tt, p_key_idx).time;
 		} break;
 		case TYPE_VALUE: {
 			ValueTrack *vt = static_cast<ValueTrack *>(t);
@@ -1202,6 +1450,7 @@ void Animation::track_set_key_time(int p_track, int p_key_idx, float p_time) {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			TKey<TransformKey> key = tt->transforms[p_key_idx];
 			key.time = p_time;
@@ -1266,8 +1515,8 @@ float Animation::track_get_key_transition(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
-			return tt->transforms[p_key_idx].transition;
+			ERR_FAIL_INDEX_V(p_key_idx, _transform_track_get_key_count(tt), -1);
+			return _transform_track_get_key_time(tt, p_key_idx).transition;
 		} break;
 		case TYPE_VALUE: {
 			ValueTrack *vt = static_cast<ValueTrack *>(t);
@@ -1302,6 +1551,7 @@ void Animation::track_set_key_value(int p_track, int p_key_idx, const Variant &p
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 
 			Dictionary d = p_value;
@@ -1385,6 +1635,7 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, float p_tra
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			tt->transforms.write[p_key_idx].transition = p_transition;
 		} break;
@@ -1582,30 +1833,26 @@ float Animation::_cubic_interpolate(const float &p_pre_a, const float &p_a, cons
 	return _interpolate(p_a, p_b, p_c);
 }
 
-template <class T>
-T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const {
+template <class K>
+bool Animation::_find_interpolation_span(const Vector<K> &p_keys, float p_time, bool p_loop_wrap, InterpolationSpan &r_span) const {
 	int len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
 
 	if (len <= 0) {
 		// (-1 or -2 returned originally) (plus one above)
 		// meaning no keys, or only key time is larger than length
-		if (p_ok) {
-			*p_ok = false;
-		}
-		return T();
+		return false;
 	} else if (len == 1) { // one key found (0+1), return it
 
-		if (p_ok) {
-			*p_ok = true;
-		}
-		return p_keys[0].value;
+		r_span.idx = r_span.next = 0;
+		r_span.len = 1;
+		r_span.c = 0;
+		return true;
 	}
 
 	int idx = _find(p_keys, p_time);
 
-	ERR_FAIL_COND_V(idx == -2, T());
+	ERR_FAIL_COND_V(idx == -2, false);
 
-	bool result = true;
 	int next = 0;
 	float c = 0;
 	// prepare for all cases of interpolation
@@ -1677,11 +1924,32 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, Interpola
 			if (loop) {
 				idx = next = 0;
 			} else {
-				result = false;
+				return false;
 			}
 		}
 	}
 
+	float tr = p_keys[idx].transition;
+
+	if (tr == 0) {
+		// don't interpolate if not needed
+		next = idx;
+	} else if (tr != 1.0 && idx != next) {
+		c = Math::ease(c, tr);
+	}
+
+	r_span.idx = idx;
+	r_span.next = next;
+	r_span.len = len;
+	r_span.c = c;
+	return true;
+}
+
+template <class T>
+T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const {
+	InterpolationSpan span;
+	bool result = _find_interpolation_span(p_keys, p_time, p_loop_wrap, span);
+
 	if (p_ok) {
 		*p_ok = result;
 	}
@@ -1689,23 +1957,20 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, Interpola
 		return T();
 	}
 
-	float tr = p_keys[idx].transition;
+	int idx = span.idx;
+	int next = span.next;
 
-	if (tr == 0 || idx == next) {
+	if (idx == next) {
 		// don't interpolate if not needed
 		return p_keys[idx].value;
 	}
 
-	if (tr != 1.0) {
-		c = Math::ease(c, tr);
-	}
-
 	switch (p_interp) {
 		case INTERPOLATION_NEAREST: {
 			return p_keys[idx].value;
 		} break;
 		case INTERPOLATION_LINEAR: {
-			return _interpolate(p_keys[idx].value, p_keys[next].value, c);
+			return _interpolate(p_keys[idx].value, p_keys[next].value, span.c);
 		} break;
 		case INTERPOLATION_CUBIC: {
 			int pre = idx - 1;
@@ -1713,11 +1978,11 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, Interpola
 				pre = 0;
 			}
 			int post = next + 1;
-			if (post >= len) {
+			if (post >= span.len) {
 				post = next;
 			}
 
-			return _cubic_interpolate(p_keys[pre].value, p_keys[idx].value, p_keys[next].value, p_keys[post].value, c);
+			return _cubic_interpolate(p_keys[pre].value, p_keys[idx].value, p_keys[next].value, p_keys[post].value, span.c);
 
 		} break;
 		default:
@@ -1727,6 +1992,34 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, Interpola
 	// do a barrel roll
 }
 
+Animation::TransformKey Animation::_transform_track_interpolate_span(const TransformTrack *p_track, const InterpolationSpan &p_span) const {
+	TransformKey a;
+	_transform_track_decode_key(p_track, p_span.idx, a);
+
+	if (p_span.idx == p_span.next || p_track->interpolation == INTERPOLATION_NEAREST) {
+		return a;
+	}
+
+	TransformKey b;
+	_transform_track_decode_key(p_track, p_span.next, b);
+
+	if (p_track->interpolation == INTERPOLATION_CUBIC) {
+		int pre = MAX(p_span.idx - 1, 0);
+		int post = p_span.next + 1;
+		if (post >= p_span.len) {
+			post = p_span.next;
+		}
+
+		TransformKey pre_a;
+		TransformKey post_b;
+		_transform_track_decode_key(p_track, pre, pre_a);
+		_transform_track_decode_key(p_track, post, post_b);
+		return _cubic_interpolate(pre_a, a, b, post_b, p_span.c);
+	}
+
+	return _interpolate(a, b, p_span.c);
+}
+
 Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const {
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), ERR_INVALID_PARAMETER);
 	Track *t = tracks[p_track];
@@ -1736,7 +2029,16 @@ Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3
 
 	bool ok = false;
 
-	TransformKey tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+	TransformKey tk;
+	if (tt->compressed) {
+		InterpolationSpan span;
+		ok = _find_interpolation_span(tt->compressed_keys, p_time, tt->loop_wrap, span);
+		if (ok) {
+			tk = _transform_track_interpolate_span(tt, span);
+		}
+	} else {
+		tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+	}
 
 	if (!ok) {
 		return ERR_UNAVAILABLE;
@@ -1757,6 +2059,52 @@ Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3
 	return OK;
 }
 
+void Animation::transform_tracks_sample(float p_time, TransformTrackSample *r_samples) const {
+	// Tracks compressed together share their key times, so the span found for
+	// one of them is reused for the following ones instead of searching again.
+	const Key *span_keys = nullptr;
+	bool span_loop_wrap = false;
+	bool span_ok = false;
+	InterpolationSpan span;
+
+	for (int i = 0; i < tracks.size(); i++) {
+		TransformTrackSample &sample = r_samples[i];
+		sample.valid = false;
+
+		const Track *t = tracks[i];
+		if (t->type != TYPE_TRANSFORM) {
+			continue;
+		}
+
+		const TransformTrack *tt = static_cast<const TransformTrack *>(t);
+
+		TransformKey tk;
+		if (tt->compressed) {
+			const Key *keys = tt->compressed_keys.ptr();
+			if (keys != span_keys || tt->loop_wrap != span_loop_wrap) {
+				span_keys = keys;
+				span_loop_wrap = tt->loop_wrap;
+				span_ok = _find_interpolation_span(tt->compressed_keys, p_time, tt->loop_wrap, span);
+			}
+			if (!span_ok) {
+				continue;
+			}
+			tk = _transform_track_interpolate_span(tt, span);
+		} else {
+			bool ok = false;
+			tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+			if (!ok) {
+				continue;
+			}
+		}
+
+		sample.loc = tk.loc;
+		sample.rot = tk.rot;
+		sample.scale = tk.scale;
+		sample.valid = true;
+	}
+}
+
 Variant Animation::value_track_interpolate(int p_track, float p_time) const {
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), 0);
 	Track *t = tracks[p_track];
@@ -1933,8 +2281,13 @@ void Animation::track_get_key_indices_in_range(int p_track, float p_time, float
 			switch (t->type) {
 				case TYPE_TRANSFORM: {
 					const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-					_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
-					_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					if (tt->compressed) {
+						_track_get_key_indices_in_range(tt->compressed_keys, from_time, length, p_indices);
+						_track_get_key_indices_in_range(tt->compressed_keys, 0, to_time, p_indices);
+					} else {
+						_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
+						_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					}
 
 				} break;
 				case TYPE_VALUE: {
@@ -1989,7 +2342,11 @@ void Animation::track_get_key_indices_in_range(int p_track, float p_time, float
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-			_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+			if (tt->compressed) {
+				_track_get_key_indices_in_range(tt->compressed_keys, from_time, to_time, p_indices);
+			} else {
+				_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+			}
 
 		} break;
 		case TYPE_VALUE: {
@@ -2581,6 +2938,9 @@ void Animation::copy_track(int p_track, Ref<Animation> p_to_animation) {
 	for (int i = 0; i < track_get_key_count(p_track); i++) {
 		p_to_animation->track_insert_key(dst_track, track_get_key_time(p_track, i), track_get_key_value(p_track, i), track_get_key_transition(p_track, i));
 	}
+	if (track_get_type(p_track) == TYPE_TRANSFORM && transform_track_is_compressed(p_track)) {
+		p_to_animation->transform_track_set_compressed(dst_track, true);
+	}
 }
 
 void Animation::_bind_methods() {
@@ -2624,6 +2984,8 @@ void Animation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("track_get_interpolation_loop_wrap", "track_idx"), &Animation::track_get_interpolation_loop_wrap);
 
 	ClassDB::bind_method(D_METHOD("transform_track_interpolate", "track_idx", "time_sec"), &Animation::_transform_track_interpolate);
+	ClassDB::bind_method(D_METHOD("transform_track_set_compressed", "track_idx", "compressed"), &Animation::transform_track_set_compressed);
+	ClassDB::bind_method(D_METHOD("transform_track_is_compressed", "track_idx"), &Animation::transform_track_is_compressed);
 	ClassDB::bind_method(D_METHOD("value_track_set_update_mode", "track_idx", "mode"), &Animation::value_track_set_update_mode);
 	ClassDB::bind_method(D_METHOD("value_track_get_update_mode", "track_idx"), &Animation::value_track_get_update_mode);
 
@@ -2668,6 +3030,7 @@ void Animation::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("clear"), &Animation::clear);
 	ClassDB::bind_method(D_METHOD("copy_track", "track_idx", "to_animation"), &Animation::copy_track);
+	ClassDB::bind_method(D_METHOD("compress", "reduce_keys"), &Animation::compress, DEFVAL(true));
 
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "length", PROPERTY_HINT_RANGE, "0.001,99999,0.001"), "set_length", "get_length");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "loop"), "set_loop", "has_loop");
@@ -2874,6 +3237,7 @@ void Animation::_transform_track_optimize(int p_idx, float p_allowed_linear_err,
 	ERR_FAIL_INDEX(p_idx, tracks.size());
 	ERR_FAIL_COND(tracks[p_idx]->type != TYPE_TRANSFORM);
 	TransformTrack *tt = static_cast<TransformTrack *>(tracks[p_idx]);
+	_transform_track_decompress(tt);
 	bool prev_erased = false;
 	TKey<TransformKey> first_erased;
 
@@ -2918,6 +3282,23 @@ void Animation::optimize(float p_allowed_linear_err, float p_allowed_angular_err
 	}
 }
 
+void Animation::compress(bool p_reduce_keys) {
+	for (int i = 0; i < tracks.size(); i++) {
+		if (tracks[i]->type != TYPE_TRANSFORM) {
+			continue;
+		}
+		TransformTrack *tt = static_cast<TransformTrack *>(tracks[i]);
+		if (tt->compressed) {
+			continue;
+		}
+		if (p_reduce_keys) {
+			_transform_track_optimize(i);
+		}
+		_transform_track_compress(tt);
+	}
+	emit_changed();
+}
+
 Animation::Animation() {
 	step = 0.1;
 	loop = false;
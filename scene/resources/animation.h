@@ -104,6 +104,22 @@ private:
 	struct TransformTrack : public Track {
 		Vector<TKey<TransformKey>> transforms;
 
+		// Compressed tracks keep only times and transitions as plain keys (shared
+		// between tracks with the same timing) and quantize the values to 16 bits.
+		// Location and scale are range compressed, rotations store the smallest
+		// three quaternion components. A value array is empty when the value is
+		// constant across the whole track, in which case the *_min member holds it.
+		bool compressed = false;
+		Vector<Key> compressed_keys;
+		Vector3 loc_min;
+		Vector3 loc_range;
+		Vector<uint16_t> loc;
+		Quat rot_constant;
+		Vector<uint16_t> rot;
+		Vector3 scale_min;
+		Vector3 scale_range;
+		Vector<uint16_t> scale;
+
 		TransformTrack() { type = TYPE_TRANSFORM; }
 	};
 
@@ -206,9 +222,26 @@ private:
 	_FORCE_INLINE_ Variant _cubic_interpolate(const Variant &p_pre_a, const Variant &p_a, const Variant &p_b, const Variant &p_post_b, float p_c) const;
 	_FORCE_INLINE_ float _cubic_interpolate(const float &p_pre_a, const float &p_a, const float &p_b, const float &p_post_b, float p_c) const;
 
+	struct InterpolationSpan {
+		int idx = 0;
+		int next = 0;
+		int len = 0;
+		float c = 0;
+	};
+
+	template <class K>
+	_FORCE_INLINE_ bool _find_interpolation_span(const Vector<K> &p_keys, float p_time, bool p_loop_wrap, InterpolationSpan &r_span) const;
+
 	template <class T>
 	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T>> &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const;
 
+	void _transform_track_compress(TransformTrack *p_track);
+	void _transform_track_decompress(TransformTrack *p_track);
+	void _transform_track_decode_key(const TransformTrack *p_track, int p_key, TransformKey &r_key) const;
+	_FORCE_INLINE_ int _transform_track_get_key_count(const TransformTrack *p_track) const;
+	_FORCE_INLINE_ const Key &_transform_track_get_key_time(const TransformTrack *p_track, int p_key) const;
+	TransformKey _transform_track_interpolate_span(const TransformTrack *p_track, const InterpolationSpan &p_span) const;
+
 	template <class T>
 	_FORCE_INLINE_ void _track_get_key_indices_in_range(const Vector<T> &p_array, float from_time, float to_time, List<int> *p_indices) const;
 
@@ -331,6 +364,20 @@ public:
 
 	Error transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const;
 
+	struct TransformTrackSample {
+		Vector3 loc;
+		Quat rot;
+		Vector3 scale;
+		bool valid = false;
+	};
+
+	// Samples every transform track at p_time in a single pass. r_samples must hold
+	// get_track_count() entries; entries for other track types are left invalid.
+	void transform_tracks_sample(float p_time, TransformTrackSample *r_samples) const;
+
+	void transform_track_set_compressed(int p_track, bool p_compressed);
+	bool transform_track_is_compressed(int p_track) const;
+
 	Variant value_track_interpolate(int p_track, float p_time) const;
 	void value_track_get_key_indices(int p_track, float p_time, float p_delta, List<int> *p_indices) const;
 	void value_track_set_update_mode(int p_track, UpdateMode p_mode);
@@ -356,6 +403,7 @@ public:
 	void clear();
 
 	void optimize(float p_allowed_linear_err = 0.05, float p_allowed_angular_err = 0.01, float p_max_optimizable_angle = Math_PI * 0.125);
+	void compress(bool p_reduce_keys = true);
 
 	Animation();
 	~Animation();
@@ -45,6 +45,60 @@ bool SceneState::can_instance() const {
 	return nodes.size() > 0;
 }
 
+const SceneState::InstancePlan *SceneState::_get_instance_plan() const {
+	MutexLock lock(instance_plan_mutex);
+
+	if (instance_plan) {
+		return instance_plan;
+	}
+
+	InstancePlan *plan = memnew(InstancePlan);
+	plan->nodes.resize(nodes.size());
+
+	for (int i = 0; i < nodes.size(); i++) {
+		const NodeData &n = nodes[i];
+		InstancePlan::NodeEntry &entry = plan->nodes[i];
+
+		// Inherited, instanced and already existing nodes are not created here.
+		if ((i == 0 && base_scene_idx >= 0) || n.instance >= 0 || n.type == TYPE_INSTANCED) {
+			continue;
+		}
+		if (n.type < 0 || n.type >= names.size()) {
+			continue;
+		}
+
+		StringName type = names[n.type];
+		if (!ClassDB::is_class_enabled(type) || !ClassDB::is_parent_class(type, "Node")) {
+			continue;
+		}
+
+		entry.create = ClassDB::get_creation_func(type);
+		if (!entry.create) {
+			continue;
+		}
+
+		entry.setters.resize(n.properties.size());
+		for (int j = 0; j < n.properties.size(); j++) {
+			int name = n.properties[j].name;
+			if (name >= 0 && name < names.size()) {
+				entry.setters[j].method = ClassDB::get_property_setter_bind(type, names[name], &entry.setters[j].index);
+			}
+		}
+	}
+
+	instance_plan = plan;
+	return plan;
+}
+
+void SceneState::_clear_instance_plan() {
+	MutexLock lock(instance_plan_mutex);
+
+	if (instance_plan) {
+		memdelete(instance_plan);
+		instance_plan = nullptr;
+	}
+}
+
 Node *SceneState::instance(GenEditState p_edit_state) const {
 	// nodes where instancing failed (because something is missing)
 	List<Node *> stray_instances;
@@ -82,10 +136,14 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 
 	bool gen_node_path_cache = p_edit_state != GEN_EDIT_STATE_DISABLED && node_path_cache.empty();
 
+	// Editor instancing keeps resolving everything by name.
+	const InstancePlan *plan = p_edit_state == GEN_EDIT_STATE_DISABLED ? _get_instance_plan() : nullptr;
+
 	Map<Ref<Resource>, Ref<Resource>> resources_local_to_scene;
 
 	for (int i = 0; i < nc; i++) {
 		const NodeData &n = nd[i];
+		const InstancePlan::NodeEntry *planned = plan ? &plan->nodes[i] : nullptr;
 
 		Node *parent = nullptr;
 
@@ -144,6 +202,9 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 				}
 #endif
 			}
+		} else if (planned && planned->create) {
+			node = static_cast<Node *>(planned->create());
+
 		} else if (ClassDB::is_class_enabled(snames[n.type])) {
 			//node belongs to this scene and must be created
 			Object *obj = ClassDB::instance(snames[n.type]);
@@ -183,6 +244,7 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 			int nprop_count = n.properties.size();
 			if (nprop_count) {
 				const NodeData::Property *nprops = &n.properties[0];
+				const InstancePlan::Setter *setters = planned && planned->create ? &planned->setters[0] : nullptr;
 
 				for (int j = 0; j < nprop_count; j++) {
 					bool valid;
@@ -240,7 +302,21 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 						} else if (p_edit_state == GEN_EDIT_STATE_INSTANCE) {
 							value = value.duplicate(true); // Duplicate arrays and dictionaries for the editor
 						}
-						node->set(snames[nprops[j].name], value, &valid);
+
+						if (setters && setters[j].method && !node->get_script_instance()) {
+							// Same as what Object::set() ends up calling when no script claims the property.
+							Callable::CallError ce;
+							if (setters[j].index >= 0) {
+								Variant index = setters[j].index;
+								const Variant *args[2] = { &index, &value };
+								node->call_method_bind(setters[j].method, args, 2, ce);
+							} else {
+								const Variant *args[1] = { &value };
+								node->call_method_bind(setters[j].method, args, 1, ce);
+							}
+						} else {
+							node->set(snames[nprops[j].name], value, &valid);
+						}
 					}
 				}
 			}
@@ -897,6 +973,7 @@ String SceneState::get_path() const {
 }
 
 void SceneState::clear() {
+	_clear_instance_plan();
 	names.clear();
 	variants.clear();
 	nodes.clear();
@@ -1060,6 +1137,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 
 	ERR_FAIL_COND_MSG(version > PACKED_SCENE_VERSION, "Save format version too new.");
 
+	_clear_instance_plan();
+
 	const int node_count = p_dictionary["node_count"];
 	const Vector<int> snodes = p_dictionary["nodes"];
 	ERR_FAIL_COND(snodes.size() < node_count);
@@ -1507,6 +1586,7 @@ int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int
 	nd.instance = p_instance;
 	nd.index = p_index;
 
+	_clear_instance_plan();
 	nodes.push_back(nd);
 
 	return nodes.size() - 1;
@@ -1520,6 +1600,7 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value) {
 	NodeData::Property prop;
 	prop.name = p_name;
 	prop.value = p_value;
+	_clear_instance_plan();
 	nodes.write[p_node].properties.push_back(prop);
 }
 
@@ -1531,6 +1612,7 @@ void SceneState::add_node_group(int p_node, int p_group) {
 
 void SceneState::set_base_scene(int p_idx) {
 	ERR_FAIL_INDEX(p_idx, variants.size());
+	_clear_instance_plan();
 	base_scene_idx = p_idx;
 }
 
@@ -1600,6 +1682,10 @@ SceneState::SceneState() {
 	last_modified_time = 0;
 }
 
+SceneState::~SceneState() {
+	_clear_instance_plan();
+}
+
 ////////////////
 
 void PackedScene::_set_bundled_scene(const Dictionary &p_scene) {
@@ -31,6 +31,8 @@
 #ifndef PACKED_SCENE_H
 #define PACKED_SCENE_H
 
+#include "core/local_vector.h"
+#include "core/os/mutex.h"
 #include "core/resource.h"
 #include "scene/main/node.h"
 
@@ -88,6 +90,28 @@ class SceneState : public Reference {
 
 	Vector<ConnectionData> connections;
 
+	// What instance() resolves by name for every node and property, done once
+	// on first use and dropped whenever the node data changes.
+	struct InstancePlan {
+		struct Setter {
+			MethodBind *method = nullptr; // Null means going through Object::set().
+			int index = -1;
+		};
+
+		struct NodeEntry {
+			Object *(*create)() = nullptr; // Only for nodes created from their type.
+			LocalVector<Setter> setters; // One per NodeData::Property.
+		};
+
+		LocalVector<NodeEntry> nodes;
+	};
+
+	mutable InstancePlan *instance_plan = nullptr;
+	Mutex instance_plan_mutex;
+
+	const InstancePlan *_get_instance_plan() const;
+	void _clear_instance_plan();
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 
@@ -186,6 +210,7 @@ public:
 	uint64_t get_last_modified_time() const { return last_modified_time; }
 
 	SceneState();
+	~SceneState();
 };
 
 VARIANT_ENUM_CAST(SceneState::GenEditState)
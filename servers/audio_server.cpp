@@ -226,6 +226,8 @@ AudioDriver *AudioDriverManager::get_driver(int p_driver) {
 //////////////////////////////////////////////
 
 void AudioServer::_driver_process(int p_frames, int32_t *p_buffer) {
+	MemoryTagScope memory_tag(Memory::TAG_AUDIO);
+
 	int todo = p_frames;
 
 #ifdef DEBUG_ENABLED
@@ -34,6 +34,8 @@
 
 #include "navigation_server_3d.h"
 
+#include "core/method_bind_ext.gen.inc"
+
 NavigationServer3D *NavigationServer3D::singleton = nullptr;
 
 void NavigationServer3D::_bind_methods() {
@@ -47,6 +49,8 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_set_edge_connection_margin", "map", "margin"), &NavigationServer3D::map_set_edge_connection_margin);
 	ClassDB::bind_method(D_METHOD("map_get_edge_connection_margin", "map"), &NavigationServer3D::map_get_edge_connection_margin);
 	ClassDB::bind_method(D_METHOD("map_get_path", "map", "origin", "destination", "optimize"), &NavigationServer3D::map_get_path);
+	ClassDB::bind_method(D_METHOD("map_get_paths", "map", "origins", "destinations", "optimize"), &NavigationServer3D::map_get_paths);
+	ClassDB::bind_method(D_METHOD("map_get_paths_async", "map", "origins", "destinations", "optimize", "receiver", "method", "userdata"), &NavigationServer3D::map_get_paths_async, DEFVAL(Variant()));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_to_segment", "map", "start", "end", "use_collision"), &NavigationServer3D::map_get_closest_point_to_segment, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point", "map", "to_point"), &NavigationServer3D::map_get_closest_point);
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_normal", "map", "to_point"), &NavigationServer3D::map_get_closest_point_normal);
@@ -75,6 +79,11 @@ void NavigationServer3D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("set_active", "active"), &NavigationServer3D::set_active);
 	ClassDB::bind_method(D_METHOD("process", "delta_time"), &NavigationServer3D::process);
+
+	ClassDB::bind_method(D_METHOD("get_process_info", "process_info"), &NavigationServer3D::get_process_info);
+
+	BIND_ENUM_CONSTANT(INFO_LINK_REBUILD_TIME_USEC);
+	BIND_ENUM_CONSTANT(INFO_LINK_REBUILT_REGIONS);
 }
 
 const NavigationServer3D *NavigationServer3D::get_singleton() {
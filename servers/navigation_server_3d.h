@@ -90,6 +90,14 @@ public:
 	/// Returns the navigation path to reach the destination from the origin.
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize) const = 0;
 
+	/// Returns the paths between each origin and the destination at the same
+	/// index, all the queries are computed in parallel.
+	virtual Array map_get_paths(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize) const = 0;
+
+	/// Queues the same queries of `map_get_paths`; the paths are computed and
+	/// sent to the receiver method during the next `process`.
+	virtual void map_get_paths_async(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize, Object *p_receiver, StringName p_method, Variant p_udata = Variant()) const = 0;
+
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const = 0;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const = 0;
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const = 0;
@@ -175,6 +183,14 @@ public:
 	/// Control activation of this server.
 	virtual void set_active(bool p_active) const = 0;
 
+	enum ProcessInfo {
+		INFO_LINK_REBUILD_TIME_USEC,
+		INFO_LINK_REBUILT_REGIONS,
+	};
+
+	/// Returns stats about the last `process` call.
+	virtual int get_process_info(ProcessInfo p_info) const = 0;
+
 	/// Process the collision avoidance agents.
 	/// The result of this process is needed by the physics server,
 	/// so this must be called in the main thread.
@@ -185,6 +201,8 @@ public:
 	virtual ~NavigationServer3D();
 };
 
+VARIANT_ENUM_CAST(NavigationServer3D::ProcessInfo);
+
 typedef NavigationServer3D *(*NavigationServer3DCallback)();
 
 /// Manager used for the server singleton registration
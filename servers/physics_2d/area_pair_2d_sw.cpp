@@ -30,6 +30,7 @@
 
 #include "area_pair_2d_sw.h"
 #include "collision_solver_2d_sw.h"
+#include "space_2d_sw.h"
 
 bool AreaPair2DSW::setup(real_t p_step) {
 	bool result = false;
@@ -41,6 +42,10 @@ bool AreaPair2DSW::setup(real_t p_step) {
 	}
 
 	if (result != colliding) {
+		// Areas are shared between islands, which are set up in parallel.
+		SpinLock &lock = area->get_space()->get_shared_state_lock();
+		lock.lock();
+
 		if (result) {
 			if (area->get_space_override_mode() != PhysicsServer2D::AREA_SPACE_OVERRIDE_DISABLED) {
 				body->add_area(area);
@@ -59,6 +64,8 @@ bool AreaPair2DSW::setup(real_t p_step) {
 		}
 
 		colliding = result;
+
+		lock.unlock();
 	}
 
 	return false; //never do any post solving
@@ -104,6 +111,10 @@ bool Area2Pair2DSW::setup(real_t p_step) {
 	}
 
 	if (result != colliding) {
+		// Areas are shared between islands, which are set up in parallel.
+		SpinLock &lock = area_a->get_space()->get_shared_state_lock();
+		lock.lock();
+
 		if (result) {
 			if (area_b->has_area_monitor_callback() && area_a->is_monitorable()) {
 				area_b->add_area_to_query(area_a, shape_a, shape_b);
@@ -124,6 +135,8 @@ bool Area2Pair2DSW::setup(real_t p_step) {
 		}
 
 		colliding = result;
+
+		lock.unlock();
 	}
 
 	return false; //never do any post solving
@@ -33,6 +33,7 @@
 
 #include "area_2d_sw.h"
 #include "collision_object_2d_sw.h"
+#include "core/spin_lock.h"
 #include "core/vset.h"
 
 class Constraint2DSW;
@@ -112,6 +113,7 @@ class Body2DSW : public CollisionObject2DSW {
 	};
 
 	Vector<Contact> contacts; //no contacts by default
+	SpinLock contacts_lock; // Static and kinematic bodies can be reported from several islands at once.
 	int contact_count;
 
 	struct ForceIntegrationCallback {
@@ -199,20 +201,34 @@ public:
 	_FORCE_INLINE_ void set_biased_angular_velocity(real_t p_velocity) { biased_angular_velocity = p_velocity; }
 	_FORCE_INLINE_ real_t get_biased_angular_velocity() const { return biased_angular_velocity; }
 
+	// Static and kinematic bodies (zero inverse mass) never change velocity from impulses.
+	// Skipping the write also keeps islands solved in parallel from racing on a shared body.
 	_FORCE_INLINE_ void apply_central_impulse(const Vector2 &p_impulse) {
+		if (_inv_mass == 0) {
+			return;
+		}
 		linear_velocity += p_impulse * _inv_mass;
 	}
 
 	_FORCE_INLINE_ void apply_impulse(const Vector2 &p_offset, const Vector2 &p_impulse) {
+		if (_inv_mass == 0) {
+			return;
+		}
 		linear_velocity += p_impulse * _inv_mass;
 		angular_velocity += _inv_inertia * p_offset.cross(p_impulse);
 	}
 
 	_FORCE_INLINE_ void apply_torque_impulse(real_t p_torque) {
+		if (_inv_mass == 0) {
+			return;
+		}
 		angular_velocity += _inv_inertia * p_torque;
 	}
 
 	_FORCE_INLINE_ void apply_bias_impulse(const Vector2 &p_pos, const Vector2 &p_j) {
+		if (_inv_mass == 0) {
+			return;
+		}
 		biased_linear_velocity += p_j * _inv_mass;
 		biased_angular_velocity += _inv_inertia * p_pos.cross(p_j);
 	}
@@ -300,6 +316,8 @@ void Body2DSW::add_contact(const Vector2 &p_local_pos, const Vector2 &p_local_no
 		return;
 	}
 
+	contacts_lock.lock();
+
 	Contact *c = contacts.ptrw();
 
 	int idx = -1;
@@ -320,6 +338,7 @@ void Body2DSW::add_contact(const Vector2 &p_local_pos, const Vector2 &p_local_no
 			idx = least_deep;
 		}
 		if (idx == -1) {
+			contacts_lock.unlock();
 			return; //none least deepe than this
 		}
 	}
@@ -333,6 +352,8 @@ void Body2DSW::add_contact(const Vector2 &p_local_pos, const Vector2 &p_local_no
 	c[idx].collider_instance_id = p_collider_instance_id;
 	c[idx].collider = p_collider;
 	c[idx].collider_velocity_at_pos = p_collider_velocity_at_pos;
+
+	contacts_lock.unlock();
 }
 
 class PhysicsDirectBodyState2DSW : public PhysicsDirectBodyState2D {
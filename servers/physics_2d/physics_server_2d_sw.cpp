@@ -31,6 +31,7 @@
 #include "physics_server_2d_sw.h"
 
 #include "broad_phase_2d_basic.h"
+#include "broad_phase_2d_bvh.h"
 #include "broad_phase_2d_hash_grid.h"
 #include "collision_solver_2d_sw.h"
 #include "core/debugger/engine_debugger.h"
@@ -1223,6 +1224,8 @@ void PhysicsServer2DSW::init() {
 };
 
 void PhysicsServer2DSW::step(real_t p_step) {
+	MemoryTagScope memory_tag(Memory::TAG_PHYSICS);
+
 	if (!active) {
 		return;
 	}
@@ -1249,6 +1252,8 @@ void PhysicsServer2DSW::sync() {
 };
 
 void PhysicsServer2DSW::flush_queries() {
+	MemoryTagScope memory_tag(Memory::TAG_PHYSICS);
+
 	if (!active) {
 		return;
 	}
@@ -1334,7 +1339,13 @@ PhysicsServer2DSW *PhysicsServer2DSW::singletonsw = nullptr;
 
 PhysicsServer2DSW::PhysicsServer2DSW() {
 	singletonsw = this;
-	BroadPhase2DSW::create_func = BroadPhase2DHashGrid::_create;
+	String broadphase = GLOBAL_DEF("physics/2d/broadphase", "HashGrid");
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/broadphase", PropertyInfo(Variant::STRING, "physics/2d/broadphase", PROPERTY_HINT_ENUM, "HashGrid,BVH"));
+	if (broadphase == "BVH") {
+		BroadPhase2DSW::create_func = BroadPhase2DBVH::_create;
+	} else {
+		BroadPhase2DSW::create_func = BroadPhase2DHashGrid::_create;
+	}
 	//BroadPhase2DSW::create_func=BroadPhase2DBasic::_create;
 
 	active = true;
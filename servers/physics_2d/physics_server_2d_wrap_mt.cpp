@@ -48,6 +48,8 @@ void PhysicsServer2DWrapMT::_thread_callback(void *_instance) {
 }
 
 void PhysicsServer2DWrapMT::thread_loop() {
+	MemoryTagScope memory_tag(Memory::TAG_PHYSICS);
+
 	server_thread = Thread::get_caller_id();
 
 	physics_2d_server->init();
@@ -39,6 +39,7 @@
 #include "collision_object_2d_sw.h"
 #include "core/hash_map.h"
 #include "core/project_settings.h"
+#include "core/spin_lock.h"
 #include "core/typedefs.h"
 
 class PhysicsDirectSpaceState2DSW : public PhysicsDirectSpaceState2D {
@@ -127,6 +128,8 @@ private:
 	Vector<Vector2> contact_debug;
 	int contact_debug_count;
 
+	SpinLock shared_state_lock;
+
 	friend class PhysicsDirectSpaceState2DSW;
 
 public:
@@ -190,15 +193,21 @@ public:
 	void set_debug_contacts(int p_amount) { contact_debug.resize(p_amount); }
 	_FORCE_INLINE_ bool is_debugging_contacts() const { return !contact_debug.empty(); }
 	_FORCE_INLINE_ void add_debug_contact(const Vector2 &p_contact) {
+		shared_state_lock.lock();
 		if (contact_debug_count < contact_debug.size()) {
 			contact_debug.write[contact_debug_count++] = p_contact;
 		}
+		shared_state_lock.unlock();
 	}
 	_FORCE_INLINE_ Vector<Vector2> get_debug_contacts() { return contact_debug; }
 	_FORCE_INLINE_ int get_debug_contact_count() { return contact_debug_count; }
 
 	PhysicsDirectSpaceState2DSW *get_direct_state();
 
+	// Islands are set up and solved in parallel; constraints touching state shared
+	// between islands (areas, the monitor query list) must hold this lock.
+	_FORCE_INLINE_ SpinLock &get_shared_state_lock() { return shared_state_lock; }
+
 	void set_elapsed_time(ElapsedTime p_time, uint64_t p_msec) { elapsed_time[p_time] = p_msec; }
 	uint64_t get_elapsed_time(ElapsedTime p_time) const { return elapsed_time[p_time]; }
 
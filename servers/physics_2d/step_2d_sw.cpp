@@ -30,6 +30,7 @@
 
 #include "step_2d_sw.h"
 #include "core/os/os.h"
+#include "core/thread_work_pool.h"
 
 void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island) {
 	p_body->set_island_step(_step);
@@ -58,12 +59,12 @@ void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constrain
 	}
 }
 
-bool Step2DSW::_setup_island(Constraint2DSW *p_island, real_t p_delta) {
-	Constraint2DSW *ci = p_island;
+void Step2DSW::_setup_island(uint32_t p_island_index, void *p_userdata) {
+	Constraint2DSW *ci = constraint_islands[p_island_index];
 	Constraint2DSW *prev_ci = nullptr;
 	bool removed_root = false;
 	while (ci) {
-		bool process = ci->setup(p_delta);
+		bool process = ci->setup(delta);
 
 		if (!process) {
 			//remove from island if process fails
@@ -79,39 +80,52 @@ bool Step2DSW::_setup_island(Constraint2DSW *p_island, real_t p_delta) {
 		ci = ci->get_island_next();
 	}
 
-	return removed_root;
+	if (removed_root) {
+		//removed the root from the island graph because it is not to be processed, the island may be empty now
+		constraint_islands[p_island_index] = constraint_islands[p_island_index]->get_island_next();
+	}
 }
 
-void Step2DSW::_solve_island(Constraint2DSW *p_island, int p_iterations, real_t p_delta) {
-	for (int i = 0; i < p_iterations; i++) {
-		Constraint2DSW *ci = p_island;
+void Step2DSW::_solve_island(uint32_t p_island_index, void *p_userdata) {
+	Constraint2DSW *island = constraint_islands[p_island_index];
+	if (!island) {
+		return;
+	}
+
+	for (int i = 0; i < iterations; i++) {
+		Constraint2DSW *ci = island;
 		while (ci) {
-			ci->solve(p_delta);
+			ci->solve(delta);
 			ci = ci->get_island_next();
 		}
 	}
 }
 
-void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
+void Step2DSW::_check_suspend(uint32_t p_island_index, void *p_userdata) {
 	bool can_sleep = true;
 
-	Body2DSW *b = p_island;
+	Body2DSW *b = body_islands[p_island_index];
 	while (b) {
 		if (b->get_mode() == PhysicsServer2D::BODY_MODE_STATIC || b->get_mode() == PhysicsServer2D::BODY_MODE_KINEMATIC) {
 			b = b->get_island_next();
 			continue; //ignore for static
 		}
 
-		if (!b->sleep_test(p_delta)) {
+		if (!b->sleep_test(delta)) {
 			can_sleep = false;
 		}
 
 		b = b->get_island_next();
 	}
 
+	island_can_sleep[p_island_index] = can_sleep;
+}
+
+void Step2DSW::_apply_suspend(Body2DSW *p_island, bool p_can_sleep) {
 	//put all to sleep or wake up everyoen
+	//changing the active state edits the space's active list, so this is not done in parallel
 
-	b = p_island;
+	Body2DSW *b = p_island;
 	while (b) {
 		if (b->get_mode() == PhysicsServer2D::BODY_MODE_STATIC || b->get_mode() == PhysicsServer2D::BODY_MODE_KINEMATIC) {
 			b = b->get_island_next();
@@ -120,8 +134,8 @@ void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
 
 		bool active = b->is_active();
 
-		if (active == can_sleep) {
-			b->set_active(!can_sleep);
+		if (active == p_can_sleep) {
+			b->set_active(!p_can_sleep);
 		}
 
 		b = b->get_island_next();
@@ -131,6 +145,10 @@ void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
 void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 	p_space->lock(); // can't access space during this
 
+	delta = p_delta;
+	iterations = p_iterations;
+	ThreadWorkPool *work_pool = ThreadWorkPool::get_singleton();
+
 	p_space->setup(); //update inertias, etc
 
 	const SelfList<Body2DSW>::List *body_list = &p_space->get_active_body_list();
@@ -159,8 +177,8 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* GENERATE CONSTRAINT ISLANDS */
 
-	Body2DSW *island_list = nullptr;
-	Constraint2DSW *constraint_island_list = nullptr;
+	body_islands.clear();
+	constraint_islands.clear();
 	b = body_list->first();
 
 	int island_count = 0;
@@ -173,12 +191,10 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 			Constraint2DSW *constraint_island = nullptr;
 			_populate_island(body, &island, &constraint_island);
 
-			island->set_island_list_next(island_list);
-			island_list = island;
+			body_islands.push_back(island);
 
 			if (constraint_island) {
-				constraint_island->set_island_list_next(constraint_island_list);
-				constraint_island_list = constraint_island;
+				constraint_islands.push_back(constraint_island);
 				island_count++;
 			}
 		}
@@ -197,8 +213,7 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 			}
 			c->set_island_step(_step);
 			c->set_island_next(nullptr);
-			c->set_island_list_next(constraint_island_list);
-			constraint_island_list = c;
+			constraint_islands.push_back(c);
 		}
 		p_space->area_remove_from_moved_list((SelfList<Area2DSW> *)aml.first()); //faster to remove here
 	}
@@ -211,40 +226,7 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SETUP CONSTRAINT ISLANDS */
 
-	{
-		Constraint2DSW *ci = constraint_island_list;
-		Constraint2DSW *prev_ci = nullptr;
-		while (ci) {
-			if (_setup_island(ci, p_delta)) {
-				//removed the root from the island graph because it is not to be processed
-
-				Constraint2DSW *next = ci->get_island_next();
-
-				if (next) {
-					//root from list being deleted no longer exists, replace by next
-					next->set_island_list_next(ci->get_island_list_next());
-					if (prev_ci) {
-						prev_ci->set_island_list_next(next);
-					} else {
-						constraint_island_list = next;
-					}
-					prev_ci = next;
-				} else {
-					//list is empty, just skip
-					if (prev_ci) {
-						prev_ci->set_island_list_next(ci->get_island_list_next());
-
-					} else {
-						constraint_island_list = ci->get_island_list_next();
-					}
-				}
-			} else {
-				prev_ci = ci;
-			}
-
-			ci = ci->get_island_list_next();
-		}
-	}
+	work_pool->do_work(constraint_islands.size(), this, &Step2DSW::_setup_island, nullptr);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -254,14 +236,8 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
-	{
-		Constraint2DSW *ci = constraint_island_list;
-		while (ci) {
-			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
-			ci = ci->get_island_list_next();
-		}
-	}
+	//iterating each island separatedly improves cache efficiency
+	work_pool->do_work(constraint_islands.size(), this, &Step2DSW::_solve_island, nullptr);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -280,12 +256,11 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SLEEP / WAKE UP ISLANDS */
 
-	{
-		Body2DSW *bi = island_list;
-		while (bi) {
-			_check_suspend(bi, p_delta);
-			bi = bi->get_island_list_next();
-		}
+	island_can_sleep.resize(body_islands.size());
+	work_pool->do_work(body_islands.size(), this, &Step2DSW::_check_suspend, nullptr);
+
+	for (uint32_t i = 0; i < body_islands.size(); i++) {
+		_apply_suspend(body_islands[i], island_can_sleep[i]);
 	}
 
 	{ //profile
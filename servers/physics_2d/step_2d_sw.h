@@ -33,13 +33,25 @@
 
 #include "space_2d_sw.h"
 
+#include "core/local_vector.h"
+
 class Step2DSW {
 	uint64_t _step;
 
+	// Islands share no bodies that can move, so each phase below runs one island
+	// per task on the ThreadWorkPool.
+	LocalVector<Body2DSW *> body_islands;
+	LocalVector<Constraint2DSW *> constraint_islands;
+	LocalVector<bool> island_can_sleep;
+
+	real_t delta = 0.0;
+	int iterations = 0;
+
 	void _populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island);
-	bool _setup_island(Constraint2DSW *p_island, real_t p_delta);
-	void _solve_island(Constraint2DSW *p_island, int p_iterations, real_t p_delta);
-	void _check_suspend(Body2DSW *p_island, real_t p_delta);
+	void _setup_island(uint32_t p_island_index, void *p_userdata = nullptr);
+	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr);
+	void _check_suspend(uint32_t p_island_index, void *p_userdata = nullptr);
+	void _apply_suspend(Body2DSW *p_island, bool p_can_sleep);
 
 public:
 	void step(Space2DSW *p_space, real_t p_delta, int p_iterations);
@@ -33,6 +33,7 @@
 
 #include "area_3d_sw.h"
 #include "collision_object_3d_sw.h"
+#include "core/spin_lock.h"
 #include "core/vset.h"
 
 class Constraint3DSW;
@@ -124,6 +125,7 @@ class Body3DSW : public CollisionObject3DSW {
 	};
 
 	Vector<Contact> contacts; //no contacts by default
+	SpinLock contacts_lock; // Static and kinematic bodies can be reported from several islands at once.
 	int contact_count;
 
 	struct ForceIntegrationCallback {
@@ -216,20 +218,34 @@ public:
 	_FORCE_INLINE_ const Vector3 &get_biased_linear_velocity() const { return biased_linear_velocity; }
 	_FORCE_INLINE_ const Vector3 &get_biased_angular_velocity() const { return biased_angular_velocity; }
 
+	// Static and kinematic bodies (zero inverse mass) never change velocity from impulses.
+	// Skipping the write also keeps islands solved in parallel from racing on a shared body.
 	_FORCE_INLINE_ void apply_central_impulse(const Vector3 &p_j) {
+		if (_inv_mass == 0) {
+			return;
+		}
 		linear_velocity += p_j * _inv_mass;
 	}
 
 	_FORCE_INLINE_ void apply_impulse(const Vector3 &p_pos, const Vector3 &p_j) {
+		if (_inv_mass == 0) {
+			return;
+		}
 		linear_velocity += p_j * _inv_mass;
 		angular_velocity += _inv_inertia_tensor.xform((p_pos - center_of_mass).cross(p_j));
 	}
 
 	_FORCE_INLINE_ void apply_torque_impulse(const Vector3 &p_j) {
+		if (_inv_mass == 0) {
+			return;
+		}
 		angular_velocity += _inv_inertia_tensor.xform(p_j);
 	}
 
 	_FORCE_INLINE_ void apply_bias_impulse(const Vector3 &p_pos, const Vector3 &p_j, real_t p_max_delta_av = -1.0) {
+		if (_inv_mass == 0) {
+			return;
+		}
 		biased_linear_velocity += p_j * _inv_mass;
 		if (p_max_delta_av != 0.0) {
 			Vector3 delta_av = _inv_inertia_tensor.xform((p_pos - center_of_mass).cross(p_j));
@@ -241,6 +257,9 @@ public:
 	}
 
 	_FORCE_INLINE_ void apply_bias_torque_impulse(const Vector3 &p_j) {
+		if (_inv_mass == 0) {
+			return;
+		}
 		biased_angular_velocity += _inv_inertia_tensor.xform(p_j);
 	}
 
@@ -339,6 +358,8 @@ void Body3DSW::add_contact(const Vector3 &p_local_pos, const Vector3 &p_local_no
 		return;
 	}
 
+	contacts_lock.lock();
+
 	Contact *c = contacts.ptrw();
 
 	int idx = -1;
@@ -359,6 +380,7 @@ void Body3DSW::add_contact(const Vector3 &p_local_pos, const Vector3 &p_local_no
 			idx = least_deep;
 		}
 		if (idx == -1) {
+			contacts_lock.unlock();
 			return; //none least deepe than this
 		}
 	}
@@ -372,6 +394,8 @@ void Body3DSW::add_contact(const Vector3 &p_local_pos, const Vector3 &p_local_no
 	c[idx].collider_instance_id = p_collider_instance_id;
 	c[idx].collider = p_collider;
 	c[idx].collider_velocity_at_pos = p_collider_velocity_at_pos;
+
+	contacts_lock.unlock();
 }
 
 class PhysicsDirectBodyState3DSW : public PhysicsDirectBodyState3D {
@@ -39,6 +39,7 @@
 #include "collision_object_3d_sw.h"
 #include "core/hash_map.h"
 #include "core/project_settings.h"
+#include "core/spin_lock.h"
 #include "core/typedefs.h"
 
 class PhysicsDirectSpaceState3DSW : public PhysicsDirectSpaceState3D {
@@ -120,6 +121,8 @@ private:
 	Vector<Vector3> contact_debug;
 	int contact_debug_count;
 
+	SpinLock shared_state_lock;
+
 	friend class PhysicsDirectSpaceState3DSW;
 
 	int _cull_aabb_for_body(Body3DSW *p_body, const AABB &p_aabb);
@@ -185,9 +188,11 @@ public:
 	void set_debug_contacts(int p_amount) { contact_debug.resize(p_amount); }
 	_FORCE_INLINE_ bool is_debugging_contacts() const { return !contact_debug.empty(); }
 	_FORCE_INLINE_ void add_debug_contact(const Vector3 &p_contact) {
+		shared_state_lock.lock();
 		if (contact_debug_count < contact_debug.size()) {
 			contact_debug.write[contact_debug_count++] = p_contact;
 		}
+		shared_state_lock.unlock();
 	}
 	_FORCE_INLINE_ Vector<Vector3> get_debug_contacts() { return contact_debug; }
 	_FORCE_INLINE_ int get_debug_contact_count() { return contact_debug_count; }
@@ -195,6 +200,10 @@ public:
 	void set_static_global_body(RID p_body) { static_global_body = p_body; }
 	RID get_static_global_body() { return static_global_body; }
 
+	// Islands are set up and solved in parallel; constraints touching state shared
+	// between islands (areas, the monitor query list) must hold this lock.
+	_FORCE_INLINE_ SpinLock &get_shared_state_lock() { return shared_state_lock; }
+
 	void set_elapsed_time(ElapsedTime p_time, uint64_t p_msec) { elapsed_time[p_time] = p_msec; }
 	uint64_t get_elapsed_time(ElapsedTime p_time) const { return elapsed_time[p_time]; }
 
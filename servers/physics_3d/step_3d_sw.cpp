@@ -32,6 +32,7 @@
 #include "joints_3d_sw.h"
 
 #include "core/os/os.h"
+#include "core/thread_work_pool.h"
 
 void Step3DSW::_populate_island(Body3DSW *p_body, Body3DSW **p_island, Constraint3DSW **p_constraint_island) {
 	p_body->set_island_step(_step);
@@ -60,23 +61,24 @@ void Step3DSW::_populate_island(Body3DSW *p_body, Body3DSW **p_island, Constrain
 	}
 }
 
-void Step3DSW::_setup_island(Constraint3DSW *p_island, real_t p_delta) {
-	Constraint3DSW *ci = p_island;
+void Step3DSW::_setup_island(uint32_t p_island_index, void *p_userdata) {
+	Constraint3DSW *ci = constraint_islands[p_island_index];
 	while (ci) {
-		ci->setup(p_delta);
+		ci->setup(delta);
 		//todo remove from island if process fails
 		ci = ci->get_island_next();
 	}
 }
 
-void Step3DSW::_solve_island(Constraint3DSW *p_island, int p_iterations, real_t p_delta) {
+void Step3DSW::_solve_island(uint32_t p_island_index, void *p_userdata) {
+	Constraint3DSW *island = constraint_islands[p_island_index];
 	int at_priority = 1;
 
-	while (p_island) {
-		for (int i = 0; i < p_iterations; i++) {
-			Constraint3DSW *ci = p_island;
+	while (island) {
+		for (int i = 0; i < iterations; i++) {
+			Constraint3DSW *ci = island;
 			while (ci) {
-				ci->solve(p_delta);
+				ci->solve(delta);
 				ci = ci->get_island_next();
 			}
 		}
@@ -84,14 +86,14 @@ void Step3DSW::_solve_island(Constraint3DSW *p_island, int p_iterations, real_t
 		at_priority++;
 
 		{
-			Constraint3DSW *ci = p_island;
+			Constraint3DSW *ci = island;
 			Constraint3DSW *prev = nullptr;
 			while (ci) {
 				if (ci->get_priority() < at_priority) {
 					if (prev) {
 						prev->set_island_next(ci->get_island_next()); //remove
 					} else {
-						p_island = ci->get_island_next();
+						island = ci->get_island_next();
 					}
 				} else {
 					prev = ci;
@@ -103,26 +105,31 @@ void Step3DSW::_solve_island(Constraint3DSW *p_island, int p_iterations, real_t
 	}
 }
 
-void Step3DSW::_check_suspend(Body3DSW *p_island, real_t p_delta) {
+void Step3DSW::_check_suspend(uint32_t p_island_index, void *p_userdata) {
 	bool can_sleep = true;
 
-	Body3DSW *b = p_island;
+	Body3DSW *b = body_islands[p_island_index];
 	while (b) {
 		if (b->get_mode() == PhysicsServer3D::BODY_MODE_STATIC || b->get_mode() == PhysicsServer3D::BODY_MODE_KINEMATIC) {
 			b = b->get_island_next();
 			continue; //ignore for static
 		}
 
-		if (!b->sleep_test(p_delta)) {
+		if (!b->sleep_test(delta)) {
 			can_sleep = false;
 		}
 
 		b = b->get_island_next();
 	}
 
+	island_can_sleep[p_island_index] = can_sleep;
+}
+
+void Step3DSW::_apply_suspend(Body3DSW *p_island, bool p_can_sleep) {
 	//put all to sleep or wake up everyoen
+	//changing the active state edits the space's active list, so this is not done in parallel
 
-	b = p_island;
+	Body3DSW *b = p_island;
 	while (b) {
 		if (b->get_mode() == PhysicsServer3D::BODY_MODE_STATIC || b->get_mode() == PhysicsServer3D::BODY_MODE_KINEMATIC) {
 			b = b->get_island_next();
@@ -131,8 +138,8 @@ void Step3DSW::_check_suspend(Body3DSW *p_island, real_t p_delta) {
 
 		bool active = b->is_active();
 
-		if (active == can_sleep) {
-			b->set_active(!can_sleep);
+		if (active == p_can_sleep) {
+			b->set_active(!p_can_sleep);
 		}
 
 		b = b->get_island_next();
@@ -142,6 +149,10 @@ void Step3DSW::_check_suspend(Body3DSW *p_island, real_t p_delta) {
 void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 	p_space->lock(); // can't access space during this
 
+	delta = p_delta;
+	iterations = p_iterations;
+	ThreadWorkPool *work_pool = ThreadWorkPool::get_singleton();
+
 	p_space->setup(); //update inertias, etc
 
 	const SelfList<Body3DSW>::List *body_list = &p_space->get_active_body_list();
@@ -170,8 +181,8 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* GENERATE CONSTRAINT ISLANDS */
 
-	Body3DSW *island_list = nullptr;
-	Constraint3DSW *constraint_island_list = nullptr;
+	body_islands.clear();
+	constraint_islands.clear();
 	b = body_list->first();
 
 	int island_count = 0;
@@ -184,12 +195,10 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 			Constraint3DSW *constraint_island = nullptr;
 			_populate_island(body, &island, &constraint_island);
 
-			island->set_island_list_next(island_list);
-			island_list = island;
+			body_islands.push_back(island);
 
 			if (constraint_island) {
-				constraint_island->set_island_list_next(constraint_island_list);
-				constraint_island_list = constraint_island;
+				constraint_islands.push_back(constraint_island);
 				island_count++;
 			}
 		}
@@ -208,8 +217,7 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 			}
 			c->set_island_step(_step);
 			c->set_island_next(nullptr);
-			c->set_island_list_next(constraint_island_list);
-			constraint_island_list = c;
+			constraint_islands.push_back(c);
 		}
 		p_space->area_remove_from_moved_list((SelfList<Area3DSW> *)aml.first()); //faster to remove here
 	}
@@ -222,13 +230,7 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SETUP CONSTRAINT ISLANDS */
 
-	{
-		Constraint3DSW *ci = constraint_island_list;
-		while (ci) {
-			_setup_island(ci, p_delta);
-			ci = ci->get_island_list_next();
-		}
-	}
+	work_pool->do_work(constraint_islands.size(), this, &Step3DSW::_setup_island, nullptr);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -238,14 +240,8 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
-	{
-		Constraint3DSW *ci = constraint_island_list;
-		while (ci) {
-			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
-			ci = ci->get_island_list_next();
-		}
-	}
+	//iterating each island separatedly improves cache efficiency
+	work_pool->do_work(constraint_islands.size(), this, &Step3DSW::_solve_island, nullptr);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -264,12 +260,11 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SLEEP / WAKE UP ISLANDS */
 
-	{
-		Body3DSW *bi = island_list;
-		while (bi) {
-			_check_suspend(bi, p_delta);
-			bi = bi->get_island_list_next();
-		}
+	island_can_sleep.resize(body_islands.size());
+	work_pool->do_work(body_islands.size(), this, &Step3DSW::_check_suspend, nullptr);
+
+	for (uint32_t i = 0; i < body_islands.size(); i++) {
+		_apply_suspend(body_islands[i], island_can_sleep[i]);
 	}
 
 	{ //profile
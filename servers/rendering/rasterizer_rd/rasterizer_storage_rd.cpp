@@ -3174,6 +3174,23 @@ void RasterizerStorageRD::skeleton_bone_set_transform(RID p_skeleton, int p_bone
 	_skeleton_make_dirty(skeleton);
 }
 
+void RasterizerStorageRD::skeleton_set_buffer(RID p_skeleton, const Vector<float> &p_buffer) {
+	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
+
+	ERR_FAIL_COND(!skeleton);
+	ERR_FAIL_COND(skeleton->use_2d);
+	ERR_FAIL_COND(p_buffer.size() != skeleton->data.size());
+
+	if (!skeleton->size) {
+		return;
+	}
+
+	// Same layout as the storage buffer, so the data is shared rather than copied.
+	skeleton->data = p_buffer;
+
+	_skeleton_make_dirty(skeleton);
+}
+
 Transform RasterizerStorageRD::skeleton_bone_get_transform(RID p_skeleton, int p_bone) const {
 	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
 
@@ -1002,6 +1002,7 @@ public:
 	void skeleton_set_world_transform(RID p_skeleton, bool p_enable, const Transform &p_world_transform);
 	int skeleton_get_bone_count(RID p_skeleton) const;
 	void skeleton_bone_set_transform(RID p_skeleton, int p_bone, const Transform &p_transform);
+	void skeleton_set_buffer(RID p_skeleton, const Vector<float> &p_buffer);
 	Transform skeleton_bone_get_transform(RID p_skeleton, int p_bone) const;
 	void skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform);
 	Transform2D skeleton_bone_get_transform_2d(RID p_skeleton, int p_bone) const;
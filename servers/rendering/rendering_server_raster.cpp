@@ -95,6 +95,8 @@ void RenderingServerRaster::request_frame_drawn_callback(Object *p_where, const
 }
 
 void RenderingServerRaster::draw(bool p_swap_buffers, double frame_step) {
+	MemoryTagScope memory_tag(Memory::TAG_RENDERER);
+
 	//needs to be done before changes is reset to 0, to not force the editor to redraw
 	RS::get_singleton()->emit_signal("frame_pre_draw");
 
@@ -170,6 +172,7 @@ bool RenderingServerRaster::has_changed() const {
 }
 
 void RenderingServerRaster::init() {
+	MemoryTagScope memory_tag(Memory::TAG_RENDERER);
 	RSG::rasterizer->initialize();
 }
 
@@ -54,6 +54,8 @@ void RenderingServerWrapMT::_thread_callback(void *_instance) {
 }
 
 void RenderingServerWrapMT::thread_loop() {
+	MemoryTagScope memory_tag(Memory::TAG_RENDERER);
+
 	server_thread = Thread::get_caller_id();
 
 	DisplayServer::get_singleton()->make_rendering_thread();